@@ -0,0 +1,115 @@
+/**
+ * @file Apa102Frame.h
+ * @brief One strip's pixels held in APA102 wire format
+ *
+ * The buffer is exactly what goes down the data line: a 32-bit zero
+ * start frame, then per LED a 0xE0|brightness header and B, G, R, then
+ * the end frame. Renderers write pixels into place with set(); sending
+ * a frame is a single transfer of bytes[], with no reorder or framing
+ * pass in between. Header-only, so the native tests cover it.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef APA102FRAME_H
+#define APA102FRAME_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Apa102Parallel.h"
+#include "FlickerMath.h"
+
+/**
+ * LED header byte: 0xE0 marker with a 5-bit global brightness
+ */
+constexpr uint8_t apa102Header(uint8_t brightness)
+{
+    return 0xE0 | (brightness & 0x1F);
+}
+
+/**
+ * @struct Apa102Frame
+ * @brief Wire-format frame for one strip of NumLeds LEDs
+ *
+ * @tparam NumLeds LEDs on the strip
+ */
+template <int NumLeds>
+struct Apa102Frame
+{
+    static const int BYTES = apa102FrameBytes(NumLeds);
+
+    uint8_t bytes[BYTES];
+
+    /**
+     * Write start frame, LED headers and end frame; all LEDs black
+     *
+     * @param brightness Global brightness for every LED (0-31)
+     */
+    void begin(uint8_t brightness)
+    {
+        memset(bytes, 0, sizeof(bytes));
+        for (int i = 0; i < NumLeds; i++)
+        {
+            bytes[APA102_START_FRAME_BYTES + APA102_LED_BYTES * i] = apa102Header(brightness);
+        }
+    }
+
+    /**
+     * Put one pixel in place (safe on the IRAM render path)
+     */
+    RENDER_INLINE void set(int i, uint8_t r, uint8_t g, uint8_t b)
+    {
+        uint8_t *led = bytes + APA102_START_FRAME_BYTES + APA102_LED_BYTES * i;
+        led[1] = b;
+        led[2] = g;
+        led[3] = r;
+    }
+
+    /**
+     * Copy in packed RGB triples (FastLED CRGB layout), NumLeds of them
+     */
+    void pack(const uint8_t *rgb)
+    {
+        for (int i = 0; i < NumLeds; i++)
+        {
+            set(i, rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+        }
+    }
+
+    /**
+     * Copy out packed RGB triples, e.g. for a preview of what was sent
+     */
+    void unpack(uint8_t *rgb) const
+    {
+        for (int i = 0; i < NumLeds; i++)
+        {
+            const uint8_t *led = bytes + APA102_START_FRAME_BYTES + APA102_LED_BYTES * i;
+            rgb[3 * i] = led[3];
+            rgb[3 * i + 1] = led[2];
+            rgb[3 * i + 2] = led[1];
+        }
+    }
+};
+
+#endif // APA102FRAME_H
@@ -0,0 +1,197 @@
+/**
+ * @file Apa102Parallel.h
+ * @brief APA102 frame encoding for bit-parallel (I2S) output
+ *
+ * The I2S peripheral in LCD mode clocks out one 8- or 16-bit word per
+ * clock edge, one bit per GPIO. Driving N APA102 strips from a shared
+ * clock line therefore needs every wire byte of every strip spread
+ * across 8 consecutive words: word k carries bit (7-k) of each strip's
+ * byte on that strip's lane. This header builds that layout straight
+ * from the leds[strip][i] arrays with an 8x8 bit-matrix transpose, so
+ * the cost is a handful of shifts and masks per group of 8 strips.
+ *
+ * Pure C++ with no Arduino dependency so it runs in the native tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef APA102PARALLEL_H
+#define APA102PARALLEL_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// APA102 FRAME LAYOUT
+// ============================================================================
+
+#define APA102_START_FRAME_BYTES 4
+#define APA102_LED_BYTES 4
+#define APA102_LED_HEADER 0xFF // 0xE0 marker | global brightness 31
+
+/**
+ * End frame length: one extra clock per two LEDs, at least 32 clocks
+ */
+constexpr int apa102EndFrameBytes(int numLeds)
+{
+    return (numLeds + 15) / 16 < 4 ? 4 : (numLeds + 15) / 16;
+}
+
+/**
+ * Total wire bytes for one strip: start frame, LEDs, end frame
+ */
+constexpr int apa102FrameBytes(int numLeds)
+{
+    return APA102_START_FRAME_BYTES + APA102_LED_BYTES * numLeds + apa102EndFrameBytes(numLeds);
+}
+
+// ============================================================================
+// BIT TRANSPOSE
+// ============================================================================
+
+/**
+ * Transpose 8 lane bytes into 8 bit-slot bytes
+ *
+ * Output slot k (sent first for k = 0) holds bit (7-k) of every lane,
+ * with lane s on bit s. Uses the 32-bit 8x8 transpose from Hacker's
+ * Delight (transpose8rS32): two words, three swap stages, no loops.
+ *
+ * @param in  in[s] = wire byte for lane s
+ * @param out out[k] = bit slot k
+ */
+inline void transposeLanes8(const uint8_t in[8], uint8_t out[8])
+{
+    // Row i of the bit matrix is lane (7-i), so column k lands on bit s
+    uint32_t x = ((uint32_t)in[7] << 24) | ((uint32_t)in[6] << 16) | ((uint32_t)in[5] << 8) | in[4];
+    uint32_t y = ((uint32_t)in[3] << 24) | ((uint32_t)in[2] << 16) | ((uint32_t)in[1] << 8) | in[0];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AAu;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AAu;
+    y = y ^ t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCCu;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCCu;
+    y = y ^ t ^ (t << 14);
+
+    t = (x & 0xF0F0F0F0u) | ((y >> 4) & 0x0F0F0F0Fu);
+    y = ((x << 4) & 0xF0F0F0F0u) | (y & 0x0F0F0F0Fu);
+    x = t;
+
+    out[0] = x >> 24;
+    out[1] = x >> 16;
+    out[2] = x >> 8;
+    out[3] = x;
+    out[4] = y >> 24;
+    out[5] = y >> 16;
+    out[6] = y >> 8;
+    out[7] = y;
+}
+
+// ============================================================================
+// FRAME ENCODER
+// ============================================================================
+
+/**
+ * Lane word type for a strip count: a byte up to 8 strips, else 16 bits
+ */
+template <bool Wide>
+struct ParallelWord
+{
+    typedef uint8_t type;
+};
+
+template <>
+struct ParallelWord<true>
+{
+    typedef uint16_t type;
+};
+
+/**
+ * Encode all strips into one bit-parallel APA102 frame
+ *
+ * Pixels are read as packed RGB triples (FastLED CRGB layout) and sent
+ * in APA102 BGR order. Start and end frames are all-zero words, LED
+ * headers are all-ones on every active lane.
+ *
+ * @tparam Word uint8_t for up to 8 lanes, uint16_t for up to 16
+ * @param strips    strips[s] = RGB bytes of strip s (numLeds * 3)
+ * @param numStrips Active lanes (unused lanes stay low)
+ * @param numLeds   LEDs per strip
+ * @param out       apa102FrameBytes(numLeds) * 8 words
+ */
+template <typename Word>
+void apa102EncodeParallel(const uint8_t *const *strips, int numStrips, int numLeds, Word *out)
+{
+    const int lanes = sizeof(Word) * 8;
+    const int groups = lanes / 8;
+    const Word activeMask = (Word)((numStrips >= lanes) ? ~0u : ((1u << numStrips) - 1));
+
+    // Start frame: 32 clocks of zeros
+    memset(out, 0, APA102_START_FRAME_BYTES * 8 * sizeof(Word));
+    out += APA102_START_FRAME_BYTES * 8;
+
+    // BGR byte offsets within a packed RGB pixel
+    static const uint8_t channel[3] = {2, 1, 0};
+
+    for (int led = 0; led < numLeds; led++)
+    {
+        // LED header byte: all ones on every active lane
+        for (int k = 0; k < 8; k++)
+        {
+            out[k] = activeMask;
+        }
+        out += 8;
+
+        for (int c = 0; c < 3; c++)
+        {
+            for (int k = 0; k < 8; k++)
+            {
+                out[k] = 0;
+            }
+            for (int g = 0; g < groups; g++)
+            {
+                uint8_t in[8];
+                uint8_t slots[8];
+                for (int s = 0; s < 8; s++)
+                {
+                    int strip = g * 8 + s;
+                    in[s] = strip < numStrips ? strips[strip][led * 3 + channel[c]] : 0;
+                }
+                transposeLanes8(in, slots);
+                for (int k = 0; k < 8; k++)
+                {
+                    out[k] |= (Word)((Word)slots[k] << (g * 8));
+                }
+            }
+            out += 8;
+        }
+    }
+
+    // End frame: zeros (also what SK9822 expects)
+    memset(out, 0, apa102EndFrameBytes(numLeds) * 8 * sizeof(Word));
+}
+
+#endif // APA102PARALLEL_H
@@ -0,0 +1,185 @@
+/**
+ * @file Calibration.h
+ * @brief Per-strip white balance and per-LED intensity calibration
+ *
+ * Strips from different batches render the same color differently. Each
+ * strip gets an RGB gain and an overall intensity, and each LED an
+ * optional intensity trim. The three are folded into one 8-bit factor
+ * per LED and channel whenever a setting changes, so the output stage
+ * pays a single multiply-shift per channel and never touches floats.
+ *
+ * The table logic is header-only and Arduino-free for the native tests;
+ * NVS persistence and the serial CLI live in Calibration.cpp.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "FlickerMath.h"
+
+/**
+ * Scale a byte by an 8-bit factor, 255 = unity (255 * 255 -> 255)
+ */
+RENDER_INLINE uint8_t scaleByte(uint8_t value, uint8_t factor)
+{
+    return (uint8_t)(((uint16_t)value * ((uint16_t)factor + 1)) >> 8);
+}
+
+/**
+ * @struct StripCalibration
+ * @brief User-editable calibration for one strip (persisted to NVS)
+ *
+ * All values are 8-bit factors where 255 means unchanged.
+ */
+struct StripCalibration
+{
+    uint8_t gain[3];         // White balance: R, G, B
+    uint8_t intensity;       // Overall strip intensity
+    uint8_t led[LED_LENGTH]; // Per-LED intensity trim
+};
+
+/**
+ * @class CalibrationTable
+ * @brief Calibration settings plus the fused per-LED factors
+ */
+class CalibrationTable
+{
+public:
+    StripCalibration strips[NUM_STRIPS];
+
+    /**
+     * Fused factor per strip, LED and channel (R, G, B)
+     * Read by the output stage; rebuilt by rebuild()
+     */
+    uint8_t factor[NUM_STRIPS][LED_LENGTH][3];
+
+    CalibrationTable() { reset(); }
+
+    /**
+     * Restore unity calibration on every strip and LED
+     */
+    void reset()
+    {
+        memset(strips, 255, sizeof(strips));
+        rebuild();
+    }
+
+    /**
+     * Recompute the fused factors after any setting change
+     */
+    void rebuild()
+    {
+        for (int strip = 0; strip < NUM_STRIPS; strip++)
+        {
+            const StripCalibration &cal = strips[strip];
+            for (int i = 0; i < LED_LENGTH; i++)
+            {
+                uint8_t ledScale = scaleByte(cal.intensity, cal.led[i]);
+                for (int c = 0; c < 3; c++)
+                {
+                    factor[strip][i][c] = scaleByte(cal.gain[c], ledScale);
+                }
+            }
+        }
+    }
+
+    /**
+     * Set a strip's RGB white balance
+     *
+     * @return false if the strip index is out of range
+     */
+    bool setGain(int strip, uint8_t r, uint8_t g, uint8_t b)
+    {
+        if (strip < 0 || strip >= NUM_STRIPS)
+        {
+            return false;
+        }
+        strips[strip].gain[0] = r;
+        strips[strip].gain[1] = g;
+        strips[strip].gain[2] = b;
+        rebuild();
+        return true;
+    }
+
+    /**
+     * Set a strip's overall intensity
+     *
+     * @return false if the strip index is out of range
+     */
+    bool setIntensity(int strip, uint8_t intensity)
+    {
+        if (strip < 0 || strip >= NUM_STRIPS)
+        {
+            return false;
+        }
+        strips[strip].intensity = intensity;
+        rebuild();
+        return true;
+    }
+
+    /**
+     * Set one LED's intensity trim
+     *
+     * @return false if the strip or LED index is out of range
+     */
+    bool setLed(int strip, int led, uint8_t intensity)
+    {
+        if (strip < 0 || strip >= NUM_STRIPS || led < 0 || led >= LED_LENGTH)
+        {
+            return false;
+        }
+        strips[strip].led[led] = intensity;
+        rebuild();
+        return true;
+    }
+
+    /**
+     * Load from NVS (keeps unity calibration if nothing valid is stored)
+     */
+    void load();
+
+    /**
+     * Save the current settings to NVS
+     */
+    void save();
+
+    /**
+     * Handle the "@c" serial command
+     *
+     * @param args Command text after "@c"
+     */
+    void command(const char *args);
+
+    /**
+     * Print all settings to serial
+     */
+    void print();
+};
+
+#endif // CALIBRATION_H
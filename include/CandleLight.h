@@ -39,18 +39,38 @@
 
 // Project headers
 #include "config.h"
+#include "Calibration.h"
+#include "ControlServer.h"
+#include "Crossfade.h"
+#include "Effect.h"
+#include "EffectVM.h"
+#include "FlickerEngine.h"
+#include "FlickerSync.h"
+#include "FrameStats.h"
+#include "MqttBridge.h"
+#include "OverlayStack.h"
+#include "RealtimeReceiver.h"
+#include "RenderQuality.h"
+#include "SyncLink.h"
+
+#define PACER_TASK_STACK 2048
+#define PACER_TASK_PRIORITY 20 // Above lwIP and HomeSpan, below the WiFi driver
+#define PACER_CORE 0           // Away from loop() on core 1
 
 /**
  * @class DEV_CandleLight
  * @brief HomeKit LightBulb service with candle flicker effect
  *
  * Features:
- * - Dual synchronized APA102 LED strips
+ * - Dual synchronized LED strips (APA102, SK9822 or WS2812 per strip)
  * - Brightness control via LED count (0-100% → 0-8 LEDs)
  * - Fractional brightness on last LED for smooth transitions
  * - Exponential smoothing for natural flicker
  * - Manual power button with debouncing
  * - HomeKit HSV color control
+ * - Notification overlays (doorbell, timer, WiFi AP) over the flicker
+ * - Optional flicker sync with other lamps over UDP multicast
+ * - Frame pacer task that keeps the strips going while loop() is blocked
  */
 struct DEV_CandleLight : Service::LightBulb
 {
@@ -62,6 +82,7 @@ struct DEV_CandleLight : Service::LightBulb
     SpanCharacteristic *hue;          // Color hue (0-360°)
     SpanCharacteristic *saturation;   // Color saturation (0-100%)
     SpanCharacteristic *brightness;   // Brightness (0-100%)
+    SpanCharacteristic *notification; // Custom: write an OverlayId to show it
 
     // ========================================================================
     // BUTTON STATE MACHINE
@@ -95,10 +116,119 @@ struct DEV_CandleLight : Service::LightBulb
     // ========================================================================
 
     /**
-     * Previous brightness values for exponential smoothing
-     * Indexed as: previousBrightness[strip][led]
+     * Flicker synthesis and smoothing state (shared by both strips)
+     */
+    FlickerEngine flicker;
+
+    /**
+     * Flicker step clock: UPDATE_INTERVAL ticks, frame index and seed
+     * Follows the leader's beacons when syncing with other lamps
+     */
+    SyncClock syncClock;
+    SyncLink syncLink;              // Multicast beacons for syncClock
+
+    uint32_t lastOutputFrame;       // millis() of the last OUTPUT_INTERVAL frame
+
+    /**
+     * Characteristic values renderFrame() draws, copied by loop() each
+     * pass so the pacer never reads characteristics HomeSpan is changing
+     */
+    struct RenderInputs
+    {
+        bool on;
+        int hue;                    // 0-360
+        int saturation;             // 0-100
+        int brightness;             // 0-100
+    };
+    RenderInputs inputs;
+
+#if CONTROL_API_ENABLED || MQTT_ENABLED
+    /**
+     * Commands from the network tasks, applied in loop(); state back
+     */
+    ControlMailbox controlMailbox;
+#endif
+
+#if CONTROL_API_ENABLED
+    ControlServer control;          // Local HTTP/WebSocket API
+#endif
+
+#if MQTT_ENABLED
+    MqttBridge mqtt;                // MQTT state, metrics and commands
+    uint32_t lastMetrics;           // millis() of the last metrics snapshot
+#endif
+
+#if REALTIME_ENABLED
+    /**
+     * DDP / E1.31 input: while a stream is live its pixels go straight
+     * to the strips and the candle pauses
      */
-    float previousBrightness[NUM_STRIPS][LED_LENGTH];
+    RealtimeReceiver realtime;
+    bool realtimeActive;            // Stream owned the strips last loop
+#endif
+
+    /**
+     * Flicker steps being interpolated (shared by both strips)
+     * Output frames blend fromFrame -> toFrame over UPDATE_INTERVAL
+     */
+    CRGB fromFrame[LED_LENGTH];
+    CRGB toFrame[LED_LENGTH];
+
+    /**
+     * White balance and LED intensity calibration
+     * Applied in the same pass as interpolation, right before output
+     */
+    CalibrationTable calibration;
+
+    /**
+     * User effect program, replaces the candle flicker while loaded
+     * Run once per flicker step in renderFrame()
+     */
+    EffectVM effects;
+
+    /**
+     * Active notification overlays
+     * Blended over the candle in the same pass as interpolation
+     */
+    OverlayStack overlays;
+
+    /**
+     * Fade between the candle and another look
+     * Blended in the same pass as interpolation, under the overlays
+     */
+    Crossfade fade;
+    SolidEffect fadeBlack;          // Power off, and the dark end of Identify
+    FlashEffect identifyFlash;      // Identify flashes, shown through the fade
+    FrameEffect heldFrame;          // Last frame of a stream or program, faded into the new look
+    bool powerShown;                // Power state the last fade was started for
+
+    // ========================================================================
+    // WRITE-TO-FRAME FAST PATH
+    // ========================================================================
+
+    bool framePending;              // Out-of-cycle frame requested by a state change
+    uint32_t pendingSince;          // micros() when the pending change was accepted
+    FrameStats writeLatency;        // Accepted change -> first rendered frame (µs)
+
+    // ========================================================================
+    // FRAME TIMING
+    // ========================================================================
+
+    FrameStats frameTime;           // renderFrame() duration (µs)
+    FrameStats frameInterval;       // Time between flicker ticks (µs), shows stalls
+    uint32_t droppedFrames;         // Flicker steps lost to stalls plus output slots lost to overruns
+    uint32_t lastTickMicros;        // micros() of the previous flicker tick
+    RenderQuality quality;          // Deadline overruns and the quality level they force
+
+    // ========================================================================
+    // FRAME PACER
+    // ========================================================================
+
+    FrameGate outputGate;           // Held by whichever of loop() and the pacer is producing a frame
+    bool pacing;                    // Last output frame came from the pacer
+    uint32_t pacedFrames;           // Frames the pacer produced while loop() was blocked
+    FrameStats outputInterval;      // Time between output frames from either (µs)
+    uint32_t lastOutputMicros;      // micros() of the last output frame
 
     // ========================================================================
     // LED ARRAYS
@@ -118,9 +248,9 @@ struct DEV_CandleLight : Service::LightBulb
      *
      * Sets up:
      * - HomeKit characteristics with default values
-     * - FastLED for both APA102 strips
+     * - LED output layer for both strips
      * - Power button with internal pullup
-     * - Smoothing state arrays
+     * - Flicker step clock with a random session seed
      */
     DEV_CandleLight();
 
@@ -131,7 +261,8 @@ struct DEV_CandleLight : Service::LightBulb
     /**
      * Called when HomeKit characteristics are updated
      *
-     * Logs changes to serial monitor.
+     * Requests an immediate out-of-cycle frame, then logs changes to
+     * serial monitor.
      * @return true to indicate successful update
      */
     boolean update() override;
@@ -142,12 +273,124 @@ struct DEV_CandleLight : Service::LightBulb
      * Called continuously by HomeSpan.
      * Handles:
      * - Button polling and debouncing
-     * - Flicker animation updates
+     * - Out-of-cycle frames for pending state changes
+     * - Flicker animation updates (UPDATE_INTERVAL)
+     * - Interpolated output frames (OUTPUT_INTERVAL)
      * - LED brightness smoothing
-     * - FastLED output
+     * - LED output
      */
     void loop() override;
 
+    /**
+     * Print render performance counters to serial
+     *
+     * Reports write-to-frame latency, frame render time, the interval
+     * between flicker ticks and per-strip output cost.
+     * Bound to the HomeSpan "@p" user command in main.cpp.
+     */
+    void printStats();
+
+    /**
+     * Handle the "@p" serial command
+     *
+     * No arguments prints the counters (printStats()); "@p nvs [writes]"
+     * runs nvsWriteTest().
+     *
+     * @param args Command arguments after "@p"
+     */
+    void statsCommand(const char *args);
+
+    /**
+     * Measure output frame gaps across forced NVS writes
+     *
+     * Writes a scratch Preferences entry the given number of times with
+     * new content each time, blocking loop() as a real save does, then
+     * prints the output frame interval, flicker tick interval and paced
+     * frames seen meanwhile. Restarts those counters.
+     *
+     * @param writes Number of writes (1-100)
+     * @return Longest time without an output frame (µs)
+     */
+    uint32_t nvsWriteTest(int writes);
+
+    /**
+     * Produce a frame if loop() has fallen behind (frame pacer task)
+     *
+     * Called every OUTPUT_INTERVAL from a task on the other core. Once
+     * loop() is PACER_STALL_MS late, e.g. blocked in an NVS write, this
+     * steps the flicker and shows frames itself, crossfades and overlays
+     * included, until loop() produces one again. A mitigation for loop()
+     * stalls: like loop(), it runs from flash, between flash operations.
+     *
+     * @param now millis()
+     * @param nowMicros micros()
+     */
+    void paceFrame(uint32_t now, uint32_t nowMicros);
+
+    /**
+     * Show a built-in notification overlay
+     *
+     * @param id OverlayId to show; OVERLAY_NONE clears all overlays
+     */
+    void notify(uint8_t id);
+
+    /**
+     * Handle the "@o" serial command
+     *
+     * No arguments lists the notifications; "@o <name|number>" shows one,
+     * "@o clear" removes all.
+     *
+     * @param args Command arguments after "@o"
+     */
+    void overlayCommand(const char *args);
+
+    /**
+     * Reflect a HomeSpan status change on the strips
+     *
+     * Starts or clears the pairing, connecting and WiFi AP overlays.
+     * Bound via homeSpan.setStatusCallback() in main.cpp when
+     * STATUS_ON_STRIPS is set.
+     *
+     * @param status New HomeSpan status
+     */
+    void showStatus(HS_STATUS status);
+
+    /**
+     * Handle the "@s" serial command (multi-lamp sync)
+     *
+     * @param args Command arguments after "@s"
+     */
+    void syncCommand(const char *args);
+
+    /**
+     * Handle the "@v" serial command (effect programs)
+     *
+     * Crossfades when a program starts or stops running.
+     *
+     * @param args Command arguments after "@v"
+     */
+    void effectCommand(const char *args);
+
+    /**
+     * Handle the "@c" serial command (calibration)
+     *
+     * @param args Command arguments after "@c"
+     */
+    void calibrationCommand(const char *args);
+
+    /**
+     * Flash the strips for HomeKit Identify, then fade the candle back in
+     *
+     * Returns at once; the flashes run in loop() at the output rate.
+     */
+    void identify();
+
+    /**
+     * Fade the candle in from black instead of cutting back to it
+     * Used when something else has left the strips dark
+     */
+    void fadeFromBlack();
+
     // ========================================================================
     // PRIVATE METHODS
     // ========================================================================
@@ -167,26 +410,96 @@ private:
     void handlePowerButton();
 
     /**
-     * Apply candle flicker effect to active LEDs
+     * Request an out-of-cycle frame on the next loop() pass
      *
-     * @param fullLEDs Number of fully-lit LEDs
-     * @param fraction Fractional brightness for last LED (0.0-1.0)
-     * @param baseHue Base color hue from HomeKit
-     * @param baseSat Base color saturation from HomeKit
+     * Timestamps the first request so write-to-frame latency can be
+     * measured; further requests before the frame is rendered coalesce.
      */
-    void applyFlicker(int fullLEDs, float fraction, int baseHue, int baseSat);
+    void requestFrame();
 
+#if CONTROL_API_ENABLED || MQTT_ENABLED
     /**
-     * Calculate smoothed brightness using exponential moving average
+     * Apply a command from the local control API or MQTT
      *
-     * Formula: smoothed = (alpha × previous) + ((1-alpha) × target)
-     * Where alpha = FLICKER_SMOOTHING
+     * Same effect as a HomeKit write: values are set on the
+     * characteristics (so HomeKit controllers see them), logged and
+     * rendered with an out-of-cycle frame.
      *
-     * @param target Target brightness value
-     * @param previous Previous smoothed value
-     * @return Smoothed brightness value
+     * @param cmd Merged command from ControlServer::take()
      */
-    float calculateSmoothedBrightness(float target, float previous);
+    void applyControl(const ControlCommand &cmd);
+
+    /**
+     * Publish the current characteristic values to the network tasks
+     */
+    void publishControlState();
+#endif
+
+    /**
+     * Note an output frame: interval stats and who produced it
+     *
+     * @param now millis() of the frame
+     * @param nowMicros micros() of the frame
+     * @param paced true if the pacer produced it
+     */
+    void frameShown(uint32_t now, uint32_t nowMicros, bool paced);
+
+    /**
+     * Crossfade, overlays and interpolation for this instant, then show
+     *
+     * The output half of a frame, shared by loop() and the pacer.
+     *
+     * @param now millis() of this output frame
+     * @param paced true if the pacer produced it
+     */
+    void showFrame(uint32_t now, bool paced);
+
+    /**
+     * Synthesize the next flicker step into toFrame
+     *
+     * Shifts the previous target into fromFrame for interpolation. A
+     * pending state change snaps fromFrame to the new target instead so
+     * the change is visible in the very next output frame. Draws from
+     * inputs, not the characteristics, so the pacer can call it too.
+     *
+     * @param advanceFlicker true on UPDATE_INTERVAL ticks to step the
+     *        flicker animation; false for out-of-cycle frames, which
+     *        re-render the last flicker state so the timeline is unchanged
+     * @param now millis() of this frame
+     */
+    void renderFrame(bool advanceFlicker, uint32_t now);
+
+    /**
+     * Fill leds[][] with fromFrame -> toFrame interpolated for this instant
+     *
+     * Crossfade, overlays and calibration are fused into the same pass:
+     * one lerp while fading, one per active overlay and one
+     * multiply-shift per channel. Runs from IRAM (RENDER_HOT); 8-bit
+     * integer math only. fade.prepare() and overlays.prepare() must have
+     * run for this frame.
+     *
+     * @param now millis() of this output frame
+     */
+    void interpolateFrame(uint32_t now);
+
+    /**
+     * Apply candle flicker effect to active LEDs
+     *
+     * Runs FlickerEngine::render(), which writes flicker.flame[]. Runs
+     * from IRAM (RENDER_HOT); the engine is inlined into it and uses only
+     * FlickerMath.h helpers and FlickerTables.h tables.
+     *
+     * @param fullLEDs Number of fully-lit LEDs
+     * @param fraction Fractional brightness for last LED (0.0-1.0)
+     * @param baseHue Base color hue from HomeKit
+     * @param baseSat Base color saturation from HomeKit
+     * @param advance true to step the flicker, false to reuse the last step
+     * @param skipMask 0 to step every LED, 1 to step alternate LEDs
+     * @param phase Which LEDs a partial step covers (see FlickerEngine::render())
+     * @return Number of LEDs written to flicker.flame[]
+     */
+    int applyFlicker(int fullLEDs, float fraction, int baseHue, int baseSat, bool advance,
+                     uint32_t skipMask, uint32_t phase);
 };
 
 /**
@@ -198,11 +511,13 @@ private:
  * users identify which physical device corresponds to the HomeKit accessory
  * during pairing.
  *
- * Note: This service directly controls the LED hardware via the global
- * leds array to perform the identification flash sequence.
+ * The flashes are drawn by the candle's render loop (see
+ * DEV_CandleLight::identify()), so the request returns at once.
  */
 struct DEV_Identify : Service::AccessoryInformation
 {
+    DEV_CandleLight *candle;        // Shows the flashes, set once created
+
     /**
      * Constructor
      *
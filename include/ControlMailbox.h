@@ -0,0 +1,119 @@
+/**
+ * @file ControlMailbox.h
+ * @brief Hand-off between network tasks and the render loop
+ *
+ * The control API and MQTT bridge run on their own tasks and never touch
+ * the characteristics or render state. They post commands here; the
+ * render loop takes them once per loop() pass (latest value per field
+ * wins) and publishes the resulting state back. Each side holds the
+ * spinlock only for a struct copy.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONTROLMAILBOX_H
+#define CONTROLMAILBOX_H
+
+// Third-party libraries
+#include <Arduino.h>
+
+// Project headers
+#include "ControlProtocol.h"
+
+/**
+ * @class ControlMailbox
+ * @brief One pending command in, one published state out
+ */
+class ControlMailbox
+{
+public:
+    ControlMailbox() : state{false, 0, 0, 0}, version(0)
+    {
+        portMUX_INITIALIZE(&lock);
+    }
+
+    /**
+     * Queue a command (network task side), merged into any pending one
+     */
+    void post(const ControlCommand &cmd)
+    {
+        portENTER_CRITICAL(&lock);
+        pending.merge(cmd);
+        portEXIT_CRITICAL(&lock);
+    }
+
+    /**
+     * Take the pending command (render loop side)
+     *
+     * @return true if anything was posted since the last take
+     */
+    bool take(ControlCommand &cmd)
+    {
+        // Unlocked peek: a command landing right after is taken next pass
+        if (pending.fields == 0)
+        {
+            return false;
+        }
+        portENTER_CRITICAL(&lock);
+        cmd = pending;
+        pending = ControlCommand();
+        portEXIT_CRITICAL(&lock);
+        return true;
+    }
+
+    /**
+     * Publish the lamp state (render loop side)
+     */
+    void publishState(const ControlState &newState)
+    {
+        portENTER_CRITICAL(&lock);
+        state = newState;
+        version++;
+        portEXIT_CRITICAL(&lock);
+    }
+
+    /**
+     * Read the last published state (network task side)
+     *
+     * @param stateVersion Optional: incremented on every publishState()
+     */
+    ControlState readState(uint32_t *stateVersion = nullptr)
+    {
+        portENTER_CRITICAL(&lock);
+        ControlState snapshot = state;
+        if (stateVersion)
+        {
+            *stateVersion = version;
+        }
+        portEXIT_CRITICAL(&lock);
+        return snapshot;
+    }
+
+private:
+    portMUX_TYPE lock;
+    ControlCommand pending;
+    ControlState state;
+    uint32_t version;
+};
+
+#endif // CONTROLMAILBOX_H
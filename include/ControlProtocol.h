@@ -0,0 +1,519 @@
+/**
+ * @file ControlProtocol.h
+ * @brief JSON messages of the local HTTP/WebSocket control API
+ *
+ * A zero-copy reader for flat JSON objects (keys and values are slices
+ * of the request buffer, nothing is allocated or copied), the command
+ * and state messages built on it, and the latest-wins merge used by the
+ * mailbox between the server task and the render loop. Free of Arduino
+ * and ESP-IDF dependencies so it runs in the native unit tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONTROLPROTOCOL_H
+#define CONTROLPROTOCOL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "OverlayStack.h"
+
+// ============================================================================
+// JSON READER
+// ============================================================================
+
+/**
+ * Kind of a JSON value
+ */
+enum JsonType : uint8_t
+{
+    JSON_STRING, // Slice excludes the quotes; escapes are left as-is
+    JSON_NUMBER,
+    JSON_TRUE,
+    JSON_FALSE,
+    JSON_NULL,
+    JSON_NESTED // Object or array, skipped as a whole
+};
+
+/**
+ * @struct JsonSlice
+ * @brief A key or value pointing into the parsed buffer
+ */
+struct JsonSlice
+{
+    const char *p;
+    uint16_t len;
+    JsonType type;
+
+    bool equals(const char *s) const
+    {
+        return strlen(s) == len && memcmp(p, s, len) == 0;
+    }
+
+    /**
+     * Integer value of a number (fractions and exponents rejected)
+     */
+    bool toInt(int32_t &out) const
+    {
+        if (type != JSON_NUMBER)
+        {
+            return false;
+        }
+        uint16_t i = 0;
+        bool negative = p[0] == '-';
+        if (negative)
+        {
+            i++;
+        }
+        if (i == len)
+        {
+            return false;
+        }
+        int32_t value = 0;
+        for (; i < len; i++)
+        {
+            if (p[i] < '0' || p[i] > '9' || value > 100000000)
+            {
+                return false;
+            }
+            value = value * 10 + (p[i] - '0');
+        }
+        out = negative ? -value : value;
+        return true;
+    }
+};
+
+/**
+ * @class JsonObjectReader
+ * @brief Walks the members of one flat JSON object in place
+ *
+ * Usage: while (reader.next(key, value)) { ... } then check ok(), which
+ * is true only if the whole input was a single well-formed object.
+ */
+class JsonObjectReader
+{
+public:
+    JsonObjectReader(const char *json, size_t length)
+        : p(json), end(json + length), members(0), failed(false), done(false)
+    {
+        skipSpace();
+        if (p < end && *p == '{')
+        {
+            p++;
+        }
+        else
+        {
+            failed = true;
+        }
+    }
+
+    /**
+     * Next member of the object
+     *
+     * @return false at the end of the object or on malformed input
+     */
+    bool next(JsonSlice &key, JsonSlice &value)
+    {
+        if (failed || done)
+        {
+            return false;
+        }
+
+        skipSpace();
+        if (p < end && *p == '}' && members == 0)
+        {
+            return finish();
+        }
+        if (members > 0)
+        {
+            if (p < end && *p == '}')
+            {
+                return finish();
+            }
+            if (p >= end || *p != ',')
+            {
+                return fail();
+            }
+            p++;
+            skipSpace();
+        }
+
+        if (!readString(key))
+        {
+            return fail();
+        }
+        skipSpace();
+        if (p >= end || *p != ':')
+        {
+            return fail();
+        }
+        p++;
+        skipSpace();
+        if (!readValue(value))
+        {
+            return fail();
+        }
+        members++;
+        return true;
+    }
+
+    /**
+     * True once the closing brace was reached with nothing after it
+     */
+    bool ok() const
+    {
+        return done && !failed;
+    }
+
+private:
+    const char *p;
+    const char *end;
+    uint16_t members;
+    bool failed;
+    bool done;
+
+    bool fail()
+    {
+        failed = true;
+        return false;
+    }
+
+    bool finish()
+    {
+        p++;
+        skipSpace();
+        done = true;
+        failed = p != end;
+        return false;
+    }
+
+    void skipSpace()
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+        {
+            p++;
+        }
+    }
+
+    bool readString(JsonSlice &out)
+    {
+        if (p >= end || *p != '"')
+        {
+            return false;
+        }
+        const char *start = ++p;
+        while (p < end && *p != '"')
+        {
+            if (*p == '\\')
+            {
+                p++;
+            }
+            p++;
+        }
+        if (p >= end)
+        {
+            return false;
+        }
+        out.p = start;
+        out.len = p - start;
+        out.type = JSON_STRING;
+        p++;
+        return true;
+    }
+
+    bool readLiteral(const char *word, JsonType type, JsonSlice &out)
+    {
+        size_t n = strlen(word);
+        if ((size_t)(end - p) < n || memcmp(p, word, n) != 0)
+        {
+            return false;
+        }
+        out.p = p;
+        out.len = n;
+        out.type = type;
+        p += n;
+        return true;
+    }
+
+    bool readValue(JsonSlice &out)
+    {
+        if (p >= end)
+        {
+            return false;
+        }
+        switch (*p)
+        {
+        case '"':
+            return readString(out);
+        case 't':
+            return readLiteral("true", JSON_TRUE, out);
+        case 'f':
+            return readLiteral("false", JSON_FALSE, out);
+        case 'n':
+            return readLiteral("null", JSON_NULL, out);
+        case '{':
+        case '[':
+            return skipNested(out);
+        default:
+            break;
+        }
+
+        const char *start = p;
+        while (p < end && (*p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E' ||
+                           (*p >= '0' && *p <= '9')))
+        {
+            p++;
+        }
+        if (p == start)
+        {
+            return false;
+        }
+        out.p = start;
+        out.len = p - start;
+        out.type = JSON_NUMBER;
+        return true;
+    }
+
+    /**
+     * Skip a nested object or array, honouring strings
+     */
+    bool skipNested(JsonSlice &out)
+    {
+        const char *start = p;
+        int depth = 0;
+        do
+        {
+            if (*p == '"')
+            {
+                JsonSlice ignored;
+                if (!readString(ignored))
+                {
+                    return false;
+                }
+                continue;
+            }
+            if (*p == '{' || *p == '[')
+            {
+                depth++;
+            }
+            else if (*p == '}' || *p == ']')
+            {
+                depth--;
+            }
+            p++;
+        } while (depth > 0 && p < end);
+
+        if (depth != 0)
+        {
+            return false;
+        }
+        out.p = start;
+        out.len = p - start;
+        out.type = JSON_NESTED;
+        return true;
+    }
+};
+
+// ============================================================================
+// MESSAGES
+// ============================================================================
+
+/**
+ * Fields present in a ControlCommand
+ */
+enum ControlField : uint8_t
+{
+    CONTROL_POWER = 0x01,
+    CONTROL_HUE = 0x02,
+    CONTROL_SATURATION = 0x04,
+    CONTROL_BRIGHTNESS = 0x08,
+    CONTROL_NOTIFY = 0x10
+};
+
+/**
+ * @struct ControlCommand
+ * @brief A change request; only the fields flagged in `fields` apply
+ */
+struct ControlCommand
+{
+    uint8_t fields;
+    bool power;
+    uint16_t hue;       // 0-360
+    uint8_t saturation; // 0-100
+    uint8_t brightness; // 0-100
+    uint8_t notify;     // OverlayId, OVERLAY_NONE clears
+
+    ControlCommand() : fields(0), power(false), hue(0), saturation(0), brightness(0), notify(0) {}
+
+    /**
+     * Fold a newer command into this one; newer fields win
+     */
+    void merge(const ControlCommand &newer)
+    {
+        if (newer.fields & CONTROL_POWER)
+        {
+            power = newer.power;
+        }
+        if (newer.fields & CONTROL_HUE)
+        {
+            hue = newer.hue;
+        }
+        if (newer.fields & CONTROL_SATURATION)
+        {
+            saturation = newer.saturation;
+        }
+        if (newer.fields & CONTROL_BRIGHTNESS)
+        {
+            brightness = newer.brightness;
+        }
+        if (newer.fields & CONTROL_NOTIFY)
+        {
+            notify = newer.notify;
+        }
+        fields |= newer.fields;
+    }
+};
+
+/**
+ * @struct ControlState
+ * @brief The lamp state reported by GET /api/state
+ */
+struct ControlState
+{
+    bool power;
+    uint16_t hue;
+    uint8_t saturation;
+    uint8_t brightness;
+};
+
+/**
+ * Read an integer member within [lo, hi]
+ */
+static inline bool controlRange(const JsonSlice &value, int32_t lo, int32_t hi, int32_t &out)
+{
+    return value.toInt(out) && out >= lo && out <= hi;
+}
+
+/**
+ * Parse a command object, e.g. {"power":true,"brightness":40}
+ *
+ * Keys: power (bool), hue (0-360), saturation (0-100), brightness
+ * (0-100), notify (overlay name or number, "clear"). Unknown keys are
+ * ignored so clients can send a full state object back.
+ *
+ * @return false if the JSON is malformed or a value is out of range
+ */
+static inline bool parseControlCommand(const char *json, size_t length, ControlCommand &cmd)
+{
+    JsonObjectReader reader(json, length);
+    JsonSlice key, value;
+    int32_t n;
+
+    cmd = ControlCommand();
+    while (reader.next(key, value))
+    {
+        if (key.equals("power"))
+        {
+            if (value.type != JSON_TRUE && value.type != JSON_FALSE)
+            {
+                return false;
+            }
+            cmd.power = value.type == JSON_TRUE;
+            cmd.fields |= CONTROL_POWER;
+        }
+        else if (key.equals("hue"))
+        {
+            if (!controlRange(value, 0, 360, n))
+            {
+                return false;
+            }
+            cmd.hue = n;
+            cmd.fields |= CONTROL_HUE;
+        }
+        else if (key.equals("saturation"))
+        {
+            if (!controlRange(value, 0, 100, n))
+            {
+                return false;
+            }
+            cmd.saturation = n;
+            cmd.fields |= CONTROL_SATURATION;
+        }
+        else if (key.equals("brightness"))
+        {
+            if (!controlRange(value, 0, 100, n))
+            {
+                return false;
+            }
+            cmd.brightness = n;
+            cmd.fields |= CONTROL_BRIGHTNESS;
+        }
+        else if (key.equals("notify"))
+        {
+            // Preset names are short; copy to terminate for findPreset()
+            char name[16];
+            if (value.type == JSON_NUMBER)
+            {
+                if (!controlRange(value, 0, OVERLAY_PRESET_COUNT - 1, n))
+                {
+                    return false;
+                }
+                cmd.notify = n;
+            }
+            else if (value.type == JSON_STRING && value.len < sizeof(name))
+            {
+                memcpy(name, value.p, value.len);
+                name[value.len] = '\0';
+                cmd.notify = strcmp(name, "clear") == 0 ? (uint8_t)OVERLAY_NONE : OverlayStack::findPreset(name);
+                if (cmd.notify >= OVERLAY_PRESET_COUNT)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+            cmd.fields |= CONTROL_NOTIFY;
+        }
+    }
+    return reader.ok();
+}
+
+/**
+ * Write the state as a JSON object
+ *
+ * @return Length written (excluding the terminator), 0 if out is too small
+ */
+static inline size_t encodeControlState(const ControlState &state, char *out, size_t size)
+{
+    int n = snprintf(out, size, "{\"power\":%s,\"hue\":%u,\"saturation\":%u,\"brightness\":%u}",
+                     state.power ? "true" : "false", (unsigned)state.hue,
+                     (unsigned)state.saturation, (unsigned)state.brightness);
+    return n > 0 && (size_t)n < size ? (size_t)n : 0;
+}
+
+#endif // CONTROLPROTOCOL_H
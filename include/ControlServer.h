@@ -0,0 +1,119 @@
+/**
+ * @file ControlServer.h
+ * @brief Local HTTP/WebSocket control API
+ *
+ * Runs ESP-IDF's esp_http_server in its own task on core 0, away from
+ * the render loop on core 1. The server never touches the lamp state:
+ * parsed commands go into the ControlMailbox that DEV_CandleLight drains
+ * each loop() pass, and the loop publishes the state and LED previews
+ * back. Both directions are a short copy under a spinlock.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONTROLSERVER_H
+#define CONTROLSERVER_H
+
+// Third-party libraries
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Project headers
+#include "config.h"
+#include "ControlMailbox.h"
+#include "ControlProtocol.h"
+
+#if CONTROL_API_ENABLED
+
+#include <esp_http_server.h>
+
+/**
+ * @class ControlServer
+ * @brief HTTP/WebSocket endpoints feeding a ControlMailbox
+ *
+ * Endpoints:
+ * - GET  /api/state  current state as JSON
+ * - POST /api/state  JSON command (see parseControlCommand())
+ * - GET  /ws         WebSocket: JSON commands in, binary RGB previews out
+ */
+class ControlServer
+{
+public:
+    uint32_t requests;  // HTTP requests and WebSocket messages handled
+    uint32_t rejected;  // Malformed or oversized commands
+    uint32_t previews;  // Preview frames sent (per client)
+
+    /**
+     * @param mailbox Commands out, state in; shared with the render loop
+     */
+    explicit ControlServer(ControlMailbox &mailbox);
+
+    /**
+     * Start the server once WiFi is up; call every loop() pass
+     */
+    void poll();
+
+    /**
+     * Offer the frame just shown as a preview to WebSocket clients
+     *
+     * Returns at once unless a client is connected, CONTROL_PREVIEW_INTERVAL
+     * has passed and the previous preview has been sent. Sending happens
+     * on the server task.
+     *
+     * @param pixels LED arrays, leds[strip][i]
+     * @param now    Current time (ms)
+     */
+    void publishPreview(const CRGB pixels[][LED_LENGTH], uint32_t now);
+
+    /**
+     * Whether publishPreview() would send a preview now
+     */
+    bool previewDue(uint32_t now) const
+    {
+        return wsConnected && !previewBusy && now - lastPreview >= CONTROL_PREVIEW_INTERVAL;
+    }
+
+    /**
+     * Print request counters to serial
+     */
+    void printStats();
+
+private:
+    httpd_handle_t server;
+    ControlMailbox &mailbox;
+    portMUX_TYPE previewLock;        // Guards preview
+    uint8_t preview[NUM_STRIPS * LED_LENGTH * 3];
+    volatile bool previewBusy;       // Preview queued, not yet sent
+    volatile bool wsConnected;       // A WebSocket client was seen
+    uint32_t lastPreview;            // millis() of the last preview offered
+    char body[CONTROL_JSON_MAX + 1]; // Request buffer, server task only
+
+    static esp_err_t handleGetState(httpd_req_t *req);
+    static esp_err_t handlePostState(httpd_req_t *req);
+    static esp_err_t handleWebSocket(httpd_req_t *req);
+    static void sendPreview(void *arg);
+};
+
+#endif // CONTROL_API_ENABLED
+
+#endif // CONTROLSERVER_H
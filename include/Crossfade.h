@@ -0,0 +1,174 @@
+/**
+ * @file Crossfade.h
+ * @brief Crossfade between the candle and another look
+ *
+ * While a fade runs, the other Effect keeps rendering into a scratch
+ * buffer allocated up front, and the output pass blends it with the
+ * candle per LED by an 8-bit ramp (see crossfadePixel()). Header-only
+ * and free of Arduino dependencies so it runs in the native unit tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CROSSFADE_H
+#define CROSSFADE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "Effect.h"
+#include "FlickerMath.h"
+
+/**
+ * @class Crossfade
+ * @brief Mix of the candle (primary) and one other Effect over time
+ *
+ * A fade toward the other look holds it once complete, until the next
+ * begin() or release(); a fade back to the candle releases it.
+ */
+class Crossfade
+{
+public:
+    /**
+     * The other look for this frame, valid after prepare()
+     */
+    EffectPixel scratch[LED_LENGTH];
+
+    /**
+     * Weight of scratch for this frame, 0-256 for lerp8()
+     * Valid after prepare(); 0 whenever no fade is on screen
+     */
+    uint16_t t;
+
+    Crossfade() : t(0), other(nullptr), toOther(false), start(0), duration(0)
+    {
+        memset(scratch, 0, sizeof(scratch));
+    }
+
+    /**
+     * Start fading to or from another look
+     *
+     * Reversing a fade with the same effect picks up at the current mix,
+     * so a quick on-off-on doesn't jump. Any other fade in progress is
+     * replaced.
+     *
+     * @param effect     The other look; must outlive the fade
+     * @param towardOther true to fade the candle out to effect, false to
+     *                   fade from effect back to the candle
+     * @param now        millis()
+     * @param durationMs Length of a full fade, 0 to cut
+     */
+    void begin(Effect &effect, bool towardOther, uint32_t now, uint32_t durationMs)
+    {
+        uint16_t from = (other == &effect) ? weight(now) : (towardOther ? 0 : 256);
+        uint32_t covered = towardOther ? from : 256 - from;
+
+        other = &effect;
+        toOther = towardOther;
+        duration = durationMs;
+        start = now - (uint32_t)(((uint64_t)covered * durationMs) >> 8);
+    }
+
+    /**
+     * Drop the other look; the candle shows unblended
+     */
+    void release()
+    {
+        other = nullptr;
+        t = 0;
+    }
+
+    /**
+     * Render the other look and its weight for this frame
+     *
+     * @param now millis() of this output frame
+     * @return t
+     */
+    uint16_t prepare(uint32_t now)
+    {
+        t = weight(now);
+        if (other && t == 0 && !toOther && !ramping(now))
+        {
+            other = nullptr;
+        }
+        if (t)
+        {
+            other->render(scratch, now);
+        }
+        return t;
+    }
+
+    /**
+     * Weight of the other look at an instant, 0-256
+     */
+    uint16_t weight(uint32_t now) const
+    {
+        if (!other)
+        {
+            return 0;
+        }
+        uint32_t elapsed = now - start;
+        uint16_t ramp = elapsed >= duration ? 256 : (uint16_t)(((uint64_t)elapsed << 8) / duration);
+        return toOther ? ramp : 256 - ramp;
+    }
+
+    /**
+     * true while the mix is still changing
+     */
+    bool ramping(uint32_t now) const
+    {
+        return other && now - start < duration;
+    }
+
+    /**
+     * true while the candle is fading out (it must keep rendering)
+     */
+    bool fadingOut(uint32_t now) const
+    {
+        return toOther && ramping(now);
+    }
+
+    /**
+     * The other look, nullptr if none
+     */
+    const Effect *effect() const { return other; }
+
+private:
+    Effect *other;     // Other look, nullptr when the candle shows alone
+    bool toOther;      // Fading candle -> other (else other -> candle)
+    uint32_t start;    // millis() the ramp started
+    uint32_t duration; // Full ramp length (ms)
+};
+
+/**
+ * Blend one pixel toward the other look by the frame's fade weight
+ */
+RENDER_INLINE void crossfadePixel(uint8_t &r, uint8_t &g, uint8_t &b, const EffectPixel &other, uint16_t t)
+{
+    r = lerp8(r, other.r, t);
+    g = lerp8(g, other.g, t);
+    b = lerp8(b, other.b, t);
+}
+
+#endif // CROSSFADE_H
@@ -0,0 +1,83 @@
+/**
+ * @file Diagnostics.h
+ * @brief Custom HomeKit service exposing live performance counters
+ *
+ * Read-only characteristics for frame rate, worst frame time, dropped
+ * frames, free heap, uptime and reset reason, visible in Eve or any HAP
+ * browser. Sampled from the lamp's existing counters in the service's
+ * loop() every DIAGNOSTICS_INTERVAL; HomeSpan answers reads from the
+ * stored values, so a read never touches the render path.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+// Third-party libraries
+#include <Arduino.h>
+#include "HomeSpan.h"
+
+// Project headers
+#include "config.h"
+#include "CandleLight.h"
+#include "DiagnosticsStats.h"
+
+#if DIAGNOSTICS_ENABLED
+
+/**
+ * @class DEV_Diagnostics
+ * @brief Custom HAP service with the lamp's performance counters
+ *
+ * Add it to the lamp's accessory after DEV_CandleLight.
+ */
+struct DEV_Diagnostics : SpanService
+{
+    /**
+     * @param lamp Candle light service whose counters are reported
+     */
+    explicit DEV_Diagnostics(DEV_CandleLight &lamp);
+
+    /**
+     * Refresh the values every DIAGNOSTICS_INTERVAL
+     */
+    void loop() override;
+
+private:
+    DEV_CandleLight &lamp;
+    FrameRateMeter frameRate;
+    uint32_t lastRefresh;
+
+    SpanCharacteristic *frameRateChar;
+    SpanCharacteristic *worstFrameChar;
+    SpanCharacteristic *droppedFramesChar;
+    SpanCharacteristic *freeHeapChar;
+    SpanCharacteristic *uptimeChar;
+    SpanCharacteristic *resetReasonChar;
+
+    void refresh(uint32_t now);
+};
+
+#endif // DIAGNOSTICS_ENABLED
+
+#endif // DIAGNOSTICS_H
@@ -0,0 +1,98 @@
+/**
+ * @file DiagnosticsStats.h
+ * @brief Values behind the HomeKit diagnostics service
+ *
+ * Frame rate over a refresh window and reset reason names. Header-only
+ * and free of Arduino dependencies so it runs in the native unit tests;
+ * the HomeSpan service itself is in Diagnostics.h.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DIAGNOSTICSSTATS_H
+#define DIAGNOSTICSSTATS_H
+
+#include <stdint.h>
+
+/**
+ * @class FrameRateMeter
+ * @brief Frames per second between successive samples of a frame counter
+ */
+class FrameRateMeter
+{
+public:
+    FrameRateMeter() : lastCount(0), lastMs(0), primed(false) {}
+
+    /**
+     * Take a sample of the frame counter
+     *
+     * Both counters may wrap; only the differences are used.
+     *
+     * @param frames Frames rendered so far
+     * @param nowMs  millis() now
+     * @return Frames per second since the previous sample, rounded to
+     *         0.1 so an unchanged rate doesn't raise HomeKit events
+     *         (0 on the first sample or if no time has passed)
+     */
+    float update(uint32_t frames, uint32_t nowMs)
+    {
+        uint32_t count = frames - lastCount;
+        uint32_t elapsed = nowMs - lastMs;
+        bool valid = primed && elapsed > 0;
+        lastCount = frames;
+        lastMs = nowMs;
+        primed = true;
+        if (!valid)
+        {
+            return 0.0f;
+        }
+        uint32_t tenths = (uint32_t)(((uint64_t)count * 10000 + elapsed / 2) / elapsed);
+        return tenths / 10.0f;
+    }
+
+private:
+    uint32_t lastCount;
+    uint32_t lastMs;
+    bool primed;
+};
+
+/**
+ * Short name for an esp_reset_reason() value
+ *
+ * Numbering follows esp_reset_reason_t (ESP_RST_UNKNOWN = 0 ...
+ * ESP_RST_SDIO = 10), spelled out so this header builds off-target.
+ */
+static inline const char *resetReasonName(int reason)
+{
+    static const char *const names[] = {
+        "unknown", "power-on", "external", "software", "panic", "int-wdt",
+        "task-wdt", "wdt", "deep-sleep", "brownout", "sdio",
+    };
+    if (reason < 0 || reason >= (int)(sizeof(names) / sizeof(names[0])))
+    {
+        return "unknown";
+    }
+    return names[reason];
+}
+
+#endif // DIAGNOSTICSSTATS_H
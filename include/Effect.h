@@ -0,0 +1,200 @@
+/**
+ * @file Effect.h
+ * @brief Looks the candle can crossfade to and from
+ *
+ * An Effect renders one frame of a look into a caller-owned buffer, so
+ * a crossfade can keep it running alongside the candle. Timed looks
+ * step a Sequence (Sequence.h) once per rendered frame. Header-only and
+ * free of Arduino dependencies so it runs in the native unit tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EFFECT_H
+#define EFFECT_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "Sequence.h"
+
+/**
+ * @struct EffectPixel
+ * @brief One LED's color, same layout as FastLED's CRGB
+ */
+struct EffectPixel
+{
+    uint8_t r, g, b;
+};
+
+static_assert(sizeof(EffectPixel) == 3, "EffectPixel must match the CRGB layout");
+
+/**
+ * @class Effect
+ * @brief A look rendered one frame at a time
+ */
+class Effect
+{
+public:
+    virtual ~Effect() {}
+
+    /**
+     * Render the look as it is at this instant
+     *
+     * Called once per output frame while the effect is on screen; must
+     * not allocate.
+     *
+     * @param out LED_LENGTH pixels, uncalibrated (calibration is
+     *            applied to the blended result)
+     * @param now millis() of this output frame
+     */
+    virtual void render(EffectPixel *out, uint32_t now) = 0;
+};
+
+/**
+ * @class SolidEffect
+ * @brief Every LED one color, e.g. black to fade power on and off
+ */
+class SolidEffect : public Effect
+{
+public:
+    EffectPixel color;
+
+    SolidEffect(uint8_t r = 0, uint8_t g = 0, uint8_t b = 0)
+    {
+        color.r = r;
+        color.g = g;
+        color.b = b;
+    }
+
+    void render(EffectPixel *out, uint32_t) override
+    {
+        for (int i = 0; i < LED_LENGTH; i++)
+        {
+            out[i] = color;
+        }
+    }
+};
+
+/**
+ * @class FrameEffect
+ * @brief A held copy of one frame, e.g. the last frame of a stream
+ */
+class FrameEffect : public Effect
+{
+public:
+    EffectPixel frame[LED_LENGTH];
+
+    FrameEffect() { memset(frame, 0, sizeof(frame)); }
+
+    /**
+     * Take a copy of pixels in CRGB layout
+     *
+     * @param rgb LED_LENGTH packed RGB triples
+     */
+    void capture(const void *rgb)
+    {
+        memcpy(frame, rgb, sizeof(frame));
+    }
+
+    void render(EffectPixel *out, uint32_t) override
+    {
+        memcpy(out, frame, sizeof(frame));
+    }
+};
+
+/**
+ * @class FlashEffect
+ * @brief Every LED flashes one color a few times, then stays dark
+ *
+ * A timed sequence: each render() is one step of it, so it runs at the
+ * output frame rate while on screen and never blocks. Each flash fades
+ * up over rampMs (0 for a hard flash), holds for onMs and is dark for
+ * offMs.
+ */
+class FlashEffect : public Effect
+{
+public:
+    EffectPixel color;
+    uint8_t flashes;   // Flashes per start()
+    uint16_t rampMs;   // Fade-up at the start of each flash
+    uint16_t onMs;     // Full color after the fade-up
+    uint16_t offMs;    // Dark after each flash
+
+    FlashEffect(EffectPixel color, uint8_t flashes, uint16_t rampMs, uint16_t onMs, uint16_t offMs)
+        : color(color), flashes(flashes), rampMs(rampMs), onMs(onMs), offMs(offMs), count(0), level(0)
+    {
+    }
+
+    /**
+     * Run the flashes from the first one, starting with the next render()
+     */
+    void start(uint32_t now)
+    {
+        seq.restart(now);
+        level = 0;
+    }
+
+    /**
+     * true once the last flash is over (and before the first start())
+     */
+    bool done() const { return !seq.active; }
+
+    void render(EffectPixel *out, uint32_t now) override
+    {
+        step(now);
+        EffectPixel p;
+        p.r = (uint8_t)((color.r * level) >> 8);
+        p.g = (uint8_t)((color.g * level) >> 8);
+        p.b = (uint8_t)((color.b * level) >> 8);
+        for (int i = 0; i < LED_LENGTH; i++)
+        {
+            out[i] = p;
+        }
+    }
+
+private:
+    Sequence seq;
+    uint8_t count;  // Flashes shown so far
+    uint16_t level; // Brightness of color, 0-256
+
+    bool step(uint32_t now)
+    {
+        SEQ_BEGIN(seq);
+        for (count = 0; count < flashes; count++)
+        {
+            seq.startTimer(now);
+            while ((level = seq.ramp(now, rampMs)) < 256)
+            {
+                SEQ_YIELD(seq);
+            }
+            SEQ_SLEEP(seq, now, onMs);
+            level = 0;
+            SEQ_SLEEP(seq, now, offMs);
+        }
+        SEQ_END(seq);
+    }
+};
+
+#endif // EFFECT_H
@@ -0,0 +1,613 @@
+/**
+ * @file EffectVM.h
+ * @brief Bytecode interpreter for user effect programs
+ *
+ * A loaded program stands in for the candle flicker: it runs once per
+ * LED on every flicker step and sets that LED's color. Register-based,
+ * 32-bit integer and 8.8 fixed-point math, with sine, value noise,
+ * random and time inputs. Programs are checked once on load (opcodes,
+ * registers, jump targets), so the interpreter itself does no bounds
+ * checks; a per-step instruction budget stops runaway loops.
+ *
+ * The interpreter is header-only and free of Arduino dependencies so
+ * it runs in the native unit tests and benchmarks; NVS storage and the
+ * "@v" command are in EffectVM.cpp. scripts/fxasm.py assembles source
+ * into the upload commands and reads the instruction set from the
+ * VmOpcode comments below, so keep their "mnemonic operands" format.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EFFECTVM_H
+#define EFFECTVM_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "Effect.h"
+
+// ============================================================================
+// INSTRUCTION SET
+// ============================================================================
+
+/**
+ * Opcodes, one per 4-byte instruction: op, a, b, c
+ *
+ * a, b, c are register numbers (r0-r15). imm is a signed 16-bit value
+ * in bytes b, c (little-endian); imm8 is a signed byte in c. Jumps are
+ * relative to the next instruction, in instructions. Values in 8.8
+ * fixed point (256 = 1.0) are only a convention of fmul and noise.
+ */
+enum VmOpcode : uint8_t
+{
+    OP_END = 0, // end              : this LED is done
+    OP_LDI,     // ldi a, imm       : a = imm
+    OP_LDHI,    // ldhi a, imm      : a = (a & 0xFFFF) | imm << 16
+    OP_MOV,     // mov a, b         : a = b
+    OP_ADD,     // add a, b, c      : a = b + c
+    OP_ADDI,    // addi a, b, imm8  : a = b + imm8
+    OP_SUB,     // sub a, b, c      : a = b - c
+    OP_MUL,     // mul a, b, c      : a = b * c
+    OP_FMUL,    // fmul a, b, c     : a = b * c >> 8 (8.8 fixed point)
+    OP_DIV,     // div a, b, c      : a = b / c, 0 if c is 0
+    OP_MOD,     // mod a, b, c      : a = b % c, 0 if c is 0
+    OP_AND,     // and a, b, c      : a = b & c
+    OP_OR,      // or a, b, c       : a = b | c
+    OP_XOR,     // xor a, b, c      : a = b ^ c
+    OP_SHL,     // shl a, b, c      : a = b << (c & 31)
+    OP_SHR,     // shr a, b, c      : a = b >> (c & 31), sign-extending
+    OP_MIN,     // min a, b, c      : a = min(b, c)
+    OP_MAX,     // max a, b, c      : a = max(b, c)
+    OP_ABS,     // abs a, b         : a = |b|
+    OP_SIN,     // sin a, b         : a = 0-255 sine of b, 256 per turn
+    OP_NOISE,   // noise a, b, c    : a = 0-255 value noise at b (8.8), row c
+    OP_RAND,    // rand a, b        : a = random 0..b-1, same on synced lamps
+    OP_JMP,     // jmp label        : continue at label
+    OP_JZ,      // jz a, label      : if a == 0
+    OP_JNZ,     // jnz a, label     : if a != 0
+    OP_JLT,     // jlt a, b, label8 : if a < b
+    OP_RGB,     // rgb a, b, c      : LED color, each clamped to 0-255
+    OP_HSV,     // hsv a, b, c      : LED color from hue, sat, value 0-255
+    VM_OP_COUNT
+};
+
+#define VM_INSN_BYTES 4
+#define VM_REGISTERS 16
+
+/**
+ * Registers set before each LED runs; the rest start at 0 each step and
+ * keep their values from one LED to the next
+ */
+#define VM_REG_LED 0    // LED index, 0 = first
+#define VM_REG_COUNT 1  // LED_LENGTH
+#define VM_REG_TIME 2   // millis()
+#define VM_REG_FRAME 3  // Flicker step number, same on synced lamps
+#define VM_REG_HUE 4    // HomeKit hue 0-360
+#define VM_REG_SAT 5    // HomeKit saturation 0-100
+#define VM_REG_LEVEL 6  // HomeKit brightness 0-100
+
+/**
+ * Instruction bytes, for programs built in C++ (tests, benchmarks)
+ */
+#define VM_I(op, a, b, c) (uint8_t)(op), (uint8_t)(a), (uint8_t)(b), (uint8_t)(c)
+#define VM_IMM(op, a, imm) (uint8_t)(op), (uint8_t)(a), (uint8_t)((imm) & 0xFF), (uint8_t)(((imm) >> 8) & 0xFF)
+
+/**
+ * Which operand bytes name registers, and how the instruction jumps
+ */
+enum VmOperands : uint8_t
+{
+    VM_A = 1,
+    VM_B = 2,
+    VM_C = 4,
+    VM_JUMP16 = 8, // Offset in imm
+    VM_JUMP8 = 16  // Offset in imm8
+};
+
+static const uint8_t VM_OPERANDS[VM_OP_COUNT] = {
+    0,                      // end
+    VM_A,                   // ldi
+    VM_A,                   // ldhi
+    VM_A | VM_B,            // mov
+    VM_A | VM_B | VM_C,     // add
+    VM_A | VM_B,            // addi
+    VM_A | VM_B | VM_C,     // sub
+    VM_A | VM_B | VM_C,     // mul
+    VM_A | VM_B | VM_C,     // fmul
+    VM_A | VM_B | VM_C,     // div
+    VM_A | VM_B | VM_C,     // mod
+    VM_A | VM_B | VM_C,     // and
+    VM_A | VM_B | VM_C,     // or
+    VM_A | VM_B | VM_C,     // xor
+    VM_A | VM_B | VM_C,     // shl
+    VM_A | VM_B | VM_C,     // shr
+    VM_A | VM_B | VM_C,     // min
+    VM_A | VM_B | VM_C,     // max
+    VM_A | VM_B,            // abs
+    VM_A | VM_B,            // sin
+    VM_A | VM_B | VM_C,     // noise
+    VM_A | VM_B,            // rand
+    VM_JUMP16,              // jmp
+    VM_A | VM_JUMP16,       // jz
+    VM_A | VM_JUMP16,       // jnz
+    VM_A | VM_B | VM_JUMP8, // jlt
+    VM_A | VM_B | VM_C,     // rgb
+    VM_A | VM_B | VM_C,     // hsv
+};
+
+/**
+ * sin a, b: 127.5 + 127.5 sin(2 pi i / 256), rounded
+ */
+static const uint8_t VM_SIN8[256] = {
+    128, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+    176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+    218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+    245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+    245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+    218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+    176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+    128, 124, 121, 118, 115, 112, 109, 106, 103, 100, 97, 93, 90, 88, 85, 82,
+    79, 76, 73, 70, 67, 65, 62, 59, 57, 54, 52, 49, 47, 44, 42, 40,
+    37, 35, 33, 31, 29, 27, 25, 23, 21, 20, 18, 17, 15, 14, 12, 11,
+    10, 9, 7, 6, 5, 5, 4, 3, 2, 2, 1, 1, 1, 0, 0, 0,
+    0, 0, 0, 0, 1, 1, 1, 2, 2, 3, 4, 5, 5, 6, 7, 9,
+    10, 11, 12, 14, 15, 17, 18, 20, 21, 23, 25, 27, 29, 31, 33, 35,
+    37, 40, 42, 44, 47, 49, 52, 54, 57, 59, 62, 65, 67, 70, 73, 76,
+    79, 82, 85, 88, 90, 93, 97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+};
+
+// ============================================================================
+// BUILT-IN FUNCTIONS
+// ============================================================================
+
+/**
+ * Mix two integers into a well-spread byte (lattice values for noise)
+ */
+static inline uint8_t vmHash(int32_t x, int32_t y)
+{
+    uint32_t h = (uint32_t)x * 0x9E3779B1u ^ (uint32_t)y * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    h *= 0x297A2D39u;
+    h ^= h >> 15;
+    return (uint8_t)(h >> 24);
+}
+
+/**
+ * 1D value noise: random bytes on integer points of x (8.8), blended
+ * with a smoothstep in between; each row is an unrelated curve
+ */
+static inline uint8_t vmNoise(int32_t x, int32_t row)
+{
+    int32_t cell = x >> 8;
+    uint32_t f = (uint32_t)x & 0xFF;
+    uint32_t s = (f * f * (3 * 256 - 2 * f)) >> 16; // 0-255
+    int32_t v0 = vmHash(cell, row);
+    int32_t v1 = vmHash(cell + 1, row);
+    return (uint8_t)(v0 + (((v1 - v0) * (int32_t)s) >> 8));
+}
+
+/**
+ * Clamp to a color byte
+ */
+static inline uint8_t vmByte(int32_t v)
+{
+    return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+}
+
+/**
+ * HSV to RGB, all 0-255: six linear hue sectors, value and saturation
+ * applied as 8-bit scales
+ */
+static inline EffectPixel vmHsv(uint8_t h, uint8_t s, uint8_t v)
+{
+    uint8_t sector = (uint8_t)((h * 6) >> 8);        // 0-5
+    uint8_t ramp = (uint8_t)((h * 6) & 0xFF);        // Position in the sector
+    uint8_t low = (uint8_t)((v * (255 - s)) / 255);
+    uint8_t rise = (uint8_t)(low + ((v - low) * ramp) / 255);
+    uint8_t fall = (uint8_t)(v - ((v - low) * ramp) / 255);
+
+    EffectPixel p;
+    switch (sector)
+    {
+    case 0: p.r = v;    p.g = rise; p.b = low;  break;
+    case 1: p.r = fall; p.g = v;    p.b = low;  break;
+    case 2: p.r = low;  p.g = v;    p.b = rise; break;
+    case 3: p.r = low;  p.g = fall; p.b = v;    break;
+    case 4: p.r = rise; p.g = low;  p.b = v;    break;
+    default: p.r = v;   p.g = low;  p.b = fall; break;
+    }
+    return p;
+}
+
+// ============================================================================
+// INTERPRETER
+// ============================================================================
+
+/**
+ * @struct VmInputs
+ * @brief Values a program sees in its input registers for one step
+ */
+struct VmInputs
+{
+    uint32_t time;  // millis()
+    uint32_t frame; // Flicker step number
+    uint32_t seed;  // Generator seed for rand, same on synced lamps
+    int32_t hue;    // 0-360
+    int32_t sat;    // 0-100
+    int32_t level;  // 0-100
+};
+
+/**
+ * @class EffectVM
+ * @brief One loaded effect program and the interpreter that runs it
+ */
+class EffectVM
+{
+public:
+    uint8_t code[VM_MAX_CODE]; // Program, VM_INSN_BYTES per instruction
+    uint16_t length;           // Bytes in code
+    bool loaded;               // code has passed validate() and runs
+
+    uint32_t steps;     // Steps run since the program was loaded
+    uint32_t exhausted; // Steps cut short by VM_STEP_BUDGET
+    uint32_t lastUsed;  // Instructions the last step executed
+
+    EffectVM() { unload(); }
+
+    /**
+     * Check a program, returning nullptr if it is safe to run
+     *
+     * Every opcode and register must exist, every jump must land on an
+     * instruction, and the last instruction must be end or jmp so no
+     * LED runs off the end of the code.
+     *
+     * @param where Set to the failing instruction's index
+     * @return Reason for rejecting the program, nullptr if valid
+     */
+    static const char *validate(const uint8_t *program, size_t bytes, int *where)
+    {
+        *where = 0;
+        if (bytes == 0 || bytes % VM_INSN_BYTES != 0)
+        {
+            return "length is not a whole number of instructions";
+        }
+        if (bytes > VM_MAX_CODE)
+        {
+            return "longer than VM_MAX_CODE";
+        }
+
+        int count = (int)(bytes / VM_INSN_BYTES);
+        for (int n = 0; n < count; n++)
+        {
+            const uint8_t *insn = program + n * VM_INSN_BYTES;
+            *where = n;
+            if (insn[0] >= VM_OP_COUNT)
+            {
+                return "unknown opcode";
+            }
+            uint8_t operands = VM_OPERANDS[insn[0]];
+            if (((operands & VM_A) && insn[1] >= VM_REGISTERS) || ((operands & VM_B) && insn[2] >= VM_REGISTERS) ||
+                ((operands & VM_C) && insn[3] >= VM_REGISTERS))
+            {
+                return "register out of range";
+            }
+            if (operands & (VM_JUMP16 | VM_JUMP8))
+            {
+                int offset = (operands & VM_JUMP16) ? (int16_t)(insn[2] | insn[3] << 8) : (int8_t)insn[3];
+                int target = n + 1 + offset;
+                if (target < 0 || target >= count)
+                {
+                    return "jump outside the program";
+                }
+            }
+        }
+
+        uint8_t last = program[bytes - VM_INSN_BYTES];
+        if (last != OP_END && last != OP_JMP)
+        {
+            *where = count - 1;
+            return "program must end with end or jmp";
+        }
+        return nullptr;
+    }
+
+    /**
+     * Validate and install a program
+     *
+     * @return Reason it was rejected (nothing changes), nullptr if loaded
+     */
+    const char *install(const uint8_t *program, size_t bytes, int *where)
+    {
+        const char *error = validate(program, bytes, where);
+        if (error)
+        {
+            return error;
+        }
+        memmove(code, program, bytes);
+        length = (uint16_t)bytes;
+        loaded = true;
+        steps = 0;
+        exhausted = 0;
+        lastUsed = 0;
+        return nullptr;
+    }
+
+    /**
+     * Drop the program; the candle flicker takes over again
+     */
+    void unload()
+    {
+        memset(code, 0, sizeof(code));
+        length = 0;
+        loaded = false;
+        steps = 0;
+        exhausted = 0;
+        lastUsed = 0;
+    }
+
+    /**
+     * Load the saved program from NVS (the candle runs if none is saved)
+     */
+    void load();
+
+    /**
+     * Save the running program to NVS, or erase it if none is running
+     */
+    void save();
+
+    /**
+     * Handle the "@v" serial command
+     *
+     * @param args Command arguments after "@v"
+     * @return true if a program started or stopped running
+     */
+    bool command(const char *args);
+
+    /**
+     * Print the program's size and budget counters to serial
+     */
+    void print();
+
+    /**
+     * Run the program once for each LED
+     *
+     * With the step's budget spent, the LED being run and any after it
+     * are left as they were.
+     *
+     * @param out   count pixels
+     * @param count Number of LEDs
+     * @param in    Input register values for this step
+     * @return Number of LEDs written
+     */
+    int run(EffectPixel *out, int count, const VmInputs &in);
+};
+
+/*
+ * Dispatch: GCC's labels-as-values jump straight from each handler to
+ * the next one through a table, which the ESP32's branch-heavy core
+ * handles better than the bounds check and shared indirect jump of a
+ * switch. The switch is kept for other compilers.
+ */
+#if VM_COMPUTED_GOTO && defined(__GNUC__)
+#define VM_LABEL_DISPATCH 1
+#define VM_GOTO_OP() goto *VM_LABELS[ip[0]]
+#define VM_OP(name) L_##name
+#else
+#define VM_LABEL_DISPATCH 0
+#define VM_GOTO_OP() goto dispatch
+#define VM_OP(name) case name
+#endif
+
+// Every instruction spends one unit of the step's budget
+#define VM_DISPATCH()            \
+    do                           \
+    {                            \
+        if (--fuel < 0)          \
+        {                        \
+            goto exhaustedStep;  \
+        }                        \
+        VM_GOTO_OP();            \
+    } while (0)
+#define VM_NEXT()                \
+    do                           \
+    {                            \
+        ip += VM_INSN_BYTES;     \
+        VM_DISPATCH();           \
+    } while (0)
+#define VM_BRANCH(offset)                                  \
+    do                                                     \
+    {                                                      \
+        ip += VM_INSN_BYTES + (int32_t)(offset) * VM_INSN_BYTES; \
+        VM_DISPATCH();                                     \
+    } while (0)
+
+#define RA r[ip[1]]
+#define RB r[ip[2]]
+#define RC r[ip[3]]
+#define IMM16 ((int16_t)(ip[2] | ip[3] << 8))
+#define IMM8 ((int8_t)ip[3])
+
+inline int EffectVM::run(EffectPixel *out, int count, const VmInputs &in)
+{
+#if VM_LABEL_DISPATCH
+    static const void *const VM_LABELS[VM_OP_COUNT] = {
+        &&L_OP_END, &&L_OP_LDI, &&L_OP_LDHI, &&L_OP_MOV, &&L_OP_ADD, &&L_OP_ADDI, &&L_OP_SUB,
+        &&L_OP_MUL, &&L_OP_FMUL, &&L_OP_DIV, &&L_OP_MOD, &&L_OP_AND, &&L_OP_OR, &&L_OP_XOR,
+        &&L_OP_SHL, &&L_OP_SHR, &&L_OP_MIN, &&L_OP_MAX, &&L_OP_ABS, &&L_OP_SIN, &&L_OP_NOISE,
+        &&L_OP_RAND, &&L_OP_JMP, &&L_OP_JZ, &&L_OP_JNZ, &&L_OP_JLT, &&L_OP_RGB, &&L_OP_HSV};
+#endif
+
+    int32_t r[VM_REGISTERS];
+    memset(r, 0, sizeof(r));
+    uint32_t rng = in.seed ? in.seed : 1;
+    int32_t fuel = VM_STEP_BUDGET;
+    int led = 0;
+    EffectPixel color;
+    const uint8_t *ip;
+
+    steps++;
+    for (; led < count; led++)
+    {
+        r[VM_REG_LED] = led;
+        r[VM_REG_COUNT] = count;
+        r[VM_REG_TIME] = (int32_t)in.time;
+        r[VM_REG_FRAME] = (int32_t)in.frame;
+        r[VM_REG_HUE] = in.hue;
+        r[VM_REG_SAT] = in.sat;
+        r[VM_REG_LEVEL] = in.level;
+        color.r = color.g = color.b = 0;
+        ip = code;
+        VM_DISPATCH();
+
+#if !VM_LABEL_DISPATCH
+    dispatch:
+        switch (ip[0])
+#endif
+        {
+        VM_OP(OP_END):
+            out[led] = color;
+            continue;
+        VM_OP(OP_LDI):
+            RA = IMM16;
+            VM_NEXT();
+        VM_OP(OP_LDHI):
+            RA = (int32_t)(((uint32_t)RA & 0xFFFFu) | ((uint32_t)(uint16_t)IMM16 << 16));
+            VM_NEXT();
+        VM_OP(OP_MOV):
+            RA = RB;
+            VM_NEXT();
+        VM_OP(OP_ADD):
+            RA = (int32_t)((uint32_t)RB + (uint32_t)RC);
+            VM_NEXT();
+        VM_OP(OP_ADDI):
+            RA = (int32_t)((uint32_t)RB + (uint32_t)(int32_t)IMM8);
+            VM_NEXT();
+        VM_OP(OP_SUB):
+            RA = (int32_t)((uint32_t)RB - (uint32_t)RC);
+            VM_NEXT();
+        VM_OP(OP_MUL):
+            RA = (int32_t)((uint32_t)RB * (uint32_t)RC);
+            VM_NEXT();
+        VM_OP(OP_FMUL):
+            RA = (int32_t)(((int64_t)RB * RC) >> 8);
+            VM_NEXT();
+        VM_OP(OP_DIV):
+            // INT32_MIN / -1 overflows; -1 is a plain negation
+            RA = RC == 0 ? 0 : (RC == -1 ? (int32_t)(0u - (uint32_t)RB) : RB / RC);
+            VM_NEXT();
+        VM_OP(OP_MOD):
+            RA = (RC == 0 || RC == -1) ? 0 : RB % RC;
+            VM_NEXT();
+        VM_OP(OP_AND):
+            RA = RB & RC;
+            VM_NEXT();
+        VM_OP(OP_OR):
+            RA = RB | RC;
+            VM_NEXT();
+        VM_OP(OP_XOR):
+            RA = RB ^ RC;
+            VM_NEXT();
+        VM_OP(OP_SHL):
+            RA = (int32_t)((uint32_t)RB << (RC & 31));
+            VM_NEXT();
+        VM_OP(OP_SHR):
+            RA = RB >> (RC & 31);
+            VM_NEXT();
+        VM_OP(OP_MIN):
+            RA = RB < RC ? RB : RC;
+            VM_NEXT();
+        VM_OP(OP_MAX):
+            RA = RB > RC ? RB : RC;
+            VM_NEXT();
+        VM_OP(OP_ABS):
+            RA = RB < 0 ? (int32_t)(0u - (uint32_t)RB) : RB;
+            VM_NEXT();
+        VM_OP(OP_SIN):
+            RA = VM_SIN8[RB & 0xFF];
+            VM_NEXT();
+        VM_OP(OP_NOISE):
+            RA = vmNoise(RB, RC);
+            VM_NEXT();
+        VM_OP(OP_RAND):
+            // xorshift32, reseeded every step
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            RA = RB > 0 ? (int32_t)(((uint64_t)rng * (uint32_t)RB) >> 32) : 0;
+            VM_NEXT();
+        VM_OP(OP_JMP):
+            VM_BRANCH(IMM16);
+        VM_OP(OP_JZ):
+            if (RA == 0)
+            {
+                VM_BRANCH(IMM16);
+            }
+            VM_NEXT();
+        VM_OP(OP_JNZ):
+            if (RA != 0)
+            {
+                VM_BRANCH(IMM16);
+            }
+            VM_NEXT();
+        VM_OP(OP_JLT):
+            if (RA < RB)
+            {
+                VM_BRANCH(IMM8);
+            }
+            VM_NEXT();
+        VM_OP(OP_RGB):
+            color.r = vmByte(RA);
+            color.g = vmByte(RB);
+            color.b = vmByte(RC);
+            VM_NEXT();
+        VM_OP(OP_HSV):
+            color = vmHsv(vmByte(RA), vmByte(RB), vmByte(RC));
+            VM_NEXT();
+        }
+    }
+    lastUsed = VM_STEP_BUDGET - fuel;
+    return count;
+
+exhaustedStep:
+    exhausted++;
+    lastUsed = VM_STEP_BUDGET;
+    return led;
+}
+
+#undef VM_LABEL_DISPATCH
+#undef VM_GOTO_OP
+#undef VM_OP
+#undef VM_DISPATCH
+#undef VM_NEXT
+#undef VM_BRANCH
+#undef RA
+#undef RB
+#undef RC
+#undef IMM16
+#undef IMM8
+
+#endif // EFFECTVM_H
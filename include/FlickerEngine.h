@@ -0,0 +1,207 @@
+/**
+ * @file FlickerEngine.h
+ * @brief Candle flicker synthesis, independent of HomeKit and FastLED
+ *
+ * Holds the per-LED smoothing state and produces one flicker step of
+ * flame colors at a time. DEV_CandleLight drives it on the lamp; the
+ * host simulator in sim/ drives the very same code, which is what lets
+ * several simulated lamps be checked for identical output.
+ *
+ * Everything here is forced inline so that, on the ESP32, it compiles
+ * into DEV_CandleLight::applyFlicker() in IRAM (see FlickerMath.h).
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FLICKERENGINE_H
+#define FLICKERENGINE_H
+
+#include <stdint.h>
+
+#include "config.h"
+#include "FlickerMath.h"
+#include "FlickerTables.h"
+
+/**
+ * @struct FlameColor
+ * @brief One LED's flame color, FastLED HSV scale (0-255 per channel)
+ */
+struct FlameColor
+{
+    uint8_t h, s, v;
+};
+
+/**
+ * @class FlickerEngine
+ * @brief Smoothed random flicker over one strip's worth of LEDs
+ *
+ * Both strips show the same flame, so one engine serves the lamp.
+ */
+class FlickerEngine
+{
+public:
+    /**
+     * Previous brightness per LED, for exponential smoothing
+     */
+    float previousBrightness[LED_LENGTH];
+
+    /**
+     * Hue offset chosen on the last flicker step for each LED
+     * Reused by out-of-cycle frames so they don't advance the flicker
+     */
+    int previousHueOffset[LED_LENGTH];
+
+    /**
+     * Flicker variation source (flash-safe)
+     * Reseeded per step by the caller for reproducible flicker
+     */
+    FlickerRandom rng;
+
+    /**
+     * Flame colors produced by the last render() call
+     */
+    FlameColor flame[LED_LENGTH];
+
+    FlickerEngine() { reset(); }
+
+    /**
+     * Return smoothing state to the midpoint of the flicker range
+     * This prevents large jumps on the first animation frame
+     */
+    void reset()
+    {
+        for (int i = 0; i < LED_LENGTH; i++)
+        {
+            previousBrightness[i] = (FLICKER_BRIGHTNESS_MIN + FLICKER_BRIGHTNESS_MAX) / 2.0f;
+            previousHueOffset[i] = 0;
+            flame[i].h = flame[i].s = flame[i].v = 0;
+        }
+    }
+
+    /**
+     * Apply candle flicker to the lit LEDs, writing flame[]
+     *
+     * Uses FlickerMath.h helpers and FlickerTables.h tables only, with
+     * float (not double) arithmetic, so nothing leaves for flash.
+     *
+     * @param fullLEDs Number of fully-lit LEDs
+     * @param fraction Fractional brightness for last LED (0.0-1.0)
+     * @param baseHue Base color hue from HomeKit (0-360)
+     * @param baseSat Base color saturation from HomeKit (0-100)
+     * @param advance true to step the flicker, false to reuse the last step
+     * @param skipMask 0 steps every LED; 1 steps only alternate LEDs,
+     *        halving the random draws (the rest keep their last step)
+     * @param phase Partial steps cover the LEDs where ((i + phase) &
+     *        skipMask) == 0, so alternating it covers every LED in turn
+     * @return Number of LEDs written to flame[]
+     */
+    RENDER_INLINE int render(int fullLEDs, float fraction, int baseHue, int baseSat, bool advance,
+                             uint32_t skipMask = 0, uint32_t phase = 0)
+    {
+        uint8_t finalSaturation = SATURATION_LUT[clampInt(baseSat, 0, 100)];
+        int hueIndexBase = clampInt(baseHue, 0, 360) - FLICKER_HUE_MIN;
+
+        // Apply flicker to fully-lit LEDs
+        for (int i = 0; i < fullLEDs; i++)
+        {
+            float smoothedBrightness = step(i, advance && ((i + phase) & skipMask) == 0);
+
+            // Convert to FastLED HSV scale (0-255), hue wrap is in the table
+            flame[i].h = FLICKER_HUE_LUT[hueIndexBase + previousHueOffset[i]];
+            flame[i].s = finalSaturation;
+            flame[i].v = FLICKER_VALUE_LUT[clampInt((int)smoothedBrightness, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX) - FLICKER_BRIGHTNESS_MIN];
+        }
+
+        // Handle fractional LED (if any)
+        if (fraction > 0.01f && fullLEDs < LED_LENGTH)
+        {
+            float smoothedBrightness = step(fullLEDs, advance && ((fullLEDs + phase) & skipMask) == 0);
+
+            // Scale by fractional amount
+            int scaledBrightness = (int)(smoothedBrightness * fraction);
+            flame[fullLEDs].h = FLICKER_HUE_LUT[hueIndexBase + previousHueOffset[fullLEDs]];
+            flame[fullLEDs].s = finalSaturation;
+            flame[fullLEDs].v = FLICKER_VALUE_LUT[clampInt(scaledBrightness, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX) - FLICKER_BRIGHTNESS_MIN];
+            return fullLEDs + 1;
+        }
+
+        return fullLEDs;
+    }
+
+    /**
+     * Calculate smoothed brightness using exponential moving average
+     *
+     * Formula: smoothed = (alpha × previous) + ((1-alpha) × target)
+     * Where alpha = FLICKER_SMOOTHING
+     */
+    static RENDER_INLINE float smooth(float target, float previous)
+    {
+        return ((float)FLICKER_SMOOTHING * previous) + ((1.0f - (float)FLICKER_SMOOTHING) * target);
+    }
+
+    /**
+     * Rebuild smoothing state by replaying the steps before a frame
+     *
+     * After jumping to another lamp's clock, or skipping steps while
+     * dark or stalled, the smoothing history differs from a lamp that
+     * rendered every step. Replaying the preceding steps from their seeds
+     * brings it within (FLICKER_SMOOTHING ^ steps) of theirs, so output
+     * matches from the next step instead of fading in over a second.
+     *
+     * @param seed  Session seed (see frameSeed())
+     * @param frame First frame that will be rendered normally
+     * @param steps Number of preceding steps to replay
+     */
+    void warmUp(uint32_t seed, uint32_t frame, int steps)
+    {
+        for (int k = steps; k > 0; k--)
+        {
+            rng.seed(frameSeed(seed, frame - k));
+            for (int i = 0; i < LED_LENGTH; i++)
+            {
+                step(i, true);
+            }
+        }
+    }
+
+private:
+    /**
+     * Brightness of one LED for this frame, stepping it if advance is set
+     */
+    RENDER_INLINE float step(int i, bool advance)
+    {
+        if (advance)
+        {
+            // Random target brightness, smoothed toward
+            float targetBrightness = 100.0f + rng.range(FLICKER_VARIATION_MIN, FLICKER_VARIATION_MAX);
+            targetBrightness = clampFloat(targetBrightness, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX);
+            previousBrightness[i] = smooth(targetBrightness, previousBrightness[i]);
+
+            // Hue variation (toward yellow/orange)
+            previousHueOffset[i] = rng.range(FLICKER_HUE_MIN, FLICKER_HUE_MAX);
+        }
+        return previousBrightness[i];
+    }
+};
+
+#endif // FLICKERENGINE_H
@@ -0,0 +1,221 @@
+/**
+ * @file FlickerMath.h
+ * @brief Inline helpers for the per-frame render hot path
+ *
+ * The flicker synthesis runs from IRAM on the ESP32 so it keeps working
+ * while the flash cache is disabled (NVS writes, pairing storage, OTA).
+ * Anything it calls must therefore also avoid flash: Arduino's random()
+ * and map() live in flash, as do the soft-double helpers in libgcc. This
+ * header provides forced-inline replacements that compile straight into
+ * the calling function.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FLICKERMATH_H
+#define FLICKERMATH_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_attr.h>
+#endif
+
+// ============================================================================
+// PLACEMENT ATTRIBUTES
+// ============================================================================
+
+/**
+ * RENDER_HOT marks functions on the per-frame render path, RENDER_DATA
+ * marks tables they read. Both resolve to IRAM/DRAM placement on the
+ * ESP32 when RENDER_IN_IRAM is set, and to nothing elsewhere.
+ *
+ * scripts/check_iram.py verifies after each build that RENDER_HOT code
+ * makes no direct calls into flash.
+ */
+#if defined(ARDUINO_ARCH_ESP32) && RENDER_IN_IRAM
+#define RENDER_HOT IRAM_ATTR
+#define RENDER_DATA DRAM_ATTR
+#else
+#define RENDER_HOT
+#define RENDER_DATA
+#endif
+
+#define RENDER_INLINE inline __attribute__((always_inline))
+
+// ============================================================================
+// RANDOM NUMBER GENERATOR
+// ============================================================================
+
+/**
+ * @struct FlickerRandom
+ * @brief xorshift32 generator for flicker variation
+ *
+ * Replaces Arduino random() on the hot path. Its state lives in the
+ * owning object (DRAM), so it is safe with the flash cache disabled.
+ */
+struct FlickerRandom
+{
+    uint32_t state;
+
+    FlickerRandom() : state(0x9E3779B9u) {}
+
+    /**
+     * Seed the generator (zero is remapped, xorshift never leaves it)
+     *
+     * @param seed Seed value, e.g. from esp_random()
+     */
+    void seed(uint32_t seed)
+    {
+        state = seed ? seed : 0x9E3779B9u;
+    }
+
+    /**
+     * Next raw 32-bit value
+     */
+    RENDER_INLINE uint32_t next()
+    {
+        uint32_t x = state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state = x;
+        return x;
+    }
+
+    /**
+     * Uniform value in [min, max), same contract as Arduino random(min, max)
+     */
+    RENDER_INLINE int32_t range(int32_t min, int32_t max)
+    {
+        if (max <= min)
+        {
+            return min;
+        }
+        return min + (int32_t)(next() % (uint32_t)(max - min));
+    }
+};
+
+/**
+ * Generator seed for one flicker step
+ *
+ * murmur3 finalizer over (seed, frame): neighbouring frames get
+ * unrelated seeds, and the result depends on nothing but its inputs.
+ */
+RENDER_INLINE uint32_t frameSeed(uint32_t seed, uint32_t frame)
+{
+    uint32_t x = seed ^ (frame * 0x9E3779B9u);
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+// ============================================================================
+// INTEGER HELPERS
+// ============================================================================
+
+/**
+ * Linear range mapping, same formula as Arduino map()
+ * constexpr so FlickerTables.h can build lookup tables at compile time
+ */
+RENDER_INLINE constexpr int32_t scaleRange(int32_t x, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+/**
+ * Clamp an integer to [lo, hi]
+ */
+RENDER_INLINE constexpr int32_t clampInt(int32_t x, int32_t lo, int32_t hi)
+{
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+/**
+ * Linear interpolation between two bytes, t in 0-256 (256 = b exactly)
+ */
+RENDER_INLINE uint8_t lerp8(uint8_t a, uint8_t b, uint16_t t)
+{
+    return (uint8_t)(a + ((((int32_t)b - (int32_t)a) * (int32_t)t) >> 8));
+}
+
+/**
+ * Clamp a float to [lo, hi]
+ */
+RENDER_INLINE float clampFloat(float x, float lo, float hi)
+{
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+// ============================================================================
+// FRAME GATE
+// ============================================================================
+
+/**
+ * @struct FrameGate
+ * @brief Lets one of two cores at a time render and show a frame
+ *
+ * The render loop and the frame pacer task share the frame buffers and
+ * the LED driver. A compare-and-set flag rather than a FreeRTOS mutex,
+ * so the pacer can skip a slot instead of waiting and the same code runs
+ * in the host simulations.
+ */
+struct FrameGate
+{
+    uint32_t held; // 1 while a frame is being produced
+
+    FrameGate() : held(0) {}
+
+    /**
+     * Take the gate if it is free
+     *
+     * @return true if taken; release() it when the frame is out
+     */
+    RENDER_INLINE bool tryAcquire()
+    {
+        uint32_t expected = 0;
+        return __atomic_compare_exchange_n(&held, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+
+    /**
+     * Take the gate, spinning while the other core finishes its frame
+     */
+    RENDER_INLINE void acquire()
+    {
+        while (!tryAcquire())
+        {
+        }
+    }
+
+    RENDER_INLINE void release()
+    {
+        __atomic_store_n(&held, 0, __ATOMIC_RELEASE);
+    }
+};
+
+#endif // FLICKERMATH_H
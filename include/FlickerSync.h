@@ -0,0 +1,321 @@
+/**
+ * @file FlickerSync.h
+ * @brief Multi-lamp flicker synchronization: beacon format and clock
+ *
+ * Lamps flicker as one fire by computing the same flicker locally rather
+ * than exchanging frames. Every flicker step reseeds the generator from
+ * (session seed, frame index), so two lamps with the same seed, frame
+ * index and step phase produce the same random targets. A leader
+ * multicasts those three values in a 20-byte beacon; followers adopt
+ * the seed and pull their step clock onto the leader's.
+ *
+ * Transport lives in SyncLink (ESP32) and sim/sync_sim.cpp (host); this
+ * header is Arduino-free so both, and the native tests, share it.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FLICKERSYNC_H
+#define FLICKERSYNC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "FlickerMath.h"
+
+// ============================================================================
+// BEACON FORMAT
+// ============================================================================
+
+/**
+ * Wire layout, little-endian:
+ *   0  magic "ALSY"     4
+ *   4  version          1
+ *   5  group            1
+ *   6  interval (ms)    2   leader's UPDATE_INTERVAL, must match
+ *   8  seed             4
+ *  12  frame index      4
+ *  16  phase (ms)       2   time since the leader's last flicker step
+ *  18  reserved         2
+ */
+#define SYNC_MAGIC 0x59534C41u // "ALSY" little-endian
+#define SYNC_VERSION 1
+#define SYNC_PACKET_SIZE 20
+
+/**
+ * Most steps replayed by FlickerEngine::warmUp() to catch up
+ * FLICKER_SMOOTHING ^ 64 is about 1e-8 at the default 0.75, below float
+ * resolution, so replayed and lived-through histories come out equal
+ */
+#define SYNC_WARMUP_STEPS 64
+
+/**
+ * @struct SyncPacket
+ * @brief Decoded leader beacon
+ */
+struct SyncPacket
+{
+    uint8_t group;
+    uint16_t intervalMs;
+    uint32_t seed;
+    uint32_t frame;
+    uint16_t phaseMs;
+};
+
+static inline void syncPut16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static inline void syncPut32(uint8_t *p, uint32_t v)
+{
+    syncPut16(p, v & 0xFFFF);
+    syncPut16(p + 2, v >> 16);
+}
+
+static inline uint16_t syncGet16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t syncGet32(const uint8_t *p)
+{
+    return syncGet16(p) | ((uint32_t)syncGet16(p + 2) << 16);
+}
+
+/**
+ * Serialize a beacon
+ *
+ * @param packet Beacon to send
+ * @param out    Buffer of at least SYNC_PACKET_SIZE bytes
+ * @return Number of bytes written
+ */
+static inline size_t encodeSyncPacket(const SyncPacket &packet, uint8_t *out)
+{
+    syncPut32(out, SYNC_MAGIC);
+    out[4] = SYNC_VERSION;
+    out[5] = packet.group;
+    syncPut16(out + 6, packet.intervalMs);
+    syncPut32(out + 8, packet.seed);
+    syncPut32(out + 12, packet.frame);
+    syncPut16(out + 16, packet.phaseMs);
+    syncPut16(out + 18, 0);
+    return SYNC_PACKET_SIZE;
+}
+
+/**
+ * Parse a beacon, rejecting anything that is not one
+ *
+ * @return true if data holds a valid beacon of this version
+ */
+static inline bool decodeSyncPacket(const uint8_t *data, size_t length, SyncPacket &packet)
+{
+    if (length < SYNC_PACKET_SIZE || syncGet32(data) != SYNC_MAGIC || data[4] != SYNC_VERSION)
+    {
+        return false;
+    }
+    packet.group = data[5];
+    packet.intervalMs = syncGet16(data + 6);
+    packet.seed = syncGet32(data + 8);
+    packet.frame = syncGet32(data + 12);
+    packet.phaseMs = syncGet16(data + 16);
+    return true;
+}
+
+// ============================================================================
+// SYNC CLOCK
+// ============================================================================
+
+/**
+ * @class SyncClock
+ * @brief Flicker step clock that can follow a leader's beacons
+ *
+ * Steps land on a fixed UPDATE_INTERVAL grid from lastStep; a stall
+ * skips frames rather than bunching them, so the frame index keeps
+ * tracking wall time and stays comparable between lamps.
+ */
+class SyncClock
+{
+public:
+    uint32_t seed;        // Session seed, the leader's when following
+    uint32_t frame;       // Index of the current flicker step
+    uint32_t lastStep;    // Time of the current step (ms)
+    int32_t frameOffset;  // Frames to run ahead of the leader
+    uint32_t lastBeacon;  // Time the last beacon was accepted (ms)
+    uint32_t resyncs;     // Hard jumps (first lock, lost sync)
+    bool locked;          // At least one beacon accepted
+
+    SyncClock() : seed(0), frame(0), lastStep(0), frameOffset(SYNC_FRAME_OFFSET),
+                  lastBeacon(0), resyncs(0), locked(false), renderedFrame(0), jumped(true) {}
+
+    /**
+     * Start free-running with a local seed
+     */
+    void begin(uint32_t localSeed, uint32_t now)
+    {
+        seed = localSeed;
+        frame = 0;
+        lastStep = now;
+        locked = false;
+        jumped = true;
+    }
+
+    /**
+     * Advance the step clock
+     *
+     * @param now Current time (ms)
+     * @return true if a new flicker step is due
+     */
+    bool tick(uint32_t now)
+    {
+        uint32_t elapsed = now - lastStep;
+        if (elapsed < UPDATE_INTERVAL)
+        {
+            return false;
+        }
+        uint32_t steps = elapsed / UPDATE_INTERVAL;
+        frame += steps;
+        lastStep += steps * UPDATE_INTERVAL;
+        return true;
+    }
+
+    /**
+     * Generator seed for the current step
+     */
+    uint32_t stepSeed() const
+    {
+        return frameSeed(seed, frame + frameOffset);
+    }
+
+    /**
+     * Steps to replay before rendering the current one
+     *
+     * The flicker only matches another lamp's if it went through the
+     * same steps. This counts the ones this lamp did not render: frames
+     * skipped by a stall or while it was dark, or a full history after
+     * boot or a jump onto the leader's clock. Marks the current step as
+     * rendered; pass the result to FlickerEngine::warmUp().
+     *
+     * @return Preceding steps to replay (0 to SYNC_WARMUP_STEPS)
+     */
+    int catchUpSteps()
+    {
+        if (frame == renderedFrame && !jumped)
+        {
+            return 0;
+        }
+        uint32_t missed = frame - renderedFrame - 1;
+        if (jumped || missed > SYNC_WARMUP_STEPS)
+        {
+            missed = SYNC_WARMUP_STEPS;
+        }
+        jumped = false;
+        renderedFrame = frame;
+        return (int)missed;
+    }
+
+    /**
+     * Beacon describing this clock (leader side)
+     */
+    SyncPacket beacon(uint8_t group, uint32_t now) const
+    {
+        SyncPacket packet;
+        packet.group = group;
+        packet.intervalMs = UPDATE_INTERVAL;
+        packet.seed = seed;
+        packet.frame = frame;
+        uint32_t phase = now - lastStep;
+        packet.phaseMs = phase > 0xFFFF ? 0xFFFF : phase;
+        return packet;
+    }
+
+    /**
+     * Align to a leader's beacon (follower side)
+     *
+     * Small phase errors are halved on each beacon so the step grid
+     * never jumps visibly; a different seed, a frame mismatch or a
+     * large error snaps straight to the leader. Network transit time
+     * (~1 ms on a LAN) is not compensated.
+     *
+     * @param packet Received beacon
+     * @param group  This lamp's group
+     * @param now    Receive time (ms)
+     * @return true if the beacon was accepted
+     */
+    bool follow(const SyncPacket &packet, uint8_t group, uint32_t now)
+    {
+        if (packet.group != group || packet.intervalMs != UPDATE_INTERVAL)
+        {
+            return false;
+        }
+
+        // Leader's step and phase right now
+        uint32_t leaderFrame = packet.frame + packet.phaseMs / UPDATE_INTERVAL;
+        uint32_t leaderPhase = packet.phaseMs % UPDATE_INTERVAL;
+
+        // How far the leader is ahead of us (ms), valid if frames are close
+        int32_t frameDiff = (int32_t)(leaderFrame - frame);
+        int32_t error = frameDiff * UPDATE_INTERVAL + (int32_t)leaderPhase - (int32_t)(now - lastStep);
+
+        if (locked && packet.seed == seed && frameDiff >= -1 && frameDiff <= 1 &&
+            error >= -SYNC_SLEW_LIMIT && error <= SYNC_SLEW_LIMIT)
+        {
+            // Slew: moving lastStep back makes the next step come sooner.
+            // Never past now, which would look like a huge stall to tick().
+            int32_t adjust = error / 2;
+            if (adjust < 0 && (uint32_t)(-adjust) > now - lastStep)
+            {
+                adjust = -(int32_t)(now - lastStep);
+            }
+            lastStep -= adjust;
+        }
+        else
+        {
+            seed = packet.seed;
+            frame = leaderFrame;
+            lastStep = now - leaderPhase;
+            resyncs++;
+            jumped = true;
+        }
+
+        locked = true;
+        lastBeacon = now;
+        return true;
+    }
+
+    /**
+     * True while beacons keep arriving
+     */
+    bool inSync(uint32_t now) const
+    {
+        return locked && now - lastBeacon < SYNC_TIMEOUT;
+    }
+
+private:
+    uint32_t renderedFrame; // Last step the flicker engine rendered
+    bool jumped;            // Clock moved to an unrelated frame/seed
+};
+
+#endif // FLICKERSYNC_H
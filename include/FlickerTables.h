@@ -0,0 +1,190 @@
+/**
+ * @file FlickerTables.h
+ * @brief Compile-time lookup tables for the flicker renderer
+ *
+ * Every table here is generated by the compiler from the config.h
+ * constants, so nothing is computed in setup() or the DEV_CandleLight
+ * constructor. The generator is plain C++11 (index-list pack expansion
+ * over a constexpr function) so it builds with both the ESP32 toolchain
+ * and the native test environment.
+ *
+ * Tables are RENDER_DATA: in DRAM when the render hot path runs from
+ * IRAM (it must read them with the flash cache disabled), otherwise
+ * const data in flash. Either way they are initialized from the image,
+ * not at runtime.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FLICKERTABLES_H
+#define FLICKERTABLES_H
+
+#include <stdint.h>
+
+#include "config.h"
+#include "FlickerMath.h"
+
+// ============================================================================
+// TABLE GENERATOR
+// ============================================================================
+
+/**
+ * @struct Lut
+ * @brief Fixed-size byte table usable in constant expressions
+ */
+template <int N>
+struct Lut
+{
+    uint8_t v[N];
+
+    static constexpr int size = N;
+
+    RENDER_INLINE constexpr uint8_t operator[](int i) const { return v[i]; }
+};
+
+/**
+ * Compile-time integer sequence 0..N-1 (std::index_sequence is C++14)
+ */
+template <int... Is>
+struct IndexList {};
+
+template <int N, int... Is>
+struct MakeIndexList : MakeIndexList<N - 1, N - 1, Is...> {};
+
+template <int... Is>
+struct MakeIndexList<0, Is...>
+{
+    typedef IndexList<Is...> type;
+};
+
+/**
+ * Expand Gen::value(i) for every index into a Lut
+ *
+ * @tparam Gen Type with `static constexpr uint8_t value(int i)`
+ */
+template <typename Gen, int... Is>
+constexpr Lut<sizeof...(Is)> buildLut(IndexList<Is...>)
+{
+    return Lut<sizeof...(Is)>{{Gen::value(Is)...}};
+}
+
+template <typename Gen, int N>
+constexpr Lut<N> makeLut()
+{
+    return buildLut<Gen>(typename MakeIndexList<N>::type());
+}
+
+/**
+ * True if t[i-1] <= t[i] for every i (used by static_assert below)
+ */
+template <int N>
+constexpr bool lutIsMonotonic(const Lut<N> &t, int i = 1)
+{
+    return i >= N ? true : (t.v[i - 1] <= t.v[i] && lutIsMonotonic(t, i + 1));
+}
+
+// ============================================================================
+// TABLE DEFINITIONS
+// ============================================================================
+
+/**
+ * Flickered hue (degrees) -> FastLED hue byte, wrap included
+ *
+ * Index is (baseHue + hueOffset - FLICKER_HUE_MIN), where baseHue is the
+ * HomeKit hue 0-360 and hueOffset is in [FLICKER_HUE_MIN, FLICKER_HUE_MAX).
+ * Folding the 0-360 wrap into the table removes two modulos per LED.
+ */
+#define FLICKER_HUE_LUT_SIZE (360 + FLICKER_HUE_MAX - FLICKER_HUE_MIN)
+
+struct FlickerHueGen
+{
+    static constexpr uint8_t value(int i)
+    {
+        return (uint8_t)scaleRange((((i + FLICKER_HUE_MIN) % 360) + 360) % 360, 0, 360, 0, 255);
+    }
+};
+
+/**
+ * HomeKit saturation (0-100%) -> FastLED saturation byte
+ */
+#define SATURATION_LUT_SIZE 101
+
+struct SaturationGen
+{
+    static constexpr uint8_t value(int i)
+    {
+        return (uint8_t)scaleRange(i, 0, 100, 0, 255);
+    }
+};
+
+/**
+ * Smoothed flicker brightness -> FastLED value byte
+ *
+ * Index is (brightness - FLICKER_BRIGHTNESS_MIN), brightness clamped to
+ * [FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX].
+ */
+#define FLICKER_VALUE_LUT_SIZE (FLICKER_BRIGHTNESS_MAX - FLICKER_BRIGHTNESS_MIN + 1)
+
+struct FlickerValueGen
+{
+    static constexpr uint8_t value(int i)
+    {
+        return (uint8_t)scaleRange(i + FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX, 0, 255);
+    }
+};
+
+RENDER_DATA static constexpr Lut<FLICKER_HUE_LUT_SIZE> FLICKER_HUE_LUT =
+    makeLut<FlickerHueGen, FLICKER_HUE_LUT_SIZE>();
+
+RENDER_DATA static constexpr Lut<SATURATION_LUT_SIZE> SATURATION_LUT =
+    makeLut<SaturationGen, SATURATION_LUT_SIZE>();
+
+RENDER_DATA static constexpr Lut<FLICKER_VALUE_LUT_SIZE> FLICKER_VALUE_LUT =
+    makeLut<FlickerValueGen, FLICKER_VALUE_LUT_SIZE>();
+
+// ============================================================================
+// SANITY CHECKS
+// ============================================================================
+
+static_assert(FLICKER_HUE_MIN <= 0 && FLICKER_HUE_MAX >= 0,
+              "FLICKER_HUE_MIN/MAX must bracket zero");
+static_assert(FLICKER_HUE_LUT[-FLICKER_HUE_MIN] == 0,
+              "Unshifted hue 0 must map to hue byte 0");
+static_assert(FLICKER_HUE_LUT[360 - FLICKER_HUE_MIN] == 0,
+              "Hue 360 must wrap to hue byte 0");
+static_assert(FLICKER_HUE_LUT[0] == FLICKER_HUE_LUT[360],
+              "Negative hue offsets must wrap below 0 degrees");
+
+static_assert(SATURATION_LUT[0] == 0 && SATURATION_LUT[100] == 255,
+              "Saturation table must span 0-255");
+static_assert(lutIsMonotonic(SATURATION_LUT),
+              "Saturation table must be monotonic");
+
+static_assert(FLICKER_BRIGHTNESS_MIN < FLICKER_BRIGHTNESS_MAX,
+              "FLICKER_BRIGHTNESS_MIN must be below FLICKER_BRIGHTNESS_MAX");
+static_assert(FLICKER_VALUE_LUT[0] == 0 && FLICKER_VALUE_LUT[FLICKER_VALUE_LUT_SIZE - 1] == 255,
+              "Flicker value table must span 0-255");
+static_assert(lutIsMonotonic(FLICKER_VALUE_LUT),
+              "Flicker value table must be monotonic");
+
+#endif // FLICKERTABLES_H
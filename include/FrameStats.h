@@ -0,0 +1,91 @@
+/**
+ * @file FrameStats.h
+ * @brief Lightweight timing counters for the render path
+ *
+ * Accumulates count, last, worst and mean of a stream of microsecond
+ * samples. Used to track write-to-frame latency and frame timing in the
+ * field without pulling in any heavyweight profiling.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#include <stdint.h>
+
+/**
+ * @struct FrameStats
+ * @brief Running statistics over microsecond timing samples
+ *
+ * Deliberately header-only and free of Arduino dependencies so the same
+ * code runs in the native unit tests.
+ */
+struct FrameStats
+{
+    uint32_t count; // Number of samples recorded
+    uint32_t last;  // Most recent sample (µs)
+    uint32_t worst; // Largest sample seen (µs)
+    uint64_t total; // Sum of all samples (µs), for the mean
+
+    FrameStats() { reset(); }
+
+    /**
+     * Record one timing sample
+     *
+     * @param us Sample duration in microseconds
+     */
+    void record(uint32_t us)
+    {
+        count++;
+        last = us;
+        total += us;
+        if (us > worst)
+        {
+            worst = us;
+        }
+    }
+
+    /**
+     * Mean of all recorded samples
+     *
+     * @return Average duration in microseconds (0 if no samples)
+     */
+    uint32_t average() const
+    {
+        return count ? (uint32_t)(total / count) : 0;
+    }
+
+    /**
+     * Clear all counters
+     */
+    void reset()
+    {
+        count = 0;
+        last = 0;
+        worst = 0;
+        total = 0;
+    }
+};
+
+#endif // FRAMESTATS_H
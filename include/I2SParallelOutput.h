@@ -0,0 +1,104 @@
+/**
+ * @file I2SParallelOutput.h
+ * @brief I2S-parallel APA102 output driver for the ESP32
+ *
+ * Drives up to 16 APA102 strips at once from a single DMA buffer using
+ * the I2S peripheral in LCD (i80) mode: one data lane per strip plus a
+ * shared clock. Selected with LED_OUTPUT = LED_OUTPUT_I2S_PARALLEL.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef I2SPARALLELOUTPUT_H
+#define I2SPARALLELOUTPUT_H
+
+// Third-party libraries
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Project headers
+#include "config.h"
+
+#if LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
+
+#include <esp_lcd_panel_io.h>
+
+#include "Apa102Parallel.h"
+
+/**
+ * @class I2SParallelOutput
+ * @brief Clocks all strips simultaneously from one DMA transfer
+ *
+ * Each show() transposes leds[strip][i] into the bit-parallel buffer and
+ * queues it; the DMA engine does the rest while the render loop carries
+ * on. A frame is dropped (and counted) if the previous one is still on
+ * the wire, so show() never blocks.
+ */
+class I2SParallelOutput
+{
+public:
+    /**
+     * Lane word size: 8 lanes fit a byte, up to 16 need a halfword
+     */
+    typedef ParallelWord<(NUM_STRIPS > 8)>::type Word;
+
+    static const int LANES = sizeof(Word) * 8;
+    static const int FRAME_WORDS = apa102FrameBytes(LED_LENGTH) * 8;
+
+    I2SParallelOutput();
+
+    /**
+     * Set up the I2S bus, GPIOs and DMA buffer
+     *
+     * @param dataPins One data GPIO per strip (NUM_STRIPS entries)
+     * @param clockPin Shared clock GPIO
+     * @param clockHz  Bit clock frequency
+     * @return true on success
+     */
+    bool begin(const int *dataPins, int clockPin, uint32_t clockHz);
+
+    /**
+     * Encode and send one frame for all strips
+     *
+     * @param leds LED arrays, leds[strip][i]
+     * @return false if the frame was dropped (previous transfer busy)
+     */
+    bool show(CRGB leds[][LED_LENGTH]);
+
+    uint32_t droppedFrames() const { return dropped; }
+
+private:
+    static bool onTransferDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *event, void *ctx);
+
+    esp_lcd_i80_bus_handle_t bus;
+    esp_lcd_panel_io_handle_t io;
+    Word *dmaBuffer;           // FRAME_WORDS words, DMA-capable
+    volatile bool busy;        // Transfer in flight
+    uint32_t dropped;          // Frames skipped because busy
+};
+
+static_assert(NUM_STRIPS <= 16, "I2S parallel output supports at most 16 strips");
+
+#endif // LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
+
+#endif // I2SPARALLELOUTPUT_H
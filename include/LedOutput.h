@@ -0,0 +1,125 @@
+/**
+ * @file LedOutput.h
+ * @brief Single output interface for all LED strips and chipsets
+ *
+ * Hides which chipset each strip uses (STRIPn_CHIPSET in config.h) and
+ * which driver sends the frame (LED_OUTPUT). The render code fills the
+ * leds arrays and calls show(); nothing else in the firmware names a
+ * chipset or color order.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LEDOUTPUT_H
+#define LEDOUTPUT_H
+
+// Third-party libraries
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Project headers
+#include "config.h"
+#include "FrameStats.h"
+#include "I2SParallelOutput.h"
+#include "RmtOutput.h"
+#include "SpiDirectOutput.h"
+
+/**
+ * @class LedOutput
+ * @brief Sends leds[strip][i] to the strips with per-strip chipsets
+ *
+ * With LED_OUTPUT_FASTLED each strip gets the driver for its chipset:
+ * the FastLED controller for APA102/SK9822 (clocked SPI-style), an
+ * RmtOutput channel for WS2812. FastLED's own clockless driver waits in
+ * showPixels() for the previous frame to leave, so WS2812 goes through
+ * RmtOutput instead, which encodes into a second buffer and drops the
+ * frame if the channel is still busy. Each strip's output call is timed
+ * separately so the cost per chipset can be compared.
+ *
+ * With LED_OUTPUT_SPI_DIRECT the render pass writes frame(strip), which
+ * is already in APA102 wire format, and showRendered() only queues it.
+ * show() still works from the leds arrays (packing them first) for the
+ * paths that draw there: real-time input, Identify, startup.
+ */
+class LedOutput
+{
+public:
+    LedOutput();
+
+    /**
+     * Register every strip with its driver and clear the strips
+     *
+     * @param leds LED arrays, leds[strip][i]
+     */
+    void begin(CRGB leds[][LED_LENGTH]);
+
+    /**
+     * Send the current contents of the leds arrays to all strips
+     */
+    void show();
+
+    /**
+     * Send the frame the render pass just wrote: frame(strip) with
+     * LED_OUTPUT_SPI_DIRECT, the leds arrays otherwise (same as show())
+     */
+    void showRendered();
+
+#if LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+    /**
+     * Wire-format frame the render pass writes for a strip
+     */
+    RENDER_INLINE SpiDirectOutput::Frame &frame(int strip) { return spi.frame(strip); }
+
+    /**
+     * Copy the last frame sent back into CRGB arrays (previews)
+     */
+    void unpack(CRGB out[][LED_LENGTH]) const;
+#endif
+
+    /**
+     * Print per-strip output cost to serial
+     */
+    void printStats();
+
+    /**
+     * Human-readable chipset name
+     */
+    static const char *chipsetName(int chipset);
+
+private:
+    CRGB (*leds)[LED_LENGTH];
+
+#if LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
+    I2SParallelOutput i2s;
+    FrameStats outputTime;             // One transfer covers every strip
+#elif LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+    SpiDirectOutput spi;
+    FrameStats outputTime;             // Queueing every strip's transfer
+#else
+    CLEDController *controllers[NUM_STRIPS]; // Null for WS2812 strips
+    RmtOutput rmt;                           // WS2812 strips
+    FrameStats outputTime[NUM_STRIPS];       // Per strip, so per chipset
+#endif
+};
+
+#endif // LEDOUTPUT_H
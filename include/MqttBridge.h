@@ -0,0 +1,101 @@
+/**
+ * @file MqttBridge.h
+ * @brief MQTT state/metrics publisher and command subscriber
+ *
+ * Runs MqttClient on its own low-priority FreeRTOS task, so a slow or
+ * unreachable broker only ever blocks that task. Commands on
+ * <prefix>/set go into the ControlMailbox like control API requests;
+ * state changes are batched for MQTT_PUBLISH_INTERVAL and published as
+ * one retained message.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MQTTBRIDGE_H
+#define MQTTBRIDGE_H
+
+// Third-party libraries
+#include <Arduino.h>
+
+// Project headers
+#include "config.h"
+#include "ControlMailbox.h"
+#include "MqttClient.h"
+#include "MqttProtocol.h"
+
+#if MQTT_ENABLED
+
+#define MQTT_TASK_STACK 4096
+#define MQTT_TASK_PRIORITY 1 // Below HomeSpan/loop() work, above idle
+#define MQTT_POLL_MS 50      // Longest wait for broker data per pass
+
+/**
+ * @class MqttBridge
+ * @brief Background task linking the lamp to an MQTT broker
+ */
+class MqttBridge
+{
+public:
+    /**
+     * @param mailbox Commands out, state in; shared with the render loop
+     */
+    explicit MqttBridge(ControlMailbox &mailbox);
+
+    /**
+     * Start the background task (waits for WiFi by itself)
+     */
+    void begin();
+
+    /**
+     * Hand over a metrics snapshot (render loop side, a struct copy)
+     */
+    void publishMetrics(const LampMetrics &metrics);
+
+    /**
+     * Print connection and batching counters to serial
+     */
+    void printStats();
+
+private:
+    ControlMailbox &mailbox;
+    MqttClient client;
+    PublishBatcher stateBatch;
+    uint32_t stateVersion;   // Last mailbox state version seen
+    bool announced;          // Status and state sent on this connection
+    portMUX_TYPE metricsLock;
+    LampMetrics metrics;
+    volatile bool metricsFresh;
+    uint32_t rejected;       // Malformed commands on <prefix>/set
+
+    char clientId[32];
+
+    static void taskEntry(void *arg);
+    void run();
+    void publishState(uint32_t now);
+    static void onMessage(void *context, const char *topic, size_t topicLength,
+                          const uint8_t *payload, size_t length);
+};
+
+#endif // MQTT_ENABLED
+
+#endif // MQTTBRIDGE_H
@@ -0,0 +1,130 @@
+/**
+ * @file MqttClient.h
+ * @brief Minimal blocking-socket MQTT session for a background task
+ *
+ * Owns one TCP connection to the broker: connects (and reconnects after
+ * MQTT_RECONNECT_DELAY), subscribes, keeps the session alive with
+ * pings and hands received PUBLISH packets to a callback. Uses only BSD
+ * sockets (lwIP on the ESP32, POSIX on the host), so the host simulator
+ * runs the exact same session code against a local broker.
+ *
+ * Every call may block for up to the poll timeout or the socket timeout;
+ * run it on its own task, never from the render loop.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MQTTCLIENT_H
+#define MQTTCLIENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "MqttProtocol.h"
+
+/**
+ * @class MqttClient
+ * @brief One broker connection with reconnect, keep-alive and subscribe
+ */
+class MqttClient
+{
+public:
+    /**
+     * Called for each message on the subscribed topic
+     */
+    typedef void (*MessageHandler)(void *context, const char *topic, size_t topicLength,
+                                   const uint8_t *payload, size_t length);
+
+    uint32_t published;      // Messages sent
+    uint32_t received;       // Messages delivered to the handler
+    uint32_t connects;       // Successful connections
+    uint32_t failures;       // Failed connects and dropped connections
+    uint32_t reconnectDelay; // ms between connection attempts
+
+    /**
+     * @param options   CONNECT parameters (strings must outlive the client)
+     * @param subscribe Topic to subscribe to after each connect (nullptr: none)
+     */
+    MqttClient(const MqttConnectOptions &options, const char *subscribe);
+
+    void onMessage(MessageHandler handler, void *context);
+
+    /**
+     * Connect if needed, then wait up to timeoutMs for incoming packets
+     * and send a ping when the keep-alive is due
+     *
+     * @param host Broker address or name
+     * @param port Broker port
+     * @param now  Current time (ms)
+     * @param timeoutMs Longest wait for incoming data
+     * @return true if connected afterwards
+     */
+    bool poll(const char *host, uint16_t port, uint32_t now, uint32_t timeoutMs);
+
+    /**
+     * Publish at QoS 0
+     *
+     * @return false if not connected or the send failed
+     */
+    bool publish(const char *topic, const char *payload, size_t length, bool retain, uint32_t now);
+
+    bool connected() const
+    {
+        return state == CONNECTED;
+    }
+
+    /**
+     * Send DISCONNECT (no last will) and close
+     */
+    void disconnect();
+
+private:
+    enum State : uint8_t
+    {
+        IDLE,
+        WAIT_CONNACK,
+        CONNECTED
+    };
+
+    MqttConnectOptions options;
+    const char *subscription;
+    MessageHandler handler;
+    void *context;
+
+    int fd;
+    State state;
+    uint32_t lastAttempt;   // Last connection attempt (ms)
+    uint32_t lastSent;      // Last packet sent, for keep-alive (ms)
+    uint32_t lastReceived;  // Last data from the broker (ms)
+    bool attempted;         // lastAttempt is valid
+    MqttReader reader;
+    uint8_t tx[MQTT_MAX_PACKET];
+
+    bool open(const char *host, uint16_t port, uint32_t now);
+    void close();
+    bool send(const uint8_t *data, size_t length, uint32_t now);
+    void handle(const MqttPacket &packet, uint32_t now);
+};
+
+#endif // MQTTCLIENT_H
@@ -0,0 +1,500 @@
+/**
+ * @file MqttProtocol.h
+ * @brief MQTT 3.1.1 packet codec and publish batching
+ *
+ * Just the subset the lamp needs: CONNECT with a last will, QoS 0
+ * PUBLISH and SUBSCRIBE, PINGREQ and DISCONNECT out; CONNACK, SUBACK,
+ * PUBLISH and PINGRESP in. Packets are built in and parsed from fixed
+ * caller buffers. No Arduino dependencies, so the same code runs in the
+ * native unit tests and the host simulator.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MQTTPROTOCOL_H
+#define MQTTPROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// PACKET TYPES
+// ============================================================================
+
+#define MQTT_CONNECT 1
+#define MQTT_CONNACK 2
+#define MQTT_PUBLISH 3
+#define MQTT_PUBACK 4
+#define MQTT_SUBSCRIBE 8
+#define MQTT_SUBACK 9
+#define MQTT_PINGREQ 12
+#define MQTT_PINGRESP 13
+#define MQTT_DISCONNECT 14
+
+#define MQTT_MAX_PACKET 512 // Largest packet sent or accepted
+
+/**
+ * Connection parameters for CONNECT
+ */
+struct MqttConnectOptions
+{
+    const char *clientId;
+    const char *user;        // Empty: no credentials
+    const char *password;
+    const char *willTopic;   // Empty: no last will
+    const char *willMessage; // Published retained by the broker on a lost connection
+    uint16_t keepAlive;      // Seconds
+};
+
+// ============================================================================
+// ENCODING
+// ============================================================================
+
+/**
+ * @class MqttWriter
+ * @brief Builds one packet in a caller buffer; overflow makes it invalid
+ */
+class MqttWriter
+{
+public:
+    MqttWriter(uint8_t *buffer, size_t size) : buf(buffer), cap(size), len(0), overflow(false) {}
+
+    void byte(uint8_t b)
+    {
+        if (len < cap)
+        {
+            buf[len++] = b;
+        }
+        else
+        {
+            overflow = true;
+        }
+    }
+
+    void u16(uint16_t v)
+    {
+        byte(v >> 8);
+        byte(v & 0xFF);
+    }
+
+    void bytes(const void *data, size_t n)
+    {
+        if (n > cap - len)
+        {
+            overflow = true;
+            return;
+        }
+        memcpy(buf + len, data, n);
+        len += n;
+    }
+
+    /**
+     * Length-prefixed UTF-8 string
+     */
+    void str(const char *s)
+    {
+        size_t n = strlen(s);
+        u16(n);
+        bytes(s, n);
+    }
+
+    /**
+     * Fixed header: type/flags and variable-length remaining length
+     */
+    void header(uint8_t typeFlags, size_t remaining)
+    {
+        byte(typeFlags);
+        do
+        {
+            uint8_t digit = remaining % 128;
+            remaining /= 128;
+            byte(remaining > 0 ? digit | 0x80 : digit);
+        } while (remaining > 0);
+    }
+
+    /**
+     * Packet length, 0 if it did not fit
+     */
+    size_t finish() const
+    {
+        return overflow ? 0 : len;
+    }
+
+private:
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+};
+
+/**
+ * Build a CONNECT packet (clean session)
+ *
+ * @return Packet length, 0 if buf is too small
+ */
+static inline size_t mqttConnect(const MqttConnectOptions &opt, uint8_t *buf, size_t size)
+{
+    bool will = opt.willTopic && *opt.willTopic;
+    bool user = opt.user && *opt.user;
+
+    size_t remaining = 10 + 2 + strlen(opt.clientId);
+    uint8_t flags = 0x02; // Clean session
+    if (will)
+    {
+        remaining += 2 + strlen(opt.willTopic) + 2 + strlen(opt.willMessage);
+        flags |= 0x04 | 0x20; // Will, retained, QoS 0
+    }
+    if (user)
+    {
+        remaining += 2 + strlen(opt.user) + 2 + strlen(opt.password);
+        flags |= 0x80 | 0x40;
+    }
+
+    MqttWriter w(buf, size);
+    w.header(MQTT_CONNECT << 4, remaining);
+    w.str("MQTT");
+    w.byte(4); // Protocol level 3.1.1
+    w.byte(flags);
+    w.u16(opt.keepAlive);
+    w.str(opt.clientId);
+    if (will)
+    {
+        w.str(opt.willTopic);
+        w.str(opt.willMessage);
+    }
+    if (user)
+    {
+        w.str(opt.user);
+        w.str(opt.password);
+    }
+    return w.finish();
+}
+
+/**
+ * Build a QoS 0 PUBLISH packet
+ */
+static inline size_t mqttPublish(const char *topic, const void *payload, size_t length, bool retain,
+                                 uint8_t *buf, size_t size)
+{
+    MqttWriter w(buf, size);
+    w.header((MQTT_PUBLISH << 4) | (retain ? 0x01 : 0x00), 2 + strlen(topic) + length);
+    w.str(topic);
+    w.bytes(payload, length);
+    return w.finish();
+}
+
+/**
+ * Build a SUBSCRIBE packet for one topic at QoS 0
+ */
+static inline size_t mqttSubscribe(uint16_t packetId, const char *topic, uint8_t *buf, size_t size)
+{
+    MqttWriter w(buf, size);
+    w.header((MQTT_SUBSCRIBE << 4) | 0x02, 2 + 2 + strlen(topic) + 1);
+    w.u16(packetId);
+    w.str(topic);
+    w.byte(0);
+    return w.finish();
+}
+
+/**
+ * Build a packet with no variable header or payload (PINGREQ, DISCONNECT)
+ */
+static inline size_t mqttEmpty(uint8_t type, uint8_t *buf, size_t size)
+{
+    MqttWriter w(buf, size);
+    w.header(type << 4, 0);
+    return w.finish();
+}
+
+// ============================================================================
+// DECODING
+// ============================================================================
+
+/**
+ * @struct MqttPacket
+ * @brief One received packet; body points into the reader's buffer
+ */
+struct MqttPacket
+{
+    uint8_t type;
+    uint8_t flags;
+    const uint8_t *body;
+    size_t length;
+};
+
+/**
+ * @class MqttReader
+ * @brief Reassembles packets from a byte stream in a fixed buffer
+ *
+ * feed() the bytes received, then take packets with next() until it
+ * returns false. Packets larger than the buffer are skipped.
+ */
+class MqttReader
+{
+public:
+    uint32_t oversized; // Packets skipped for not fitting
+
+    MqttReader() : oversized(0), fill(0), consumed(0), skip(0) {}
+
+    void reset()
+    {
+        fill = 0;
+        consumed = 0;
+        skip = 0;
+    }
+
+    /**
+     * Space for the next read, and how much fits
+     */
+    uint8_t *space()
+    {
+        compact();
+        return buf + fill;
+    }
+
+    size_t spaceLeft() const
+    {
+        return sizeof(buf) - fill;
+    }
+
+    /**
+     * Account for n bytes written at space()
+     */
+    void received(size_t n)
+    {
+        // Drop the rest of an oversized packet as it streams in
+        size_t dropped = n < skip ? n : skip;
+        skip -= dropped;
+        if (dropped > 0)
+        {
+            memmove(buf + fill, buf + fill + dropped, n - dropped);
+        }
+        fill += n - dropped;
+    }
+
+    /**
+     * Copy bytes in (for callers without a socket)
+     */
+    void feed(const uint8_t *data, size_t n)
+    {
+        while (n > 0)
+        {
+            uint8_t *dst = space();
+            size_t chunk = n < spaceLeft() ? n : spaceLeft();
+            if (chunk == 0)
+            {
+                return;
+            }
+            memcpy(dst, data, chunk);
+            received(chunk);
+            data += chunk;
+            n -= chunk;
+        }
+    }
+
+    /**
+     * Next complete packet, valid until the following next()/space()
+     */
+    bool next(MqttPacket &packet)
+    {
+        const uint8_t *p = buf + consumed;
+        size_t available = fill - consumed;
+        if (available < 2)
+        {
+            return false;
+        }
+
+        size_t remaining = 0;
+        size_t header = 1;
+        for (int shift = 0;; shift += 7)
+        {
+            if (header >= available)
+            {
+                return false; // Length not complete yet
+            }
+            uint8_t digit = p[header++];
+            remaining |= (size_t)(digit & 0x7F) << shift;
+            if (!(digit & 0x80))
+            {
+                break;
+            }
+            if (shift >= 21)
+            {
+                reset(); // Malformed length: resynchronise on a new connection
+                return false;
+            }
+        }
+
+        if (header + remaining > sizeof(buf))
+        {
+            oversized++;
+            skip = header + remaining - available;
+            consumed = fill;
+            return false;
+        }
+        if (header + remaining > available)
+        {
+            return false;
+        }
+
+        packet.type = p[0] >> 4;
+        packet.flags = p[0] & 0x0F;
+        packet.body = p + header;
+        packet.length = remaining;
+        consumed += header + remaining;
+        return true;
+    }
+
+private:
+    uint8_t buf[MQTT_MAX_PACKET];
+    size_t fill;     // Bytes in buf
+    size_t consumed; // Bytes already returned as packets
+    size_t skip;     // Bytes of an oversized packet still to drop
+
+    void compact()
+    {
+        if (consumed > 0)
+        {
+            memmove(buf, buf + consumed, fill - consumed);
+            fill -= consumed;
+            consumed = 0;
+        }
+    }
+};
+
+/**
+ * Split a received PUBLISH into topic and payload
+ */
+static inline bool mqttParsePublish(const MqttPacket &packet, const char *&topic, size_t &topicLength,
+                                    const uint8_t *&payload, size_t &payloadLength)
+{
+    if (packet.type != MQTT_PUBLISH || packet.length < 2)
+    {
+        return false;
+    }
+    topicLength = (packet.body[0] << 8) | packet.body[1];
+    size_t offset = 2 + topicLength;
+    if (((packet.flags >> 1) & 0x03) > 0)
+    {
+        offset += 2; // Packet identifier (QoS 1/2, delivered as QoS 0 here)
+    }
+    if (offset > packet.length)
+    {
+        return false;
+    }
+    topic = (const char *)packet.body + 2;
+    payload = packet.body + offset;
+    payloadLength = packet.length - offset;
+    return true;
+}
+
+// ============================================================================
+// BATCHING
+// ============================================================================
+
+/**
+ * @struct PublishBatcher
+ * @brief Turns bursts of changes into one publish per window
+ *
+ * The first change opens a window of `window` ms; further changes in
+ * that window ride along. The publish then carries the latest state.
+ */
+struct PublishBatcher
+{
+    uint32_t window;     // Batch window (ms)
+    uint32_t firstDirty; // Time of the first unpublished change
+    bool dirty;
+    uint32_t changes;    // Changes seen
+    uint32_t publishes;  // Publishes due (changes / publishes = batching ratio)
+
+    explicit PublishBatcher(uint32_t windowMs)
+        : window(windowMs), firstDirty(0), dirty(false), changes(0), publishes(0) {}
+
+    void mark(uint32_t now)
+    {
+        if (!dirty)
+        {
+            dirty = true;
+            firstDirty = now;
+        }
+        changes++;
+    }
+
+    /**
+     * True once the window has closed; call sent() after publishing
+     */
+    bool due(uint32_t now) const
+    {
+        return dirty && now - firstDirty >= window;
+    }
+
+    void sent()
+    {
+        dirty = false;
+        publishes++;
+    }
+};
+
+// ============================================================================
+// METRICS
+// ============================================================================
+
+/**
+ * @struct LampMetrics
+ * @brief Snapshot of the render counters and heap for <prefix>/metrics
+ */
+struct LampMetrics
+{
+    uint32_t uptime;       // Seconds
+    uint32_t heapFree;     // Bytes
+    uint32_t heapMin;      // Lowest free heap since boot (bytes)
+    uint32_t frames;       // Output frames rendered
+    uint32_t frameAvgUs;
+    uint32_t frameWorstUs;
+    uint32_t latencyAvgUs; // Write-to-frame latency
+    uint32_t latencyWorstUs;
+    uint32_t overruns;     // Frames past RENDER_DEADLINE_US
+    uint32_t quality;      // RenderQualityLevel, 0 = full
+};
+
+/**
+ * Write metrics as a JSON object
+ *
+ * @return Length written, 0 if out is too small
+ */
+static inline size_t encodeMetrics(const LampMetrics &m, char *out, size_t size)
+{
+    int n = snprintf(out, size,
+                     "{\"uptime\":%u,\"heapFree\":%u,\"heapMin\":%u,\"frames\":%u,"
+                     "\"frameAvgUs\":%u,\"frameWorstUs\":%u,\"latencyAvgUs\":%u,\"latencyWorstUs\":%u,"
+                     "\"overruns\":%u,\"quality\":%u}",
+                     (unsigned)m.uptime, (unsigned)m.heapFree, (unsigned)m.heapMin, (unsigned)m.frames,
+                     (unsigned)m.frameAvgUs, (unsigned)m.frameWorstUs,
+                     (unsigned)m.latencyAvgUs, (unsigned)m.latencyWorstUs,
+                     (unsigned)m.overruns, (unsigned)m.quality);
+    return n > 0 && (size_t)n < size ? (size_t)n : 0;
+}
+
+#endif // MQTTPROTOCOL_H
@@ -0,0 +1,355 @@
+/**
+ * @file OverlayStack.h
+ * @brief Short-lived notification overlays composited over the candle
+ *
+ * Overlays (doorbell pulse, timer blink, WiFi AP indicator, ...) sit
+ * above the base effect and blend into every LED. Storage is a fixed
+ * array of OVERLAY_CAPACITY slots, so triggering one never allocates.
+ * Once per output frame prepare() turns the active overlays into a short
+ * list of (color, alpha) layers in priority order, which the output pass
+ * applies per pixel in the same loop as interpolation and calibration.
+ *
+ * Header-only and Arduino-free for the native tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OVERLAYSTACK_H
+#define OVERLAYSTACK_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "FlickerMath.h"
+
+// ============================================================================
+// OVERLAY DEFINITIONS
+// ============================================================================
+
+/**
+ * Temporal pattern of an overlay (uniform across all LEDs)
+ */
+enum OverlayPattern : uint8_t
+{
+    PATTERN_SOLID, // Constant alpha
+    PATTERN_PULSE, // Triangle wave, smooth breathing
+    PATTERN_BLINK, // Square wave, on for half of each period
+    PATTERN_SHIMMER // Two beating triangle waves, never fully dark
+};
+
+/**
+ * Built-in notifications; the value is what the Notification
+ * characteristic and the "@o" command accept
+ */
+enum OverlayId : uint8_t
+{
+    OVERLAY_NONE = 0,
+    OVERLAY_DOORBELL = 1,
+    OVERLAY_TIMER = 2,
+    OVERLAY_WIFI_AP = 3,
+    OVERLAY_PAIRING = 4,
+    OVERLAY_CONNECTING = 5,
+    OVERLAY_PRESET_COUNT
+};
+
+/**
+ * @struct OverlayPreset
+ * @brief How a built-in notification looks
+ */
+struct OverlayPreset
+{
+    const char *name;
+    uint8_t priority;  // Higher draws on top
+    OverlayPattern pattern;
+    uint8_t r, g, b;
+    uint8_t maxAlpha;  // Peak opacity, 255 = fully replaces the candle
+    uint16_t periodMs; // Pattern period
+    uint32_t durationMs; // 0 = until cleared
+};
+
+/**
+ * Built-in notifications, indexed by OverlayId
+ */
+static const OverlayPreset OVERLAY_PRESETS[OVERLAY_PRESET_COUNT] = {
+    {"none", 0, PATTERN_SOLID, 0, 0, 0, 0, 1, 0},
+    {"doorbell", 3, PATTERN_PULSE, 40, 120, 255, 255, 1000, 3000},
+    {"timer", 3, PATTERN_BLINK, 255, 255, 255, 255, 600, 1800},
+    {"wifi-ap", 1, PATTERN_PULSE, 0, 180, 160, 96, 2000, WIFI_AP_TIMEOUT * 1000UL},
+    {"pairing", 2, PATTERN_PULSE, 255, 160, 40, 160, 3000, 0},
+    {"connecting", 2, PATTERN_SHIMMER, 60, 60, 255, 112, 1400, 0},
+};
+
+/**
+ * @struct OverlayLayer
+ * @brief One overlay resolved for the current frame
+ */
+struct OverlayLayer
+{
+    uint8_t r, g, b;
+    uint16_t t; // Blend weight 0-256 for lerp8()
+};
+
+// ============================================================================
+// OVERLAY STACK
+// ============================================================================
+
+/**
+ * @class OverlayStack
+ * @brief Fixed-capacity set of active overlays
+ */
+class OverlayStack
+{
+public:
+    /**
+     * Layers for the current frame, lowest priority first
+     * Valid after prepare(); numLayers is 0 on most frames
+     */
+    OverlayLayer layers[OVERLAY_CAPACITY];
+    int numLayers;
+
+    OverlayStack() : numLayers(0)
+    {
+        memset(slots, 0, sizeof(slots));
+    }
+
+    /**
+     * Start (or restart) a built-in notification
+     *
+     * Re-triggering an active id restarts it in place. With every slot
+     * busy, the lowest-priority overlay is evicted if the new one ranks
+     * at least as high; otherwise the trigger is ignored.
+     *
+     * @param id  Notification to show
+     * @param now Current time (ms)
+     * @return true if the overlay is now active
+     */
+    bool trigger(uint8_t id, uint32_t now)
+    {
+        if (id == OVERLAY_NONE || id >= OVERLAY_PRESET_COUNT)
+        {
+            return false;
+        }
+        const OverlayPreset &preset = OVERLAY_PRESETS[id];
+
+        int target = -1;
+        int lowest = -1;
+        for (int i = 0; i < OVERLAY_CAPACITY; i++)
+        {
+            if (slots[i].id == id)
+            {
+                target = i;
+                break;
+            }
+            if (slots[i].id == OVERLAY_NONE)
+            {
+                if (target < 0)
+                {
+                    target = i;
+                }
+            }
+            else if (lowest < 0 || OVERLAY_PRESETS[slots[i].id].priority < OVERLAY_PRESETS[slots[lowest].id].priority)
+            {
+                lowest = i;
+            }
+        }
+
+        if (target < 0)
+        {
+            if (OVERLAY_PRESETS[slots[lowest].id].priority > preset.priority)
+            {
+                return false;
+            }
+            target = lowest;
+        }
+
+        slots[target].id = id;
+        slots[target].start = now;
+        return true;
+    }
+
+    /**
+     * Stop a notification (OVERLAY_NONE clears all)
+     */
+    void clear(uint8_t id)
+    {
+        for (int i = 0; i < OVERLAY_CAPACITY; i++)
+        {
+            if (id == OVERLAY_NONE || slots[i].id == id)
+            {
+                slots[i].id = OVERLAY_NONE;
+            }
+        }
+    }
+
+    /**
+     * True if the notification is currently active
+     */
+    bool isActive(uint8_t id) const
+    {
+        for (int i = 0; i < OVERLAY_CAPACITY; i++)
+        {
+            if (slots[i].id == id)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Expire finished overlays and resolve the rest into layers[]
+     *
+     * O(OVERLAY_CAPACITY^2) at worst, independent of LED count.
+     *
+     * @param now Current time (ms)
+     */
+    void prepare(uint32_t now)
+    {
+        numLayers = 0;
+        uint8_t order[OVERLAY_CAPACITY];
+
+        for (int i = 0; i < OVERLAY_CAPACITY; i++)
+        {
+            if (slots[i].id == OVERLAY_NONE)
+            {
+                continue;
+            }
+            const OverlayPreset &preset = OVERLAY_PRESETS[slots[i].id];
+            if (preset.durationMs && now - slots[i].start >= preset.durationMs)
+            {
+                slots[i].id = OVERLAY_NONE;
+                continue;
+            }
+
+            // Insertion sort by priority, stable for equal priorities
+            int pos = numLayers;
+            while (pos > 0 && OVERLAY_PRESETS[slots[order[pos - 1]].id].priority > preset.priority)
+            {
+                order[pos] = order[pos - 1];
+                pos--;
+            }
+            order[pos] = i;
+            numLayers++;
+        }
+
+        for (int n = 0; n < numLayers; n++)
+        {
+            const Slot &slot = slots[order[n]];
+            const OverlayPreset &preset = OVERLAY_PRESETS[slot.id];
+            uint8_t alpha = scaleAlpha(patternLevel(preset, now - slot.start), preset.maxAlpha);
+            layers[n].r = preset.r;
+            layers[n].g = preset.g;
+            layers[n].b = preset.b;
+            layers[n].t = alpha + (alpha >> 7); // 0-255 -> 0-256
+        }
+    }
+
+    /**
+     * Pattern level (0-255) at a time offset into the overlay
+     */
+    static uint8_t patternLevel(const OverlayPreset &preset, uint32_t elapsed)
+    {
+        uint32_t period = preset.periodMs ? preset.periodMs : 1;
+        uint32_t phase = elapsed % period;
+        switch (preset.pattern)
+        {
+        case PATTERN_PULSE:
+            // 0 -> 255 -> 0 over one period
+            return triangle(elapsed, period);
+        case PATTERN_BLINK:
+            return phase < period / 2 ? 255 : 0;
+        case PATTERN_SHIMMER:
+        {
+            // Second wave at 3/7 of the period keeps it from looking regular
+            uint32_t sum = triangle(elapsed, period) + triangle(elapsed, period * 3 / 7);
+            return (uint8_t)(96 + sum * 159 / 510);
+        }
+        case PATTERN_SOLID:
+        default:
+            return 255;
+        }
+    }
+
+    /**
+     * Look up a built-in notification by name or number
+     *
+     * @return OverlayId, or OVERLAY_PRESET_COUNT if unknown
+     */
+    static uint8_t findPreset(const char *name)
+    {
+        for (uint8_t id = 0; id < OVERLAY_PRESET_COUNT; id++)
+        {
+            if (strcmp(name, OVERLAY_PRESETS[id].name) == 0)
+            {
+                return id;
+            }
+        }
+        if (name[0] >= '0' && name[0] <= '9' && name[1] == '\0')
+        {
+            uint8_t id = name[0] - '0';
+            return id < OVERLAY_PRESET_COUNT ? id : OVERLAY_PRESET_COUNT;
+        }
+        return OVERLAY_PRESET_COUNT;
+    }
+
+private:
+    static uint8_t triangle(uint32_t elapsed, uint32_t period)
+    {
+        if (period < 2)
+        {
+            return 255;
+        }
+        uint32_t phase = elapsed % period;
+        uint32_t level = (phase < period / 2 ? phase : period - phase) * 510 / period;
+        return level > 255 ? 255 : (uint8_t)level;
+    }
+
+    static uint8_t scaleAlpha(uint8_t level, uint8_t maxAlpha)
+    {
+        return (uint8_t)(((uint16_t)level * ((uint16_t)maxAlpha + 1)) >> 8);
+    }
+
+    struct Slot
+    {
+        uint8_t id;     // OverlayId, OVERLAY_NONE when free
+        uint32_t start; // Trigger time (ms)
+    };
+
+    Slot slots[OVERLAY_CAPACITY];
+};
+
+/**
+ * Blend the frame's overlay layers onto one pixel, lowest first
+ */
+RENDER_INLINE void compositeLayers(uint8_t &r, uint8_t &g, uint8_t &b, const OverlayLayer *layers, int numLayers)
+{
+    for (int n = 0; n < numLayers; n++)
+    {
+        r = lerp8(r, layers[n].r, layers[n].t);
+        g = lerp8(g, layers[n].g, layers[n].t);
+        b = lerp8(b, layers[n].b, layers[n].t);
+    }
+}
+
+#endif // OVERLAYSTACK_H
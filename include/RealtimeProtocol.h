@@ -0,0 +1,279 @@
+/**
+ * @file RealtimeProtocol.h
+ * @brief In-place DDP and E1.31 (sACN) packet parsing
+ *
+ * Lighting consoles drive pixels over DDP (Distributed Display Protocol)
+ * or E1.31 (streaming DMX over UDP). Both parsers validate a received
+ * datagram where it lies and copy its RGB payload straight into the
+ * caller's pixel bytes, normally the leds[][] output arrays, which are
+ * laid out as packed R,G,B triplets strip after strip. Nothing is
+ * allocated or buffered in between.
+ *
+ * Arduino-free; shared by RealtimeReceiver (ESP32), the host simulator
+ * and the native tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef REALTIMEPROTOCOL_H
+#define REALTIMEPROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// PROTOCOL CONSTANTS
+// ============================================================================
+
+// DDP, see http://www.3waylabs.com/ddp/
+#define DDP_PORT 4048
+#define DDP_HEADER_LEN 10
+#define DDP_TIMECODE_LEN 4
+#define DDP_FLAGS_VER_MASK 0xC0
+#define DDP_FLAGS_VER1 0x40
+#define DDP_FLAGS_TIMECODE 0x10
+#define DDP_FLAGS_STORAGE 0x08
+#define DDP_FLAGS_REPLY 0x04
+#define DDP_FLAGS_QUERY 0x02
+#define DDP_FLAGS_PUSH 0x01
+#define DDP_TYPE_UNDEFINED 0x00
+#define DDP_TYPE_RGB24 0x0B // RGB, 8 bits per channel
+#define DDP_ID_DISPLAY 1
+#define DDP_ID_ALL 255
+
+// E1.31 (ANSI E1.31-2018), DMX data packets only
+#define E131_PORT 5568
+#define E131_HEADER_LEN 126
+#define E131_MAX_CHANNELS 512
+#define E131_ROOT_VECTOR_DATA 0x00000004
+#define E131_FRAME_VECTOR_DATA 0x00000002
+#define E131_DMP_VECTOR_SET 0x02
+#define E131_OPT_PREVIEW 0x80
+#define E131_OPT_TERMINATED 0x40
+#define E131_STALE_WINDOW 20 // Sequence numbers this far behind are late duplicates
+
+/**
+ * Outcome of parsing one datagram
+ */
+enum RealtimeResult : uint8_t
+{
+    RT_IGNORED,   // Malformed, or not addressed to this lamp
+    RT_STALE,     // Valid but out of order, discarded
+    RT_DATA,      // Pixels written, more to come before display (DDP)
+    RT_FRAME,     // Pixels written, frame complete: show it
+    RT_TERMINATED // Source ended the stream (E1.31)
+};
+
+// ============================================================================
+// SEQUENCE TRACKING
+// ============================================================================
+
+/**
+ * @struct SequenceTracker
+ * @brief Counts packets lost between consecutive sequence numbers
+ */
+struct SequenceTracker
+{
+    uint32_t dropped; // Packets missing from the sequence
+    uint32_t stale;   // Late packets discarded
+    int16_t last;     // Last sequence number seen, -1 before the first
+
+    SequenceTracker() { reset(); }
+
+    void reset()
+    {
+        dropped = 0;
+        stale = 0;
+        last = -1;
+    }
+
+    /**
+     * DDP: 4-bit sequence 1-15, 0 means the sender does not number packets
+     */
+    void ddp(uint8_t seq)
+    {
+        seq &= 0x0F;
+        if (seq == 0)
+        {
+            return;
+        }
+        if (last > 0)
+        {
+            int gap = (seq - last + 15) % 15; // 1 = next in order
+            dropped += gap == 0 ? 0 : gap - 1;
+        }
+        last = seq;
+    }
+
+    /**
+     * E1.31: 8-bit wrapping sequence; late packets must be discarded
+     *
+     * @return false if the packet is out of order
+     */
+    bool e131(uint8_t seq)
+    {
+        if (last >= 0)
+        {
+            int8_t diff = (int8_t)(seq - (uint8_t)last);
+            if (diff <= 0 && diff > -E131_STALE_WINDOW)
+            {
+                stale++;
+                return false;
+            }
+            if (diff > 1)
+            {
+                dropped += diff - 1;
+            }
+        }
+        last = seq;
+        return true;
+    }
+};
+
+// ============================================================================
+// PARSERS
+// ============================================================================
+
+static inline uint16_t rtGet16(const uint8_t *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static inline uint32_t rtGet32(const uint8_t *p)
+{
+    return ((uint32_t)rtGet16(p) << 16) | rtGet16(p + 2);
+}
+
+/**
+ * Parse a DDP packet, writing its payload at its data offset
+ *
+ * Payload beyond the end of the pixel buffer is dropped. Queries,
+ * replies and storage packets are ignored.
+ *
+ * @param packet     Datagram
+ * @param length     Datagram length
+ * @param pixels     Packed RGB output bytes
+ * @param pixelBytes Size of pixels
+ * @param seq        Sequence tracker for this source
+ */
+static inline RealtimeResult parseDdp(const uint8_t *packet, size_t length,
+                                      uint8_t *pixels, size_t pixelBytes, SequenceTracker &seq)
+{
+    if (length < DDP_HEADER_LEN)
+    {
+        return RT_IGNORED;
+    }
+    uint8_t flags = packet[0];
+    if ((flags & DDP_FLAGS_VER_MASK) != DDP_FLAGS_VER1 ||
+        (flags & (DDP_FLAGS_QUERY | DDP_FLAGS_REPLY | DDP_FLAGS_STORAGE)))
+    {
+        return RT_IGNORED;
+    }
+    if (packet[2] != DDP_TYPE_UNDEFINED && packet[2] != DDP_TYPE_RGB24)
+    {
+        return RT_IGNORED;
+    }
+    if (packet[3] != DDP_ID_DISPLAY && packet[3] != DDP_ID_ALL)
+    {
+        return RT_IGNORED;
+    }
+
+    size_t header = DDP_HEADER_LEN + ((flags & DDP_FLAGS_TIMECODE) ? DDP_TIMECODE_LEN : 0);
+    uint32_t offset = rtGet32(packet + 4);
+    size_t dataLength = rtGet16(packet + 8);
+    if (header + dataLength > length)
+    {
+        return RT_IGNORED;
+    }
+
+    seq.ddp(packet[1]);
+
+    if (offset < pixelBytes)
+    {
+        size_t n = dataLength < pixelBytes - offset ? dataLength : pixelBytes - offset;
+        memcpy(pixels + offset, packet + header, n);
+    }
+    return (flags & DDP_FLAGS_PUSH) ? RT_FRAME : RT_DATA;
+}
+
+/**
+ * Parse an E1.31 data packet for one universe, writing DMX channel 1
+ * onward to the start of the pixel buffer
+ *
+ * Preview packets and non-zero start codes (e.g. per-channel priority)
+ * are ignored, late packets discarded.
+ *
+ * @param packet     Datagram
+ * @param length     Datagram length
+ * @param universe   Universe this lamp listens to
+ * @param pixels     Packed RGB output bytes
+ * @param pixelBytes Size of pixels
+ * @param seq        Sequence tracker for this universe
+ */
+static inline RealtimeResult parseE131(const uint8_t *packet, size_t length, uint16_t universe,
+                                       uint8_t *pixels, size_t pixelBytes, SequenceTracker &seq)
+{
+    static const uint8_t ACN_ID[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+
+    if (length < E131_HEADER_LEN ||
+        memcmp(packet + 4, ACN_ID, sizeof(ACN_ID)) != 0 ||
+        rtGet32(packet + 18) != E131_ROOT_VECTOR_DATA ||
+        rtGet32(packet + 40) != E131_FRAME_VECTOR_DATA ||
+        packet[117] != E131_DMP_VECTOR_SET ||
+        rtGet16(packet + 113) != universe)
+    {
+        return RT_IGNORED;
+    }
+
+    uint8_t options = packet[112];
+    if (options & E131_OPT_TERMINATED)
+    {
+        seq.last = -1; // A restarted source may begin anywhere
+        return RT_TERMINATED;
+    }
+    if ((options & E131_OPT_PREVIEW) || packet[125] != 0)
+    {
+        return RT_IGNORED;
+    }
+    if (!seq.e131(packet[111]))
+    {
+        return RT_STALE;
+    }
+
+    // Property count includes the start code
+    size_t channels = rtGet16(packet + 123);
+    channels = channels > 0 ? channels - 1 : 0;
+    if (channels > E131_MAX_CHANNELS)
+    {
+        channels = E131_MAX_CHANNELS;
+    }
+    if (channels > length - E131_HEADER_LEN)
+    {
+        channels = length - E131_HEADER_LEN;
+    }
+    memcpy(pixels, packet + E131_HEADER_LEN, channels < pixelBytes ? channels : pixelBytes);
+    return RT_FRAME;
+}
+
+#endif // REALTIMEPROTOCOL_H
@@ -0,0 +1,108 @@
+/**
+ * @file RealtimeReceiver.h
+ * @brief UDP receiver for DDP and E1.31 pixel streams
+ *
+ * Reads datagrams with non-blocking lwIP sockets into one fixed packet
+ * buffer (WiFiUDP allocates on every packet) and hands them to the
+ * RealtimeProtocol.h parsers, which write the payload straight into the
+ * LED arrays. DEV_CandleLight decides when a frame is shown.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef REALTIMERECEIVER_H
+#define REALTIMERECEIVER_H
+
+// Third-party libraries
+#include <Arduino.h>
+
+// Project headers
+#include "config.h"
+#include "FrameStats.h"
+#include "RealtimeProtocol.h"
+
+#if REALTIME_ENABLED
+
+// Largest datagram accepted: a full E1.31 universe or a 1440-byte DDP payload
+#define REALTIME_MAX_PACKET 1472
+
+/**
+ * @class RealtimeReceiver
+ * @brief DDP and E1.31 input with takeover and timeout tracking
+ */
+class RealtimeReceiver
+{
+public:
+    FrameStats latency; // Frame-completing packet received -> shown (µs)
+    uint32_t packets;   // Datagrams read
+    uint32_t frames;    // Complete frames received
+    uint32_t ignored;   // Datagrams that were malformed or not for us
+    SequenceTracker ddpSeq;
+    SequenceTracker e131Seq;
+
+    RealtimeReceiver();
+
+    /**
+     * Read all pending datagrams into the pixel buffer
+     *
+     * Opens the sockets once WiFi is up.
+     *
+     * @param pixels     Packed RGB output bytes (the leds[][] arrays)
+     * @param pixelBytes Size of pixels
+     * @param now        Current time (ms)
+     * @return true if a complete frame arrived and should be shown now
+     */
+    bool poll(uint8_t *pixels, size_t pixelBytes, uint32_t now);
+
+    /**
+     * True while the console owns the strips
+     */
+    bool active(uint32_t now) const
+    {
+        return streaming && now - lastPacket < REALTIME_TIMEOUT;
+    }
+
+    /**
+     * Record latency once the frame poll() reported is on the strips
+     */
+    void frameShown();
+
+    /**
+     * Print packet counters and latency to serial
+     */
+    void printStats();
+
+private:
+    int ddpSocket;
+    int e131Socket;
+    bool streaming;        // A frame arrived and the stream was not terminated
+    uint32_t lastPacket;   // millis() of the last accepted packet
+    uint32_t frameMicros;  // micros() when the last frame completed
+    uint8_t packet[REALTIME_MAX_PACKET];
+
+    bool open();
+};
+
+#endif // REALTIME_ENABLED
+
+#endif // REALTIMERECEIVER_H
@@ -0,0 +1,161 @@
+/**
+ * @file RenderQuality.h
+ * @brief Frame deadline monitor and render quality levels
+ *
+ * Counts frames that miss their deadline and, once overruns are
+ * sustained, steps the candle down to cheaper rendering; it steps back
+ * up once frames finish with headroom again. Header-only and free of
+ * Arduino dependencies so it runs in the native unit tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RENDERQUALITY_H
+#define RENDERQUALITY_H
+
+#include <stdint.h>
+
+#include "config.h"
+
+static_assert(QUALITY_DEGRADE_OVERRUNS >= 1 && QUALITY_DEGRADE_OVERRUNS <= QUALITY_WINDOW,
+              "QUALITY_DEGRADE_OVERRUNS must be 1..QUALITY_WINDOW");
+static_assert(QUALITY_WINDOW <= 65535 && QUALITY_RECOVER_FRAMES <= 65535, "Quality frame counts are 16-bit");
+static_assert(QUALITY_HOLD_STEPS >= 1, "QUALITY_HOLD_STEPS must be at least 1");
+
+/**
+ * @enum RenderQualityLevel
+ * @brief How much work each flicker step does, cheapest last
+ */
+enum RenderQualityLevel : uint8_t
+{
+    QUALITY_FULL = 0, // Every LED stepped, missed steps replayed
+    QUALITY_REDUCED,  // Alternate LEDs stepped, no catch-up replay
+    QUALITY_HOLD,     // As reduced, on every QUALITY_HOLD_STEPS-th step only
+    QUALITY_LEVEL_COUNT
+};
+
+/**
+ * @class RenderQuality
+ * @brief Per-frame deadline monitor with hysteresis between levels
+ *
+ * Steps down one level when QUALITY_DEGRADE_OVERRUNS frames within a
+ * window of QUALITY_WINDOW miss the deadline, and up one level after
+ * QUALITY_RECOVER_FRAMES frames in a row finish within half of it.
+ */
+class RenderQuality
+{
+public:
+    uint8_t level;       // RenderQualityLevel in effect
+    uint32_t overruns;   // Frames that missed the deadline since boot
+    uint32_t degrades;   // Steps down
+    uint32_t recoveries; // Steps back up
+
+    RenderQuality() { reset(); }
+
+    /**
+     * Back to full quality with all counters cleared
+     */
+    void reset()
+    {
+        level = QUALITY_FULL;
+        overruns = 0;
+        degrades = 0;
+        recoveries = 0;
+        windowFrames = 0;
+        windowOverruns = 0;
+        headroomFrames = 0;
+    }
+
+    /**
+     * Record one rendered frame
+     *
+     * @param frameUs Time spent rendering and sending the frame (µs)
+     * @param late    true if the frame started a flicker step or more
+     *                behind schedule (the loop was held up elsewhere)
+     * @return true if the quality level changed
+     */
+    bool record(uint32_t frameUs, bool late)
+    {
+        bool overrun = late || frameUs > RENDER_DEADLINE_US;
+        if (overrun)
+        {
+            overruns++;
+            windowOverruns++;
+            headroomFrames = 0;
+        }
+        else if (frameUs <= RENDER_DEADLINE_US / 2)
+        {
+            headroomFrames++;
+        }
+        else
+        {
+            headroomFrames = 0;
+        }
+
+        if (windowOverruns >= QUALITY_DEGRADE_OVERRUNS)
+        {
+            windowFrames = 0;
+            windowOverruns = 0;
+            if (level < MAX_LEVEL)
+            {
+                level++;
+                degrades++;
+                return true;
+            }
+            return false;
+        }
+        if (++windowFrames >= QUALITY_WINDOW)
+        {
+            windowFrames = 0;
+            windowOverruns = 0;
+        }
+
+        if (level > QUALITY_FULL && headroomFrames >= QUALITY_RECOVER_FRAMES)
+        {
+            headroomFrames = 0;
+            level--;
+            recoveries++;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Printable name of a quality level
+     */
+    static const char *levelName(uint8_t level)
+    {
+        static const char *const NAMES[QUALITY_LEVEL_COUNT] = {"full", "reduced", "hold"};
+        return level < QUALITY_LEVEL_COUNT ? NAMES[level] : "?";
+    }
+
+private:
+    // Overruns are only counted when QUALITY_DEGRADATION is off
+    static const uint8_t MAX_LEVEL = QUALITY_DEGRADATION ? QUALITY_LEVEL_COUNT - 1 : QUALITY_FULL;
+
+    uint16_t windowFrames;   // Frames in the current degrade window
+    uint16_t windowOverruns; // Overruns in the current degrade window
+    uint16_t headroomFrames; // Consecutive frames within half the deadline
+};
+
+#endif // RENDERQUALITY_H
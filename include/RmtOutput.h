@@ -0,0 +1,100 @@
+/**
+ * @file RmtOutput.h
+ * @brief Double-buffered WS2812 output, one RMT channel per strip
+ *
+ * Used by LED_OUTPUT_FASTLED for strips set to CHIPSET_WS2812 in place
+ * of FastLED's clockless driver, whose showPixels() waits for the
+ * previous transmission to finish before it returns.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RMTOUTPUT_H
+#define RMTOUTPUT_H
+
+// Third-party libraries
+#include <Arduino.h>
+
+// Project headers
+#include "config.h"
+
+#if LED_OUTPUT == LED_OUTPUT_FASTLED
+
+#include <driver/rmt_tx.h>
+#include <soc/soc_caps.h>
+
+#include "Ws2812Frame.h"
+
+/**
+ * @class RmtOutput
+ * @brief Two frame buffers per WS2812 strip, sent without waiting
+ *
+ * show() packs the pixels into the strip's back buffer while the RMT
+ * bytes encoder may still be reading the front one. Like the I2S and
+ * SPI drivers it never blocks: if the channel is still sending the
+ * previous frame the new one is dropped (and counted), and the back
+ * buffer is simply overwritten next pass.
+ */
+class RmtOutput
+{
+public:
+    typedef Ws2812Frame<LED_LENGTH> Frame;
+
+    RmtOutput();
+
+    /**
+     * Set up the strip's RMT TX channel, bytes encoder and buffers
+     *
+     * @param strip   Strip index
+     * @param dataPin Data GPIO
+     * @return true on success
+     */
+    bool begin(int strip, int dataPin);
+
+    /**
+     * Pack RGB triples into the back buffer and start sending
+     *
+     * @param strip Strip index
+     * @param rgb   LED_LENGTH RGB triples (FastLED CRGB layout)
+     * @return false if the frame was dropped (previous frame busy)
+     */
+    bool show(int strip, const uint8_t *rgb);
+
+    uint32_t droppedFrames(int strip) const { return dropped[strip]; }
+
+private:
+    static bool IRAM_ATTR sent(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *event, void *busy);
+
+    Frame *frames[NUM_STRIPS]; // Two per strip, null for other chipsets
+    rmt_channel_handle_t channels[NUM_STRIPS];
+    rmt_encoder_handle_t encoders[NUM_STRIPS]; // Encoders keep per-send state
+    volatile bool busy[NUM_STRIPS];            // Cleared by the RMT interrupt
+    uint8_t back[NUM_STRIPS];                  // Index of the buffer being packed
+    uint32_t dropped[NUM_STRIPS];
+};
+
+static_assert(NUM_STRIPS <= SOC_RMT_TX_CANDIDATES_PER_GROUP, "WS2812 output needs one RMT TX channel per strip");
+
+#endif // LED_OUTPUT == LED_OUTPUT_FASTLED
+
+#endif // RMTOUTPUT_H
@@ -0,0 +1,243 @@
+/**
+ * @file Sequence.h
+ * @brief Stackless coroutines for timed light sequences
+ *
+ * Lets a timed sequence ("fade up, hold, blink 3 times, fade out") be
+ * written as straight-line code in one step function that the frame
+ * scheduler calls once per frame. Each SEQ_YIELD / SEQ_SLEEP returns
+ * from the function and records where to continue; the next call jumps
+ * straight back there. No stack is kept: anything that must survive a
+ * yield (loop counters, levels) lives in members, not locals.
+ *
+ *     bool Blink::step(uint32_t now)
+ *     {
+ *         SEQ_BEGIN(seq);
+ *         for (count = 0; count < 3; count++)
+ *         {
+ *             level = 255;
+ *             SEQ_SLEEP(seq, now, 300);
+ *             level = 0;
+ *             SEQ_SLEEP(seq, now, 300);
+ *         }
+ *         SEQ_END(seq);
+ *     }
+ *
+ * The step function returns true while the sequence is running. Each
+ * Sequence belongs to one step function. At most one SEQ_ macro per
+ * source line (resume points are named by line), and with the switch
+ * fallback no switch statements of its own.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SEQUENCE_H
+#define SEQUENCE_H
+
+#include <stdint.h>
+
+/*
+ * Resume points: GCC and clang store the address of a label and resume
+ * with one indirect jump (labels as values); other compilers fall back
+ * to a switch on the line number (Duff's device), which is why the
+ * fallback can't have a switch of its own inside the sequence. Define
+ * SEQ_LABELS 0 before including to force the fallback.
+ */
+#ifndef SEQ_LABELS
+#if defined(__GNUC__)
+#define SEQ_LABELS 1
+#else
+#define SEQ_LABELS 0
+#endif
+#endif
+
+// Label address or line number; the address is kept as an integer
+// because GCC 12's -Wdangling-pointer mistakes a stored label for one
+#if SEQ_LABELS
+typedef uintptr_t SeqResume;
+#else
+typedef int SeqResume;
+#endif
+
+/**
+ * @class Sequence
+ * @brief Where a step function continues, and its timer
+ */
+class Sequence
+{
+public:
+    SeqResume resume; // Resume point, 0 to start from the top
+    bool active;      // Between restart() and SEQ_END or stop()
+    uint32_t mark;    // millis() the current wait or ramp started
+
+    Sequence() : resume(0), active(false), mark(0) {}
+
+    /**
+     * Run from the top on the next step
+     */
+    void restart(uint32_t now)
+    {
+        resume = 0;
+        active = true;
+        mark = now;
+    }
+
+    /**
+     * Abandon the sequence; steps return false until restart()
+     */
+    void stop()
+    {
+        active = false;
+    }
+
+    /**
+     * Start timing a ramp (or anything else measured with elapsed())
+     */
+    void startTimer(uint32_t now)
+    {
+        mark = now;
+    }
+
+    /**
+     * Time since the current wait or startTimer() (ms)
+     */
+    uint32_t elapsed(uint32_t now) const
+    {
+        return now - mark;
+    }
+
+    /**
+     * Progress through a ramp of durationMs since startTimer(), 0-256
+     * 256 once complete, and at once for a zero-length ramp
+     */
+    uint16_t ramp(uint32_t now, uint32_t durationMs) const
+    {
+        uint32_t e = elapsed(now);
+        return e >= durationMs ? 256 : (uint16_t)(((uint64_t)e << 8) / durationMs);
+    }
+};
+
+#define SEQ_CAT_(a, b) a##b
+#define SEQ_CAT(a, b) SEQ_CAT_(a, b)
+#define SEQ_POINT SEQ_CAT(seqResume, __LINE__)
+
+#if SEQ_LABELS
+
+/**
+ * Start of a step function's body: continue where the last step left off
+ */
+#define SEQ_BEGIN(seq)                  \
+    do                                  \
+    {                                   \
+        if (!(seq).active)              \
+        {                               \
+            return false;               \
+        }                               \
+        if ((seq).resume)               \
+        {                               \
+            goto *(void *)(seq).resume; \
+        }                               \
+    } while (0)
+
+/**
+ * End of the body: the sequence is finished
+ */
+#define SEQ_END(seq)      \
+    (seq).active = false; \
+    return false
+
+/**
+ * Wait here until cond is true, checking once per step
+ */
+#define SEQ_WAIT_UNTIL(seq, cond)              \
+    do                                         \
+    {                                          \
+        (seq).resume = (uintptr_t)&&SEQ_POINT; \
+    SEQ_POINT:                                 \
+        if (!(cond))                           \
+        {                                      \
+            return true;                       \
+        }                                      \
+    } while (0)
+
+/**
+ * Hand the frame back; continue after this line on the next step
+ */
+#define SEQ_YIELD(seq)                         \
+    do                                         \
+    {                                          \
+        (seq).resume = (uintptr_t)&&SEQ_POINT; \
+        return true;                           \
+    SEQ_POINT:;                                \
+    } while (0)
+
+#else
+
+#define SEQ_BEGIN(seq)    \
+    if (!(seq).active)    \
+    {                     \
+        return false;     \
+    }                     \
+    switch ((seq).resume) \
+    {                     \
+    case 0:
+
+#define SEQ_END(seq)      \
+    default:              \
+        break;            \
+    }                     \
+    (seq).active = false; \
+    return false
+
+#define SEQ_WAIT_UNTIL(seq, cond) \
+    do                            \
+    {                             \
+        (seq).resume = __LINE__;  \
+    case __LINE__:                \
+        if (!(cond))              \
+        {                         \
+            return true;          \
+        }                         \
+    } while (0)
+
+#define SEQ_YIELD(seq)           \
+    do                           \
+    {                            \
+        (seq).resume = __LINE__; \
+        return true;             \
+    case __LINE__:;              \
+    } while (0)
+
+#endif // SEQ_LABELS
+
+/**
+ * Wait here for ms milliseconds, measured from the first step that
+ * reaches this line; now is the caller's millis() for the step
+ */
+#define SEQ_SLEEP(seq, now, ms)                                                \
+    do                                                                         \
+    {                                                                          \
+        (seq).mark = (now);                                                    \
+        SEQ_WAIT_UNTIL(seq, (uint32_t)((now) - (seq).mark) >= (uint32_t)(ms)); \
+    } while (0)
+
+#endif // SEQUENCE_H
@@ -0,0 +1,106 @@
+/**
+ * @file SpiDirectOutput.h
+ * @brief APA102 output from wire-format buffers over SPI DMA
+ *
+ * Each strip is one ESP32 SPI host (data on MOSI, clock on SCLK) sending
+ * an Apa102Frame as it stands: the render pass writes pixels straight
+ * into the frame, show() queues it for DMA. Selected with LED_OUTPUT =
+ * LED_OUTPUT_SPI_DIRECT.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SPIDIRECTOUTPUT_H
+#define SPIDIRECTOUTPUT_H
+
+// Third-party libraries
+#include <Arduino.h>
+
+// Project headers
+#include "config.h"
+
+#if LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+
+#include <driver/spi_master.h>
+
+#include "Apa102Frame.h"
+
+/**
+ * @class SpiDirectOutput
+ * @brief Double-buffered wire-format frames, one SPI DMA transfer per strip
+ *
+ * The render pass writes the back frames while DMA sends the front ones;
+ * show() swaps them. Like the I2S driver it never blocks: if a strip's
+ * previous transfer is still on the wire the frame is dropped (and
+ * counted) and the back frames are simply overwritten next pass.
+ */
+class SpiDirectOutput
+{
+public:
+    typedef Apa102Frame<LED_LENGTH> Frame;
+
+    SpiDirectOutput();
+
+    /**
+     * Set up one SPI bus and device per strip and the DMA frames
+     *
+     * @param dataPins  Data (MOSI) GPIO per strip
+     * @param clockPins Clock (SCLK) GPIO per strip
+     * @param clockHz   Bit clock frequency
+     * @return true on success
+     */
+    bool begin(const int *dataPins, const int *clockPins, uint32_t clockHz);
+
+    /**
+     * Frame the render pass writes for a strip (sent by the next show())
+     */
+    RENDER_INLINE Frame &frame(int strip) { return *frames[back][strip]; }
+
+    /**
+     * Frame a strip last sent
+     */
+    const Frame &shown(int strip) const { return *frames[back ^ 1][strip]; }
+
+    /**
+     * Queue the back frames of every strip and swap
+     *
+     * @return false if the frame was dropped (previous transfer busy)
+     */
+    bool show();
+
+    uint32_t droppedFrames() const { return dropped; }
+
+private:
+    spi_device_handle_t devices[NUM_STRIPS];
+    spi_transaction_t transactions[NUM_STRIPS];
+    bool inFlight[NUM_STRIPS];
+    Frame *frames[2][NUM_STRIPS]; // DMA-capable, word-aligned
+    int back;                     // Index of the frames being rendered
+    uint32_t dropped;             // Frames skipped because busy
+};
+
+static_assert(NUM_STRIPS <= 2, "SPI direct output has one ESP32 SPI host per strip, at most 2");
+
+#endif // LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+
+#endif // SPIDIRECTOUTPUT_H
@@ -0,0 +1,95 @@
+/**
+ * @file SyncLink.h
+ * @brief UDP multicast transport for multi-lamp flicker sync
+ *
+ * Sends the leader's beacon every SYNC_INTERVAL and feeds received
+ * beacons to a follower's SyncClock. Joins the multicast group whenever
+ * WiFi comes up; does nothing while the role is SYNC_ROLE_OFF. Uses a
+ * non-blocking lwIP socket and a member buffer, like RealtimeReceiver,
+ * so polling every loop() pass never touches the heap.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SYNCLINK_H
+#define SYNCLINK_H
+
+// Third-party libraries
+#include <Arduino.h>
+
+// Project headers
+#include "config.h"
+#include "FlickerSync.h"
+
+/**
+ * @class SyncLink
+ * @brief Beacon sender/receiver bound to one SyncClock
+ */
+class SyncLink
+{
+public:
+    SyncLink();
+
+    /**
+     * Send or receive beacons; call every loop() pass
+     *
+     * Socket work runs without the gate; it is only held while the
+     * clock is read or moved.
+     *
+     * @param clock The lamp's flicker step clock
+     * @param gate  Held by whoever else steps the clock (the frame pacer)
+     * @param now   Current time (ms)
+     */
+    void poll(SyncClock &clock, FrameGate &gate, uint32_t now);
+
+    /**
+     * Handle the "@s" serial command
+     *
+     * No arguments shows the sync state; "@s leader", "@s follower" and
+     * "@s off" change the role, "@s group <n>" and "@s offset <n>" the
+     * group and frame offset (not persisted).
+     *
+     * @param args  Command arguments after "@s"
+     * @param clock The lamp's flicker step clock
+     */
+    void command(const char *args, SyncClock &clock);
+
+private:
+    int sock;            // Multicast socket, -1 while not joined
+    uint8_t role;        // SYNC_ROLE_*
+    uint8_t group;       // Beacon group
+    bool joined;         // Multicast group joined on the current connection
+    bool joinFailed;     // Last join on this connection failed, retry later
+    uint32_t lastJoin;   // Time of the last join attempt (ms)
+    uint32_t lastSent;   // Time of the last beacon sent (ms)
+    uint32_t sent;       // Beacons sent
+    uint32_t received;   // Beacons accepted
+    uint32_t foreign;    // Beacons from another leader while leading
+    uint8_t buf[SYNC_PACKET_SIZE];
+
+    bool join();
+    void leave();
+    void setRole(uint8_t newRole);
+};
+
+#endif // SYNCLINK_H
@@ -0,0 +1,302 @@
+/**
+ * @file Timeline.h
+ * @brief Scoped span tracing for a Chrome / Perfetto timeline
+ *
+ * TIMELINE_SCOPE(span) at the top of a block records when the block
+ * started and how long it took. The spans go into a RAM ring of
+ * TIMELINE_CAPACITY entries, 8 bytes each, written lock-free like the
+ * crash trace (TraceLog.h). "@l" prints the ring as base64 between
+ * marker lines; scripts/timeline_json.py turns a serial capture into
+ * Chrome trace-event JSON. The host simulator writes that JSON directly.
+ *
+ * Spans nest by time, so the timeline shows HomeKit updates and frames
+ * inside the homeSpan.poll() that ran them. With TIMELINE_ENABLED at 0
+ * the markers compile to nothing.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "FlickerMath.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#else
+#include <time.h>
+#endif
+
+static_assert((TIMELINE_CAPACITY & (TIMELINE_CAPACITY - 1)) == 0, "TIMELINE_CAPACITY must be a power of two");
+
+// ============================================================================
+// SPANS
+// ============================================================================
+
+/**
+ * Instrumented blocks, stored in 7 bits
+ *
+ * scripts/timeline_json.py has the same list; keep the order in step.
+ */
+enum TimelineSpan : uint8_t
+{
+    TIMELINE_POLL = 0, // homeSpan.poll()
+    TIMELINE_LOOP,     // DEV_CandleLight::loop()
+    TIMELINE_UPDATE,   // DEV_CandleLight::update() (HomeKit write)
+    TIMELINE_BUTTON,   // handlePowerButton()
+    TIMELINE_RENDER,   // renderFrame()
+    TIMELINE_FLICKER,  // applyFlicker()
+    TIMELINE_SHOW,     // LedOutput::show()
+    TIMELINE_SPAN_COUNT
+};
+
+#define TIMELINE_MAX_DURATION 0xFFFFFFu // 24 bits of microseconds, ~16.7 s
+
+/**
+ * @struct TimelineEntry
+ * @brief One span, two 32-bit words
+ *
+ * The wire form is these two words, little-endian.
+ */
+struct TimelineEntry
+{
+    uint32_t start; // Start time (µs, low 32 bits)
+    uint32_t info;  // track << 31 | span << 24 | duration (µs, saturated)
+
+    uint32_t duration() const { return info & TIMELINE_MAX_DURATION; }
+    uint8_t span() const { return (info >> 24) & 0x7F; }
+    uint8_t track() const { return info >> 31; }
+};
+
+#define TIMELINE_WIRE_SIZE 8
+
+// ============================================================================
+// TIMELINE
+// ============================================================================
+
+/**
+ * @class Timeline
+ * @brief Ring of the most recent spans
+ */
+class Timeline
+{
+public:
+    /**
+     * Spans shorter than this are dropped (µs)
+     */
+    uint32_t minDuration;
+
+    Timeline() : minDuration(TIMELINE_MIN_US), head(0), paused(false) {}
+
+    /**
+     * Append one finished span
+     *
+     * One atomic add and two stores; safe from either core and inline
+     * so it can close a span on the IRAM render path.
+     *
+     * @param span  TimelineSpan
+     * @param track Core (device) or thread (host) it ran on, 0 or 1
+     * @param start Start time (µs)
+     * @param end   End time (µs)
+     */
+    RENDER_INLINE void record(uint8_t span, uint8_t track, uint32_t start, uint32_t end)
+    {
+        uint32_t duration = end - start;
+        if (paused || duration < minDuration)
+        {
+            return;
+        }
+        if (duration > TIMELINE_MAX_DURATION)
+        {
+            duration = TIMELINE_MAX_DURATION;
+        }
+        uint32_t n = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+        TimelineEntry &e = entries[n & (TIMELINE_CAPACITY - 1)];
+        e.start = start;
+        e.info = ((uint32_t)(track & 1) << 31) | ((uint32_t)(span & 0x7F) << 24) | duration;
+    }
+
+    /**
+     * Stop or resume recording (while the ring is being printed)
+     */
+    void pause(bool on) { paused = on; }
+
+    /**
+     * Discard all spans
+     */
+    void clear() { head = 0; }
+
+    /**
+     * Number of spans held (at most TIMELINE_CAPACITY)
+     */
+    uint32_t count() const
+    {
+        uint32_t n = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        return n > TIMELINE_CAPACITY ? TIMELINE_CAPACITY : n;
+    }
+
+    /**
+     * Visit held spans in the order they ended
+     *
+     * @param fn Called as fn(const TimelineEntry &)
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        uint32_t end = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        for (uint32_t n = end - count(); n != end; n++)
+        {
+            fn(entries[n & (TIMELINE_CAPACITY - 1)]);
+        }
+    }
+
+    /**
+     * Printable name of a span
+     */
+    static const char *spanName(uint8_t span)
+    {
+        static const char *const NAMES[TIMELINE_SPAN_COUNT] = {
+            "homeSpan.poll", "loop", "update", "handlePowerButton", "renderFrame", "applyFlicker", "show"};
+        return span < TIMELINE_SPAN_COUNT ? NAMES[span] : "?";
+    }
+
+    /**
+     * Pack one span in wire form (8 bytes, little-endian words)
+     */
+    static void encode(const TimelineEntry &e, uint8_t *out)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            out[k] = (e.start >> (8 * k)) & 0xFF;
+            out[4 + k] = (e.info >> (8 * k)) & 0xFF;
+        }
+    }
+
+    /**
+     * 64-bit time of a span start, given the clock when it was read
+     *
+     * Start times keep only 32 bits (71 minutes); every span in the ring
+     * is far younger than that, so its age recovers the full value.
+     */
+    static uint64_t unwrap(uint32_t start, uint64_t now)
+    {
+        return now - (uint32_t)((uint32_t)now - start);
+    }
+
+private:
+    TimelineEntry entries[TIMELINE_CAPACITY];
+    uint32_t head; // Spans recorded since the last clear
+    volatile bool paused;
+};
+
+/**
+ * Base64 (RFC 4648, padded) so binary spans survive a text serial log
+ *
+ * @param in     Bytes to encode
+ * @param length Number of bytes
+ * @param out    Room for 4 * ((length + 2) / 3) + 1 characters
+ * @return Characters written, excluding the terminating NUL
+ */
+static inline size_t timelineBase64(const uint8_t *in, size_t length, char *out)
+{
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t n = 0;
+    for (size_t i = 0; i < length; i += 3)
+    {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < length)
+            v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < length)
+            v |= in[i + 2];
+        out[n++] = ALPHABET[(v >> 18) & 0x3F];
+        out[n++] = ALPHABET[(v >> 12) & 0x3F];
+        out[n++] = i + 1 < length ? ALPHABET[(v >> 6) & 0x3F] : '=';
+        out[n++] = i + 2 < length ? ALPHABET[v & 0x3F] : '=';
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// ============================================================================
+// SCOPES
+// ============================================================================
+
+/**
+ * Global timeline, defined in Timeline.cpp (or by the simulator)
+ */
+extern Timeline timeline;
+
+#ifdef ARDUINO_ARCH_ESP32
+// esp_timer_get_time() runs from IRAM
+#define TIMELINE_NOW() ((uint32_t)esp_timer_get_time())
+#define TIMELINE_TRACK() ((uint8_t)xPortGetCoreID())
+#else
+static inline uint32_t timelineHostMicros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+#define TIMELINE_NOW() timelineHostMicros()
+#define TIMELINE_TRACK() ((uint8_t)0)
+#endif
+
+/**
+ * @class TimelineScope
+ * @brief Records a span from construction to the end of the block
+ */
+class TimelineScope
+{
+public:
+    RENDER_INLINE explicit TimelineScope(uint8_t span) : span(span), start(TIMELINE_NOW()) {}
+
+    RENDER_INLINE ~TimelineScope() { timeline.record(span, TIMELINE_TRACK(), start, TIMELINE_NOW()); }
+
+private:
+    uint8_t span;
+    uint32_t start;
+};
+
+#define TIMELINE_CAT2(a, b) a##b
+#define TIMELINE_CAT(a, b) TIMELINE_CAT2(a, b)
+
+#if TIMELINE_ENABLED
+#define TIMELINE_SCOPE(span) TimelineScope TIMELINE_CAT(timelineScope, __LINE__)(span)
+#else
+#define TIMELINE_SCOPE(span) ((void)0)
+#endif
+
+/**
+ * Handle the "@l" serial command ("@l" prints the spans, "@l clear" wipes)
+ *
+ * @param args Command arguments after "@l"
+ */
+void timelineCommand(const char *args);
+
+#endif // TIMELINE_H
@@ -0,0 +1,267 @@
+/**
+ * @file TraceLog.h
+ * @brief Crash-surviving event trace in RTC memory
+ *
+ * A fixed-size ring of compact, timestamped events (HomeKit writes,
+ * button presses, frame overruns, WiFi status, heap lows). On the ESP32
+ * the ring lives in RTC slow memory, which keeps its contents across
+ * software resets, panics and watchdog resets, so after an unexpected
+ * reboot "@t" shows what led up to it.
+ *
+ * Recording is lock-free: a writer reserves a sequence number with one
+ * atomic add and fills the slot it maps to. Each entry carries its own
+ * sequence number, so the order is recovered from the entries themselves
+ * on the next boot and no shared head pointer has to survive the reset.
+ *
+ * The ring logic is Arduino-free for the native tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TRACELOG_H
+#define TRACELOG_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "FlickerMath.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_timer.h>
+#endif
+
+static_assert((TRACE_CAPACITY & (TRACE_CAPACITY - 1)) == 0, "TRACE_CAPACITY must be a power of two");
+
+// ============================================================================
+// EVENTS
+// ============================================================================
+
+/**
+ * Trace event types, stored in one byte
+ */
+enum TraceEvent : uint8_t
+{
+    TRACE_BOOT = 1,      // a = reset reason
+    TRACE_HOMEKIT,       // a = power, b = brightness
+    TRACE_BUTTON,        // a = 0 short press, 1 long press
+    TRACE_FRAME_OVERRUN, // b = frame time (µs, saturated)
+    TRACE_FLICKER_STALL, // b = gap between flicker ticks (ms, saturated)
+    TRACE_STATUS,        // a = HomeSpan HS_STATUS
+    TRACE_HEAP_LOW,      // b = free heap (KB)
+    TRACE_NOTIFY,        // a = OverlayId
+    TRACE_SYNC,          // a = 1 hard resync to the leader, b = frame (low bits)
+    TRACE_CONTROL,       // a = ControlField mask, b = brightness
+    TRACE_QUALITY,       // a = new RenderQualityLevel, b = overruns so far (saturated)
+    TRACE_EVENT_COUNT
+};
+
+/**
+ * @struct TraceEntry
+ * @brief One event, three 32-bit words
+ *
+ * Written as whole words, the safe access width for RTC memory.
+ */
+struct TraceEntry
+{
+    uint32_t seq;  // Sequence number, 0 = never written
+    uint32_t time; // esp_timer time >> 10 (1.024 ms ticks)
+    uint32_t info; // event << 24 | a << 16 | b
+
+    uint8_t event() const { return info >> 24; }
+    uint8_t a() const { return (info >> 16) & 0xFF; }
+    uint16_t b() const { return info & 0xFFFF; }
+};
+
+/**
+ * @struct TraceBuffer
+ * @brief The ring as laid out in RTC memory
+ */
+struct TraceBuffer
+{
+    uint32_t magic; // TRACE_MAGIC once initialized
+    TraceEntry entries[TRACE_CAPACITY];
+};
+
+#define TRACE_MAGIC 0x54524345u // "TRCE"
+
+// ============================================================================
+// TRACE LOG
+// ============================================================================
+
+/**
+ * @class TraceLog
+ * @brief Lock-free writer and reader for a TraceBuffer
+ */
+class TraceLog
+{
+public:
+    TraceLog() : buf(nullptr), nextSeq(1) {}
+
+    /**
+     * Adopt a buffer, keeping its entries if it holds a valid trace
+     *
+     * Anything else (cold power-on, firmware with a different layout)
+     * is wiped. Continues numbering after the newest surviving entry.
+     *
+     * @param buffer Ring storage, normally in RTC_NOINIT memory
+     */
+    void attach(TraceBuffer *buffer)
+    {
+        buf = buffer;
+        if (buf->magic != TRACE_MAGIC)
+        {
+            clear();
+            return;
+        }
+
+        uint32_t newest = 0;
+        for (int i = 0; i < TRACE_CAPACITY; i++)
+        {
+            if (buf->entries[i].seq > newest)
+            {
+                newest = buf->entries[i].seq;
+            }
+        }
+        nextSeq = newest + 1;
+    }
+
+    /**
+     * Discard all entries
+     */
+    void clear()
+    {
+        if (buf)
+        {
+            memset(buf->entries, 0, sizeof(buf->entries));
+            buf->magic = TRACE_MAGIC;
+        }
+        nextSeq = 1;
+    }
+
+    /**
+     * Append one event
+     *
+     * One atomic add plus three word stores; safe from any task, and
+     * inline so it can be called on the IRAM render path.
+     */
+    RENDER_INLINE void record(uint8_t event, uint8_t a, uint16_t b, uint32_t time)
+    {
+        if (!buf)
+        {
+            return;
+        }
+        uint32_t seq = __atomic_fetch_add(&nextSeq, 1, __ATOMIC_RELAXED);
+        TraceEntry &e = buf->entries[seq & (TRACE_CAPACITY - 1)];
+        e.time = time;
+        e.info = ((uint32_t)event << 24) | ((uint32_t)a << 16) | b;
+        __atomic_store_n(&e.seq, seq, __ATOMIC_RELEASE); // Publish last
+    }
+
+    /**
+     * Visit surviving entries, oldest first
+     *
+     * @param fn Called as fn(const TraceEntry &)
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        if (!buf)
+        {
+            return;
+        }
+        uint32_t end = __atomic_load_n(&nextSeq, __ATOMIC_RELAXED);
+        uint32_t start = end > TRACE_CAPACITY ? end - TRACE_CAPACITY : 1;
+        for (uint32_t seq = start; seq < end; seq++)
+        {
+            const TraceEntry &e = buf->entries[seq & (TRACE_CAPACITY - 1)];
+            if (e.seq == seq)
+            {
+                fn(e);
+            }
+        }
+    }
+
+    /**
+     * Printable name of an event type
+     */
+    static const char *eventName(uint8_t event)
+    {
+        static const char *const NAMES[TRACE_EVENT_COUNT] = {
+            "?", "boot", "homekit", "button", "overrun", "stall", "status", "heap-low", "notify", "sync", "control", "quality"};
+        return event < TRACE_EVENT_COUNT ? NAMES[event] : "?";
+    }
+
+private:
+    TraceBuffer *buf;
+    uint32_t nextSeq; // Next sequence number to hand out
+};
+
+// ============================================================================
+// FIRMWARE HOOKS
+// ============================================================================
+
+/**
+ * Global trace, defined in TraceLog.cpp
+ */
+extern TraceLog traceLog;
+
+#ifdef ARDUINO_ARCH_ESP32
+// esp_timer_get_time() runs from IRAM; the shift avoids a 64-bit divide
+#define TRACE_NOW() ((uint32_t)(esp_timer_get_time() >> 10))
+#else
+#define TRACE_NOW() 0u
+#endif
+
+#if TRACE_ENABLED
+#define TRACE(event, a, b) traceLog.record((event), (uint8_t)(a), (uint16_t)(b), TRACE_NOW())
+#else
+#define TRACE(event, a, b) ((void)0)
+#endif
+
+/**
+ * Saturate a value into a trace entry's 16-bit argument
+ */
+RENDER_INLINE uint16_t traceClamp16(uint32_t value)
+{
+    return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+}
+
+/**
+ * Attach the RTC ring and record the boot (call once, early in setup())
+ */
+void traceBegin();
+
+/**
+ * Print the trace to serial, oldest first
+ */
+void traceDump();
+
+/**
+ * Handle the "@t" serial command ("@t" dumps, "@t clear" wipes)
+ *
+ * @param args Command arguments after "@t"
+ */
+void traceCommand(const char *args);
+
+#endif // TRACELOG_H
@@ -0,0 +1,121 @@
+/**
+ * @file Ws2812Frame.h
+ * @brief One strip's pixels in WS2812 wire order, plus the RMT bit symbols
+ *
+ * WS2812 has no clock line: each bit is a high pulse followed by a low
+ * pulse, long-high for a 1 and short-high for a 0, 24 bits per LED in
+ * G, R, B order, MSB first. The frame only holds the G, R, B bytes; the
+ * RMT bytes encoder turns each bit into WS2812_SYMBOL_0 or _1 while the
+ * channel sends, so sending it is a single rmt_transmit() of bytes[].
+ * Header-only and free of Arduino dependencies so the encoding runs in
+ * the native unit tests.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WS2812FRAME_H
+#define WS2812FRAME_H
+
+#include <stdint.h>
+
+#include "FlickerMath.h"
+
+// ============================================================================
+// BIT TIMING
+// ============================================================================
+
+#define WS2812_RMT_RESOLUTION_HZ 40000000 // 25 ns RMT ticks
+
+#define WS2812_T0H 16 // 0.40 us high for a 0
+#define WS2812_T0L 34 // 0.85 us low
+#define WS2812_T1H 32 // 0.80 us high for a 1
+#define WS2812_T1L 18 // 0.45 us low
+
+#define WS2812_BYTES_PER_LED 3
+
+/**
+ * RMT symbol word (rmt_symbol_word_t::val): duration0 in bits 0-14,
+ * level0 in bit 15, duration1 in bits 16-30, level1 in bit 31
+ */
+constexpr uint32_t ws2812Symbol(uint32_t high, uint32_t low)
+{
+    return high | (1u << 15) | (low << 16);
+}
+
+#define WS2812_SYMBOL_0 ws2812Symbol(WS2812_T0H, WS2812_T0L)
+#define WS2812_SYMBOL_1 ws2812Symbol(WS2812_T1H, WS2812_T1L)
+
+/**
+ * @struct Ws2812Frame
+ * @brief G, R, B bytes for one strip of NumLeds LEDs
+ *
+ * No reset symbol: the line idles low after the last bit, and frames go
+ * out OUTPUT_INTERVAL apart, far past the 50 us latch time.
+ *
+ * @tparam NumLeds LEDs on the strip
+ */
+template <int NumLeds>
+struct Ws2812Frame
+{
+    static const int BYTES = WS2812_BYTES_PER_LED * NumLeds;
+
+    uint8_t bytes[BYTES];
+
+    /**
+     * Put one pixel in place (safe on the IRAM render path)
+     */
+    RENDER_INLINE void set(int i, uint8_t r, uint8_t g, uint8_t b)
+    {
+        uint8_t *led = bytes + WS2812_BYTES_PER_LED * i;
+        led[0] = g;
+        led[1] = r;
+        led[2] = b;
+    }
+
+    /**
+     * Copy in packed RGB triples (FastLED CRGB layout), NumLeds of them
+     */
+    RENDER_INLINE void pack(const uint8_t *rgb)
+    {
+        for (int i = 0; i < NumLeds; i++)
+        {
+            set(i, rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+        }
+    }
+
+    /**
+     * Copy out packed RGB triples, e.g. for a preview of what was sent
+     */
+    void unpack(uint8_t *rgb) const
+    {
+        for (int i = 0; i < NumLeds; i++)
+        {
+            const uint8_t *led = bytes + WS2812_BYTES_PER_LED * i;
+            rgb[3 * i] = led[1];
+            rgb[3 * i + 1] = led[0];
+            rgb[3 * i + 2] = led[2];
+        }
+    }
+};
+
+#endif // WS2812FRAME_H
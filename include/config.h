@@ -35,13 +35,13 @@
 // HARDWARE PIN ASSIGNMENTS
 // ============================================================================
 
-// LED Strip 1 (APA102)
+// LED Strip 1
 #define STRIP1_DATA_PIN 26
-#define STRIP1_CLOCK_PIN 25
+#define STRIP1_CLOCK_PIN 25 // Unused for WS2812
 
-// LED Strip 2 (APA102)
+// LED Strip 2
 #define STRIP2_DATA_PIN 19
-#define STRIP2_CLOCK_PIN 18
+#define STRIP2_CLOCK_PIN 18 // Unused for WS2812
 
 // Control Pins
 #define STATUS_LED_PIN 22     // WiFi/HomeKit status indicator
@@ -55,6 +55,61 @@
 #define LED_LENGTH 8 // Number of LEDs per strip
 #define NUM_STRIPS 2 // Number of LED strips
 
+// ============================================================================
+// LED OUTPUT
+// ============================================================================
+
+/**
+ * LED chipset per strip
+ *
+ * CHIPSET_APA102: Clocked (data + clock), BGR order
+ * CHIPSET_SK9822: Clocked (data + clock), BGR order, APA102 look-alike
+ * CHIPSET_WS2812: Clockless (data only), GRB order, sent via ESP32 RMT
+ */
+#define CHIPSET_APA102 0
+#define CHIPSET_SK9822 1
+#define CHIPSET_WS2812 2
+
+#define STRIP1_CHIPSET CHIPSET_APA102
+#define STRIP2_CHIPSET CHIPSET_APA102
+#define STRIP_CHIPSETS {STRIP1_CHIPSET, STRIP2_CHIPSET}
+
+/**
+ * LED output driver
+ *
+ * LED_OUTPUT_FASTLED:      One driver per strip, chipset from STRIPn_CHIPSET:
+ *                          a FastLED controller for APA102/SK9822, an RMT
+ *                          channel with two encode buffers for WS2812
+ *                          (output time grows per clocked strip)
+ * LED_OUTPUT_I2S_PARALLEL: All strips (up to 16) clocked together from one
+ *                          I2S DMA buffer, so output time does not depend
+ *                          on NUM_STRIPS. Every strip's clock input must be
+ *                          wired to I2S_PARALLEL_CLOCK_PIN, and all strips
+ *                          must be APA102 or SK9822.
+ * LED_OUTPUT_SPI_DIRECT:   The render pass writes straight into APA102
+ *                          wire-format buffers (start frame, header, B, G,
+ *                          R, end frame); show() hands each strip's buffer
+ *                          to its own SPI DMA transfer, with no FastLED
+ *                          reorder/scale pass. Up to 2 strips (one per
+ *                          ESP32 SPI host), APA102 or SK9822.
+ */
+#define LED_OUTPUT_FASTLED 0
+#define LED_OUTPUT_I2S_PARALLEL 1
+#define LED_OUTPUT_SPI_DIRECT 2
+#define LED_OUTPUT LED_OUTPUT_FASTLED
+
+// Data pin (one I2S lane each) and clock pin per strip, in strip order
+#define STRIP_DATA_PINS {STRIP1_DATA_PIN, STRIP2_DATA_PIN}
+#define STRIP_CLOCK_PINS {STRIP1_CLOCK_PIN, STRIP2_CLOCK_PIN}
+
+// Shared clock line and bit rate for LED_OUTPUT_I2S_PARALLEL
+#define I2S_PARALLEL_CLOCK_PIN STRIP1_CLOCK_PIN
+#define I2S_PARALLEL_CLOCK_HZ 4000000
+
+// SPI bit rate and APA102 global brightness (0-31) for LED_OUTPUT_SPI_DIRECT
+#define SPI_DIRECT_CLOCK_HZ 4000000
+#define APA102_GLOBAL_BRIGHTNESS 31
+
 // ============================================================================
 // DEFAULT SETTINGS (Power-On State)
 // ============================================================================
@@ -90,6 +145,39 @@
  */
 #define UPDATE_INTERVAL 60
 
+/**
+ * Temporal upsampling
+ *
+ * Flicker synthesis runs every UPDATE_INTERVAL, but the strips are
+ * refreshed every OUTPUT_INTERVAL with frames linearly interpolated
+ * between the last two flicker steps (cheap 8-bit integer lerps).
+ * 8ms = 125 FPS output for the cost of 17 FPS synthesis. Set
+ * TEMPORAL_UPSAMPLING to 0 to hold each flicker step instead.
+ */
+#define TEMPORAL_UPSAMPLING 1
+#define OUTPUT_INTERVAL 8
+
+/**
+ * Crossfade length (milliseconds)
+ *
+ * Power on and off, the end of a real-time stream and the return from
+ * Identify blend between the two looks over this long instead of
+ * cutting. The candle keeps flickering through the fade. 0 = cut.
+ */
+#define CROSSFADE_MS 400
+
+/**
+ * Identify flash sequence
+ *
+ * White flashes when Identify is tapped in the Home app, stepped once
+ * per output frame rather than blocking the loop; the candle fades back
+ * in after the last one. IDENTIFY_RAMP_MS > 0 fades each flash up.
+ */
+#define IDENTIFY_FLASHES 3
+#define IDENTIFY_RAMP_MS 0
+#define IDENTIFY_ON_MS 300
+#define IDENTIFY_OFF_MS 300
+
 /**
  * Brightness variation range
  *
@@ -111,6 +199,334 @@
 #define FLICKER_HUE_MIN -8
 #define FLICKER_HUE_MAX 15
 
+// ============================================================================
+// RENDER PERFORMANCE
+// ============================================================================
+
+/**
+ * Place the render hot path in IRAM (ESP32 only)
+ *
+ * NVS writes, HomeSpan pairing storage and OTA disable the flash cache
+ * and leave it cold. With this set, flicker synthesis runs from IRAM
+ * with its data in DRAM so it does not wait on cache refills after
+ * those writes (no task runs while the cache is off). Set to 0 to
+ * reclaim IRAM.
+ */
+#define RENDER_IN_IRAM 1
+
+/**
+ * Frame pacer (ESP32 only)
+ *
+ * Mitigates loop() stalls. NVS writes (pairing storage, "@c save",
+ * "@v save") run on the HomeSpan task and hold up loop() for as long as
+ * they take: a few ms per entry, tens of ms when a page is erased. A
+ * task on the other core steps in once loop() is PACER_STALL_MS late
+ * and renders and shows frames itself at OUTPUT_INTERVAL, flicker steps
+ * and overlays included, until loop() is back. It runs from flash like
+ * loop() does, so it only gets to run between the individual flash
+ * operations, while the cache is on; with the cache off nothing runs.
+ * "@p nvs" measures the gaps. Set to 0 to leave all output to loop().
+ */
+#define FRAME_PACER 1
+#define PACER_STALL_MS (OUTPUT_INTERVAL + OUTPUT_INTERVAL / 2)
+
+/**
+ * Render deadline and quality degradation
+ *
+ * A frame that takes longer than RENDER_DEADLINE_US, or a flicker step
+ * that starts more than a step late, counts as an overrun. After
+ * QUALITY_DEGRADE_OVERRUNS overruns within QUALITY_WINDOW frames the
+ * candle drops one quality level:
+ * - reduced: alternate LEDs draw a new flicker target each step, and
+ *   steps missed during a stall are skipped rather than replayed
+ * - hold: as reduced, but a new step only every QUALITY_HOLD_STEPS;
+ *   output frames just hold the last step in between
+ * It climbs back one level after QUALITY_RECOVER_FRAMES frames in a row
+ * finish within half the deadline (250 frames = 2s at OUTPUT_INTERVAL).
+ * The default deadline leaves half of each output slot to HomeSpan.
+ * Set QUALITY_DEGRADATION to 0 to count overruns only.
+ */
+#define QUALITY_DEGRADATION 1
+#define RENDER_DEADLINE_US 4000
+#define QUALITY_WINDOW 32
+#define QUALITY_DEGRADE_OVERRUNS 4
+#define QUALITY_RECOVER_FRAMES 250
+#define QUALITY_HOLD_STEPS 4
+
+// ============================================================================
+// MULTI-LAMP SYNC
+// ============================================================================
+
+/**
+ * Flicker synchronization between lamps
+ *
+ * A leader multicasts a small beacon (seed, frame index, phase) every
+ * SYNC_INTERVAL; followers align their flicker clock to it and reseed
+ * the flicker generator per frame, so every lamp computes the same
+ * flicker locally. No frames are sent over the network.
+ */
+#define SYNC_ROLE_OFF 0
+#define SYNC_ROLE_LEADER 1
+#define SYNC_ROLE_FOLLOWER 2
+
+#define SYNC_ROLE SYNC_ROLE_OFF // Change at runtime with "@s"
+
+/**
+ * Lamps only follow beacons from their own group (1-255)
+ */
+#define SYNC_GROUP 1
+
+/**
+ * Flicker frames this lamp runs ahead of the leader
+ *
+ * 0 = identical flicker. Small offsets per lamp make the flame appear
+ * to travel across the room.
+ */
+#define SYNC_FRAME_OFFSET 0
+
+// Multicast group and UDP port for beacons
+#define SYNC_MULTICAST_ADDR 239, 255, 77, 7
+#define SYNC_PORT 45123
+
+/**
+ * Leader beacon interval and follower timeout (milliseconds)
+ */
+#define SYNC_INTERVAL 1000
+#define SYNC_TIMEOUT 5000
+
+/**
+ * Wait between attempts to join the multicast group after one fails
+ * (milliseconds), so a lamp without a usable socket doesn't retry on
+ * every loop() pass
+ */
+#define SYNC_JOIN_RETRY 2000
+
+/**
+ * Phase errors up to this many ms are slewed out, larger ones jump
+ */
+#define SYNC_SLEW_LIMIT 8
+
+// ============================================================================
+// REAL-TIME PIXEL INPUT
+// ============================================================================
+
+/**
+ * Accept pixel frames from a lighting console (DDP and E1.31)
+ *
+ * While frames arrive they replace the candle effect; the candle comes
+ * back REALTIME_TIMEOUT after the last packet, or as soon as an E1.31
+ * source terminates its stream. Pixels are numbered strip after strip,
+ * 3 bytes (R, G, B) each.
+ */
+#define REALTIME_ENABLED 0
+
+/**
+ * E1.31 universe to listen to (1-63999)
+ * Received both unicast and on its multicast group 239.255.<hi>.<lo>
+ */
+#define REALTIME_E131_UNIVERSE 1
+
+/**
+ * Fall back to the candle this long after the last packet (milliseconds)
+ */
+#define REALTIME_TIMEOUT 2500
+
+// ============================================================================
+// LOCAL CONTROL API
+// ============================================================================
+
+/**
+ * HTTP / WebSocket control on the local network, next to HomeKit
+ *
+ * GET/POST /api/state reads or changes power, hue, saturation and
+ * brightness (JSON); /ws accepts the same JSON as text messages and
+ * streams live LED previews as binary messages. Changes go through the
+ * same path as HomeKit writes and are reported back to HomeKit.
+ */
+#define CONTROL_API_ENABLED 0
+
+/**
+ * Server port (HomeSpan's HAP server already owns port 80)
+ */
+#define CONTROL_PORT 8080
+
+/**
+ * Largest accepted JSON request body or WebSocket message (bytes)
+ */
+#define CONTROL_JSON_MAX 256
+
+/**
+ * Simultaneous HTTP/WebSocket connections (sockets are shared with HAP)
+ */
+#define CONTROL_MAX_CLIENTS 3
+
+/**
+ * Minimum time between WebSocket frame previews (milliseconds)
+ */
+#define CONTROL_PREVIEW_INTERVAL 100
+
+// ============================================================================
+// MQTT BRIDGE
+// ============================================================================
+
+/**
+ * Publish state and metrics to an MQTT broker and accept commands
+ *
+ * Topics under MQTT_TOPIC_PREFIX:
+ * - <prefix>/state    lamp state JSON (retained)
+ * - <prefix>/metrics  frame timing and heap JSON
+ * - <prefix>/status   "online", or "offline" as the last will
+ * - <prefix>/set      commands, same JSON as the local control API
+ */
+#define MQTT_ENABLED 0
+
+/**
+ * Broker address (IP or DNS name), port and optional credentials
+ */
+#define MQTT_BROKER "192.168.1.2"
+#define MQTT_PORT 1883
+#define MQTT_USER ""
+#define MQTT_PASSWORD ""
+
+#define MQTT_TOPIC_PREFIX "aladdin-lamp"
+
+/**
+ * State changes are batched for this long before one publish
+ * (milliseconds), so a slider drag becomes a single message
+ */
+#define MQTT_PUBLISH_INTERVAL 250
+
+/**
+ * Metrics publish interval (milliseconds)
+ */
+#define MQTT_METRICS_INTERVAL 10000
+
+/**
+ * Keep-alive (seconds) and delay between reconnect attempts (milliseconds)
+ */
+#define MQTT_KEEPALIVE 30
+#define MQTT_RECONNECT_DELAY 5000
+
+// ============================================================================
+// HOMEKIT DIAGNOSTICS
+// ============================================================================
+
+/**
+ * Add a custom read-only HomeKit service with live performance counters
+ *
+ * Frame rate, worst frame time, dropped frames, free heap, uptime and
+ * reset reason, readable from Eve or any HAP browser (the Home app
+ * ignores custom services). Values are refreshed from the existing
+ * counters every DIAGNOSTICS_INTERVAL; reads are served from that cache.
+ */
+#define DIAGNOSTICS_ENABLED 0
+
+/**
+ * Refresh interval (milliseconds); each changed value raises one event
+ */
+#define DIAGNOSTICS_INTERVAL 10000
+
+// ============================================================================
+// NOTIFICATION OVERLAYS
+// ============================================================================
+
+/**
+ * Maximum simultaneous notification overlays
+ *
+ * Overlays (doorbell, timer, WiFi AP indicator) blend over the candle in
+ * the output pass. Slots are preallocated; when all are busy the lowest
+ * priority overlay gives way. Presets live in OverlayStack.h.
+ */
+#define OVERLAY_CAPACITY 4
+
+/**
+ * Show WiFi and pairing status on the main strips
+ *
+ * STATUS_LED_PIN sits inside the enclosure on most lamps. With this set,
+ * HomeSpan status changes also drive overlays: amber pulse while waiting
+ * to pair, blue shimmer while (re)connecting to WiFi, cyan pulse while
+ * the setup AP is up. They clear themselves once the lamp is paired and
+ * connected. Set to 0 to leave status on STATUS_LED_PIN only.
+ */
+#define STATUS_ON_STRIPS 1
+
+// ============================================================================
+// EFFECT PROGRAMS
+// ============================================================================
+
+/**
+ * Largest effect program (bytes, 4 per instruction)
+ *
+ * Uploaded programs replace the candle flicker; see EffectVM.h and
+ * scripts/fxasm.py. The loaded program lives in RAM and, once saved,
+ * in NVS.
+ */
+#define VM_MAX_CODE 256
+
+/**
+ * Instructions one flicker step may execute across all LEDs
+ *
+ * A program that loops too long stops here and the remaining LEDs keep
+ * their previous color. 4096 is about 0.3ms on the ESP32, 68 per LED.
+ */
+#define VM_STEP_BUDGET 4096
+
+/**
+ * Dispatch through a table of label addresses (GCC) instead of a switch
+ */
+#define VM_COMPUTED_GOTO 1
+
+// ============================================================================
+// CRASH TRACE
+// ============================================================================
+
+/**
+ * Record events to a ring buffer in RTC memory
+ *
+ * The ring survives resets and panics; dump it with "@t" after an
+ * unexpected reboot. Recording costs one atomic add and three stores.
+ */
+#define TRACE_ENABLED 1
+
+/**
+ * Trace ring size in entries (power of two, 12 bytes each)
+ *
+ * 128 entries use 1.5 KB of the 8 KB RTC slow memory.
+ */
+#define TRACE_CAPACITY 128
+
+/**
+ * Free heap below which new lows are traced (bytes)
+ */
+#define TRACE_HEAP_LOW_BYTES 32768
+
+// ============================================================================
+// TIMELINE
+// ============================================================================
+
+/**
+ * Record timed spans of the main loop (HomeSpan poll, HomeKit update,
+ * button, flicker, output) for a Chrome / Perfetto timeline
+ *
+ * "@l" prints the most recent spans in a compact binary form;
+ * scripts/timeline_json.py turns a serial capture of it into trace JSON.
+ * At 0 the TIMELINE_SCOPE() markers compile to nothing.
+ */
+#define TIMELINE_ENABLED 0
+
+/**
+ * Span ring size (power of two, 8 bytes each)
+ */
+#define TIMELINE_CAPACITY 1024
+
+/**
+ * Spans shorter than this are not recorded (microseconds)
+ *
+ * Idle loop() passes would otherwise push the frames out of the ring
+ * within a few milliseconds.
+ */
+#define TIMELINE_MIN_US 20
+
 // ============================================================================
 // BUTTON DEBOUNCING
 // ============================================================================
@@ -0,0 +1,221 @@
+"""
+@file check_iram.py
+@brief Post-build check that the IRAM render hot path never touches flash
+
+Functions marked RENDER_HOT (see include/FlickerMath.h) are linked into
+IRAM so they keep running while the flash cache is disabled. A single
+call from one of them into flash-resident code (Arduino random(), a
+FastLED helper, a libgcc soft-double routine) or a read of a const table
+left in flash (a switch jump table, a lookup table without RENDER_DATA)
+would undo that and crash or stall during NVS/OTA writes. This script
+disassembles the firmware ELF after linking and reports:
+
+- a direct call into the flash text window
+- an indirect call (callx) whose target, loaded with l32r from the
+  literal pool, is in flash
+- an indirect call whose target can't be resolved
+- a load through a pointer, loaded with l32r, into flash rodata
+
+Registers are tracked per function in straight-line order only: l32r
+sets one, mov and add/addx/addi carry it over, anything else that writes
+it forgets it, and calls, jumps and returns forget everything. Calls
+that may leave the hot path go in ALLOWED_CALLS with the reason.
+
+It also prints the IRAM the hot path costs (function sizes from the
+symbol table) next to the whole .iram0.text section.
+
+`custom_check_iram` in platformio.ini picks what a finding does: "warn"
+prints it, "error" fails the build. It stays at "warn" until the check
+has been run against a real firmware build and its findings fixed.
+
+Hooked up through `extra_scripts` in platformio.ini.
+
+@license MIT License
+Copyright (c) 2025 @outofjungle
+"""
+
+import re
+import struct
+import subprocess
+
+Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+
+# Symbols (demangled, prefix match) that make up the render hot path
+HOT_PATH_PREFIXES = (
+    "DEV_CandleLight::applyFlicker",  # FlickerEngine is inlined into it
+    "DEV_CandleLight::interpolateFrame",
+)
+
+# (caller prefix, callee prefix or None for an unresolved callx, reason).
+# Nothing on the hot path may leave IRAM today
+ALLOWED_CALLS = ()
+
+# ESP32 memory map: internal ROM and IRAM are safe with the cache off,
+# the cached flash text window (IROM) and rodata window (DROM) are not
+SAFE_RANGES = (
+    (0x40000000, 0x40070000),  # Internal ROM (memcpy, libgcc float helpers)
+    (0x40070000, 0x400C0000),  # IRAM (incl. cache-as-IRAM banks)
+)
+FLASH_RANGE = (0x400C2000, 0x40C00000)
+FLASH_DATA_RANGE = (0x3F400000, 0x3F800000)
+
+FUNC_RE = re.compile(r"^([0-9a-f]{8}) <(.+)>:$")
+INSN_RE = re.compile(r"^\s*[0-9a-f]+:\s+(?:[0-9a-f]{2}\s?)+\s+(\S+)\s*(.*)$")
+CALL_RE = re.compile(r"^call(?:0|4|8|12)$")
+CALLX_RE = re.compile(r"^callx(?:0|4|8|12)$")
+ADD_RE = re.compile(r"^(?:add|addx2|addx4|addx8|addi)(?:\.n)?$")
+LOAD_RE = re.compile(r"^l(?:8ui|16ui|16si|32i)(?:\.n)?$")
+TARGET_RE = re.compile(r"([0-9a-f]+)\s+<([^>]+)>")
+REG_RE = re.compile(r"^a(\d+)$")
+
+# First operand is read, not written
+NO_DEST_RE = re.compile(r"^(?:s8i|s16i|s32i|s32i\.n|s32e|b\w*|j|jx|call\w*|ret\w*|wsr\S*|nop\S*|memw|entry)$")
+
+
+def in_range(addr, rng):
+    return rng[0] <= addr < rng[1]
+
+
+class ElfImage:
+    """Just enough of an ELF32 little-endian reader to fetch literals"""
+
+    def __init__(self, path):
+        data = open(path, "rb").read()
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        headers = [struct.unpack_from("<IIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx][4]
+        self.sections = []
+        self.sizes = {}
+        for name, kind, _, addr, offset, size in headers:
+            label = data[names + name:data.index(b"\0", names + name)].decode()
+            self.sizes[label] = size
+            if addr and kind != 8:  # SHT_NOBITS has no file contents
+                self.sections.append((addr, size, data[offset:offset + size]))
+
+    def word(self, addr):
+        for start, size, contents in self.sections:
+            if start <= addr and addr + 4 <= start + size:
+                return struct.unpack_from("<I", contents, addr - start)[0]
+        return None
+
+
+def operands(text):
+    return [op.strip() for op in text.split(",")] if text else []
+
+
+def allowed(caller, callee):
+    for prefix, target, _ in ALLOWED_CALLS:
+        if caller.startswith(prefix) and (target is None if callee is None
+                                          else target is not None and callee.startswith(target)):
+            return True
+    return False
+
+
+def check_call(current, addr, name, errors, warnings):
+    if in_range(addr, FLASH_RANGE):
+        if not allowed(current, name):
+            errors.append("%s -> %s (0x%08x in flash)" % (current, name, addr))
+    elif not any(in_range(addr, r) for r in SAFE_RANGES):
+        warnings.append("%s -> %s (0x%08x unknown region)" % (current, name, addr))
+
+
+def check_iram(source, target, env):
+    elf = str(target[0])
+    mode = env.GetProjectOption("custom_check_iram", "warn")
+    objdump = env.subst("$OBJCOPY").replace("objcopy", "objdump")
+    listing = subprocess.run(
+        [objdump, "-d", "-C", "-j", ".iram0.text", elf],
+        check=True, capture_output=True, text=True).stdout
+    image = ElfImage(elf)
+
+    # Address -> name and size for every function, to name resolved callx
+    # targets (with -mlongcalls most calls are l32r + callx) and to add up
+    # what the hot path costs
+    nm = env.subst("$OBJCOPY").replace("objcopy", "nm")
+    symbols = {}
+    sizes = {}
+    for line in subprocess.run([nm, "-C", "-S", elf], check=True, capture_output=True, text=True).stdout.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) == 4 and fields[2] in "tTwW":
+            symbols[int(fields[0], 16)] = fields[3]
+            sizes[fields[3]] = int(fields[1], 16)
+
+    current = None
+    regs = {}
+    checked = set()
+    errors = []
+    warnings = []
+
+    for line in listing.splitlines():
+        m = FUNC_RE.match(line.strip())
+        if m:
+            name = m.group(2)
+            current = name if name.startswith(HOT_PATH_PREFIXES) else None
+            if current:
+                checked.add(current)
+            regs = {}
+            continue
+        if not current:
+            continue
+
+        insn = INSN_RE.match(line)
+        if not insn:
+            continue
+        mnemonic, args = insn.group(1), insn.group(2)
+        ops = operands(args.split("<")[0]) if "l32r" == mnemonic else operands(args)
+
+        if CALL_RE.match(mnemonic):
+            call = TARGET_RE.search(args)
+            if call:
+                check_call(current, int(call.group(1), 16), call.group(2), errors, warnings)
+            regs = {}
+        elif CALLX_RE.match(mnemonic):
+            addr = regs.get(ops[0]) if ops else None
+            if addr is None:
+                if not allowed(current, None):
+                    errors.append("%s: indirect call through %s cannot be resolved" % (current, args))
+            else:
+                check_call(current, addr, symbols.get(addr, "0x%08x" % addr), errors, warnings)
+            regs = {}
+        elif mnemonic in ("j", "jx") or mnemonic.startswith("ret"):
+            regs = {}
+        elif mnemonic == "l32r" and len(ops) == 2:
+            literal = TARGET_RE.search(args)
+            regs[ops[0]] = image.word(int(literal.group(1), 16)) if literal else None
+        elif mnemonic in ("mov", "mov.n") and len(ops) == 2:
+            regs[ops[0]] = regs.get(ops[1])
+        elif ADD_RE.match(mnemonic) and len(ops) == 3:
+            # Indexing a table keeps the pointer in the table's region,
+            # which is all the load check needs
+            regs[ops[0]] = regs.get(ops[1]) or regs.get(ops[2])
+        else:
+            if LOAD_RE.match(mnemonic) and len(ops) == 3:
+                base = regs.get(ops[1])
+                if base is not None and in_range(base + int(ops[2], 0), FLASH_DATA_RANGE):
+                    errors.append("%s: %s reads 0x%08x in flash rodata" % (current, mnemonic, base + int(ops[2], 0)))
+            if ops and REG_RE.match(ops[0]) and not NO_DEST_RE.match(mnemonic):
+                regs.pop(ops[0], None)
+
+    if not checked:
+        print("check_iram: no render hot path in IRAM (RENDER_IN_IRAM=0?), skipping")
+        return
+
+    cost = sum(sizes.get(name, 0) for name in checked)
+    print("check_iram: hot path uses %d bytes of IRAM (.iram0.text %d bytes)" %
+          (cost, image.sizes.get(".iram0.text", 0)))
+
+    for w in warnings:
+        print("check_iram: warning: " + w)
+    if errors:
+        for e in errors:
+            print("check_iram: %s: %s" % ("error" if mode == "error" else "warning", e))
+        print("check_iram: render hot path reaches flash, see include/FlickerMath.h")
+        if mode == "error":
+            env.Exit(1)
+        return
+
+    print("check_iram: %d hot path function(s) verified flash-free" % len(checked))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_iram)  # noqa: F821
@@ -0,0 +1,193 @@
+"""
+@file fxasm.py
+@brief Assemble an effect program for the lamp's bytecode VM
+
+Reads assembly source (file argument or stdin) and prints the serial
+commands that upload it:
+
+    @v begin
+    @v + <hex, up to 24 bytes per line>
+    @v end
+
+Paste them into the serial monitor, check the result with "@v" and keep
+it with "@v save". --hex prints the bare program bytes instead.
+
+Source is one instruction per line, "label:" before an instruction,
+"; comment" or "# comment". Instructions and operands are the ones in
+the VmOpcode comments of include/EffectVM.h, which this script reads,
+so it always matches the firmware next to it. Registers are r0-r15 or
+the input names led, count, time, frame, hue, sat, level (r0-r6).
+Numbers are decimal or 0x hex. Extras:
+
+    .equ NAME value      constant usable wherever a number is
+    li a, value          load any 32-bit value (ldi, plus ldhi if needed)
+
+Examples are in scripts/effects/.
+
+Usage:
+    python3 scripts/fxasm.py scripts/effects/rainbow.fxs
+    python3 scripts/fxasm.py --hex scripts/effects/rainbow.fxs
+
+@license MIT License
+Copyright (c) 2025 @outofjungle
+"""
+
+import argparse
+import os
+import re
+import sys
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include", "EffectVM.h")
+
+# Same as VM_REG_* in include/EffectVM.h
+REGISTER_NAMES = ("led", "count", "time", "frame", "hue", "sat", "level")
+
+# Hex characters per "@v +" line, kept short for the serial console
+LINE_HEX = 48
+
+
+class AsmError(Exception):
+    pass
+
+
+def read_opcodes(path):
+    """Map mnemonic -> (opcode, operand kinds) from the VmOpcode enum"""
+    source = open(path).read()
+    body = re.search(r"enum VmOpcode[^{]*\{(.*?)\};", source, re.S)
+    if not body:
+        sys.exit("%s: VmOpcode enum not found" % path)
+
+    opcodes = {}
+    for line in body.group(1).splitlines():
+        match = re.match(r"\s*OP_\w+(?:\s*=\s*\d+)?,\s*//\s*(\w+)([^:]*):", line)
+        if match:
+            operands = [kind.strip() for kind in match.group(2).split(",") if kind.strip()]
+            opcodes[match.group(1)] = (len(opcodes), operands)
+    return opcodes
+
+
+def number(text, constants):
+    if text in constants:
+        return constants[text]
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise AsmError("expected a number, got '%s'" % text)
+
+
+def register(text):
+    if text in REGISTER_NAMES:
+        return REGISTER_NAMES.index(text)
+    match = re.match(r"r(\d+)$", text)
+    if not match or int(match.group(1)) > 15:
+        raise AsmError("expected a register r0-r15, got '%s'" % text)
+    return int(match.group(1))
+
+
+def load_immediate(lineno, operands, constants):
+    """Expand li into ldi, plus ldhi when the value needs the high half"""
+    if len(operands) != 2:
+        raise AsmError("line %d: li takes a register and a value" % lineno)
+    value = number(operands[1], constants) & 0xFFFFFFFF
+    low = value & 0xFFFF
+    out = [(lineno, "ldi", [operands[0], str(low - 0x10000 if low & 0x8000 else low)])]
+    # ldi sign-extends, so the high half is only free if it matches
+    if value >> 16 != (0xFFFF if low & 0x8000 else 0):
+        out.append((lineno, "ldhi", [operands[0], str(value >> 16)]))
+    return out
+
+
+def parse(lines):
+    """Split source into (line number, mnemonic, operands), labels, constants"""
+    program = []
+    labels = {}
+    constants = {}
+    for lineno, line in enumerate(lines, 1):
+        line = re.split(r"[;#]", line, 1)[0].strip()
+        while True:
+            match = re.match(r"(\w+):\s*(.*)", line)
+            if not match:
+                break
+            labels[match.group(1)] = len(program)
+            line = match.group(2)
+        if not line:
+            continue
+        parts = line.split(None, 1)
+        mnemonic = parts[0].lower()
+        operands = [op.strip() for op in parts[1].split(",")] if len(parts) > 1 else []
+        if mnemonic == ".equ":
+            fields = parts[1].split() if len(parts) > 1 else []
+            if len(fields) != 2:
+                raise AsmError("line %d: .equ NAME value" % lineno)
+            constants[fields[0]] = number(fields[1], constants)
+        elif mnemonic == "li":
+            program += load_immediate(lineno, operands, constants)
+        else:
+            program.append((lineno, mnemonic, operands))
+    return program, labels, constants
+
+
+def assemble(lines, opcodes):
+    program, labels, constants = parse(lines)
+
+    code = bytearray()
+    for index, (lineno, mnemonic, operands) in enumerate(program):
+        if mnemonic not in opcodes:
+            raise AsmError("line %d: unknown instruction '%s'" % (lineno, mnemonic))
+        opcode, kinds = opcodes[mnemonic]
+        if len(operands) != len(kinds):
+            raise AsmError("line %d: %s takes %s" % (lineno, mnemonic, ", ".join(kinds) or "no operands"))
+
+        insn = [opcode, 0, 0, 0]
+        try:
+            for kind, text in zip(kinds, operands):
+                if kind in ("a", "b", "c"):
+                    insn[1 + "abc".index(kind)] = register(text)
+                    continue
+                if kind in ("label", "label8"):
+                    if text not in labels:
+                        raise AsmError("unknown label '%s'" % text)
+                    value = labels[text] - (index + 1)  # Relative to the next instruction
+                else:
+                    value = number(text, constants)
+                if kind in ("imm", "label"):
+                    if not -0x8000 <= value <= 0xFFFF:
+                        raise AsmError("'%s' does not fit 16 bits, use li" % text)
+                    insn[2] = value & 0xFF
+                    insn[3] = (value >> 8) & 0xFF
+                else:
+                    if not -128 <= value <= 127:
+                        raise AsmError("'%s' does not fit 8 bits" % text)
+                    insn[3] = value & 0xFF
+        except AsmError as error:
+            raise AsmError("line %d: %s" % (lineno, error))
+        code += bytes(insn)
+    return bytes(code)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Assemble a lamp effect program")
+    parser.add_argument("source", nargs="?", help="assembly file (default: stdin)")
+    parser.add_argument("--hex", action="store_true", help="print the program as one hex string")
+    args = parser.parse_args()
+
+    opcodes = read_opcodes(HEADER)
+    source = open(args.source) if args.source else sys.stdin
+    try:
+        code = assemble(source.read().splitlines(), opcodes)
+    except AsmError as error:
+        sys.exit("%s: %s" % (args.source or "stdin", error))
+
+    if args.hex:
+        print(code.hex())
+    else:
+        print("@v begin")
+        text = code.hex()
+        for start in range(0, len(text), LINE_HEX):
+            print("@v + " + text[start:start + LINE_HEX])
+        print("@v end")
+    sys.stderr.write("%d instructions, %d bytes\n" % (len(code) // 4, len(code)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,234 @@
+"""
+@file perf_gate.py
+@brief Performance regression gate: compare benchmark results across commits
+
+Builds the native benchmarks (sim/bench.cpp, `make bench-build`) for the
+working tree and for a base commit (checked out into a temporary git
+worktree), runs both binaries alternately so machine load hits them
+equally, and compares:
+
+- render timings: pooled median per benchmark; a regression must exceed
+  --time-threshold percent AND three standard errors of the difference
+  (estimated from the median absolute deviation), so noise alone never
+  fails the gate
+- memory footprint (render state and table sizes): exact, --size-threshold
+- with --firmware: flash and static RAM of the firmware ELF, as
+  `make size` reports them (needs PlatformIO), also --size-threshold
+
+Results are stored as .pio/perf/<commit>.json (a "-dirty" suffix marks
+uncommitted changes) so past runs can be inspected or diffed. Exits
+non-zero if anything regressed.
+
+Usage: python3 scripts/perf_gate.py [--base REF] [--runs N] [--firmware]
+
+@license MIT License
+Copyright (c) 2025 @outofjungle
+"""
+
+import argparse
+import json
+import math
+import os
+import platform
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PERF_DIR = os.path.join(ROOT, ".pio", "perf")
+
+# ELF section flags/types used to size the firmware image
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+def git(*args, cwd=ROOT):
+    return subprocess.run(["git"] + list(args), cwd=cwd, check=True,
+                          capture_output=True, text=True).stdout.strip()
+
+
+def tree_key():
+    """Commit of the working tree, marked dirty if tracked files changed"""
+    sha = git("rev-parse", "--short=12", "HEAD")
+    if git("status", "--porcelain", "--untracked-files=no"):
+        sha += "-dirty"
+    return sha
+
+
+def build_bench(tree, out_dir):
+    """Build sim/bench.cpp in a source tree; returns the binary path"""
+    os.makedirs(out_dir, exist_ok=True)
+    result = subprocess.run(["make", "-s", "-C", tree, "bench-build", "SIM_DIR=" + out_dir],
+                            capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write(result.stdout + result.stderr)
+        raise SystemExit("perf_gate: building benchmarks in %s failed "
+                         "(does that commit have `make bench-build`?)" % tree)
+    return os.path.join(out_dir, "bench")
+
+
+def run_bench(binary, metrics, args):
+    """One benchmark run, samples appended to metrics"""
+    out = subprocess.run([binary, "--repeat", str(args.repeat)], check=True,
+                         capture_output=True, text=True).stdout
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) < 4 or fields[0] not in ("time", "size"):
+            continue
+        kind, name, unit = fields[0], fields[1], fields[2]
+        entry = metrics.setdefault(name, {"kind": kind, "unit": unit, "samples": []})
+        entry["samples"].extend(float(v) for v in fields[3:])
+
+
+def elf_sizes(path):
+    """Flash image and static RAM of an ELF32 firmware, from its section headers"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF" or data[4] != 1:
+        raise SystemExit("perf_gate: %s is not an ELF32 file" % path)
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+
+    def header(i):
+        return struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize)
+
+    names_offset = header(shstrndx)[4]
+    flash = ram = iram = 0
+    for i in range(shnum):
+        name_ptr, sh_type, flags, _addr, _off, size = header(i)[:6]
+        if not flags & SHF_ALLOC:
+            continue
+        end = data.index(b"\0", names_offset + name_ptr)
+        name = data[names_offset + name_ptr:end].decode()
+        if sh_type != SHT_NOBITS:
+            flash += size
+        if name.startswith(".dram0"):
+            ram += size
+        elif name.startswith(".iram0"):
+            iram += size
+    return {"flash_bytes": flash, "dram_bytes": ram, "iram_bytes": iram}
+
+
+def build_firmware(tree, env):
+    """Build the firmware with PlatformIO; returns its section sizes"""
+    subprocess.run(["pio", "run", "-s", "-e", env, "-d", tree], check=True)
+    return elf_sizes(os.path.join(tree, ".pio", "build", env, "firmware.elf"))
+
+
+def median(values):
+    s = sorted(values)
+    n = len(s)
+    return s[n // 2] if n % 2 else (s[n // 2 - 1] + s[n // 2]) / 2.0
+
+
+def summarize(entry):
+    """Median and standard error of the median (robust, via MAD)"""
+    samples = entry["samples"]
+    mid = median(samples)
+    sigma = 1.4826 * median([abs(v - mid) for v in samples])
+    return mid, 1.253 * sigma / math.sqrt(len(samples))
+
+
+def save(key, metrics, args):
+    os.makedirs(PERF_DIR, exist_ok=True)
+    path = os.path.join(PERF_DIR, key + ".json")
+    with open(path, "w") as f:
+        json.dump({"commit": key, "time": time.strftime("%Y-%m-%dT%H:%M:%S"),
+                   "host": platform.node(), "compiler": os.environ.get("CXX", "c++"),
+                   "metrics": metrics}, f, indent=1, sort_keys=True)
+    return path
+
+
+def compare(base, head, args):
+    """Print a comparison table; returns the names that regressed"""
+    regressed = []
+    print("%-20s %12s %12s %9s  %s" % ("metric", "base", "head", "change", "verdict"))
+    for name in sorted(set(base) | set(head)):
+        if name not in base or name not in head:
+            print("%-20s %s" % (name, "new" if name in head else "removed"))
+            continue
+        b, h = base[name], head[name]
+        if h["kind"] == "time":
+            b_mid, b_err = summarize(b)
+            h_mid, h_err = summarize(h)
+            threshold = args.time_threshold
+            noise = 3.0 * math.sqrt(b_err ** 2 + h_err ** 2)
+        else:
+            b_mid, h_mid = b["samples"][0], h["samples"][0]
+            threshold = args.size_threshold
+            noise = 0.0
+        change = (h_mid - b_mid) * 100.0 / b_mid if b_mid else 0.0
+        if change > threshold and h_mid - b_mid > noise:
+            verdict = "REGRESSED"
+            regressed.append(name)
+        elif change < -threshold and b_mid - h_mid > noise:
+            verdict = "improved"
+        elif abs(h_mid - b_mid) <= noise and noise > 0:
+            verdict = "within noise"
+        else:
+            verdict = "ok"
+        print("%-20s %12.2f %12.2f %+8.1f%%  %s" % (name, b_mid, h_mid, change, verdict))
+    return regressed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[2])
+    parser.add_argument("--base", default=None,
+                        help="commit to compare against (default: HEAD, or HEAD~1 on a clean tree)")
+    parser.add_argument("--runs", type=int, default=3, help="alternating runs per side (default 3)")
+    parser.add_argument("--repeat", type=int, default=11, help="timed batches per benchmark per run")
+    parser.add_argument("--time-threshold", type=float, default=10.0,
+                        help="allowed timing increase, percent (default 10)")
+    parser.add_argument("--size-threshold", type=float, default=2.0,
+                        help="allowed size increase, percent (default 2)")
+    parser.add_argument("--firmware", action="store_true",
+                        help="also build both firmwares with PlatformIO and compare flash/RAM")
+    parser.add_argument("--env", default="pico32", help="PlatformIO environment for --firmware")
+    args = parser.parse_args()
+
+    head_key = tree_key()
+    base_ref = args.base or ("HEAD" if head_key.endswith("-dirty") else "HEAD~1")
+    base_key = git("rev-parse", "--short=12", base_ref)
+    print("perf_gate: %s against base %s (%s)" % (head_key, base_key, base_ref))
+
+    worktree = tempfile.mkdtemp(prefix="perf-base-")
+    git("worktree", "add", "--detach", worktree, base_key)
+    try:
+        build_dir = os.path.join(PERF_DIR, "build")
+        head_bin = build_bench(ROOT, os.path.join(build_dir, "head"))
+        base_bin = build_bench(worktree, os.path.join(build_dir, "base"))
+
+        head, base = {}, {}
+        for _ in range(args.runs):
+            run_bench(base_bin, base, args)
+            run_bench(head_bin, head, args)
+
+        if args.firmware:
+            for metrics, tree in ((base, worktree), (head, ROOT)):
+                for name, value in build_firmware(tree, args.env).items():
+                    metrics[name] = {"kind": "size", "unit": "bytes", "samples": [value]}
+    finally:
+        git("worktree", "remove", "--force", worktree)
+        shutil.rmtree(worktree, ignore_errors=True)
+
+    # Sizes are measured once per run; keep one value
+    for metrics in (head, base):
+        for entry in metrics.values():
+            if entry["kind"] == "size":
+                entry["samples"] = entry["samples"][:1]
+
+    print("Results: %s, %s" % (save(base_key, base, args), save(head_key, head, args)))
+    regressed = compare(base, head, args)
+    if regressed:
+        print("FAIL: regressed beyond threshold: %s" % ", ".join(regressed))
+        return 1
+    print("PASS: no regressions beyond %.0f%% (time) / %.0f%% (size)"
+          % (args.time_threshold, args.size_threshold))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
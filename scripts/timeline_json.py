@@ -0,0 +1,98 @@
+"""
+@file timeline_json.py
+@brief Convert the lamp's "@l" timeline dump to Chrome trace-event JSON
+
+Reads a serial log (file argument or stdin) containing one or more
+blocks printed by "@l":
+
+    TIMELINE BEGIN <esp_timer µs at dump> <span count>
+    <base64 lines, 8 bytes per span>
+    TIMELINE END
+
+and writes JSON for ui.perfetto.dev or chrome://tracing. Each span is
+two little-endian words: start time (low 32 bits of µs since boot) and
+track << 31 | span << 24 | duration µs. Spans repeated in later dumps
+are written once. Times are µs since boot, one thread per core.
+
+Usage:
+    pio device monitor | tee lamp.log      # then type @l
+    python3 scripts/timeline_json.py lamp.log > timeline.json
+
+@license MIT License
+Copyright (c) 2025 @outofjungle
+"""
+
+import base64
+import json
+import struct
+import sys
+
+# Same order as TimelineSpan in include/Timeline.h
+SPAN_NAMES = (
+    "homeSpan.poll",
+    "loop",
+    "update",
+    "handlePowerButton",
+    "renderFrame",
+    "applyFlicker",
+    "show",
+)
+
+
+def blocks(lines):
+    """Yield (now µs, raw bytes) for each complete dump in the log"""
+    now = None
+    data = []
+    for line in lines:
+        line = line.strip()
+        if line.startswith("TIMELINE BEGIN"):
+            now = int(line.split()[2])
+            data = []
+        elif line == "TIMELINE END" and now is not None:
+            yield now, base64.b64decode("".join(data))
+            now = None
+        elif now is not None:
+            data.append(line)
+
+
+def spans(now, raw):
+    """Decode one dump's spans with their full start times"""
+    for offset in range(0, len(raw) - len(raw) % 8, 8):
+        start, info = struct.unpack_from("<II", raw, offset)
+        age = (now - start) & 0xFFFFFFFF
+        yield now - age, info
+
+
+def main():
+    source = open(sys.argv[1], errors="replace") if len(sys.argv) > 1 else sys.stdin
+
+    seen = set()
+    events = [
+        {"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "Aladdin Lamp"}},
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": 0, "args": {"name": "core 0"}},
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": 1, "args": {"name": "core 1"}},
+    ]
+    for now, raw in blocks(source):
+        for start, info in spans(now, raw):
+            if (start, info) in seen:
+                continue
+            seen.add((start, info))
+            span = (info >> 24) & 0x7F
+            events.append({
+                "name": SPAN_NAMES[span] if span < len(SPAN_NAMES) else "span %d" % span,
+                "ph": "X",
+                "ts": start,
+                "dur": info & 0xFFFFFF,
+                "pid": 1,
+                "tid": info >> 31,
+            })
+
+    if len(seen) == 0:
+        sys.exit("no TIMELINE BEGIN ... TIMELINE END block found")
+    json.dump({"displayTimeUnit": "ms", "traceEvents": events}, sys.stdout)
+    sys.stdout.write("\n")
+    sys.stderr.write("%d spans\n" % len(seen))
+
+
+if __name__ == "__main__":
+    main()
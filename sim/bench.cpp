@@ -0,0 +1,385 @@
+/**
+ * @file bench.cpp
+ * @brief Native render benchmarks for the performance gate
+ *
+ * Times the lamp's render path on the host: the flicker engine alone,
+ * the warm-up replay, effect programs in the bytecode VM, and whole
+ * DEV_CandleLight::loop() passes (flicker step, interpolated output,
+ * overlay, crossfade, idle) built from the real CandleLight.cpp against
+ * the stand-ins in sim/host/. Also reports the
+ * static footprint of the render state and tables.
+ *
+ * Each benchmark first sizes a batch to about --batch-ms of work, then
+ * times --repeat batches. All samples are printed, so the caller can
+ * take medians and a noise estimate instead of trusting one run:
+ *
+ *   time <name> ns <sample> <sample> ...
+ *   size <name> bytes <value>
+ *
+ * scripts/perf_gate.py runs this for two commits and compares them.
+ * Host timings track the device only in relative terms; a change that
+ * doubles applyFlicker() here doubles it on the ESP32 too.
+ *
+ * Usage: bench [--repeat N] [--batch-ms MS] [--filter NAME]
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Apa102Frame.h"
+#include "CandleLight.h"
+#include "HostHal.h"
+#include "LedOutput.h"
+#include "Ws2812Frame.h"
+
+// What main.cpp provides on the device
+CRGB leds[NUM_STRIPS][LED_LENGTH];
+LedOutput ledOutput;
+
+static int repeat = 11;
+static double batchMs = 20.0;
+static const char *filter = NULL;
+
+// Keeps results alive so the optimizer can't drop the work
+static volatile uint32_t sink;
+
+static uint64_t hostNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// ============================================================================
+// HARNESS
+// ============================================================================
+
+/**
+ * Time body(iterations) in batches, print ns per iteration for each batch
+ */
+template <typename Body>
+static void timeIt(const char *name, Body body)
+{
+    if (filter && !strstr(name, filter))
+    {
+        return;
+    }
+
+    // Size the batch: double until it takes a measurable share of batchMs
+    uint32_t iterations = 1;
+    for (;;)
+    {
+        uint64_t start = hostNanos();
+        body(iterations);
+        uint64_t elapsed = hostNanos() - start;
+        if (elapsed >= batchMs * 1e6 / 4 || iterations >= (1u << 30))
+        {
+            iterations = (uint32_t)(iterations * (batchMs * 1e6 / (elapsed ? elapsed : 1)));
+            break;
+        }
+        iterations *= 2;
+    }
+    if (iterations < 1)
+    {
+        iterations = 1;
+    }
+
+    printf("time %s ns", name);
+    for (int r = 0; r < repeat; r++)
+    {
+        uint64_t start = hostNanos();
+        body(iterations);
+        printf(" %.2f", (double)(hostNanos() - start) / iterations);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+static void sizeOf(const char *name, size_t bytes)
+{
+    if (filter && !strstr(name, filter))
+    {
+        return;
+    }
+    printf("size %s bytes %u\n", name, (unsigned)bytes);
+}
+
+/**
+ * HomeKit write, committed like HomeSpan does
+ */
+static void write(DEV_CandleLight &lamp, SpanCharacteristic *c, int value)
+{
+    c->hostWrite(value);
+    if (lamp.update())
+    {
+        c->hostCommit();
+    }
+}
+
+/**
+ * A lamp switched on at full brightness, past its first frame and
+ * the fade in from black
+ */
+static DEV_CandleLight *litLamp()
+{
+    hostReset();
+    hostSetClock(1000000);
+    DEV_CandleLight *lamp = new DEV_CandleLight();
+    write(*lamp, lamp->power, 1);
+    write(*lamp, lamp->brightness, 100);
+    write(*lamp, lamp->hue, 25);
+    write(*lamp, lamp->saturation, 100);
+    for (int i = 0; i < 32 + CROSSFADE_MS / OUTPUT_INTERVAL; i++)
+    {
+        hostAdvance(OUTPUT_INTERVAL * 1000);
+        lamp->loop();
+    }
+    return lamp;
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+static void benchFlicker()
+{
+    FlickerEngine engine;
+    engine.rng.seed(1);
+
+    // One flicker step over every LED: the cost of applyFlicker()
+    timeIt("flicker_step", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            sink += engine.render(LED_LENGTH, 0.0f, 25, 100, true);
+        }
+    });
+
+    // Re-render of the last step (out-of-cycle frame)
+    timeIt("flicker_hold", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            sink += engine.render(LED_LENGTH - 1, 0.5f, 25, 100, false);
+        }
+    });
+
+    // Catch-up replay after a resync, 16 steps
+    timeIt("flicker_warmup16", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            engine.warmUp(1, i, 16);
+            sink += (uint32_t)engine.previousBrightness[i % LED_LENGTH];
+        }
+    });
+}
+
+/**
+ * Run an effect program over every LED: the cost of renderFrame()'s
+ * program path, to set against flicker_step
+ */
+static void benchProgram(const char *name, const uint8_t *program, size_t bytes)
+{
+    static EffectVM vm;
+    static EffectPixel pixels[LED_LENGTH];
+    int where;
+
+    if (vm.install(program, bytes, &where))
+    {
+        fprintf(stderr, "%s: rejected at instruction %d\n", name, where);
+        exit(1);
+    }
+    timeIt(name, [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            VmInputs in = {i * UPDATE_INTERVAL, i, i * 2654435761u, 25, 100, 100};
+            sink += vm.run(pixels, LED_LENGTH, in) + pixels[i % LED_LENGTH].r;
+        }
+    });
+}
+
+static void benchEffects()
+{
+    // scripts/effects/candle.fxs: noise flicker in the HomeKit color
+    static const uint8_t candle[] = {
+        VM_I(OP_NOISE, 7, VM_REG_TIME, VM_REG_LED), VM_IMM(OP_LDI, 8, 1), VM_I(OP_SHR, 7, 7, 8),
+        VM_I(OP_ADDI, 7, 7, 127), VM_I(OP_MUL, 7, 7, VM_REG_LEVEL), VM_IMM(OP_LDI, 8, 100),
+        VM_I(OP_DIV, 7, 7, 8), VM_IMM(OP_LDI, 9, 255), VM_I(OP_MUL, 10, VM_REG_HUE, 9),
+        VM_IMM(OP_LDI, 8, 360), VM_I(OP_DIV, 10, 10, 8), VM_I(OP_MUL, 11, VM_REG_SAT, 9),
+        VM_IMM(OP_LDI, 8, 100), VM_I(OP_DIV, 11, 11, 8), VM_I(OP_HSV, 10, 11, 7), VM_I(OP_END, 0, 0, 0)};
+
+    // scripts/effects/rainbow.fxs: scrolling hues, mostly plain arithmetic
+    static const uint8_t rainbow[] = {
+        VM_IMM(OP_LDI, 7, 4), VM_I(OP_SHR, 7, VM_REG_TIME, 7), VM_IMM(OP_LDI, 8, 32),
+        VM_I(OP_MUL, 9, VM_REG_LED, 8), VM_I(OP_ADD, 7, 7, 9), VM_IMM(OP_LDI, 8, 255),
+        VM_I(OP_AND, 7, 7, 8), VM_I(OP_MUL, 9, VM_REG_LEVEL, 8), VM_IMM(OP_LDI, 10, 100),
+        VM_I(OP_DIV, 9, 9, 10), VM_I(OP_HSV, 7, 8, 9), VM_I(OP_END, 0, 0, 0)};
+
+    benchProgram("vm_candle", candle, sizeof(candle));
+    benchProgram("vm_rainbow", rainbow, sizeof(rainbow));
+}
+
+/**
+ * Encode one strip per chipset: the CPU side of LedOutput::show(), the
+ * transfer itself runs from SPI DMA or the RMT interrupt
+ */
+static void benchOutput()
+{
+    static uint8_t pixels[LED_LENGTH * 3];
+    static Apa102Frame<LED_LENGTH> apa102;
+    static Ws2812Frame<LED_LENGTH> ws2812;
+
+    apa102.begin(31);
+    timeIt("encode_apa102", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            pixels[i % sizeof(pixels)] = i;
+            apa102.pack(pixels);
+            sink += apa102.bytes[i % sizeof(apa102.bytes)];
+        }
+    });
+
+    timeIt("encode_ws2812", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            pixels[i % sizeof(pixels)] = i;
+            ws2812.pack(pixels);
+            sink += ws2812.bytes[i % sizeof(ws2812.bytes)];
+        }
+    });
+}
+
+static void benchLoop()
+{
+    DEV_CandleLight *lamp = litLamp();
+
+    // Every pass is a flicker step: renderFrame + interpolate + show
+    timeIt("loop_flicker", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            hostAdvance(UPDATE_INTERVAL * 1000);
+            lamp->loop();
+        }
+    });
+
+    // Passes at the output rate: mostly interpolation, a step now and then
+    timeIt("loop_output", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            hostAdvance(OUTPUT_INTERVAL * 1000);
+            lamp->loop();
+        }
+    });
+
+    // Output passes with a notification overlay blended on top
+    timeIt("loop_overlay", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            if (lamp->overlays.numLayers == 0)
+            {
+                write(*lamp, lamp->notification, 1);
+            }
+            hostAdvance(OUTPUT_INTERVAL * 1000);
+            lamp->loop();
+        }
+    });
+
+    // Output passes with a crossfade from black always running
+    timeIt("loop_crossfade", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            if (!lamp->fade.ramping(millis()))
+            {
+                lamp->fadeFromBlack();
+            }
+            hostAdvance(OUTPUT_INTERVAL * 1000);
+            lamp->loop();
+        }
+    });
+
+    // Passes with nothing due: the early return HomeSpan polls thousands of times a second
+    timeIt("loop_idle", [&](uint32_t n) {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            hostAdvance(100);
+            lamp->loop();
+        }
+    });
+
+    delete lamp;
+    hostReset();
+}
+
+static void benchSizes()
+{
+    sizeOf("lamp_state", sizeof(DEV_CandleLight));
+    sizeOf("flicker_engine", sizeof(FlickerEngine));
+    sizeOf("overlay_stack", sizeof(OverlayStack));
+    sizeOf("crossfade", sizeof(Crossfade));
+    sizeOf("effect_vm", sizeof(EffectVM));
+    sizeOf("led_buffers", sizeof(leds));
+    sizeOf("ws2812_frame", sizeof(Ws2812Frame<LED_LENGTH>));
+    sizeOf("render_tables", sizeof(FLICKER_HUE_LUT) + sizeof(SATURATION_LUT) + sizeof(FLICKER_VALUE_LUT));
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+        {
+            repeat = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--batch-ms") == 0 && i + 1 < argc)
+        {
+            batchMs = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--repeat N] [--batch-ms MS] [--filter NAME]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeat < 1)
+    {
+        repeat = 1;
+    }
+
+    hostSetSerialEcho(false);
+    benchSizes();
+    benchFlicker();
+    benchEffects();
+    benchOutput();
+    benchLoop();
+    return 0;
+}
@@ -0,0 +1,861 @@
+/**
+ * @file fleet_sim.cpp
+ * @brief Host simulation of a fleet of lamps, stepped across all cores
+ *
+ * Instantiates thousands of virtual lamps, each with its own state,
+ * FlickerEngine and SyncClock, and steps them in virtual time on a
+ * work-stealing thread pool. Lamps are grouped: the first lamp of each
+ * group leads, the rest follow its beacons, and each group receives the
+ * same random control API commands (power, brightness, color), which
+ * every member parses with the firmware's parseControlCommand().
+ *
+ * Costs are uneven on purpose, as on real lamps: dark lamps skip the
+ * flicker, dim ones render few LEDs, and a lamp that jumps onto its
+ * leader's clock or comes back on replays SYNC_WARMUP_STEPS steps. Idle
+ * workers steal half of a busy worker's remaining chunks.
+ *
+ * Beacons and step hashes cross between lamps only from one step to the
+ * next, so a run's result does not depend on the number of threads. The
+ * fleet digest printed at the end must be the same for any --threads;
+ * --scaling checks that while it measures speedup.
+ *
+ * A locked follower must render its leader's flame on every step but
+ * one kind: for SYNC_WARMUP_STEPS after a command lights more LEDs.
+ * Render only steps lit LEDs, so a dark LED keeps the history it had,
+ * and a follower's warm-up after it jumped onto the clock stepped all
+ * of them while its leader's dark LEDs sat still. Newly lit LEDs start
+ * from different smoothing and agree once FLICKER_SMOOTHING has
+ * forgotten it, which is what SYNC_WARMUP_STEPS is sized for. Those
+ * steps are reported as settling; any other mismatch fails the run.
+ *
+ * Before the fleet runs, one VirtualLamp is checked against the real
+ * DEV_CandleLight built on the host stand-ins in sim/host/: same clock,
+ * same writes, and toFrame must come out identical on every step.
+ *
+ * Usage:
+ *   fleet_sim [--lamps N] [--steps N] [--threads N] [--chunk N]
+ *             [--group N] [--commands PERMILLE] [--seed N] [--scaling]
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+#include "config.h"
+#include "CandleLight.h"
+#include "ControlProtocol.h"
+#include "FlickerEngine.h"
+#include "FlickerSync.h"
+#include "HostHal.h"
+#include "LedOutput.h"
+
+// What main.cpp provides on the device, for the reference lamp
+CRGB leds[NUM_STRIPS][LED_LENGTH];
+LedOutput ledOutput;
+
+/**
+ * Nanoseconds on the host's monotonic clock
+ */
+static uint64_t hostNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// ============================================================================
+// WORK-STEALING POOL
+// ============================================================================
+
+/**
+ * @class StealingPool
+ * @brief Fixed set of threads running batches of numbered tasks
+ *
+ * Each batch is split into one contiguous range of task numbers per
+ * worker. A worker takes tasks from the front of its own range; once
+ * empty it steals the back half of another worker's. A range is one
+ * 64-bit word (begin << 32 | end), so both are a single compare-and-swap
+ * and no locks are taken. The calling thread works as worker 0.
+ */
+class StealingPool
+{
+public:
+    typedef std::function<void(uint32_t task)> Job;
+
+    explicit StealingPool(int threads)
+        : workers(threads), job(NULL), generation(0), active(0), remaining(0), stopping(false)
+    {
+        for (int w = 1; w < threads; w++)
+        {
+            pool.push_back(std::thread(&StealingPool::serve, this, w));
+        }
+    }
+
+    ~StealingPool()
+    {
+        stopping.store(true);
+        generation.fetch_add(1, std::memory_order_release);
+        for (size_t i = 0; i < pool.size(); i++)
+        {
+            pool[i].join();
+        }
+    }
+
+    int size() const { return (int)workers.size(); }
+
+    /**
+     * Run fn(0) .. fn(tasks - 1) across all workers, return when all are done
+     */
+    void run(uint32_t tasks, const Job &fn)
+    {
+        uint32_t n = workers.size();
+        job = &fn;
+        for (uint32_t w = 0; w < n; w++)
+        {
+            workers[w].range.store(pack(tasks * (uint64_t)w / n, tasks * (uint64_t)(w + 1) / n),
+                                   std::memory_order_relaxed);
+        }
+        remaining.store(tasks, std::memory_order_relaxed);
+        active.store(n - 1, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+
+        work(0);
+        while (active.load(std::memory_order_acquire) != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Totals over all workers and batches
+    uint64_t busyNs() const { return sum(&Worker::busyNs); }
+    uint64_t steals() const { return sum(&Worker::steals); }
+
+private:
+    struct Worker
+    {
+        std::atomic<uint64_t> range; // begin << 32 | end
+        uint64_t busyNs;             // Time spent in tasks
+        uint64_t steals;             // Ranges taken from other workers
+        char pad[40];                // Keep hot ranges on separate cache lines
+
+        Worker() : range(0), busyNs(0), steals(0) {}
+    };
+
+    std::vector<Worker> workers;
+    std::vector<std::thread> pool;
+    const Job *job;
+    std::atomic<uint32_t> generation; // Bumped to start a batch (or stop)
+    std::atomic<uint32_t> active;     // Helper threads still in the batch
+    std::atomic<uint32_t> remaining;  // Tasks not yet finished
+    std::atomic<bool> stopping;
+
+    static uint64_t pack(uint32_t begin, uint32_t end) { return (uint64_t)begin << 32 | end; }
+
+    uint64_t sum(uint64_t Worker::*field) const
+    {
+        uint64_t total = 0;
+        for (size_t w = 0; w < workers.size(); w++)
+        {
+            total += workers[w].*field;
+        }
+        return total;
+    }
+
+    /**
+     * Take the first task of a worker's own range
+     */
+    static bool pop(Worker &self, uint32_t &task)
+    {
+        uint64_t range = self.range.load(std::memory_order_acquire);
+        for (;;)
+        {
+            uint32_t begin = range >> 32, end = (uint32_t)range;
+            if (begin >= end)
+            {
+                return false;
+            }
+            if (self.range.compare_exchange_weak(range, pack(begin + 1, end), std::memory_order_acq_rel))
+            {
+                task = begin;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Move the back half of some other worker's range into ours
+     *
+     * Only called with our own range empty, so storing into it cannot
+     * lose tasks: other thieves see it empty until then and skip it.
+     */
+    bool steal(uint32_t w)
+    {
+        uint32_t n = workers.size();
+        for (uint32_t k = 1; k < n; k++)
+        {
+            Worker &victim = workers[(w + k) % n];
+            uint64_t range = victim.range.load(std::memory_order_acquire);
+            for (;;)
+            {
+                uint32_t begin = range >> 32, end = (uint32_t)range;
+                if (begin >= end)
+                {
+                    break;
+                }
+                uint32_t split = end - (end - begin + 1) / 2;
+                if (victim.range.compare_exchange_weak(range, pack(begin, split), std::memory_order_acq_rel))
+                {
+                    workers[w].range.store(pack(split, end), std::memory_order_release);
+                    workers[w].steals++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void work(uint32_t w)
+    {
+        Worker &self = workers[w];
+        uint32_t task;
+        while (remaining.load(std::memory_order_acquire) != 0)
+        {
+            if (pop(self, task))
+            {
+                uint64_t start = hostNanos();
+                (*job)(task);
+                self.busyNs += hostNanos() - start;
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            else if (!steal(w))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void serve(uint32_t w)
+    {
+        uint32_t seen = 0;
+        for (;;)
+        {
+            uint32_t current;
+            while ((current = generation.load(std::memory_order_acquire)) == seen)
+            {
+                std::this_thread::yield();
+            }
+            seen = current;
+            if (stopping.load())
+            {
+                return;
+            }
+            work(w);
+            active.fetch_sub(1, std::memory_order_release);
+        }
+    }
+};
+
+// ============================================================================
+// VIRTUAL LAMPS
+// ============================================================================
+
+/**
+ * One lamp: what DEV_CandleLight keeps between frames, minus the strips
+ */
+struct VirtualLamp
+{
+    FlickerEngine engine;
+    SyncClock clock;
+    ControlState state;
+    uint32_t lastBeacon; // Leader: time of the last beacon sent (ms)
+    uint32_t digest;     // FNV-1a over every step's flame
+    uint32_t rendered;   // Flicker steps rendered
+    uint32_t replayed;   // Steps replayed by warmUp()
+    uint32_t commands;   // Control commands applied
+    uint32_t matched;    // Follower: steps identical to the leader's
+    uint32_t settling;   // Follower: locked steps that were not, newly lit LEDs settling
+    uint32_t differed;   // Follower: locked steps that were not, for any other reason
+    uint32_t litRaised;  // Step a command last lit more LEDs
+};
+
+/**
+ * LEDs a lamp in this state lights, as DEV_CandleLight::renderFrame()
+ * counts them (0 if the lamp is dark)
+ */
+static int litLEDs(const ControlState &state, int &fullLEDs, float &fraction)
+{
+    float numLEDsFloat = state.brightness * LED_LENGTH / 100.0f;
+    fullLEDs = (int)numLEDsFloat;
+    fraction = numLEDsFloat - fullLEDs;
+    if (!state.power || (fullLEDs == 0 && fraction < 0.01f))
+    {
+        return 0;
+    }
+    return fraction > 0.01f && fullLEDs < LED_LENGTH ? fullLEDs + 1 : fullLEDs;
+}
+
+/**
+ * One flicker step into lamp.engine.flame, as DEV_CandleLight::renderFrame() does it
+ *
+ * @return LEDs lit, 0 if the lamp is dark (nothing stepped)
+ */
+static int renderFlame(VirtualLamp &lamp)
+{
+    int fullLEDs;
+    float fraction;
+    if (litLEDs(lamp.state, fullLEDs, fraction) == 0)
+    {
+        return 0;
+    }
+
+    SyncClock &clock = lamp.clock;
+    int replay = clock.catchUpSteps();
+    lamp.engine.warmUp(clock.seed, clock.frame + clock.frameOffset, replay);
+    lamp.engine.rng.seed(clock.stepSeed());
+    lamp.replayed += replay;
+    return lamp.engine.render(fullLEDs, fraction, lamp.state.hue, lamp.state.saturation, true);
+}
+
+/**
+ * A beacon in flight from a group's leader to its followers
+ */
+struct FleetBeacon
+{
+    SyncPacket packet;
+    uint32_t sentAt; // Virtual time (ms)
+    uint32_t step;   // Fleet step it was sent in
+};
+
+/**
+ * @class Fleet
+ * @brief All lamps plus the state they share between steps
+ *
+ * Lamp i belongs to group i / groupSize and leads it if it is the
+ * group's first lamp. Within a step a lamp touches only its own state
+ * and the previous step's beacons and hashes, so lamps can be stepped
+ * in any order on any thread.
+ */
+class Fleet
+{
+public:
+    Fleet(uint32_t count, uint32_t groupSize, uint32_t commandPermille, uint32_t seed)
+        : lamps(count), groupSize(groupSize), commandPermille(commandPermille), seed(seed)
+    {
+        uint32_t groups = (count + groupSize - 1) / groupSize;
+        for (int k = 0; k < 2; k++)
+        {
+            beacons[k].resize(groups);
+            stepHash[k].assign(count, 0);
+            for (uint32_t g = 0; g < groups; g++)
+            {
+                beacons[k][g].step = UINT32_MAX;
+            }
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            VirtualLamp &lamp = lamps[i];
+            lamp.clock.begin(frameSeed(seed, i), 0);
+            lamp.state.power = true;
+            lamp.state.hue = DEFAULT_HUE;
+            lamp.state.saturation = DEFAULT_SATURATION;
+            lamp.state.brightness = DEFAULT_BRIGHTNESS;
+            lamp.lastBeacon = 0 - SYNC_INTERVAL;
+            lamp.digest = 2166136261u;
+            lamp.rendered = lamp.replayed = lamp.commands = 0;
+            lamp.matched = lamp.settling = lamp.differed = 0;
+            lamp.litRaised = 0 - SYNC_WARMUP_STEPS - 1;
+        }
+    }
+
+    uint32_t size() const { return lamps.size(); }
+    const VirtualLamp &lamp(uint32_t i) const { return lamps[i]; }
+
+    /**
+     * Advance lamp i through fleet step t (one UPDATE_INTERVAL)
+     */
+    void step(uint32_t i, uint32_t t)
+    {
+        VirtualLamp &lamp = lamps[i];
+        uint32_t now = (t + 1) * UPDATE_INTERVAL;
+        uint32_t group = i / groupSize;
+        uint32_t leader = group * groupSize;
+        bool synced = groupSize > 1;
+        int prev = (t + 1) & 1, cur = t & 1;
+
+        // Did the last step show the same flame as the leader's?
+        if (synced && i != leader && t > 0 && lamp.clock.locked)
+        {
+            uint32_t mine = stepHash[prev][i], theirs = stepHash[prev][leader];
+            if (mine && theirs)
+            {
+                if (mine == theirs)
+                    lamp.matched++;
+                else if (t - 1 - lamp.litRaised < SYNC_WARMUP_STEPS)
+                    lamp.settling++;
+                else
+                    lamp.differed++;
+            }
+        }
+
+        int fullLEDs;
+        float fraction;
+        int lit = litLEDs(lamp.state, fullLEDs, fraction);
+        applyCommand(lamp, group, t);
+        if (litLEDs(lamp.state, fullLEDs, fraction) > lit)
+        {
+            lamp.litRaised = t;
+        }
+
+        // Beacons arrive one step after they are sent, stamped with the
+        // send time so transit takes no virtual time
+        const FleetBeacon &beacon = beacons[prev][group];
+        if (synced && i != leader && t > 0 && beacon.step == t - 1)
+        {
+            lamp.clock.follow(beacon.packet, SYNC_GROUP, beacon.sentAt);
+        }
+
+        stepHash[cur][i] = lamp.clock.tick(now) ? render(lamp) : 0;
+
+        if (synced && i == leader && now - lamp.lastBeacon >= SYNC_INTERVAL)
+        {
+            FleetBeacon &out = beacons[cur][group];
+            out.packet = lamp.clock.beacon(SYNC_GROUP, now);
+            out.sentAt = now;
+            out.step = t;
+            lamp.lastBeacon = now;
+        }
+    }
+
+private:
+    std::vector<VirtualLamp> lamps;
+    std::vector<FleetBeacon> beacons[2]; // Per group, by step parity
+    std::vector<uint32_t> stepHash[2];   // Per lamp, by step parity (0 = dark)
+    uint32_t groupSize;
+    uint32_t commandPermille;
+    uint32_t seed;
+
+    /**
+     * Maybe deliver this step's command for the group, as JSON
+     *
+     * Derived from (seed, group, step) alone, so every member gets the
+     * same one no matter which thread steps it.
+     */
+    void applyCommand(VirtualLamp &lamp, uint32_t group, uint32_t t)
+    {
+        uint32_t r = frameSeed(seed ^ (group * 0x85EBCA6Bu), t);
+        if (r % 1000 >= commandPermille)
+        {
+            return;
+        }
+
+        char json[64];
+        int length;
+        switch ((r >> 10) % 4)
+        {
+        case 0:
+            length = snprintf(json, sizeof(json), "{\"power\":%s}", (r >> 12) % 4 ? "true" : "false");
+            break;
+        case 1:
+            length = snprintf(json, sizeof(json), "{\"brightness\":%u}", (unsigned)((r >> 12) % 101));
+            break;
+        case 2:
+            length = snprintf(json, sizeof(json), "{\"hue\":%u,\"saturation\":%u}",
+                              (unsigned)((r >> 12) % 361), (unsigned)((r >> 21) % 101));
+            break;
+        default:
+            length = snprintf(json, sizeof(json), "{\"power\":true,\"brightness\":%u}",
+                              (unsigned)(20 + (r >> 12) % 81));
+            break;
+        }
+
+        ControlCommand cmd;
+        if (!parseControlCommand(json, length, cmd))
+        {
+            return;
+        }
+        if (cmd.fields & CONTROL_POWER)
+            lamp.state.power = cmd.power;
+        if (cmd.fields & CONTROL_HUE)
+            lamp.state.hue = cmd.hue;
+        if (cmd.fields & CONTROL_SATURATION)
+            lamp.state.saturation = cmd.saturation;
+        if (cmd.fields & CONTROL_BRIGHTNESS)
+            lamp.state.brightness = cmd.brightness;
+        lamp.commands++;
+    }
+
+    /**
+     * One flicker step, hashed
+     *
+     * @return Hash of the step's flame (never 0), or 0 if the lamp is dark
+     */
+    static uint32_t render(VirtualLamp &lamp)
+    {
+        int lit = renderFlame(lamp);
+        if (lit == 0)
+        {
+            return 0;
+        }
+
+        uint32_t h = 2166136261u;
+        for (int i = 0; i < lit; i++)
+        {
+            const uint8_t bytes[3] = {lamp.engine.flame[i].h, lamp.engine.flame[i].s, lamp.engine.flame[i].v};
+            for (int k = 0; k < 3; k++)
+            {
+                h = (h ^ bytes[k]) * 16777619u;
+            }
+        }
+        h = h ? h : 1;
+
+        lamp.digest = (lamp.digest ^ h) * 16777619u;
+        lamp.rendered++;
+        return h;
+    }
+};
+
+// ============================================================================
+// REFERENCE CHECK
+// ============================================================================
+
+/**
+ * Write one characteristic the way HomeSpan does
+ */
+static void writeCharacteristic(DEV_CandleLight &real, SpanCharacteristic *c, int value)
+{
+    c->hostWrite(value);
+    if (real.update())
+    {
+        c->hostCommit();
+    }
+}
+
+/**
+ * Step one VirtualLamp next to the real lamp accessory through random
+ * brightness, hue and saturation writes (dark and partly lit LEDs
+ * included) and compare toFrame after every flicker step. Power stays
+ * on: the real lamp keeps rendering while it fades out, which a fleet
+ * lamp doesn't model.
+ *
+ * @return true if every step matched
+ */
+static bool matchesRealLamp(uint32_t seed, uint32_t steps)
+{
+    hostReset();
+    hostSetClock(1000000);
+    DEV_CandleLight *real = new DEV_CandleLight();
+    writeCharacteristic(*real, real->power, 1);
+
+    VirtualLamp lamp = VirtualLamp();
+    lamp.clock = real->syncClock;
+    lamp.state.power = true;
+    lamp.state.hue = real->hue->getVal();
+    lamp.state.saturation = real->saturation->getVal();
+    lamp.state.brightness = real->brightness->getVal();
+
+    bool ok = true;
+    uint32_t compared = 0;
+    for (uint32_t t = 0; ok && compared < steps; t++)
+    {
+        uint32_t r = frameSeed(seed, t);
+        if (r % 200 == 0)
+        {
+            switch ((r >> 8) % 3)
+            {
+            case 0:
+                lamp.state.brightness = (r >> 10) % 101;
+                writeCharacteristic(*real, real->brightness, lamp.state.brightness);
+                break;
+            case 1:
+                lamp.state.hue = (r >> 10) % 361;
+                writeCharacteristic(*real, real->hue, lamp.state.hue);
+                break;
+            default:
+                lamp.state.saturation = (r >> 10) % 101;
+                writeCharacteristic(*real, real->saturation, lamp.state.saturation);
+                break;
+            }
+        }
+
+        hostAdvance(1000);
+        uint32_t frame = real->syncClock.frame;
+        real->loop();
+        if (!lamp.clock.tick(millis()))
+        {
+            continue;
+        }
+
+        CRGB expected[LED_LENGTH];
+        fill_solid(expected, LED_LENGTH, CRGB::Black);
+        int lit = renderFlame(lamp);
+        for (int i = 0; i < lit; i++)
+        {
+            expected[i] = CHSV(lamp.engine.flame[i].h, lamp.engine.flame[i].s, lamp.engine.flame[i].v);
+        }
+
+        compared++;
+        if (real->syncClock.frame == frame || real->syncClock.frame != lamp.clock.frame)
+        {
+            printf("reference: step %u, real lamp at frame %u, virtual at %u\n", (unsigned)compared,
+                   (unsigned)real->syncClock.frame, (unsigned)lamp.clock.frame);
+            ok = false;
+        }
+        else if (memcmp(expected, real->toFrame, sizeof(expected)) != 0)
+        {
+            printf("reference: step %u (brightness %d, hue %d, saturation %d): toFrame differs from "
+                   "DEV_CandleLight\n",
+                   (unsigned)compared, lamp.state.brightness, lamp.state.hue, lamp.state.saturation);
+            ok = false;
+        }
+    }
+
+    delete real;
+    hostReset();
+    if (ok)
+    {
+        printf("reference: %u steps, toFrame identical to DEV_CandleLight\n", (unsigned)compared);
+    }
+    return ok;
+}
+
+// ============================================================================
+// RUNS
+// ============================================================================
+
+struct FleetOptions
+{
+    uint32_t lamps;
+    uint32_t steps;
+    uint32_t chunk;
+    uint32_t groupSize;
+    uint32_t commandPermille;
+    uint32_t seed;
+};
+
+struct FleetResult
+{
+    int threads;
+    uint64_t wallNs;
+    uint64_t busyNs;
+    uint64_t steals;
+    uint64_t rendered;
+    uint64_t replayed;
+    uint64_t commands;
+    uint64_t matched;
+    uint64_t settling;
+    uint64_t differed;
+    uint32_t digest;
+
+    double lampSteps(const FleetOptions &o) const { return (double)o.lamps * o.steps; }
+};
+
+static FleetResult runFleet(const FleetOptions &options, int threads)
+{
+    Fleet fleet(options.lamps, options.groupSize, options.commandPermille, options.seed);
+    StealingPool pool(threads);
+    uint32_t chunks = (options.lamps + options.chunk - 1) / options.chunk;
+    uint32_t t = 0;
+
+    StealingPool::Job job = [&](uint32_t chunk) {
+        uint32_t end = (chunk + 1) * options.chunk;
+        if (end > options.lamps)
+        {
+            end = options.lamps;
+        }
+        for (uint32_t i = chunk * options.chunk; i < end; i++)
+        {
+            fleet.step(i, t);
+        }
+    };
+
+    uint64_t start = hostNanos();
+    for (t = 0; t < options.steps; t++)
+    {
+        pool.run(chunks, job);
+    }
+
+    FleetResult result;
+    memset(&result, 0, sizeof(result));
+    result.threads = threads;
+    result.wallNs = hostNanos() - start;
+    result.busyNs = pool.busyNs();
+    result.steals = pool.steals();
+    result.digest = 2166136261u;
+    for (uint32_t i = 0; i < fleet.size(); i++)
+    {
+        const VirtualLamp &lamp = fleet.lamp(i);
+        result.rendered += lamp.rendered;
+        result.replayed += lamp.replayed;
+        result.commands += lamp.commands;
+        result.matched += lamp.matched;
+        result.settling += lamp.settling;
+        result.differed += lamp.differed;
+        for (int k = 0; k < 4; k++)
+        {
+            result.digest = (result.digest ^ ((lamp.digest >> (8 * k)) & 0xFF)) * 16777619u;
+        }
+    }
+    return result;
+}
+
+static void printSync(const FleetOptions &o, const FleetResult &r)
+{
+    if (o.groupSize > 1)
+    {
+        uint64_t compared = r.matched + r.settling + r.differed;
+        printf("sync: %llu of %llu follower steps match their leader, %llu within %d steps of newly lit "
+               "LEDs (allowed), %llu other\n",
+               (unsigned long long)r.matched, (unsigned long long)compared, (unsigned long long)r.settling,
+               SYNC_WARMUP_STEPS, (unsigned long long)r.differed);
+    }
+}
+
+static void printResult(const FleetOptions &o, const FleetResult &r)
+{
+    double wall = r.wallNs / 1e9;
+    double rate = r.lampSteps(o) / wall;
+    double virtualSeconds = (double)o.steps * UPDATE_INTERVAL / 1000.0;
+
+    printf("fleet: %u lamps, %u per group, %u steps (%.1f s virtual), %d threads, %u lamps per chunk\n",
+           (unsigned)o.lamps, (unsigned)o.groupSize, (unsigned)o.steps, virtualSeconds, r.threads,
+           (unsigned)o.chunk);
+    printf("wall %.3f s: %.2fM lamp-steps/s, %.0fx real time (%.0f lamps live)\n", wall, rate / 1e6,
+           virtualSeconds / wall, rate * UPDATE_INTERVAL / 1000.0);
+    printf("per lamp-step: %.0f ns busy; %llu flicker steps, %llu replayed, %llu commands\n",
+           r.busyNs / r.lampSteps(o), (unsigned long long)r.rendered, (unsigned long long)r.replayed,
+           (unsigned long long)r.commands);
+    printf("pool: %llu steals, workers %.0f%% busy\n", (unsigned long long)r.steals,
+           100.0 * r.busyNs / ((double)r.wallNs * r.threads));
+    printSync(o, r);
+    printf("digest %08x\n", (unsigned)r.digest);
+}
+
+/**
+ * True if followers rendered their leader's flame once locked, except
+ * while newly lit LEDs settle
+ */
+static bool syncOk(const FleetOptions &o, const FleetResult &r)
+{
+    return o.groupSize <= 1 || (r.matched > 0 && r.differed == 0);
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: fleet_sim [--lamps N] [--steps N] [--threads N] [--chunk N] [--group N]\n"
+                    "                 [--commands PERMILLE] [--seed N] [--scaling]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    FleetOptions options;
+    options.lamps = 4096;
+    options.steps = 1000;
+    options.chunk = 64;
+    options.groupSize = 8;
+    options.commandPermille = 5;
+    options.seed = 1;
+    int threads = std::thread::hardware_concurrency();
+    bool scaling = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--scaling") == 0)
+        {
+            scaling = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            usage();
+        if (strcmp(argv[i], "--lamps") == 0)
+            options.lamps = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--steps") == 0)
+            options.steps = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--threads") == 0)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--chunk") == 0)
+            options.chunk = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--group") == 0)
+            options.groupSize = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--commands") == 0)
+            options.commandPermille = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--seed") == 0)
+            options.seed = strtoul(argv[++i], NULL, 0);
+        else
+            usage();
+    }
+    if (threads < 1)
+        threads = 1;
+    if (options.lamps == 0 || options.chunk == 0 || options.groupSize == 0)
+        usage();
+
+    bool reference = matchesRealLamp(options.seed, 500);
+
+    if (!scaling)
+    {
+        FleetResult result = runFleet(options, threads);
+        printResult(options, result);
+        return reference && syncOk(options, result) ? 0 : 1;
+    }
+
+    // Powers of two up to the thread count, then the thread count itself
+    std::vector<int> counts;
+    for (int n = 1; n < threads; n *= 2)
+    {
+        counts.push_back(n);
+    }
+    counts.push_back(threads);
+
+    printf("fleet: %u lamps, %u per group, %u steps, %u lamps per chunk\n", (unsigned)options.lamps,
+           (unsigned)options.groupSize, (unsigned)options.steps, (unsigned)options.chunk);
+    printf("threads   wall s  lamp-steps/s  speedup  ns/lamp-step  steals  digest\n");
+
+    bool ok = true;
+    FleetResult first = runFleet(options, counts[0]);
+    for (size_t k = 0; k < counts.size(); k++)
+    {
+        FleetResult r = k == 0 ? first : runFleet(options, counts[k]);
+        bool same = r.digest == first.digest && syncOk(options, r);
+        ok = ok && same;
+        printf("%7d %8.3f %12.2fM %7.2fx %13.0f %7llu  %08x%s\n", r.threads, r.wallNs / 1e9,
+               r.lampSteps(options) / (r.wallNs / 1e9) / 1e6, (double)first.wallNs / r.wallNs,
+               r.busyNs / r.lampSteps(options), (unsigned long long)r.steals, (unsigned)r.digest,
+               same ? "" : "  MISMATCH");
+    }
+
+    printSync(options, first);
+    if (!reference)
+    {
+        printf("Fleet FAILED: VirtualLamp no longer renders what DEV_CandleLight does\n");
+        return 1;
+    }
+    printf(ok ? "Fleet OK\n" : "Fleet FAILED: results depend on thread count or lamps lost sync\n");
+    return ok ? 0 : 1;
+}
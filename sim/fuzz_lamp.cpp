@@ -0,0 +1,492 @@
+/**
+ * @file fuzz_lamp.cpp
+ * @brief Coverage-guided fuzz target for DEV_CandleLight update()/loop()
+ *
+ * Builds the lamp's real CandleLight.cpp (with LedOutput, Calibration,
+ * SyncLink, TraceLog and EffectVM) against the host stand-ins in
+ * sim/host/ and turns each fuzzer input into a session: HomeKit
+ * characteristic writes (edge values favoured), power button edges,
+ * small steps and large jumps of the clock (across the millis() and
+ * micros() wraps), WiFi changes, "@o"/"@s"/"@c"/"@v" serial commands,
+ * effect programs, Identify and loop() blocked with only the frame pacer
+ * running. Every action is followed by one loop() pass, as HomeSpan's
+ * poll() would run it, and checked:
+ *
+ * - flicker smoothing state stays finite and within its range
+ * - characteristics stay within their HAP ranges
+ * - a dark lamp with no overlay shows nothing on the strips
+ * - one loop() pass stays within FUZZ_LOOP_BUDGET_US of host time
+ * - while loop() is blocked, the pacer never lets PACER_STALL_MS pass
+ *   without a frame
+ *
+ * Out-of-range LED, table or calibration indices are caught by
+ * AddressSanitizer, overflow and bad shifts by UBSan.
+ *
+ * Built two ways (see the Makefile):
+ *   make fuzz        clang++ -fsanitize=fuzzer: libFuzzer drives it
+ *   make fuzz-smoke  any compiler, -DFUZZ_STANDALONE: random inputs or
+ *                    replay of saved crash files, for CI and quick checks
+ *
+ * Usage (standalone): fuzz_lamp [--runs N] [--seed N] [FILE...]
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CandleLight.h"
+#include "HostHal.h"
+#include "LedOutput.h"
+
+/**
+ * Host-time limit for one loop() pass (µs), generous for sanitizer builds
+ * The device budget is OUTPUT_INTERVAL; a 64-step catch-up costs ~100 µs here.
+ */
+#define FUZZ_LOOP_BUDGET_US 20000
+
+// What main.cpp provides on the device
+CRGB leds[NUM_STRIPS][LED_LENGTH];
+LedOutput ledOutput;
+
+// ============================================================================
+// INPUT
+// ============================================================================
+
+/**
+ * @struct FuzzInput
+ * @brief Reads the input front to back; zeros once it runs out
+ */
+struct FuzzInput
+{
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+
+    bool more() const { return pos < size; }
+    uint8_t byte() { return pos < size ? data[pos++] : 0; }
+    uint16_t u16() { return byte() | (byte() << 8); }
+    uint32_t u32() { return u16() | ((uint32_t)u16() << 16); }
+
+    /**
+     * A value in [0, max], half the time one of the edges
+     */
+    int value(int max)
+    {
+        uint8_t pick = byte();
+        switch (pick & 7)
+        {
+        case 0:
+            return 0;
+        case 1:
+            return max;
+        case 2:
+            return 1 < max ? 1 : max;
+        case 3:
+            return max - 1 > 0 ? max - 1 : 0;
+        default:
+            return u16() % (max + 1);
+        }
+    }
+};
+
+static uint64_t hostNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#define FUZZ_CHECK(cond, ...)                        \
+    do                                               \
+    {                                                \
+        if (!(cond))                                 \
+        {                                            \
+            fprintf(stderr, "fuzz_lamp: " __VA_ARGS__); \
+            fprintf(stderr, "\n");                   \
+            abort();                                 \
+        }                                            \
+    } while (0)
+
+// ============================================================================
+// SESSION
+// ============================================================================
+
+/**
+ * HomeKit write of one or more characteristics, committed like HomeSpan
+ */
+static void writeCharacteristics(DEV_CandleLight &lamp, SpanCharacteristic **chars, const int *values, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        chars[i]->hostWrite(values[i]);
+    }
+    if (lamp.update())
+    {
+        for (int i = 0; i < count; i++)
+        {
+            chars[i]->hostCommit();
+        }
+    }
+}
+
+static void checkRange(SpanCharacteristic *c, const char *name)
+{
+    FUZZ_CHECK(c->getVal() >= c->minValue && c->getVal() <= c->maxValue, "%s out of range: %d", name, c->getVal());
+}
+
+/**
+ * One loop() pass, then the invariants
+ */
+static void poll(DEV_CandleLight &lamp)
+{
+    uint64_t start = hostNanos();
+    lamp.loop();
+    uint64_t elapsedUs = (hostNanos() - start) / 1000;
+    FUZZ_CHECK(elapsedUs <= FUZZ_LOOP_BUDGET_US, "loop() took %llu us", (unsigned long long)elapsedUs);
+
+    for (int i = 0; i < LED_LENGTH; i++)
+    {
+        float level = lamp.flicker.previousBrightness[i];
+        FUZZ_CHECK(isfinite(level) && level >= FLICKER_BRIGHTNESS_MIN && level <= FLICKER_BRIGHTNESS_MAX,
+                   "previousBrightness[%d] = %f", i, level);
+        int offset = lamp.flicker.previousHueOffset[i];
+        FUZZ_CHECK(offset >= FLICKER_HUE_MIN && offset <= FLICKER_HUE_MAX, "previousHueOffset[%d] = %d", i, offset);
+    }
+
+    checkRange(lamp.power, "power");
+    checkRange(lamp.hue, "hue");
+    checkRange(lamp.saturation, "saturation");
+    checkRange(lamp.brightness, "brightness");
+
+    // A frame went out this pass: dark lamp, no overlay, no fade still
+    // running, not identifying -> dark strips
+    bool framed = lamp.lastOutputFrame == (uint32_t)millis();
+    if (framed && !lamp.power->getVal() && lamp.overlays.numLayers == 0 && !lamp.fade.ramping(millis()) &&
+        lamp.fade.effect() != &lamp.identifyFlash)
+    {
+        for (int strip = 0; strip < NUM_STRIPS; strip++)
+        {
+            for (int i = 0; i < LED_LENGTH; i++)
+            {
+                FUZZ_CHECK(!leds[strip][i].r && !leds[strip][i].g && !leds[strip][i].b,
+                           "strip %d LED %d lit while off", strip, i);
+            }
+        }
+    }
+}
+
+/**
+ * Serial command text from the input, NUL-terminated
+ */
+static void readText(FuzzInput &in, char *out, size_t room)
+{
+    size_t length = in.byte() % room;
+    for (size_t i = 0; i < length; i++)
+    {
+        out[i] = (char)in.byte();
+    }
+    out[length] = '\0';
+}
+
+static void runSession(const uint8_t *data, size_t size)
+{
+    FuzzInput in = {data, size, 0};
+
+    hostReset();
+    switch (in.byte() & 3)
+    {
+    case 0:
+        hostSetClock(0);
+        break;
+    case 1:
+        hostSetClock((0x100000000ULL - 5000) * 1000); // millis() wraps in 5 s
+        break;
+    case 2:
+        hostSetClock(0x100000000ULL - 2000000); // micros() wraps in 2 s
+        break;
+    default:
+        hostSetClock((uint64_t)in.u32() * 1000);
+        break;
+    }
+
+    DEV_CandleLight *lamp = new DEV_CandleLight();
+    poll(*lamp);
+
+    while (in.more())
+    {
+        uint8_t op = in.byte();
+        switch (op % 15)
+        {
+        case 0:
+        {
+            int v = in.byte() & 1;
+            writeCharacteristics(*lamp, &lamp->power, &v, 1);
+            break;
+        }
+        case 1:
+        {
+            int v = in.value(360);
+            writeCharacteristics(*lamp, &lamp->hue, &v, 1);
+            break;
+        }
+        case 2:
+        {
+            int v = in.value(100);
+            writeCharacteristics(*lamp, &lamp->saturation, &v, 1);
+            break;
+        }
+        case 3:
+        {
+            int v = in.value(100);
+            writeCharacteristics(*lamp, &lamp->brightness, &v, 1);
+            break;
+        }
+        case 4:
+        {
+            // Several characteristics in one write, as the Home app sends scenes
+            SpanCharacteristic *chars[4];
+            int values[4];
+            int n = 0;
+            uint8_t mask = in.byte();
+            if (mask & 1)
+            {
+                chars[n] = lamp->power;
+                values[n++] = in.byte() & 1;
+            }
+            if (mask & 2)
+            {
+                chars[n] = lamp->hue;
+                values[n++] = in.value(360);
+            }
+            if (mask & 4)
+            {
+                chars[n] = lamp->saturation;
+                values[n++] = in.value(100);
+            }
+            if (mask & 8)
+            {
+                chars[n] = lamp->brightness;
+                values[n++] = in.value(100);
+            }
+            if (n > 0)
+            {
+                writeCharacteristics(*lamp, chars, values, n);
+            }
+            break;
+        }
+        case 5:
+        {
+            int v = in.value(OVERLAY_PRESET_COUNT - 1);
+            writeCharacteristics(*lamp, &lamp->notification, &v, 1);
+            break;
+        }
+        case 6:
+            hostSetPin(POWER_BUTTON_PIN, in.byte() & 1);
+            break;
+        case 7:
+            hostAdvance(in.u16()); // Up to 65 ms, sub-millisecond steps
+            break;
+        case 8:
+            hostAdvance((uint64_t)in.u32() * 1000); // Up to 49 days
+            break;
+        case 9:
+        {
+            // Steady running: a batch of passes at a fixed spacing
+            int passes = in.byte() % 64;
+            uint32_t stepUs = 1 + in.u16() % 20000;
+            for (int i = 0; i < passes; i++)
+            {
+                hostAdvance(stepUs);
+                poll(*lamp);
+            }
+            break;
+        }
+        case 10:
+        {
+            char text[32];
+            uint8_t target = in.byte() % 4;
+            readText(in, text, sizeof(text));
+            if (target == 0)
+                lamp->overlayCommand(text);
+            else if (target == 1)
+                lamp->syncCommand(text);
+            else if (target == 2)
+                lamp->calibrationCommand(text);
+            else
+                lamp->effectCommand(text);
+            break;
+        }
+        case 11:
+        {
+            // Effect program built to pass validation most of the time:
+            // opcodes, registers and jump targets in range, loops allowed
+            uint8_t program[VM_MAX_CODE];
+            int count = 1 + in.byte() % (VM_MAX_CODE / VM_INSN_BYTES);
+            for (int n = 0; n < count; n++)
+            {
+                uint8_t *insn = program + n * VM_INSN_BYTES;
+                uint8_t opcode = in.byte() % VM_OP_COUNT;
+                uint8_t operands = VM_OPERANDS[opcode];
+                insn[0] = opcode;
+                insn[1] = in.byte() % VM_REGISTERS;
+                insn[2] = (operands & VM_B) ? in.byte() % VM_REGISTERS : in.byte();
+                insn[3] = (operands & VM_C) ? in.byte() % VM_REGISTERS : in.byte();
+                if (operands & (VM_JUMP16 | VM_JUMP8))
+                {
+                    int offset = in.byte() % count - (n + 1);
+                    insn[3] = (uint8_t)offset;
+                    if (operands & VM_JUMP16)
+                    {
+                        insn[2] = (uint8_t)offset;
+                        insn[3] = (uint8_t)(offset >> 8);
+                    }
+                }
+            }
+            if (in.byte() & 1)
+            {
+                program[(count - 1) * VM_INSN_BYTES] = OP_END;
+            }
+            size_t length = count * VM_INSN_BYTES;
+            int where;
+            lamp->effects.install(program, length, &where);
+            break;
+        }
+        case 12:
+            lamp->identify();
+            break;
+        case 13:
+        {
+            // loop() blocked (e.g. in an NVS write): the pacer task alone
+            int wakes = in.byte() % 64;
+            for (int i = 0; i < wakes; i++)
+            {
+                hostAdvance(OUTPUT_INTERVAL * 1000ULL);
+                if (in.byte() % 8 == 0)
+                {
+                    // Status and Identify arrive through homeSpan.poll(), the stalled call
+                    uint8_t id = in.byte() % (OVERLAY_PRESET_COUNT + 1);
+                    if (id < OVERLAY_PRESET_COUNT)
+                        lamp->notify(id);
+                    else
+                        lamp->identify();
+                }
+                lamp->paceFrame(millis(), micros());
+                FUZZ_CHECK(lamp->lastOutputMicros == 0 || millis() - lamp->lastOutputFrame < PACER_STALL_MS,
+                           "no frame for %u ms with loop() blocked", (unsigned)(millis() - lamp->lastOutputFrame));
+            }
+            break;
+        }
+        default:
+        {
+            uint8_t network = in.byte();
+            hostSetWiFi(network & 1);
+            hostSetSocketFail(network & 2);
+            break;
+        }
+        }
+        poll(*lamp);
+    }
+
+    delete lamp;
+    hostReset();
+}
+
+// ============================================================================
+// ENTRY POINTS
+// ============================================================================
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    runSession(data, size);
+    return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+
+/**
+ * Replay one saved input (e.g. a libFuzzer crash file)
+ */
+static void replay(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        exit(2);
+    }
+    static uint8_t buf[1 << 16];
+    size_t size = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    runSession(buf, size);
+    printf("%s: OK (%u bytes)\n", path, (unsigned)size);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long runs = 10000;
+    uint32_t seed = 1;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+        {
+            runs = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            replay(argv[i]);
+            files++;
+        }
+    }
+    if (files > 0)
+    {
+        return 0;
+    }
+
+    // Random sessions of up to 512 bytes from a fixed seed, reproducible
+    FlickerRandom rng;
+    rng.seed(seed);
+    uint8_t buf[512];
+    for (unsigned long run = 0; run < runs; run++)
+    {
+        size_t size = rng.next() % sizeof(buf);
+        for (size_t i = 0; i < size; i++)
+        {
+            buf[i] = (uint8_t)rng.next();
+        }
+        runSession(buf, size);
+    }
+    printf("fuzz_lamp: %lu random sessions OK (seed %u)\n", runs, (unsigned)seed);
+    return 0;
+}
+
+#endif // FUZZ_STANDALONE
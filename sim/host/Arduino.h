@@ -0,0 +1,114 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core (see HostHal.h)
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+int digitalRead(int pin);
+void digitalWrite(int pin, int level);
+void pinMode(int pin, int mode);
+uint32_t esp_random();
+long random(long max);
+long random(long min, long max);
+
+// FreeRTOS spinlocks, which Arduino.h brings in on the ESP32; the host
+// programs using these headers are single-threaded
+typedef struct
+{
+    int owner;
+} portMUX_TYPE;
+#define portMUX_INITIALIZE(mux) ((mux)->owner = 0)
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+template <class T, class L, class H>
+T constrain(T x, L lo, H hi)
+{
+    return x < lo ? lo : (x > hi ? hi : x);
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+/**
+ * @class HostSerial
+ * @brief Serial formatted like the real one, echoed only on request
+ */
+class HostSerial
+{
+public:
+    void begin(unsigned long) {}
+    operator bool() const { return true; }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char *s) { return emit("%s", s); }
+    size_t print(char c) { return emit("%c", c); }
+    size_t print(int v) { return emit("%d", v); }
+    size_t print(unsigned v) { return emit("%u", v); }
+    size_t print(long v) { return emit("%ld", v); }
+    size_t print(unsigned long v) { return emit("%lu", v); }
+    size_t print(double v, int digits = 2) { return emit("%.*f", digits, v); }
+    size_t println() { return emit("\n"); }
+    template <class T>
+    size_t println(T v)
+    {
+        size_t n = print(v);
+        return n + println();
+    }
+    size_t write(const uint8_t *data, size_t length) { return emit("%.*s", (int)length, (const char *)data); }
+    int available() { return 0; }
+    int read() { return -1; }
+    void flush() {}
+
+private:
+    size_t emit(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,129 @@
+/**
+ * @file FastLED.h
+ * @brief Host stand-in for the parts of FastLED the lamp uses
+ *
+ * CRGB/CHSV with FastLED's layout, an HSV conversion with the same
+ * 0-255 scales, and controllers that accept frames without sending them
+ * anywhere; host programs read the LED arrays directly.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+#include <Arduino.h>
+
+struct CHSV
+{
+    uint8_t h, s, v;
+
+    CHSV() : h(0), s(0), v(0) {}
+    CHSV(uint8_t h, uint8_t s, uint8_t v) : h(h), s(s), v(v) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+
+struct CRGB
+{
+    union
+    {
+        struct
+        {
+            uint8_t r, g, b;
+        };
+        uint8_t raw[3];
+    };
+
+    enum HTMLColorCode
+    {
+        Black = 0x000000,
+        White = 0xFFFFFF
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b) {}
+    CRGB(HTMLColorCode c) : r((c >> 16) & 0xFF), g((c >> 8) & 0xFF), b(c & 0xFF) {}
+    CRGB(const CHSV &hsv) { hsv2rgb_rainbow(hsv, *this); }
+
+    CRGB &operator=(const CHSV &hsv)
+    {
+        hsv2rgb_rainbow(hsv, *this);
+        return *this;
+    }
+    uint8_t &operator[](int i) { return raw[i]; }
+    bool operator==(const CRGB &o) const { return r == o.r && g == o.g && b == o.b; }
+};
+
+void fill_solid(CRGB *leds, int count, const CRGB &color);
+
+enum EOrder
+{
+    RGB,
+    BGR,
+    GRB
+};
+
+enum ESPIChipsets
+{
+    APA102,
+    SK9822
+};
+
+template <uint8_t DataPin>
+struct WS2812B
+{
+};
+
+class CLEDController
+{
+public:
+    void showLeds(uint8_t brightness = 255) { (void)brightness; }
+};
+
+class HostFastLED
+{
+public:
+    template <ESPIChipsets Chipset, uint8_t DataPin, uint8_t ClockPin, EOrder Order>
+    CLEDController &addLeds(CRGB *, int)
+    {
+        return controller;
+    }
+
+    template <template <uint8_t> class Chipset, uint8_t DataPin, EOrder Order>
+    CLEDController &addLeds(CRGB *, int)
+    {
+        return controller;
+    }
+
+    void setBrightness(uint8_t) {}
+    void show() {}
+
+private:
+    CLEDController controller;
+};
+
+extern HostFastLED FastLED;
+
+#endif // HOST_FASTLED_H
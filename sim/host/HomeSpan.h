@@ -0,0 +1,204 @@
+/**
+ * @file HomeSpan.h
+ * @brief Host stand-in for HomeSpan's service/characteristic model
+ *
+ * Characteristics keep a value and a pending new value like HomeSpan's:
+ * a controller write sets the new value and marks it updated, update()
+ * sees both, and the write is committed afterwards. hostWrite() and
+ * hostCommit() are those two halves for host programs.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HOST_HOMESPAN_H
+#define HOST_HOMESPAN_H
+
+#include <Arduino.h>
+
+/**
+ * @class SpanCharacteristic
+ * @brief One HAP characteristic, integer-valued
+ */
+class SpanCharacteristic
+{
+public:
+    explicit SpanCharacteristic(int initial = 0);
+    virtual ~SpanCharacteristic() {}
+
+    template <class T = int>
+    T getVal() const { return (T)value; }
+    template <class T = int>
+    T getNewVal() const { return (T)newValue; }
+    bool updated() const { return isUpdated; }
+
+    template <class T>
+    void setVal(T v, bool notify = true)
+    {
+        (void)notify;
+        value = newValue = (int)v;
+    }
+
+    SpanCharacteristic *setRange(int lo, int hi, int step = 1)
+    {
+        (void)step;
+        minValue = lo;
+        maxValue = hi;
+        return this;
+    }
+
+    /**
+     * Host: a controller writes v (update() runs next)
+     */
+    void hostWrite(int v)
+    {
+        newValue = v;
+        isUpdated = true;
+    }
+
+    /**
+     * Host: accept pending writes after update() returned true
+     */
+    void hostCommit()
+    {
+        value = newValue;
+        isUpdated = false;
+    }
+
+    int minValue, maxValue;
+
+private:
+    int value, newValue;
+    bool isUpdated;
+};
+
+/**
+ * @class SpanService
+ * @brief Base of services; HomeSpan calls update() on writes, loop() every poll
+ */
+class SpanService
+{
+public:
+    virtual ~SpanService() {}
+    virtual boolean update() { return true; }
+    virtual void loop() {}
+};
+
+namespace Service
+{
+struct LightBulb : SpanService
+{
+};
+struct AccessoryInformation : SpanService
+{
+};
+} // namespace Service
+
+#define HOST_CHAR(NAME, DEFAULT, LO, HI)                                      \
+    struct NAME : SpanCharacteristic                                          \
+    {                                                                         \
+        explicit NAME(int v = DEFAULT) : SpanCharacteristic(v) { setRange(LO, HI); } \
+    };
+#define HOST_TEXT_CHAR(NAME)                                                  \
+    struct NAME : SpanCharacteristic                                          \
+    {                                                                         \
+        explicit NAME(const char * = "") {}                                   \
+    };
+
+namespace Characteristic
+{
+HOST_CHAR(On, 0, 0, 1)
+HOST_CHAR(Hue, 0, 0, 360)
+HOST_CHAR(Saturation, 0, 0, 100)
+HOST_CHAR(Brightness, 0, 0, 100)
+HOST_CHAR(Identify, 0, 0, 1)
+HOST_TEXT_CHAR(Manufacturer)
+HOST_TEXT_CHAR(Model)
+HOST_TEXT_CHAR(Name)
+HOST_TEXT_CHAR(SerialNumber)
+HOST_TEXT_CHAR(FirmwareRevision)
+} // namespace Characteristic
+
+#define CUSTOM_CHAR(NAME, UUID, PERMS, FORMAT, DEFVAL, MINVAL, MAXVAL, STATIC) \
+    namespace Characteristic                                                  \
+    {                                                                         \
+    HOST_CHAR(NAME, DEFVAL, MINVAL, MAXVAL)                                   \
+    }
+
+struct SpanAccessory
+{
+};
+
+struct SpanUserCommand
+{
+    SpanUserCommand(char, const char *, void (*)(const char *)) {}
+};
+
+enum HS_STATUS
+{
+    HS_WIFI_NEEDED,
+    HS_WIFI_CONNECTING,
+    HS_PAIRING_NEEDED,
+    HS_PAIRED,
+    HS_ENTERING_CONFIG_MODE,
+    HS_CONFIG_MODE_EXIT,
+    HS_CONFIG_MODE_REBOOT,
+    HS_CONFIG_MODE_LAUNCH_AP,
+    HS_CONFIG_MODE_UNPAIR,
+    HS_CONFIG_MODE_ERASE_WIFI,
+    HS_CONFIG_MODE_EXIT_SELECTED,
+    HS_CONFIG_MODE_REBOOT_SELECTED,
+    HS_CONFIG_MODE_LAUNCH_AP_SELECTED,
+    HS_CONFIG_MODE_UNPAIR_SELECTED,
+    HS_CONFIG_MODE_ERASE_WIFI_SELECTED,
+    HS_REBOOTING,
+    HS_FACTORY_RESET,
+    HS_AP_STARTED,
+    HS_AP_CONNECTED,
+    HS_AP_TERMINATED,
+    HS_OTA_STARTED,
+    HS_WIFI_SCANNING,
+    HS_ETH_CONNECTING
+};
+
+/**
+ * @class HostHomeSpan
+ * @brief Records serial commands issued by the lamp (e.g. "A" for the AP)
+ */
+class HostHomeSpan
+{
+public:
+    char lastCommand[16];
+
+    HostHomeSpan() { lastCommand[0] = '\0'; }
+    void processSerialCommand(const char *cmd)
+    {
+        strncpy(lastCommand, cmd, sizeof(lastCommand) - 1);
+        lastCommand[sizeof(lastCommand) - 1] = '\0';
+    }
+    void setStatusCallback(void (*)(HS_STATUS)) {}
+    const char *statusString(HS_STATUS) { return "status"; }
+};
+
+extern HostHomeSpan homeSpan;
+
+#endif // HOST_HOMESPAN_H
@@ -0,0 +1,291 @@
+/**
+ * @file HostHal.cpp
+ * @brief Virtual clock, GPIO, NVS and HomeSpan state behind sim/host/
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <HomeSpan.h>
+#include <Preferences.h>
+#include <WiFi.h>
+
+#include "HostHal.h"
+
+HostSerial Serial;
+HostHomeSpan homeSpan;
+HostFastLED FastLED;
+HostWiFi WiFi;
+
+static uint64_t clockUs = 0;
+static uint8_t pinLevels[64];
+static bool wifiConnected = false;
+static bool socketFail = false;
+static uint32_t socketCalls = 0;
+static bool serialEcho = false;
+static uint64_t serialBytes = 0;
+static uint32_t randomState = 0x9E3779B9u;
+static std::map<std::string, std::vector<uint8_t> > nvs;
+static std::vector<SpanCharacteristic *> characteristics;
+static uint32_t nvsWriteUs = 0;
+static void (*nvsBackground)(void *) = NULL;
+static void *nvsBackgroundArg = NULL;
+
+// ============================================================================
+// CONTROLS
+// ============================================================================
+
+void hostSetClock(uint64_t us) { clockUs = us; }
+void hostAdvance(uint64_t us) { clockUs += us; }
+void hostSetWiFi(bool connected) { wifiConnected = connected; }
+void hostSetSocketFail(bool fail) { socketFail = fail; }
+void hostSetSerialEcho(bool on) { serialEcho = on; }
+
+uint32_t hostSocketCalls() { return socketCalls; }
+
+uint64_t hostSerialBytes() { return serialBytes; }
+
+void hostSetNvsWrite(uint32_t us, void (*background)(void *), void *arg)
+{
+    nvsWriteUs = us;
+    nvsBackground = background;
+    nvsBackgroundArg = arg;
+}
+
+void hostSetPin(int pin, int level)
+{
+    if (pin >= 0 && pin < (int)sizeof(pinLevels))
+    {
+        pinLevels[pin] = level ? HIGH : LOW;
+    }
+}
+
+void hostReset()
+{
+    clockUs = 0;
+    serialBytes = 0;
+    memset(pinLevels, HIGH, sizeof(pinLevels));
+    wifiConnected = false;
+    socketFail = false;
+    socketCalls = 0;
+    randomState = 0x9E3779B9u;
+    nvs.clear();
+    hostSetNvsWrite(0, NULL, NULL);
+    for (size_t i = 0; i < characteristics.size(); i++)
+    {
+        delete characteristics[i];
+    }
+    characteristics.clear();
+    homeSpan.lastCommand[0] = '\0';
+}
+
+// ============================================================================
+// ARDUINO CORE
+// ============================================================================
+
+unsigned long millis() { return (uint32_t)(clockUs / 1000); }
+unsigned long micros() { return (uint32_t)clockUs; }
+void delay(unsigned long ms) { clockUs += ms * 1000ULL; }
+void pinMode(int pin, int mode) { (void)pin, (void)mode; }
+void digitalWrite(int pin, int level) { hostSetPin(pin, level); }
+
+int digitalRead(int pin)
+{
+    return pin >= 0 && pin < (int)sizeof(pinLevels) ? pinLevels[pin] : HIGH;
+}
+
+uint32_t esp_random()
+{
+    // Deterministic, so a fuzzer input always replays the same way
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+long random(long max) { return max > 0 ? (long)(esp_random() % (uint32_t)max) : 0; }
+long random(long min, long max) { return max > min ? min + random(max - min) : min; }
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+size_t HostSerial::printf(const char *format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (n < 0)
+    {
+        return 0;
+    }
+    serialBytes += (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1;
+    if (serialEcho)
+    {
+        fputs(buf, stdout);
+    }
+    return (size_t)n;
+}
+
+size_t HostSerial::emit(const char *format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (n < 0)
+    {
+        return 0;
+    }
+    serialBytes += (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1;
+    if (serialEcho)
+    {
+        fputs(buf, stdout);
+    }
+    return (size_t)n;
+}
+
+// ============================================================================
+// HOMESPAN, WIFI, SOCKETS, NVS
+// ============================================================================
+
+SpanCharacteristic::SpanCharacteristic(int initial)
+    : minValue(0), maxValue(0), value(initial), newValue(initial), isUpdated(false)
+{
+    // Released by hostReset(), as the real ones live until reboot
+    characteristics.push_back(this);
+}
+
+int HostWiFi::status() { return wifiConnected ? WL_CONNECTED : WL_DISCONNECTED; }
+
+int hostSocket(int, int, int)
+{
+    socketCalls++;
+    return socketFail ? -1 : 3;
+}
+
+bool Preferences::begin(const char *name, bool ro)
+{
+    strncpy(space, name, sizeof(space) - 1);
+    space[sizeof(space) - 1] = '\0';
+    readOnly = ro;
+    return true;
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+    std::map<std::string, std::vector<uint8_t> >::const_iterator it = nvs.find(std::string(space) + "/" + key);
+    return it == nvs.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLength)
+{
+    std::map<std::string, std::vector<uint8_t> >::const_iterator it = nvs.find(std::string(space) + "/" + key);
+    if (it == nvs.end() || it->second.size() > maxLength)
+    {
+        return 0;
+    }
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t length)
+{
+    if (readOnly)
+    {
+        return 0;
+    }
+    const uint8_t *bytes = (const uint8_t *)value;
+    nvs[std::string(space) + "/" + key].assign(bytes, bytes + length);
+
+    // The writing task is blocked meanwhile; other tasks get the CPU
+    for (uint32_t spent = 0; spent < nvsWriteUs; spent += 1000)
+    {
+        uint32_t step = nvsWriteUs - spent < 1000 ? nvsWriteUs - spent : 1000;
+        clockUs += step;
+        if (nvsBackground)
+        {
+            nvsBackground(nvsBackgroundArg);
+        }
+    }
+    return length;
+}
+
+bool Preferences::remove(const char *key)
+{
+    return !readOnly && nvs.erase(std::string(space) + "/" + key) > 0;
+}
+
+// ============================================================================
+// FASTLED
+// ============================================================================
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb)
+{
+    // Six 43-step hue sectors on FastLED's 0-255 scales; close to, not
+    // bit-exact with, FastLED's rainbow mapping
+    uint8_t sector = hsv.h / 43;
+    uint8_t ramp = (hsv.h - sector * 43) * 6;
+    uint8_t lo = hsv.v * (255 - hsv.s) / 255;
+    uint8_t down = hsv.v * (255 - (hsv.s * ramp) / 255) / 255;
+    uint8_t up = hsv.v * (255 - (hsv.s * (255 - ramp)) / 255) / 255;
+
+    switch (sector)
+    {
+    case 0:
+        rgb = CRGB(hsv.v, up, lo);
+        break;
+    case 1:
+        rgb = CRGB(down, hsv.v, lo);
+        break;
+    case 2:
+        rgb = CRGB(lo, hsv.v, up);
+        break;
+    case 3:
+        rgb = CRGB(lo, down, hsv.v);
+        break;
+    case 4:
+        rgb = CRGB(up, lo, hsv.v);
+        break;
+    default:
+        rgb = CRGB(hsv.v, lo, down);
+        break;
+    }
+}
+
+void fill_solid(CRGB *leds, int count, const CRGB &color)
+{
+    for (int i = 0; i < count; i++)
+    {
+        leds[i] = color;
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file HostHal.h
+ * @brief Controls for the host stand-ins of Arduino, HomeSpan and FastLED
+ *
+ * The headers in sim/host/ replace the ESP32 framework headers so the
+ * lamp's own sources (CandleLight.cpp, LedOutput.cpp, Calibration.cpp,
+ * SyncLink.cpp, TraceLog.cpp) build on the host unchanged. Time, GPIO
+ * levels and WiFi status are whatever the host program sets here, which
+ * is what lets a fuzzer or test drive update() and loop() directly.
+ *
+ * Only used by host tools (sim/fuzz_lamp.cpp); never part of firmware.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HOSTHAL_H
+#define HOSTHAL_H
+
+#include <stdint.h>
+
+/**
+ * Set the virtual clock (µs since boot); millis() and micros() derive
+ * from it and wrap like on the ESP32
+ */
+void hostSetClock(uint64_t us);
+
+/**
+ * Move the virtual clock forward
+ */
+void hostAdvance(uint64_t us);
+
+/**
+ * Level returned by digitalRead() for a pin (pins start HIGH, as with
+ * the pullups the lamp enables)
+ */
+void hostSetPin(int pin, int level);
+
+/**
+ * WiFi.status() result: connected or not
+ */
+void hostSetWiFi(bool connected);
+
+/**
+ * Make socket() fail, as it does when lwIP has no free sockets
+ */
+void hostSetSocketFail(bool fail);
+
+/**
+ * socket() calls since the last hostReset()
+ */
+uint32_t hostSocketCalls();
+
+/**
+ * Echo Serial output to stdout (off by default)
+ */
+void hostSetSerialEcho(bool on);
+
+/**
+ * Bytes written to Serial since the last hostReset(), for modelling
+ * UART transmit time
+ */
+uint64_t hostSerialBytes();
+
+/**
+ * Make each Preferences write block for us of virtual time, calling
+ * background(arg) after every millisecond of it, the way tasks on the
+ * other core keep running while the writing task waits on flash.
+ * 0 (the power-on default) makes writes instant.
+ */
+void hostSetNvsWrite(uint32_t us, void (*background)(void *), void *arg);
+
+/**
+ * Back to power-on state: clock 0, pins HIGH, WiFi down, sockets
+ * working, NVS empty, HomeSpan characteristics released
+ */
+void hostReset();
+
+#endif // HOSTHAL_H
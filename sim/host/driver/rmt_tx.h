@@ -0,0 +1,153 @@
+/**
+ * @file rmt_tx.h
+ * @brief Host stand-in for the ESP-IDF 5 RMT TX driver: every send completes at once
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HOST_DRIVER_RMT_TX_H
+#define HOST_DRIVER_RMT_TX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ESP_OK
+typedef int esp_err_t;
+#define ESP_OK 0
+#endif
+
+typedef int gpio_num_t;
+
+typedef enum
+{
+    RMT_CLK_SRC_DEFAULT
+} rmt_clock_source_t;
+
+typedef union
+{
+    struct
+    {
+        uint16_t duration0 : 15;
+        uint16_t level0 : 1;
+        uint16_t duration1 : 15;
+        uint16_t level1 : 1;
+    };
+    uint32_t val;
+} rmt_symbol_word_t;
+
+typedef struct
+{
+    size_t num_symbols;
+} rmt_tx_done_event_data_t;
+
+struct rmt_channel_t;
+struct rmt_encoder_t
+{
+    int unused;
+};
+typedef struct rmt_channel_t *rmt_channel_handle_t;
+typedef struct rmt_encoder_t *rmt_encoder_handle_t;
+
+typedef bool (*rmt_tx_done_callback_t)(rmt_channel_handle_t, const rmt_tx_done_event_data_t *, void *);
+
+typedef struct
+{
+    gpio_num_t gpio_num;
+    rmt_clock_source_t clk_src;
+    uint32_t resolution_hz;
+    size_t mem_block_symbols;
+    size_t trans_queue_depth;
+} rmt_tx_channel_config_t;
+
+typedef struct
+{
+    rmt_symbol_word_t bit0;
+    rmt_symbol_word_t bit1;
+    struct
+    {
+        uint32_t msb_first : 1;
+    } flags;
+} rmt_bytes_encoder_config_t;
+
+typedef struct
+{
+    rmt_tx_done_callback_t on_trans_done;
+} rmt_tx_event_callbacks_t;
+
+typedef struct
+{
+    int loop_count;
+} rmt_transmit_config_t;
+
+struct rmt_channel_t
+{
+    rmt_tx_done_callback_t done;
+    void *context;
+};
+
+inline esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *, rmt_channel_handle_t *channel)
+{
+    *channel = new rmt_channel_t();
+    return ESP_OK;
+}
+
+inline esp_err_t rmt_new_bytes_encoder(const rmt_bytes_encoder_config_t *, rmt_encoder_handle_t *encoder)
+{
+    *encoder = new rmt_encoder_t();
+    return ESP_OK;
+}
+
+inline esp_err_t rmt_tx_register_event_callbacks(rmt_channel_handle_t channel, const rmt_tx_event_callbacks_t *callbacks,
+                                                 void *context)
+{
+    channel->done = callbacks->on_trans_done;
+    channel->context = context;
+    return ESP_OK;
+}
+
+inline esp_err_t rmt_enable(rmt_channel_handle_t) { return ESP_OK; }
+
+inline esp_err_t rmt_transmit(rmt_channel_handle_t channel, rmt_encoder_handle_t, const void *, size_t size,
+                              const rmt_transmit_config_t *)
+{
+    if (channel->done)
+    {
+        rmt_tx_done_event_data_t event = {size * 8};
+        channel->done(channel, &event, channel->context);
+    }
+    return ESP_OK;
+}
+
+inline esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder)
+{
+    delete encoder;
+    return ESP_OK;
+}
+
+inline esp_err_t rmt_del_channel(rmt_channel_handle_t channel)
+{
+    delete channel;
+    return ESP_OK;
+}
+
+#endif // HOST_DRIVER_RMT_TX_H
@@ -0,0 +1,67 @@
+/**
+ * @file sockets.h
+ * @brief Host stand-in for lwIP sockets: sends nothing, receives nothing
+ *
+ * Types and constants come from the host's own socket headers; the calls
+ * the lamp makes are redirected to no-ops the way lwIP redirects them to
+ * its lwip_* functions, so host tools never touch the network.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HOST_LWIP_SOCKETS_H
+#define HOST_LWIP_SOCKETS_H
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+int hostSocket(int domain, int type, int protocol); // HostHal.cpp, see hostSetSocketFail()
+static inline int hostBind(int, const struct sockaddr *, socklen_t) { return 0; }
+static inline int hostSetsockopt(int, int, int, const void *, socklen_t) { return 0; }
+static inline int hostFcntl(int, int, int) { return 0; }
+static inline int hostClose(int) { return 0; }
+
+static inline ssize_t hostSendto(int, const void *, size_t length, int, const struct sockaddr *, socklen_t)
+{
+    return length;
+}
+
+static inline ssize_t hostRecvfrom(int, void *, size_t, int, struct sockaddr *, socklen_t *)
+{
+    errno = EWOULDBLOCK;
+    return -1;
+}
+
+#define socket(domain, type, protocol) hostSocket(domain, type, protocol)
+#define bind(fd, addr, length) hostBind(fd, addr, length)
+#define setsockopt(fd, level, name, value, length) hostSetsockopt(fd, level, name, value, length)
+#define fcntl(fd, cmd, arg) hostFcntl(fd, cmd, arg)
+#define close(fd) hostClose(fd)
+#define sendto(fd, data, length, flags, to, tolen) hostSendto(fd, data, length, flags, to, tolen)
+#define recvfrom(fd, data, length, flags, from, fromlen) hostRecvfrom(fd, data, length, flags, from, fromlen)
+
+#endif // HOST_LWIP_SOCKETS_H
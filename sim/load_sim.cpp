@@ -0,0 +1,576 @@
+/**
+ * @file load_sim.cpp
+ * @brief Load test of the HomeKit write path with latency percentiles
+ *
+ * Runs the real DEV_CandleLight (CandleLight.cpp on the sim/host/
+ * stand-ins) as HomeSpan would: one task that handles at most one
+ * incoming HAP request per poll, calling update() for it, then loop().
+ * Several simulated controllers drag Home app sliders (brightness or
+ * hue) at increasing write rates, stage by stage.
+ *
+ * Time is virtual. Each call advances the clock by its measured host
+ * cost times --cpu-scale (ESP32 vs. host speed), plus --request-us of
+ * HAP overhead (decrypt, parse, respond) per request, plus any time
+ * Serial blocks: logging goes through a --fifo byte UART FIFO draining
+ * at --baud, as with the Arduino-ESP32 default of no TX ring buffer.
+ * That is how a logging-heavy update() turns into frame delay.
+ *
+ * Reported per stage, as p50 / p99 / p999:
+ *   update    update() callback, device time incl. Serial blocking
+ *   to-frame  write arriving -> first frame showing it on the strips
+ * plus missed output frames (gaps over 1.5 x OUTPUT_INTERVAL) and the
+ * longest gap. Fails if a write never reaches a frame or the lamp ends
+ * on a value other than the last one written.
+ *
+ * Then the "@p nvs" test: --nvs-writes Preferences writes of
+ * --nvs-write-us each with loop() blocked, once with nothing else
+ * running and once with the frame pacer task waking every
+ * OUTPUT_INTERVAL. Reports the longest output gap and flicker tick
+ * interval of each; fails if the pacer lets a gap reach
+ * PACER_STALL_MS + OUTPUT_INTERVAL.
+ *
+ * Usage: load_sim [--controllers N] [--rates R,R,...] [--stage-ms MS]
+ *                 [--cpu-scale X] [--request-us US] [--baud B] [--fifo N]
+ *                 [--nvs-writes N] [--nvs-write-us US] [--seed N]
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "CandleLight.h"
+#include "HostHal.h"
+#include "LedOutput.h"
+
+// What main.cpp provides on the device
+CRGB leds[NUM_STRIPS][LED_LENGTH];
+LedOutput ledOutput;
+
+// ============================================================================
+// OPTIONS
+// ============================================================================
+
+static int controllers = 3;
+static std::vector<int> rates;    // Writes per second per controller, per stage
+static uint32_t stageMs = 5000;
+static double cpuScale = 30.0;    // ESP32 time per unit of host time
+static uint32_t requestUs = 1500; // HAP request handling besides update()
+static uint32_t baud = 115200;
+static uint32_t fifoBytes = 128;
+static int nvsWrites = 10;
+static uint32_t nvsWriteUs = 20000; // One entry plus, now and then, a page erase
+static uint32_t seed = 1;
+
+static uint64_t hostNanos()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// ============================================================================
+// WORKLOAD
+// ============================================================================
+
+/**
+ * @struct Write
+ * @brief One characteristic write from a controller
+ */
+struct Write
+{
+    uint64_t at;        // Arrival (virtual µs)
+    bool hue;           // Hue slider, else brightness
+    int value;
+};
+
+/**
+ * Slider drags from every controller for one stage, in arrival order
+ *
+ * A drag lasts 0.5-2 s with writes at the stage rate (±20% jitter),
+ * sweeping from one value to another, then pauses 0.2-0.8 s.
+ */
+static std::vector<Write> dragWorkload(FlickerRandom &rng, uint64_t start, int rate)
+{
+    std::vector<Write> writes;
+    uint64_t end = start + stageMs * 1000ULL;
+    for (int c = 0; c < controllers; c++)
+    {
+        uint64_t t = start + rng.range(0, 300) * 1000ULL;
+        while (t < end)
+        {
+            bool hue = rng.range(0, 3) == 0;
+            int max = hue ? 360 : 100;
+            int from = rng.range(0, max);
+            int to = rng.range(0, max);
+            uint64_t length = rng.range(500, 2000) * 1000ULL;
+            uint64_t period = 1000000ULL / rate;
+            for (uint64_t d = 0; d < length && t + d < end;)
+            {
+                Write w = {t + d, hue, from + (int)((to - from) * (int64_t)d / (int64_t)length)};
+                writes.push_back(w);
+                d += period * rng.range(80, 120) / 100;
+            }
+            t += length + rng.range(200, 800) * 1000ULL;
+        }
+    }
+    std::stable_sort(writes.begin(), writes.end(), [](const Write &a, const Write &b) { return a.at < b.at; });
+    return writes;
+}
+
+// ============================================================================
+// DEVICE MODEL
+// ============================================================================
+
+/**
+ * @class Device
+ * @brief The HomeSpan task: virtual clock, UART FIFO, cost accounting
+ */
+class Device
+{
+public:
+    DEV_CandleLight *lamp;
+    uint64_t now;            // Virtual µs
+    double uartBacklog;      // Bytes still in the TX FIFO
+    uint64_t uartDrainedAt;
+
+    Device() : lamp(NULL), now(0), uartBacklog(0), uartDrainedAt(0) {}
+
+    /**
+     * Run fn on the lamp; advance virtual time by its device cost
+     *
+     * @return Device µs spent, including Serial blocking
+     */
+    template <typename Fn>
+    uint64_t run(Fn fn)
+    {
+        hostSetClock(now);
+        uint64_t bytes = hostSerialBytes();
+        uint64_t start = hostNanos();
+        fn();
+        uint64_t cost = (uint64_t)((hostNanos() - start) * cpuScale / 1000.0);
+        cost += serialBlock(hostSerialBytes() - bytes);
+        now += cost;
+        return cost;
+    }
+
+    void idleUntil(uint64_t t)
+    {
+        if (t > now)
+        {
+            now = t;
+        }
+    }
+
+private:
+    /**
+     * Time a Serial write of n bytes blocks: only what doesn't fit in the FIFO
+     */
+    uint64_t serialBlock(uint64_t n)
+    {
+        double bytesPerUs = baud / 10.0 / 1e6;
+        uartBacklog -= (now - uartDrainedAt) * bytesPerUs;
+        if (uartBacklog < 0)
+        {
+            uartBacklog = 0;
+        }
+        uartDrainedAt = now;
+        uartBacklog += n;
+        if (uartBacklog <= fifoBytes)
+        {
+            return 0;
+        }
+        uint64_t wait = (uint64_t)((uartBacklog - fifoBytes) / bytesPerUs);
+        uartBacklog = fifoBytes;
+        uartDrainedAt = now + wait;
+        return wait;
+    }
+};
+
+// ============================================================================
+// STAGES
+// ============================================================================
+
+static double percentile(std::vector<double> &v, double p)
+{
+    if (v.empty())
+    {
+        return 0;
+    }
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)(p * v.size());
+    return v[i < v.size() ? i : v.size() - 1];
+}
+
+/**
+ * @struct StageResult
+ * @brief Measurements from one write rate
+ */
+struct StageResult
+{
+    std::vector<double> updateUs;
+    std::vector<double> toFrameMs;
+    uint32_t frames;
+    uint32_t missedFrames;
+    uint64_t worstGapUs;
+    uint32_t lost;
+};
+
+static StageResult runStage(Device &dev, const std::vector<Write> &writes, uint64_t end, int &lastHue, int &lastBrightness)
+{
+    StageResult r = StageResult();
+    std::vector<uint64_t> awaiting; // Arrival times of writes not yet on the strips
+    size_t next = 0;
+    uint64_t lastFrame = dev.now;
+
+    while (dev.now < end || next < writes.size() || !awaiting.empty())
+    {
+        // One HAP request per poll, if one has arrived
+        if (next < writes.size() && writes[next].at <= dev.now)
+        {
+            const Write &w = writes[next++];
+            SpanCharacteristic *c = w.hue ? dev.lamp->hue : dev.lamp->brightness;
+            dev.now += requestUs;
+            uint64_t cost = dev.run([&]() {
+                c->hostWrite(w.value);
+                if (dev.lamp->update())
+                {
+                    c->hostCommit();
+                }
+            });
+            r.updateUs.push_back((double)cost);
+            awaiting.push_back(w.at);
+            (w.hue ? lastHue : lastBrightness) = w.value;
+        }
+
+        uint32_t framesBefore = dev.lamp->frameTime.count;
+        dev.run([&]() { dev.lamp->loop(); });
+        if (dev.lamp->frameTime.count != framesBefore)
+        {
+            r.frames++;
+            uint64_t gap = dev.now - lastFrame;
+            if (gap > 1500ULL * OUTPUT_INTERVAL)
+            {
+                uint64_t slots = (gap + 500ULL * OUTPUT_INTERVAL) / (1000ULL * OUTPUT_INTERVAL);
+                r.missedFrames += slots > 1 ? slots - 1 : 1;
+            }
+            if (gap > r.worstGapUs)
+            {
+                r.worstGapUs = gap;
+            }
+            lastFrame = dev.now;
+            for (size_t i = 0; i < awaiting.size(); i++)
+            {
+                r.toFrameMs.push_back((dev.now - awaiting[i]) / 1000.0);
+            }
+            awaiting.clear();
+        }
+        else if (next >= writes.size() || writes[next].at > dev.now)
+        {
+            // Nothing due: sleep to the next write or millisecond
+            uint64_t wake = (dev.now / 1000 + 1) * 1000;
+            if (next < writes.size() && writes[next].at < wake)
+            {
+                wake = writes[next].at;
+            }
+            dev.idleUntil(wake);
+        }
+
+        // A write still waiting long after the stage means it was lost
+        if (dev.now > end + 10000000ULL && !awaiting.empty())
+        {
+            r.lost += awaiting.size();
+            awaiting.clear();
+        }
+    }
+    return r;
+}
+
+// ============================================================================
+// NVS WRITES
+// ============================================================================
+
+/**
+ * @struct Pacer
+ * @brief The frame pacer task: wakes every OUTPUT_INTERVAL
+ */
+struct Pacer
+{
+    DEV_CandleLight *lamp;
+    uint32_t nextWake; // millis()
+
+    static void run(void *arg)
+    {
+        Pacer *pacer = (Pacer *)arg;
+        if ((int32_t)(millis() - pacer->nextWake) >= 0)
+        {
+            pacer->nextWake += OUTPUT_INTERVAL;
+            pacer->lamp->paceFrame(millis(), micros());
+        }
+    }
+};
+
+/**
+ * Run loop() alone for a while so frames are steady
+ */
+static void settle(Device &dev)
+{
+    uint64_t settled = dev.now + 200000;
+    while (dev.now < settled)
+    {
+        dev.run([&]() { dev.lamp->loop(); });
+        dev.idleUntil((dev.now / 1000 + 1) * 1000);
+    }
+}
+
+/**
+ * Run the lamp's NVS write test with loop() blocked, pacer or not
+ *
+ * @return Longest output gap (µs)
+ */
+static uint32_t nvsTest(Device &dev, bool pacer)
+{
+    settle(dev);
+    Pacer task = {dev.lamp, (uint32_t)(dev.now / 1000) + OUTPUT_INTERVAL};
+    hostSetNvsWrite(nvsWriteUs, pacer ? Pacer::run : NULL, &task);
+    hostSetClock(dev.now);
+    uint32_t paced = dev.lamp->pacedFrames;
+    uint32_t before = micros();
+    uint32_t gap = dev.lamp->nvsWriteTest(nvsWrites);
+    dev.now += (uint32_t)(micros() - before);
+    hostSetNvsWrite(0, NULL, NULL);
+
+    printf("  %-11s longest output gap %6.1f ms, %3u flicker ticks (worst interval %5.1f ms), %3u paced frames\n",
+           pacer ? "with pacer" : "loop() only", gap / 1000.0, (unsigned)dev.lamp->frameInterval.count,
+           dev.lamp->frameInterval.worst / 1000.0, (unsigned)(dev.lamp->pacedFrames - paced));
+    return gap;
+}
+
+/**
+ * "@v save" of a one-instruction program, loop() blocked in its NVS write
+ * and the pacer running: the command must leave the pacer free to run
+ *
+ * @return Longest output gap (µs)
+ */
+static uint32_t effectSaveTest(Device &dev)
+{
+    dev.lamp->effectCommand("begin");
+    dev.lamp->effectCommand("+ 00000000"); // end
+    dev.lamp->effectCommand("end");
+    settle(dev);
+
+    Pacer task = {dev.lamp, (uint32_t)(dev.now / 1000) + OUTPUT_INTERVAL};
+    hostSetNvsWrite(nvsWriteUs, Pacer::run, &task);
+    hostSetClock(dev.now);
+    dev.lamp->outputInterval.reset();
+    uint32_t before = micros();
+    dev.lamp->effectCommand("save");
+    uint32_t end = micros();
+    dev.now += (uint32_t)(end - before);
+    hostSetNvsWrite(0, NULL, NULL);
+    dev.lamp->effectCommand("off");
+
+    uint32_t gap = end - dev.lamp->lastOutputMicros;
+    if (dev.lamp->outputInterval.worst > gap)
+    {
+        gap = dev.lamp->outputInterval.worst;
+    }
+    printf("  %-11s longest output gap %6.1f ms\n", "@v save", gap / 1000.0);
+    return gap;
+}
+
+/**
+ * Follower on a connected network whose sockets all fail: loop() may
+ * only retry the multicast join every SYNC_JOIN_RETRY
+ *
+ * @return socket() calls over the run
+ */
+static uint32_t syncJoinTest(Device &dev, uint32_t ms)
+{
+    hostSetWiFi(true);
+    hostSetSocketFail(true);
+    dev.lamp->syncCommand("follower");
+    uint32_t calls = hostSocketCalls();
+    uint64_t end = dev.now + ms * 1000ULL;
+    while (dev.now < end)
+    {
+        dev.run([&]() { dev.lamp->loop(); });
+        dev.idleUntil((dev.now / 1000 + 1) * 1000);
+    }
+    calls = hostSocketCalls() - calls;
+    dev.lamp->syncCommand("off");
+    hostSetSocketFail(false);
+    hostSetWiFi(false);
+
+    printf("  %-11s %u join attempts in %u ms\n", "sync join", (unsigned)calls, (unsigned)ms);
+    return calls;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void parseRates(const char *list)
+{
+    rates.clear();
+    for (const char *p = list; *p;)
+    {
+        int rate = atoi(p);
+        if (rate > 0)
+        {
+            rates.push_back(rate);
+        }
+        p = strchr(p, ',');
+        if (!p)
+        {
+            break;
+        }
+        p++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    parseRates("5,10,20,50,100,200,500");
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value)
+        {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return 2;
+        }
+        if (strcmp(arg, "--controllers") == 0)
+            controllers = atoi(value);
+        else if (strcmp(arg, "--rates") == 0)
+            parseRates(value);
+        else if (strcmp(arg, "--stage-ms") == 0)
+            stageMs = strtoul(value, NULL, 0);
+        else if (strcmp(arg, "--cpu-scale") == 0)
+            cpuScale = atof(value);
+        else if (strcmp(arg, "--request-us") == 0)
+            requestUs = strtoul(value, NULL, 0);
+        else if (strcmp(arg, "--baud") == 0)
+            baud = strtoul(value, NULL, 0);
+        else if (strcmp(arg, "--fifo") == 0)
+            fifoBytes = strtoul(value, NULL, 0);
+        else if (strcmp(arg, "--nvs-writes") == 0)
+            nvsWrites = atoi(value);
+        else if (strcmp(arg, "--nvs-write-us") == 0)
+            nvsWriteUs = strtoul(value, NULL, 0);
+        else if (strcmp(arg, "--seed") == 0)
+            seed = strtoul(value, NULL, 0);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return 2;
+        }
+        i++;
+    }
+    if (controllers < 1 || rates.empty() || baud == 0)
+    {
+        fprintf(stderr, "Need at least one controller, one rate and a baud rate\n");
+        return 2;
+    }
+
+    hostReset();
+    hostSetClock(1000000);
+    Device dev;
+    dev.now = 1000000;
+    dev.uartDrainedAt = dev.now;
+    dev.lamp = new DEV_CandleLight();
+    dev.run([&]() {
+        dev.lamp->power->hostWrite(1);
+        if (dev.lamp->update())
+        {
+            dev.lamp->power->hostCommit();
+        }
+    });
+
+    FlickerRandom rng;
+    rng.seed(seed);
+    int lastHue = dev.lamp->hue->getVal();
+    int lastBrightness = dev.lamp->brightness->getVal();
+    bool ok = true;
+
+    printf("%d controllers, %u ms per stage, cpu-scale %.0f, %u us/request, %u baud\n",
+           controllers, (unsigned)stageMs, cpuScale, (unsigned)requestUs, (unsigned)baud);
+    printf("%8s %8s | %-26s | %-26s | %7s %7s\n", "writes/s", "writes", "update us p50/p99/p999",
+           "to-frame ms p50/p99/p999", "missed", "gap ms");
+    for (size_t s = 0; s < rates.size(); s++)
+    {
+        uint64_t start = dev.now;
+        std::vector<Write> writes = dragWorkload(rng, start, rates[s]);
+        StageResult r = runStage(dev, writes, start + stageMs * 1000ULL, lastHue, lastBrightness);
+
+        char update[32], toFrame[32];
+        snprintf(update, sizeof(update), "%.0f / %.0f / %.0f", percentile(r.updateUs, 0.5),
+                 percentile(r.updateUs, 0.99), percentile(r.updateUs, 0.999));
+        snprintf(toFrame, sizeof(toFrame), "%.1f / %.1f / %.1f", percentile(r.toFrameMs, 0.5),
+                 percentile(r.toFrameMs, 0.99), percentile(r.toFrameMs, 0.999));
+        printf("%8d %8u | %-26s | %-26s | %6.1f%% %7.1f\n", rates[s] * controllers, (unsigned)writes.size(),
+               update, toFrame, r.frames ? 100.0 * r.missedFrames / (r.frames + r.missedFrames) : 0.0,
+               r.worstGapUs / 1000.0);
+
+        if (r.lost)
+        {
+            printf("  FAIL: %u writes never reached a frame\n", (unsigned)r.lost);
+            ok = false;
+        }
+        if (dev.lamp->hue->getVal() != lastHue || dev.lamp->brightness->getVal() != lastBrightness)
+        {
+            printf("  FAIL: lamp at hue %d brightness %d, last written %d / %d\n", dev.lamp->hue->getVal(),
+                   dev.lamp->brightness->getVal(), lastHue, lastBrightness);
+            ok = false;
+        }
+    }
+
+    printf("NVS writes: %d x %u us with loop() blocked\n", nvsWrites, (unsigned)nvsWriteUs);
+    nvsTest(dev, false);
+    uint32_t pacedGap = nvsTest(dev, true);
+    uint32_t saveGap = effectSaveTest(dev);
+    if (pacedGap >= 1000UL * (PACER_STALL_MS + OUTPUT_INTERVAL) ||
+        saveGap >= 1000UL * (PACER_STALL_MS + OUTPUT_INTERVAL))
+    {
+        printf("  FAIL: %.1f ms without a frame with the pacer running\n",
+               (pacedGap > saveGap ? pacedGap : saveGap) / 1000.0);
+        ok = false;
+    }
+
+    const uint32_t joinMs = 10000;
+    if (syncJoinTest(dev, joinMs) > joinMs / SYNC_JOIN_RETRY + 1)
+    {
+        printf("  FAIL: failed sync joins retried faster than every %u ms\n", (unsigned)SYNC_JOIN_RETRY);
+        ok = false;
+    }
+
+    delete dev.lamp;
+    hostReset();
+    printf(ok ? "PASS\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}
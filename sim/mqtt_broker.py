@@ -0,0 +1,214 @@
+"""
+@file mqtt_broker.py
+@brief Minimal MQTT 3.1.1 broker stand-in for host tests
+
+Enough of a broker to exercise the lamp's MQTT client on Linux without
+installing one: CONNECT (with last will), SUBSCRIBE (exact topics and a
+trailing '#'), QoS 0 PUBLISH with retained messages, PINGREQ and
+DISCONNECT. A connection lost without DISCONNECT publishes its will.
+Every publish is logged with its arrival time for the test to inspect.
+
+Standalone: python3 sim/mqtt_broker.py [port]   (prints all publishes)
+
+@license MIT License
+Copyright (c) 2025 @outofjungle
+"""
+
+import socket
+import struct
+import sys
+import threading
+import time
+
+
+def encode_length(n):
+    out = bytearray()
+    while True:
+        digit, n = n % 128, n // 128
+        out.append(digit | (0x80 if n else 0))
+        if not n:
+            return bytes(out)
+
+
+def encode_str(s):
+    data = s.encode() if isinstance(s, str) else s
+    return struct.pack(">H", len(data)) + data
+
+
+def publish_packet(topic, payload, retain=False):
+    body = encode_str(topic) + payload
+    return bytes([0x30 | (1 if retain else 0)]) + encode_length(len(body)) + body
+
+
+def matches(pattern, topic):
+    if pattern.endswith("#"):
+        return topic.startswith(pattern[:-1])
+    return pattern == topic
+
+
+class Client:
+    def __init__(self, broker, sock):
+        self.broker = broker
+        self.sock = sock
+        self.lock = threading.Lock()
+        self.subscriptions = []
+        self.will = None
+        self.client_id = "?"
+
+    def send(self, data):
+        with self.lock:
+            try:
+                self.sock.sendall(data)
+            except OSError:
+                pass
+
+    def read_exact(self, n):
+        data = b""
+        while len(data) < n:
+            chunk = self.sock.recv(n - len(data))
+            if not chunk:
+                raise ConnectionError
+            data += chunk
+        return data
+
+    def read_packet(self):
+        first = self.read_exact(1)[0]
+        length, shift = 0, 0
+        while True:
+            digit = self.read_exact(1)[0]
+            length |= (digit & 0x7F) << shift
+            shift += 7
+            if not digit & 0x80:
+                break
+        return first >> 4, first & 0x0F, self.read_exact(length)
+
+    def run(self):
+        clean = False
+        try:
+            while True:
+                kind, flags, body = self.read_packet()
+                if kind == 1:
+                    self.connect(body)
+                elif kind == 3:
+                    self.publish(flags, body)
+                elif kind == 8:
+                    self.subscribe(body)
+                elif kind == 12:
+                    self.send(b"\xd0\x00")
+                elif kind == 14:
+                    clean = True
+                    break
+        except (ConnectionError, OSError):
+            pass
+        finally:
+            self.broker.remove(self)
+            try:
+                self.sock.close()
+            except OSError:
+                pass
+            if not clean and self.will:
+                self.broker.route(*self.will)
+
+    def connect(self, body):
+        pos = 2 + struct.unpack(">H", body[:2])[0]
+        level, flags = body[pos], body[pos + 1]
+        pos += 4
+
+        def take():
+            nonlocal pos
+            n = struct.unpack(">H", body[pos:pos + 2])[0]
+            value = body[pos + 2:pos + 2 + n]
+            pos += 2 + n
+            return value
+
+        self.client_id = take().decode()
+        if flags & 0x04:
+            topic, message = take().decode(), take()
+            self.will = (topic, message, bool(flags & 0x20))
+        ok = level == 4
+        self.send(bytes([0x20, 2, 0, 0 if ok else 1]))
+
+    def publish(self, flags, body):
+        n = struct.unpack(">H", body[:2])[0]
+        topic = body[2:2 + n].decode()
+        pos = 2 + n + (2 if flags & 0x06 else 0)
+        self.broker.route(topic, body[pos:], bool(flags & 0x01))
+
+    def subscribe(self, body):
+        packet_id = body[:2]
+        pos, granted = 2, bytearray()
+        while pos < len(body):
+            n = struct.unpack(">H", body[pos:pos + 2])[0]
+            self.subscriptions.append(body[pos + 2:pos + 2 + n].decode())
+            pos += 3 + n
+            granted.append(0)
+        self.send(bytes([0x90]) + encode_length(2 + len(granted)) + packet_id + bytes(granted))
+        for topic, payload in list(self.broker.retained.items()):
+            if any(matches(p, topic) for p in self.subscriptions):
+                self.send(publish_packet(topic, payload, True))
+
+
+class Broker:
+    def __init__(self, port=0):
+        self.server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.server.bind(("127.0.0.1", port))
+        self.server.listen(8)
+        self.port = self.server.getsockname()[1]
+        self.clients = []
+        self.retained = {}
+        self.log = []  # (time, topic, payload, retain)
+        self.lock = threading.Lock()
+        threading.Thread(target=self.accept, daemon=True).start()
+
+    def accept(self):
+        while True:
+            try:
+                sock, _ = self.server.accept()
+            except OSError:
+                return
+            client = Client(self, sock)
+            with self.lock:
+                self.clients.append(client)
+            threading.Thread(target=client.run, daemon=True).start()
+
+    def remove(self, client):
+        with self.lock:
+            if client in self.clients:
+                self.clients.remove(client)
+
+    def route(self, topic, payload, retain=False):
+        with self.lock:
+            self.log.append((time.time(), topic, payload, retain))
+            if retain:
+                self.retained[topic] = payload
+            targets = [c for c in self.clients if any(matches(p, topic) for p in c.subscriptions)]
+        for client in targets:
+            client.send(publish_packet(topic, payload))
+
+    def drop_clients(self):
+        """Close every connection abruptly, as a broker restart would"""
+        with self.lock:
+            clients = list(self.clients)
+        for client in clients:
+            try:
+                client.sock.shutdown(socket.SHUT_RDWR)
+            except OSError:
+                pass
+
+    def messages(self, topic, since=0.0):
+        with self.lock:
+            return [(t, p) for t, tp, p, _ in self.log if tp == topic and t >= since]
+
+
+if __name__ == "__main__":
+    broker = Broker(int(sys.argv[1]) if len(sys.argv) > 1 else 1883)
+    print("Broker listening on port %d" % broker.port)
+    seen = 0
+    while True:
+        time.sleep(0.2)
+        with broker.lock:
+            new = broker.log[seen:]
+            seen = len(broker.log)
+        for t, topic, payload, retain in new:
+            print("%s%s %s" % (topic, " (retained)" if retain else "", payload.decode(errors="replace")))
@@ -0,0 +1,198 @@
+/**
+ * @file mqtt_sim.cpp
+ * @brief Host lamp for testing the MQTT bridge against a local broker
+ *
+ * Runs the firmware's MqttClient, PublishBatcher and command parser with
+ * a simulated lamp state and the real FlickerEngine for frame timing.
+ * Mirrors MqttBridge's loop: announce on connect, batch state changes,
+ * publish metrics, apply commands from <prefix>/set. sim/run_mqtt.py
+ * drives it through sim/mqtt_broker.py.
+ *
+ * Usage:
+ *   mqtt_sim [--port N] [--duration MS] [--metrics MS] [--reconnect MS]
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "ControlProtocol.h"
+#include "FlickerEngine.h"
+#include "FrameStats.h"
+#include "MqttClient.h"
+#include "MqttProtocol.h"
+
+#define TOPIC_STATE MQTT_TOPIC_PREFIX "/state"
+#define TOPIC_METRICS MQTT_TOPIC_PREFIX "/metrics"
+#define TOPIC_STATUS MQTT_TOPIC_PREFIX "/status"
+#define TOPIC_SET MQTT_TOPIC_PREFIX "/set"
+
+/**
+ * Milliseconds on the host's monotonic clock
+ */
+static uint32_t hostMillis()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000);
+}
+
+static uint32_t hostMicros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+/**
+ * Simulated lamp: the state the characteristics would hold
+ */
+struct SimLamp
+{
+    ControlState state;
+    PublishBatcher batch;
+    uint32_t rejected;
+
+    SimLamp() : state{true, DEFAULT_HUE, DEFAULT_SATURATION, DEFAULT_BRIGHTNESS}, batch(MQTT_PUBLISH_INTERVAL), rejected(0) {}
+};
+
+static void onMessage(void *context, const char *topic, size_t topicLength,
+                      const uint8_t *payload, size_t length)
+{
+    SimLamp *lamp = (SimLamp *)context;
+    ControlCommand cmd;
+    if (!parseControlCommand((const char *)payload, length, cmd))
+    {
+        lamp->rejected++;
+        return;
+    }
+
+    // What applyControl() followed by publishControlState() amounts to
+    if (cmd.fields & CONTROL_POWER)
+        lamp->state.power = cmd.power;
+    if (cmd.fields & CONTROL_HUE)
+        lamp->state.hue = cmd.hue;
+    if (cmd.fields & CONTROL_SATURATION)
+        lamp->state.saturation = cmd.saturation;
+    if (cmd.fields & CONTROL_BRIGHTNESS)
+        lamp->state.brightness = cmd.brightness;
+    lamp->batch.mark(hostMillis());
+}
+
+static void publishState(MqttClient &client, SimLamp &lamp, uint32_t now)
+{
+    char json[96];
+    size_t length = encodeControlState(lamp.state, json, sizeof(json));
+    if (client.publish(TOPIC_STATE, json, length, true, now))
+    {
+        lamp.batch.sent();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t port = MQTT_PORT;
+    uint32_t duration = 5000;
+    uint32_t metricsInterval = MQTT_METRICS_INTERVAL;
+    uint32_t reconnectDelay = MQTT_RECONNECT_DELAY;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--port") == 0)
+            port = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--duration") == 0)
+            duration = strtoul(argv[i + 1], NULL, 0);
+        else if (strcmp(argv[i], "--metrics") == 0)
+            metricsInterval = strtoul(argv[i + 1], NULL, 0);
+        else if (strcmp(argv[i], "--reconnect") == 0)
+            reconnectDelay = strtoul(argv[i + 1], NULL, 0);
+        else
+        {
+            fprintf(stderr, "usage: mqtt_sim [--port N] [--duration MS] [--metrics MS] [--reconnect MS]\n");
+            return 2;
+        }
+    }
+
+    MqttConnectOptions options = {"mqtt-sim", MQTT_USER, MQTT_PASSWORD, TOPIC_STATUS, "offline", MQTT_KEEPALIVE};
+    MqttClient client(options, TOPIC_SET);
+    client.reconnectDelay = reconnectDelay;
+    SimLamp lamp;
+    client.onMessage(onMessage, &lamp);
+
+    FlickerEngine engine;
+    engine.rng.seed(1);
+    FrameStats frameTime;
+    bool announced = false;
+    uint32_t start = hostMillis();
+    uint32_t lastStep = start;
+    uint32_t lastMetrics = start;
+
+    for (uint32_t now = start; now - start < duration; now = hostMillis())
+    {
+        if (!client.poll("127.0.0.1", port, now, 5))
+        {
+            announced = false;
+            continue;
+        }
+        now = hostMillis();
+
+        if (!announced)
+        {
+            client.publish(TOPIC_STATUS, "online", 6, true, now);
+            publishState(client, lamp, now);
+            announced = true;
+        }
+        if (lamp.batch.due(now))
+        {
+            publishState(client, lamp, now);
+        }
+
+        // Flicker steps stand in for the render loop's frame timing
+        if (now - lastStep >= UPDATE_INTERVAL)
+        {
+            lastStep = now;
+            uint32_t t0 = hostMicros();
+            engine.render(LED_LENGTH, 0.0f, lamp.state.hue, lamp.state.saturation, true);
+            frameTime.record(hostMicros() - t0);
+        }
+
+        if (now - lastMetrics >= metricsInterval)
+        {
+            lastMetrics = now;
+            LampMetrics metrics = {(now - start) / 1000, 0, 0, frameTime.count, frameTime.average(),
+                                   frameTime.worst, 0, 0, 0, 0};
+            char json[256];
+            size_t length = encodeMetrics(metrics, json, sizeof(json));
+            client.publish(TOPIC_METRICS, json, length, false, now);
+        }
+    }
+
+    fprintf(stderr, "mqtt_sim: connects %u failures %u received %u rejected %u changes %u publishes %u\n",
+            (unsigned)client.connects, (unsigned)client.failures, (unsigned)client.received,
+            (unsigned)lamp.rejected, (unsigned)lamp.batch.changes, (unsigned)lamp.batch.publishes);
+    client.disconnect();
+    return 0;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file realtime_sim.cpp
+ * @brief Host receiver for DDP and E1.31 pixel streams
+ *
+ * Runs the lamp's packet parsers (RealtimeProtocol.h) on real sockets:
+ * DDP unicast on loopback and E1.31 on the universe's multicast group.
+ * Every complete frame is checked against the generator's test pattern
+ * (byte j of frame n is n * 7 + j) to catch torn or misplaced writes.
+ * sim/run_realtime.py sends the streams and checks the summary.
+ *
+ * Prints one summary line per protocol when the stream ends:
+ *   "<proto> frames=N torn=N dropped=N stale=N terminated=N"
+ *
+ * Usage:
+ *   realtime_sim [--duration MS]
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "RealtimeProtocol.h"
+
+/**
+ * Milliseconds on the host's monotonic clock
+ */
+static uint32_t hostMillis()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000);
+}
+
+/**
+ * UDP socket bound to a port, optionally joined to a multicast group
+ */
+static int openSocket(uint16_t port, uint32_t group)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        perror("socket");
+        exit(1);
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("bind");
+        exit(1);
+    }
+
+    if (group != 0)
+    {
+        struct ip_mreq mreq;
+        mreq.imr_multiaddr.s_addr = htonl(group);
+        mreq.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+        {
+            perror("IP_ADD_MEMBERSHIP");
+            exit(1);
+        }
+    }
+    return fd;
+}
+
+/**
+ * Per-protocol counters
+ */
+struct StreamCheck
+{
+    const char *name;
+    uint32_t frames;
+    uint32_t torn;       // Complete frames not matching the test pattern
+    uint32_t terminated;
+    SequenceTracker seq;
+
+    /**
+     * Check a complete frame covering the first length bytes
+     */
+    void frame(const uint8_t *pixels, size_t length)
+    {
+        frames++;
+        for (size_t j = 1; j < length; j++)
+        {
+            if (pixels[j] != (uint8_t)(pixels[0] + j))
+            {
+                torn++;
+                return;
+            }
+        }
+    }
+
+    void print() const
+    {
+        printf("%s frames=%u torn=%u dropped=%u stale=%u terminated=%u\n", name,
+               (unsigned)frames, (unsigned)torn, (unsigned)seq.dropped,
+               (unsigned)seq.stale, (unsigned)terminated);
+    }
+};
+
+int main(int argc, char **argv)
+{
+    uint32_t duration = 3000;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--duration") == 0)
+        {
+            duration = strtoul(argv[i + 1], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: realtime_sim [--duration MS]\n");
+            return 2;
+        }
+    }
+
+    const int ddp = openSocket(DDP_PORT, 0);
+    const int e131 = openSocket(E131_PORT, 0xEFFF0000u | REALTIME_E131_UNIVERSE);
+
+    // Same layout as the lamp's leds[][]: strip after strip, RGB
+    static uint8_t pixels[NUM_STRIPS * LED_LENGTH * 3];
+    static uint8_t packet[1472];
+    StreamCheck ddpCheck = {"ddp", 0, 0, 0, SequenceTracker()};
+    StreamCheck e131Check = {"e131", 0, 0, 0, SequenceTracker()};
+
+    // Stop early once E1.31 terminates (the generator's last step)
+    uint32_t start = hostMillis();
+    while (hostMillis() - start < duration && e131Check.terminated == 0)
+    {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(ddp, &fds);
+        FD_SET(e131, &fds);
+        struct timeval tv = {0, 10000};
+        if (select((ddp > e131 ? ddp : e131) + 1, &fds, NULL, NULL, &tv) <= 0)
+        {
+            continue;
+        }
+
+        if (FD_ISSET(ddp, &fds))
+        {
+            ssize_t length = recv(ddp, packet, sizeof(packet), 0);
+            if (length > 0 &&
+                parseDdp(packet, length, pixels, sizeof(pixels), ddpCheck.seq) == RT_FRAME)
+            {
+                ddpCheck.frame(pixels, sizeof(pixels));
+                memset(pixels, 0, sizeof(pixels));
+            }
+        }
+        if (FD_ISSET(e131, &fds))
+        {
+            ssize_t length = recv(e131, packet, sizeof(packet), 0);
+            if (length <= 0)
+            {
+                continue;
+            }
+            switch (parseE131(packet, length, REALTIME_E131_UNIVERSE, pixels, sizeof(pixels), e131Check.seq))
+            {
+            case RT_FRAME:
+                e131Check.frame(pixels, sizeof(pixels));
+                memset(pixels, 0, sizeof(pixels));
+                break;
+            case RT_TERMINATED:
+                e131Check.terminated++;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    ddpCheck.print();
+    e131Check.print();
+    close(ddp);
+    close(e131);
+    return 0;
+}
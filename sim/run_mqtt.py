@@ -0,0 +1,106 @@
+"""
+@file run_mqtt.py
+@brief Check the MQTT bridge against the local broker stand-in
+
+Starts sim/mqtt_broker.py in-process and sim/mqtt_sim, then checks:
+
+- on connect the lamp announces "online" and its state (both retained)
+- a burst of slider changes on <prefix>/set becomes one state publish
+  carrying the last value; malformed commands publish nothing
+- metrics arrive periodically as JSON with a growing frame count
+- after the broker drops the connection the lamp reconnects and
+  announces itself again
+- killing the lamp makes the broker publish its "offline" last will
+
+Usage: python3 sim/run_mqtt.py <path to mqtt_sim>
+
+@license MIT License
+Copyright (c) 2025 @outofjungle
+"""
+
+import json
+import os
+import signal
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mqtt_broker import Broker  # noqa: E402
+
+PREFIX = "aladdin-lamp"        # MQTT_TOPIC_PREFIX
+BATCH_WINDOW = 0.25            # MQTT_PUBLISH_INTERVAL
+BURST = 20                     # Slider changes sent 5 ms apart
+
+
+def wait_for(predicate, timeout):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        if predicate():
+            return True
+        time.sleep(0.02)
+    return False
+
+
+def main():
+    sim = sys.argv[1] if len(sys.argv) > 1 else ".pio/sim/mqtt_sim"
+    broker = Broker()
+    lamp = subprocess.Popen([sim, "--port", str(broker.port), "--duration", "20000",
+                             "--metrics", "300", "--reconnect", "300"])
+    results = []
+
+    def check(name, ok, detail=""):
+        results.append(ok)
+        print("%-44s %s %s" % (name, "OK" if ok else "FAIL", detail))
+
+    status = lambda since=0.0: [p for _, p in broker.messages(PREFIX + "/status", since)]  # noqa: E731
+    states = lambda since=0.0: [json.loads(p) for _, p in broker.messages(PREFIX + "/state", since)]  # noqa: E731
+
+    try:
+        check("announces online and state on connect",
+              wait_for(lambda: status() == [b"online"] and len(states()) == 1, 3.0))
+
+        # Wait for the subscription to be in place before commanding
+        wait_for(lambda: any(c.subscriptions for c in broker.clients), 2.0)
+        burst_start = time.time()
+        for level in range(1, BURST + 1):
+            broker.route(PREFIX + "/set", json.dumps({"brightness": level}).encode())
+            time.sleep(0.005)
+        time.sleep(BATCH_WINDOW + 0.3)
+        burst = states(burst_start)
+        check("burst of %d changes -> one publish" % BURST,
+              len(burst) == 1 and burst[0]["brightness"] == BURST, str(burst))
+
+        before = time.time()
+        broker.route(PREFIX + "/set", b'{"brightness": 500}')
+        broker.route(PREFIX + "/set", b'{"brightness": ')
+        time.sleep(BATCH_WINDOW + 0.2)
+        check("malformed commands publish nothing", states(before) == [])
+
+        wait_for(lambda: len(broker.messages(PREFIX + "/metrics")) >= 3, 3.0)
+        metrics = [json.loads(p) for _, p in broker.messages(PREFIX + "/metrics")]
+        check("periodic metrics", len(metrics) >= 3 and metrics[-1]["frames"] > metrics[0]["frames"],
+              "%d messages, frames %s" % (len(metrics), [m["frames"] for m in metrics[:3]]))
+
+        dropped = time.time()
+        broker.drop_clients()
+        reconnected = wait_for(lambda: b"online" in status(dropped) and states(dropped), 3.0)
+        check("reconnects and re-announces", reconnected,
+              "" if not reconnected else "%.0f ms" % (1000 * (broker.messages(PREFIX + "/status", dropped)[-1][0] - dropped)))
+        check("state survives reconnect", states(dropped)[-1:] and states(dropped)[-1]["brightness"] == BURST)
+
+        killed = time.time()
+        lamp.send_signal(signal.SIGKILL)
+        lamp.wait()
+        check("last will on lost connection", wait_for(lambda: status(killed) == [b"offline"], 3.0))
+    finally:
+        if lamp.poll() is None:
+            lamp.kill()
+
+    if not all(results):
+        sys.exit(1)
+    print("MQTT bridge OK")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,123 @@
+"""
+@file run_realtime.py
+@brief Stream DDP and E1.31 test patterns to sim/realtime_sim over loopback
+
+Starts realtime_sim, then plays the parts of a lighting console:
+
+- DDP: frames split over two packets, pushed by the second, with one
+  whole frame left out every DROP_EVERY frames
+- E1.31: one packet per frame on the universe's multicast group, with
+  the same gaps, one late duplicate, then a stream-terminated packet
+
+and checks that every frame arrived intact and that the lamp's
+sequence trackers counted exactly the gaps and the late packet.
+
+Usage: python3 sim/run_realtime.py <path to realtime_sim>
+
+@license MIT License
+Copyright (c) 2025 @outofjungle
+"""
+
+import socket
+import struct
+import subprocess
+import sys
+import time
+
+DDP_PORT = 4048
+E131_PORT = 5568
+UNIVERSE = 1              # REALTIME_E131_UNIVERSE
+PIXEL_BYTES = 2 * 8 * 3   # NUM_STRIPS * LED_LENGTH * 3
+FRAMES = 60
+DROP_EVERY = 10
+FPS = 200
+
+
+def skipped(frame):
+    # Mid-stream gaps only: a gap at the very end is never noticed
+    return frame % DROP_EVERY == DROP_EVERY // 2
+
+
+def pattern(frame):
+    return bytes((frame * 7 + j) & 0xFF for j in range(PIXEL_BYTES))
+
+
+def ddp_packet(seq, offset, data, push):
+    flags = 0x40 | (0x01 if push else 0)
+    return struct.pack(">BBBBIH", flags, seq, 0x0B, 1, offset, len(data)) + data
+
+
+def e131_packet(seq, data, options=0):
+    channels = len(data) + 1
+    dmp = struct.pack(">HBBHHH", 0x7000 | (10 + channels), 0x02, 0xA1, 0, 1, channels) + b"\x00" + data
+    framing = (struct.pack(">HI", 0x7000 | (77 + len(dmp)), 0x02)
+               + b"run_realtime".ljust(64, b"\x00")
+               + struct.pack(">BHBBH", 100, 0, seq, options, UNIVERSE))
+    root = (struct.pack(">HH", 0x0010, 0x0000) + b"ASC-E1.17\x00\x00\x00"
+            + struct.pack(">HI", 0x7000 | (22 + len(framing) + len(dmp)), 0x04)
+            + bytes(range(16)))
+    return root + framing + dmp
+
+
+def main():
+    sim = sys.argv[1] if len(sys.argv) > 1 else ".pio/sim/realtime_sim"
+    receiver = subprocess.Popen([sim, "--duration", "5000"], stdout=subprocess.PIPE, text=True)
+    time.sleep(0.3)
+
+    tx = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    tx.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_IF, socket.inet_aton("127.0.0.1"))
+    group = "239.255.%d.%d" % (UNIVERSE >> 8, UNIVERSE & 0xFF)
+
+    sent = dropped_frames = 0
+    seq = 0
+    half = PIXEL_BYTES // 2
+    for frame in range(FRAMES):
+        data = pattern(frame)
+        for part in range(2):
+            seq = seq % 15 + 1
+            if skipped(frame):
+                continue
+            offset = part * half
+            tx.sendto(ddp_packet(seq, offset, data[offset:offset + half], part == 1), ("127.0.0.1", DDP_PORT))
+        if skipped(frame):
+            dropped_frames += 1
+        else:
+            sent += 1
+        time.sleep(1.0 / FPS)
+
+    e131_sent = 0
+    for frame in range(FRAMES):
+        if skipped(frame):
+            continue
+        packet = e131_packet(frame & 0xFF, pattern(frame))
+        tx.sendto(packet, (group, E131_PORT))
+        e131_sent += 1
+        if frame == FRAMES // 2:
+            tx.sendto(packet, (group, E131_PORT))  # Late duplicate
+        time.sleep(1.0 / FPS)
+    tx.sendto(e131_packet(FRAMES & 0xFF, b"", 0x40), (group, E131_PORT))
+
+    results = {}
+    for line in receiver.communicate()[0].splitlines():
+        proto, *fields = line.split()
+        results[proto] = dict((k, int(v)) for k, v in (f.split("=") for f in fields))
+
+    expected = {
+        "ddp": dict(frames=sent, torn=0, dropped=2 * dropped_frames, stale=0, terminated=0),
+        "e131": dict(frames=e131_sent, torn=0, dropped=dropped_frames, stale=1, terminated=1),
+    }
+    failed = False
+    for proto, want in expected.items():
+        got = results.get(proto, {})
+        ok = got == want
+        failed |= not ok
+        print("%-4s %s  %s" % (proto, " ".join("%s=%s" % kv for kv in sorted(got.items())),
+                              "OK" if ok else "FAIL (expected %s)" % want))
+
+    if failed:
+        sys.exit(1)
+    print("All frames received intact, gaps and late packets accounted for")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,80 @@
+"""
+@file run_sync.py
+@brief Check multi-lamp flicker sync with simulated lamps over loopback
+
+Starts one leader and several followers of sim/sync_sim at staggered
+times, then checks that each follower, from its first locked step,
+renders the same flicker as the leader for the same frame (or frame +
+offset) and starts its steps within a few milliseconds of the leader's.
+
+Usage: python3 sim/run_sync.py <path to sync_sim>
+
+@license MIT License
+Copyright (c) 2025 @outofjungle
+"""
+
+import subprocess
+import sys
+import time
+
+MAX_PHASE_MS = 5     # Allowed step start difference between lamps
+MIN_CHECKED = 20     # Each follower must produce at least this many comparisons
+
+# (start delay s, duration ms, frame offset)
+FOLLOWERS = (
+    (0.4, 3600, 0),
+    (1.3, 2600, 0),
+    (0.8, 3000, 3),
+)
+
+
+def parse(output):
+    frames = {}
+    for line in output.splitlines():
+        frame, digest, start = line.split()
+        frames[int(frame)] = (digest, int(start))
+    return frames
+
+
+def main():
+    sim = sys.argv[1] if len(sys.argv) > 1 else ".pio/sim/sync_sim"
+
+    leader = subprocess.Popen([sim, "leader", "--duration", "4500"],
+                              stdout=subprocess.PIPE, text=True)
+    followers = []
+    began = time.time()
+    for delay, duration, offset in sorted(FOLLOWERS):
+        time.sleep(max(0.0, delay - (time.time() - began)))
+        proc = subprocess.Popen([sim, "follower", "--duration", str(duration), "--offset", str(offset)],
+                                stdout=subprocess.PIPE, text=True)
+        followers.append((proc, offset))
+
+    reference = parse(leader.communicate()[0])
+    failed = False
+
+    for n, (proc, offset) in enumerate(followers, 1):
+        frames = parse(proc.communicate()[0])
+        checked = mismatched = 0
+        worst_phase = 0
+        for frame in sorted(frames):
+            digest, start = frames[frame]
+            if frame in reference:
+                worst_phase = max(worst_phase, abs(start - reference[frame][1]))
+            if frame + offset not in reference:
+                continue
+            checked += 1
+            if digest != reference[frame + offset][0]:
+                mismatched += 1
+
+        ok = checked >= MIN_CHECKED and mismatched == 0 and worst_phase <= MAX_PHASE_MS
+        failed |= not ok
+        print("follower %d (offset %d): %d frames compared, %d mismatched, worst phase %d ms  %s"
+              % (n, offset, checked, mismatched, worst_phase, "OK" if ok else "FAIL"))
+
+    if failed:
+        sys.exit(1)
+    print("All followers in sync with the leader")
+
+
+if __name__ == "__main__":
+    main()
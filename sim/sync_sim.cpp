@@ -0,0 +1,283 @@
+/**
+ * @file sync_sim.cpp
+ * @brief Host simulator for multi-lamp flicker sync over UDP multicast
+ *
+ * Runs one simulated lamp: the real FlickerEngine and SyncClock driven
+ * by the host clock, with beacons on a loopback multicast group. Start
+ * several instances (one leader, some followers) and compare their
+ * output; sim/run_sync.py does exactly that.
+ *
+ * Prints one line per flicker step, "<frame> <hash> <time>": hash is an
+ * FNV-1a over the step's flame colors, time the step's start on the
+ * host monotonic clock (ms), which all instances share. Followers print
+ * only once they have locked to a leader.
+ *
+ * With --timeline, the lamp's steps are also recorded with the firmware's
+ * Timeline spans and written as Chrome trace-event JSON on exit (open in
+ * ui.perfetto.dev or chrome://tracing). Timestamps are the shared host
+ * clock, so several lamps' files line up.
+ *
+ * Usage:
+ *   sync_sim leader   [--seed N] [--duration MS] [--group N] [--timeline FILE]
+ *   sync_sim follower [--offset N] [--duration MS] [--group N] [--timeline FILE]
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "FlickerEngine.h"
+#include "FlickerSync.h"
+#include "Timeline.h"
+
+// Group address as a dotted string, from the config.h byte list
+#define SIM_STR2(a, b, c, d) #a "." #b "." #c "." #d
+#define SIM_STR(x) SIM_STR2(x)
+#define SIM_MULTICAST_ADDR SIM_STR(SYNC_MULTICAST_ADDR)
+
+/**
+ * Milliseconds on the host's monotonic clock (wraps like millis())
+ */
+static uint32_t hostMillis()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000);
+}
+
+/**
+ * Non-blocking UDP socket joined to the sync group on loopback
+ */
+static int openSyncSocket()
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        perror("socket");
+        exit(1);
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SYNC_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        perror("bind");
+        exit(1);
+    }
+
+    struct ip_mreq mreq;
+    mreq.imr_multiaddr.s_addr = inet_addr(SIM_MULTICAST_ADDR);
+    mreq.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+    {
+        perror("IP_ADD_MEMBERSHIP");
+        exit(1);
+    }
+
+    struct in_addr iface;
+    iface.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface));
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &one, sizeof(one));
+
+    struct timeval tv = {0, 1000}; // 1 ms receive timeout doubles as the loop delay
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+}
+
+Timeline timeline;
+
+/**
+ * Write the recorded spans as Chrome trace-event JSON
+ */
+static void writeTimeline(const char *path, const char *role)
+{
+    FILE *out = fopen(path, "w");
+    if (!out)
+    {
+        perror(path);
+        return;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+    int pid = getpid();
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"sync_sim %s\"}}",
+            pid, role);
+    timeline.forEach([&](const TimelineEntry &e) {
+        fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":%d,\"tid\":%u}",
+                Timeline::spanName(e.span()), (unsigned long long)Timeline::unwrap(e.start, now),
+                (unsigned)e.duration(), pid, (unsigned)e.track());
+    });
+    fprintf(out, "\n]}\n");
+    fclose(out);
+    fprintf(stderr, "%s: %u spans written to %s\n", role, (unsigned)timeline.count(), path);
+}
+
+/**
+ * FNV-1a over the lit LEDs' flame colors
+ */
+static uint32_t hashFlame(const FlickerEngine &engine, int count)
+{
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < count; i++)
+    {
+        const uint8_t bytes[3] = {engine.flame[i].h, engine.flame[i].s, engine.flame[i].v};
+        for (int k = 0; k < 3; k++)
+        {
+            h = (h ^ bytes[k]) * 16777619u;
+        }
+    }
+    return h;
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: sync_sim leader|follower [--seed N] [--offset N] [--group N] [--duration MS]\n"
+                    "                                [--timeline FILE]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        usage();
+    }
+    bool leader = strcmp(argv[1], "leader") == 0;
+    if (!leader && strcmp(argv[1], "follower") != 0)
+    {
+        usage();
+    }
+
+    uint32_t seed = (uint32_t)getpid() * 2654435761u;
+    int32_t offset = 0;
+    int group = SYNC_GROUP;
+    uint32_t duration = 3000;
+    const char *timelinePath = NULL;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--seed") == 0)
+            seed = strtoul(argv[i + 1], NULL, 0);
+        else if (strcmp(argv[i], "--offset") == 0)
+            offset = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--group") == 0)
+            group = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--duration") == 0)
+            duration = strtoul(argv[i + 1], NULL, 0);
+        else if (strcmp(argv[i], "--timeline") == 0)
+            timelinePath = argv[i + 1];
+        else
+            usage();
+    }
+
+    int fd = openSyncSocket();
+    struct sockaddr_in dest;
+    memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(SYNC_PORT);
+    dest.sin_addr.s_addr = inet_addr(SIM_MULTICAST_ADDR);
+
+    FlickerEngine engine;
+    SyncClock clock;
+    uint32_t start = hostMillis();
+    clock.begin(seed, start);
+    clock.frameOffset = offset;
+    uint32_t lastSent = start - SYNC_INTERVAL;
+
+    // Every span counts here; the lamp's idle passes are the 1 ms waits
+    timeline.minDuration = 0;
+
+    // Full brightness, default color: every LED flickers
+    const int fullLEDs = LED_LENGTH;
+
+    for (uint32_t now = start; now - start < duration; now = hostMillis())
+    {
+        uint8_t buf[64];
+
+        if (leader && now - lastSent >= SYNC_INTERVAL)
+        {
+            size_t length = encodeSyncPacket(clock.beacon(group, now), buf);
+            sendto(fd, buf, length, 0, (struct sockaddr *)&dest, sizeof(dest));
+            lastSent = now;
+        }
+
+        // Beacon exchange stands in for homeSpan.poll(); only passes that
+        // received something are recorded
+        uint32_t pollStart = TIMELINE_NOW();
+        ssize_t length = recv(fd, buf, sizeof(buf), 0);
+        SyncPacket packet;
+        if (!leader && length > 0 && decodeSyncPacket(buf, length, packet))
+        {
+            clock.follow(packet, group, hostMillis());
+        }
+        if (length > 0)
+        {
+            timeline.record(TIMELINE_POLL, 0, pollStart, TIMELINE_NOW());
+        }
+
+        if (clock.tick(hostMillis()))
+        {
+            TimelineScope loopScope(TIMELINE_LOOP);
+            int lit;
+            {
+                TimelineScope renderScope(TIMELINE_RENDER);
+                engine.warmUp(clock.seed, clock.frame + clock.frameOffset, clock.catchUpSteps());
+                engine.rng.seed(clock.stepSeed());
+                TimelineScope flickerScope(TIMELINE_FLICKER);
+                lit = engine.render(fullLEDs, 0.0f, DEFAULT_HUE, DEFAULT_SATURATION, true);
+            }
+            if (leader || clock.locked)
+            {
+                printf("%u %08x %u\n", (unsigned)clock.frame, (unsigned)hashFlame(engine, lit),
+                       (unsigned)clock.lastStep);
+                fflush(stdout);
+            }
+        }
+    }
+
+    fprintf(stderr, "%s: seed %08x frame %u resyncs %u\n", argv[1], (unsigned)clock.seed,
+            (unsigned)clock.frame, (unsigned)clock.resyncs);
+    if (timelinePath)
+    {
+        writeTimeline(timelinePath, argv[1]);
+    }
+    close(fd);
+    return 0;
+}
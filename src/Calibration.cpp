@@ -0,0 +1,139 @@
+/**
+ * @file Calibration.cpp
+ * @brief NVS persistence and serial CLI for LED calibration
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Third-party libraries
+#include <Arduino.h>
+#include <Preferences.h>
+
+// Project headers
+#include "Calibration.h"
+
+// NVS namespace and key; the blob size doubles as a layout check
+#define CALIBRATION_NVS_NAMESPACE "calibration"
+#define CALIBRATION_NVS_KEY "strips"
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+void CalibrationTable::load()
+{
+    Preferences prefs;
+    prefs.begin(CALIBRATION_NVS_NAMESPACE, true);
+
+    StripCalibration stored[NUM_STRIPS];
+    if (prefs.getBytesLength(CALIBRATION_NVS_KEY) == sizeof(stored) &&
+        prefs.getBytes(CALIBRATION_NVS_KEY, stored, sizeof(stored)) == sizeof(stored))
+    {
+        memcpy(strips, stored, sizeof(strips));
+        rebuild();
+        Serial.println("Calibration loaded from NVS");
+    }
+    prefs.end();
+}
+
+void CalibrationTable::save()
+{
+    Preferences prefs;
+    prefs.begin(CALIBRATION_NVS_NAMESPACE, false);
+    prefs.putBytes(CALIBRATION_NVS_KEY, strips, sizeof(strips));
+    prefs.end();
+    Serial.println("Calibration saved");
+}
+
+// ============================================================================
+// SERIAL CLI
+// ============================================================================
+
+void CalibrationTable::command(const char *args)
+{
+    int strip, led, r, g, b, value;
+
+    while (*args == ' ')
+    {
+        args++;
+    }
+
+    // Strips are numbered 1..NUM_STRIPS and LEDs 1..LED_LENGTH on the CLI
+    if (*args == '\0')
+    {
+        print();
+    }
+    else if (sscanf(args, "%d rgb %d %d %d", &strip, &r, &g, &b) == 4)
+    {
+        if (!setGain(strip - 1, constrain(r, 0, 255), constrain(g, 0, 255), constrain(b, 0, 255)))
+        {
+            Serial.println("Invalid strip");
+        }
+    }
+    else if (sscanf(args, "%d int %d", &strip, &value) == 2)
+    {
+        if (!setIntensity(strip - 1, constrain(value, 0, 255)))
+        {
+            Serial.println("Invalid strip");
+        }
+    }
+    else if (sscanf(args, "%d led %d %d", &strip, &led, &value) == 3)
+    {
+        if (!setLed(strip - 1, led - 1, constrain(value, 0, 255)))
+        {
+            Serial.println("Invalid strip or LED");
+        }
+    }
+    else if (strncmp(args, "save", 4) == 0)
+    {
+        save();
+    }
+    else if (strncmp(args, "reset", 5) == 0)
+    {
+        reset();
+        Serial.println("Calibration reset to unity (use '@c save' to persist)");
+    }
+    else
+    {
+        Serial.println("Usage: @c                       - show calibration");
+        Serial.println("       @c <strip> rgb <r> <g> <b> - strip white balance (0-255)");
+        Serial.println("       @c <strip> int <n>       - strip intensity (0-255)");
+        Serial.println("       @c <strip> led <i> <n>   - LED intensity trim (0-255)");
+        Serial.println("       @c save | reset          - persist to NVS / unity");
+    }
+}
+
+void CalibrationTable::print()
+{
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        const StripCalibration &cal = strips[strip];
+        Serial.printf("Strip %d: rgb %u %u %u  int %u  led", strip + 1,
+                      cal.gain[0], cal.gain[1], cal.gain[2], cal.intensity);
+        for (int i = 0; i < LED_LENGTH; i++)
+        {
+            Serial.printf(" %u", cal.led[i]);
+        }
+        Serial.println();
+    }
+}
@@ -28,32 +28,96 @@
  * SOFTWARE.
  */
 
+#include <esp_system.h>
+#include <Preferences.h>
+
 #include "CandleLight.h"
+#include "LedOutput.h"
+#include "Timeline.h"
+#include "TraceLog.h"
 
-// External LED arrays defined in main.cpp
+// External LED arrays and output layer defined in main.cpp
 extern CRGB leds[NUM_STRIPS][LED_LENGTH];
+extern LedOutput ledOutput;
+
+// Notification trigger for automations (not shown by the Home app itself,
+// visible to Eve and other HAP clients); value is an OverlayId, 0 clears
+CUSTOM_CHAR(Notification, 4A9C1E50-5C2B-4C8E-9E1B-0A1ADD1E0001, PR + PW + EV, UINT8, 0, 0, OVERLAY_PRESET_COUNT - 1, false);
+
+// Scratch NVS entry rewritten by nvsWriteTest()
+#define NVS_TEST_NAMESPACE "nvstest"
+#define NVS_TEST_KEY "scratch"
+
+/**
+ * Print one timing counter as a single serial line
+ */
+static void printTiming(const char *label, const FrameStats &stats)
+{
+    Serial.printf("%-24s n=%u last=%uus avg=%uus worst=%uus\n",
+                  label, (unsigned)stats.count, (unsigned)stats.last,
+                  (unsigned)stats.average(), (unsigned)stats.worst);
+}
+
+/**
+ * true for "@c"/"@v" commands that only read the settings or program:
+ * a bare listing or "save" (an NVS write). They run without the output
+ * gate, so the pacer keeps the strips going while they hold up loop()
+ */
+static bool isReadOnlyCommand(const char *args)
+{
+    while (*args == ' ')
+    {
+        args++;
+    }
+    return *args == '\0' || strncmp(args, "save", 4) == 0;
+}
+
+#if FRAME_PACER && defined(ARDUINO_ARCH_ESP32)
+/**
+ * Frame pacer task: offers the lamp a frame every OUTPUT_INTERVAL
+ */
+static void pacerTask(void *arg)
+{
+    DEV_CandleLight *lamp = (DEV_CandleLight *)arg;
+    TickType_t wake = xTaskGetTickCount();
+    for (;;)
+    {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(OUTPUT_INTERVAL));
+        lamp->paceFrame(millis(), micros());
+    }
+}
+#endif
 
 // ============================================================================
 // CONSTRUCTOR
 // ============================================================================
 
-DEV_CandleLight::DEV_CandleLight() : Service::LightBulb()
+DEV_CandleLight::DEV_CandleLight()
+    : Service::LightBulb()
+#if CONTROL_API_ENABLED
+      , control(controlMailbox)
+#endif
+#if MQTT_ENABLED
+      , mqtt(controlMailbox)
+#endif
+      , identifyFlash({255, 255, 255}, IDENTIFY_FLASHES, IDENTIFY_RAMP_MS, IDENTIFY_ON_MS, IDENTIFY_OFF_MS)
 {
     // Initialize HomeKit characteristics with defaults
     power = new Characteristic::On(1); // Start ON after power cycle
     hue = new Characteristic::Hue(DEFAULT_HUE);
     saturation = new Characteristic::Saturation(DEFAULT_SATURATION);
     brightness = new Characteristic::Brightness(DEFAULT_BRIGHTNESS);
+    notification = new Characteristic::Notification(OVERLAY_NONE);
+    inputs = RenderInputs{true, DEFAULT_HUE, DEFAULT_SATURATION, DEFAULT_BRIGHTNESS};
+
+    // Register strips with their chipsets and turn off all LEDs initially
+    ledOutput.begin(leds);
 
-    // Initialize FastLED for both APA102 strips
-    FastLED.addLeds<APA102, STRIP1_DATA_PIN, STRIP1_CLOCK_PIN, BGR>(leds[0], LED_LENGTH);
-    FastLED.addLeds<APA102, STRIP2_DATA_PIN, STRIP2_CLOCK_PIN, BGR>(leds[1], LED_LENGTH);
-    FastLED.setBrightness(255); // Use full brightness, control via color values
+    // Per-strip white balance and LED trims from NVS (unity if none saved)
+    calibration.load();
 
-    // Turn off all LEDs initially
-    fill_solid(leds[0], LED_LENGTH, CRGB::Black);
-    fill_solid(leds[1], LED_LENGTH, CRGB::Black);
-    FastLED.show();
+    // Saved effect program, if any, replaces the candle from the first frame
+    effects.load();
 
     // Initialize power button with internal pullup (active LOW)
     pinMode(POWER_BUTTON_PIN, INPUT_PULLUP);
@@ -62,15 +126,29 @@ DEV_CandleLight::DEV_CandleLight() : Service::LightBulb()
     buttonPressStartTime = 0;
     buttonLastReading = HIGH;
 
-    // Initialize smoothing arrays to midpoint of flicker range
-    // This prevents large jumps on first animation frame
-    for (int strip = 0; strip < NUM_STRIPS; strip++)
-    {
-        for (int i = 0; i < LED_LENGTH; i++)
-        {
-            previousBrightness[strip][i] = (FLICKER_BRIGHTNESS_MIN + FLICKER_BRIGHTNESS_MAX) / 2.0;
-        }
-    }
+    // Frame scheduling and fast-path state
+    syncClock.begin(esp_random(), millis()); // Hardware RNG: different flicker each power cycle
+    lastOutputFrame = 0;
+    lastTickMicros = 0;
+    droppedFrames = 0;
+    fill_solid(fromFrame, LED_LENGTH, CRGB::Black);
+    fill_solid(toFrame, LED_LENGTH, CRGB::Black);
+    framePending = false;
+    pendingSince = 0;
+    powerShown = false; // Fade in from black on the first frame
+    pacing = false;
+    pacedFrames = 0;
+    lastOutputMicros = 0;
+#if REALTIME_ENABLED
+    realtimeActive = false;
+#endif
+#if CONTROL_API_ENABLED || MQTT_ENABLED
+    publishControlState();
+#endif
+#if MQTT_ENABLED
+    lastMetrics = 0;
+    mqtt.begin();
+#endif
 
     // Log configuration
     Serial.print("Configured Candle Light with ");
@@ -78,6 +156,10 @@ DEV_CandleLight::DEV_CandleLight() : Service::LightBulb()
     Serial.println(" strips");
     Serial.print("Flicker smoothing: ");
     Serial.println(FLICKER_SMOOTHING);
+
+#if FRAME_PACER && defined(ARDUINO_ARCH_ESP32)
+    xTaskCreatePinnedToCore(pacerTask, "pacer", PACER_TASK_STACK, this, PACER_TASK_PRIORITY, nullptr, PACER_CORE);
+#endif
 }
 
 // ============================================================================
@@ -86,6 +168,13 @@ DEV_CandleLight::DEV_CandleLight() : Service::LightBulb()
 
 boolean DEV_CandleLight::update()
 {
+    TIMELINE_SCOPE(TIMELINE_UPDATE);
+
+    // Render the new state on the next loop() pass rather than waiting up
+    // to UPDATE_INTERVAL for the next flicker tick
+    requestFrame();
+    TRACE(TRACE_HOMEKIT, power->getNewVal(), brightness->getNewVal());
+
     // Log HomeKit characteristic changes
     if (power->updated())
     {
@@ -111,56 +200,676 @@ boolean DEV_CandleLight::update()
         Serial.println(brightness->getNewVal());
     }
 
+    if (notification->updated())
+    {
+        notify(notification->getNewVal());
+    }
+
     return true;
 }
 
 void DEV_CandleLight::loop()
 {
+    TIMELINE_SCOPE(TIMELINE_LOOP);
+
     // Handle manual power button
     handlePowerButton();
 
-    // Rate-limit animation updates
-    static uint32_t lastUpdate = 0;
-    if (millis() - lastUpdate < UPDATE_INTERVAL)
+    // Exchange sync beacons with other lamps (no-op when sync is off)
+    uint32_t now = millis();
+    syncLink.poll(syncClock, outputGate, now); // The pacer steps the same clock
+
+#if CONTROL_API_ENABLED
+    control.poll();
+#endif
+#if CONTROL_API_ENABLED || MQTT_ENABLED
+    // Network changes take the same path as HomeKit writes
+    ControlCommand command;
+    if (controlMailbox.take(command))
+    {
+        applyControl(command);
+    }
+#endif
+#if MQTT_ENABLED
+    if (now - lastMetrics >= MQTT_METRICS_INTERVAL)
+    {
+        lastMetrics = now;
+        mqtt.publishMetrics(LampMetrics{now / 1000, esp_get_free_heap_size(), esp_get_minimum_free_heap_size(),
+                                        frameTime.count, frameTime.average(), frameTime.worst,
+                                        writeLatency.average(), writeLatency.worst,
+                                        quality.overruns, quality.level});
+    }
+#endif
+
+#if REALTIME_ENABLED
+    // A live DDP / E1.31 stream takes over the strips while the lamp is on
+    outputGate.acquire();
+    bool realtimeFrame = realtime.poll((uint8_t *)leds, sizeof(leds), now);
+    if (realtime.active(now) && power->getVal())
+    {
+        if (!realtimeActive)
+        {
+            Serial.println("Realtime input: streaming");
+            realtimeActive = true;
+        }
+        if (realtimeFrame)
+        {
+            ledOutput.show();
+            frameShown(now, micros(), false);
+            realtime.frameShown();
+#if CONTROL_API_ENABLED
+            control.publishPreview(leds, now);
+#endif
+        }
+        outputGate.release();
+        return;
+    }
+    outputGate.release();
+    if (realtimeActive)
+    {
+        // Stream ended or timed out: bring the candle back
+        Serial.println("Realtime input: stopped, resuming candle");
+        realtimeActive = false;
+        outputGate.acquire();
+        heldFrame.capture(leds[0]);
+        fade.begin(heldFrame, false, now, CROSSFADE_MS);
+        outputGate.release();
+        powerShown = power->getVal(); // Switched off mid-stream: fade to the dark candle
+        requestFrame();
+    }
+#endif
+
+    // Rate-limit animation updates, unless a state change is waiting;
+    // frame state is shared with the pacer task, one producer at a time
+    outputGate.acquire();
+    bool flickerTick = syncClock.tick(now);
+    bool outputTick = (now - lastOutputFrame >= OUTPUT_INTERVAL);
+    if (!flickerTick && !outputTick && !framePending)
+    {
+        outputGate.release();
+        return;
+    }
+    uint32_t frameStart = micros();
+    bool stalled = false;
+    if (flickerTick)
+    {
+        // Gaps well above UPDATE_INTERVAL mean the loop was stalled
+        if (lastTickMicros != 0)
+        {
+            uint32_t interval = frameStart - lastTickMicros;
+            frameInterval.record(interval);
+            if (interval > 2000UL * UPDATE_INTERVAL)
+            {
+                TRACE(TRACE_FLICKER_STALL, 0, traceClamp16(interval / 1000));
+                droppedFrames += interval / (1000UL * UPDATE_INTERVAL) - 1;
+                stalled = true;
+            }
+        }
+        lastTickMicros = frameStart;
+    }
+
+    // Power changes from any source fade rather than cut
+    bool on = power->getVal();
+    if (on != powerShown)
+    {
+        powerShown = on;
+        fade.begin(fadeBlack, !on, now, CROSSFADE_MS);
+    }
+    inputs = RenderInputs{on, (int)hue->getVal(), (int)saturation->getVal(), (int)brightness->getVal()};
+
+    // Expensive flicker synthesis only at UPDATE_INTERVAL (or on a change)
+    if (flickerTick || framePending)
+    {
+        renderFrame(flickerTick, now);
+    }
+
+    // Cheap interpolated output at OUTPUT_INTERVAL, overlays on top
+    showFrame(now, false);
+#if CONTROL_API_ENABLED
+#if LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+    // Rendered to wire format only: rebuild leds when a preview goes out
+    if (control.previewDue(now))
+    {
+        ledOutput.unpack(leds);
+    }
+#endif
+    control.publishPreview(leds, now);
+#endif
+    uint32_t elapsed = micros() - frameStart;
+    frameTime.record(elapsed);
+    if (elapsed > 1000UL * OUTPUT_INTERVAL)
+    {
+        TRACE(TRACE_FRAME_OVERRUN, 0, traceClamp16(elapsed));
+        droppedFrames += elapsed / (1000UL * OUTPUT_INTERVAL);
+    }
+
+    // Sustained overruns step the flicker down to cheaper rendering
+    if (quality.record(elapsed, stalled))
+    {
+        TRACE(TRACE_QUALITY, quality.level, traceClamp16(quality.overruns));
+        Serial.printf("Render quality: %s (%u overruns)\n", RenderQuality::levelName(quality.level),
+                      (unsigned)quality.overruns);
+    }
+
+    // Record write-to-frame latency once the change is on the strips
+    if (framePending)
+    {
+        writeLatency.record(micros() - pendingSince);
+        framePending = false;
+#if CONTROL_API_ENABLED || MQTT_ENABLED
+        publishControlState();
+#endif
+    }
+    outputGate.release();
+}
+
+void DEV_CandleLight::printStats()
+{
+    printTiming("Write-to-frame latency", writeLatency);
+    printTiming("Frame render time", frameTime);
+    printTiming("Flicker tick interval", frameInterval);
+    printTiming("Output frame interval", outputInterval);
+    Serial.printf("%-24s %u\n", "Dropped frames", (unsigned)droppedFrames);
+    Serial.printf("%-24s %u\n", "Paced frames", (unsigned)pacedFrames);
+    Serial.printf("%-24s %s (%u overruns, %u down, %u up)\n", "Render quality",
+                  RenderQuality::levelName(quality.level), (unsigned)quality.overruns,
+                  (unsigned)quality.degrades, (unsigned)quality.recoveries);
+    ledOutput.printStats();
+#if REALTIME_ENABLED
+    realtime.printStats();
+#endif
+#if CONTROL_API_ENABLED
+    control.printStats();
+#endif
+#if MQTT_ENABLED
+    mqtt.printStats();
+#endif
+}
+
+void DEV_CandleLight::statsCommand(const char *args)
+{
+    while (*args == ' ')
+    {
+        args++;
+    }
+
+    if (*args == '\0')
+    {
+        printStats();
+    }
+    else if (strncmp(args, "nvs", 3) == 0)
+    {
+        int writes = atoi(args + 3);
+        nvsWriteTest(writes > 0 ? writes : 10);
+    }
+    else
+    {
+        Serial.println("Usage: @p, @p nvs [writes]");
+    }
+}
+
+uint32_t DEV_CandleLight::nvsWriteTest(int writes)
+{
+    writes = clampInt(writes, 1, 100);
+    outputGate.acquire(); // The pacer records into the same counters
+    frameInterval.reset();
+    outputInterval.reset();
+    uint32_t paced = pacedFrames;
+    outputGate.release();
+
+    // Blocks this task, and with it loop(), like any save does
+    uint32_t start = micros();
+    Preferences prefs;
+    prefs.begin(NVS_TEST_NAMESPACE, false);
+    uint32_t scratch[8];
+    for (int n = 0; n < writes; n++)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            scratch[i] = esp_random(); // New content, so every put is a real write
+        }
+        prefs.putBytes(NVS_TEST_KEY, scratch, sizeof(scratch));
+    }
+    prefs.remove(NVS_TEST_KEY);
+    prefs.end();
+    uint32_t end = micros();
+
+    // Frames stopped for at least as long as the tail since the last one
+    outputGate.acquire();
+    FrameStats output = outputInterval;
+    FrameStats ticks = frameInterval;
+    uint32_t sinceFrame = end - lastOutputMicros;
+    paced = pacedFrames - paced;
+    outputGate.release();
+    uint32_t longestGap = output.worst > sinceFrame ? output.worst : sinceFrame;
+
+    Serial.printf("NVS write test: %d writes in %u ms\n", writes, (unsigned)((end - start) / 1000));
+    printTiming("Output frame interval", output);
+    printTiming("Flicker tick interval", ticks);
+    Serial.printf("%-24s %uus\n", "Longest output gap", (unsigned)longestGap);
+    Serial.printf("%-24s %u\n", "Paced frames", (unsigned)paced);
+    return longestGap;
+}
+
+// ============================================================================
+// NETWORK COMMANDS (CONTROL API, MQTT)
+// ============================================================================
+
+#if CONTROL_API_ENABLED || MQTT_ENABLED
+void DEV_CandleLight::applyControl(const ControlCommand &cmd)
+{
+    // setVal() also notifies paired HomeKit controllers
+    if (cmd.fields & CONTROL_POWER)
+    {
+        power->setVal(cmd.power);
+        Serial.print("Power (remote): ");
+        Serial.println(cmd.power ? "ON" : "OFF");
+    }
+
+    if (cmd.fields & CONTROL_HUE)
+    {
+        hue->setVal(cmd.hue);
+        Serial.print("Hue (remote): ");
+        Serial.println(cmd.hue);
+    }
+
+    if (cmd.fields & CONTROL_SATURATION)
+    {
+        saturation->setVal(cmd.saturation);
+        Serial.print("Saturation (remote): ");
+        Serial.println(cmd.saturation);
+    }
+
+    if (cmd.fields & CONTROL_BRIGHTNESS)
+    {
+        brightness->setVal(cmd.brightness);
+        Serial.print("Brightness (remote): ");
+        Serial.println(cmd.brightness);
+    }
+
+    if (cmd.fields & CONTROL_NOTIFY)
+    {
+        notify(cmd.notify);
+    }
+
+    requestFrame();
+    TRACE(TRACE_CONTROL, cmd.fields, brightness->getVal());
+}
+
+void DEV_CandleLight::publishControlState()
+{
+    controlMailbox.publishState(ControlState{(bool)power->getVal(), (uint16_t)hue->getVal(),
+                                                (uint8_t)saturation->getVal(), (uint8_t)brightness->getVal()});
+}
+#endif
+
+// ============================================================================
+// NOTIFICATION OVERLAYS
+// ============================================================================
+
+void DEV_CandleLight::notify(uint8_t id)
+{
+    if (id == OVERLAY_NONE)
+    {
+        outputGate.acquire();
+        overlays.clear(OVERLAY_NONE);
+        outputGate.release();
+        Serial.println("Notifications cleared");
+    }
+    else if (id < OVERLAY_PRESET_COUNT)
+    {
+        outputGate.acquire();
+        bool shown = overlays.trigger(id, millis());
+        outputGate.release();
+        TRACE(TRACE_NOTIFY, id, shown);
+        Serial.print("Notification: ");
+        Serial.print(OVERLAY_PRESETS[id].name);
+        Serial.println(shown ? "" : " (dropped, higher priority overlays active)");
+    }
+}
+
+void DEV_CandleLight::showStatus(HS_STATUS status)
+{
+    uint32_t now = millis();
+
+    // Called from homeSpan.poll(), which is what stalls loop(): the
+    // pacer may be showing the overlays right now
+    outputGate.acquire();
+    switch (status)
+    {
+    case HS_WIFI_NEEDED:
+    case HS_WIFI_CONNECTING:
+        overlays.clear(OVERLAY_PAIRING);
+        overlays.trigger(OVERLAY_CONNECTING, now);
+        break;
+
+    case HS_PAIRING_NEEDED:
+        overlays.clear(OVERLAY_CONNECTING);
+        overlays.trigger(OVERLAY_PAIRING, now);
+        break;
+
+    case HS_PAIRED:
+        // Paired and connected: status is no longer interesting
+        overlays.clear(OVERLAY_CONNECTING);
+        overlays.clear(OVERLAY_PAIRING);
+        break;
+
+    case HS_AP_STARTED:
+        overlays.trigger(OVERLAY_WIFI_AP, now);
+        break;
+
+    case HS_AP_TERMINATED:
+        overlays.clear(OVERLAY_WIFI_AP);
+        break;
+
+    default:
+        break;
+    }
+    outputGate.release();
+}
+
+void DEV_CandleLight::syncCommand(const char *args)
+{
+    // "@s offset" moves the clock the pacer steps
+    outputGate.acquire();
+    syncLink.command(args, syncClock);
+    outputGate.release();
+}
+
+void DEV_CandleLight::effectCommand(const char *args)
+{
+    // Listing and saving leave the program the pacer runs alone
+    if (isReadOnlyCommand(args))
+    {
+        effects.command(args);
+        return;
+    }
+
+    // The pacer may run the program: keep it out while the code changes
+    outputGate.acquire();
+
+    // Hold the outgoing look's last step and fade from it to the new one
+    heldFrame.capture(toFrame);
+    if (effects.command(args))
+    {
+        fade.begin(heldFrame, false, millis(), CROSSFADE_MS);
+        requestFrame();
+    }
+    outputGate.release();
+}
+
+void DEV_CandleLight::identify()
+{
+    // Cut to the flashes; each output frame then steps them
+    uint32_t now = millis();
+    outputGate.acquire();
+    identifyFlash.start(now);
+    fade.begin(identifyFlash, true, now, 0);
+    outputGate.release();
+    requestFrame();
+}
+
+void DEV_CandleLight::fadeFromBlack()
+{
+    outputGate.acquire();
+    fade.begin(fadeBlack, false, millis(), CROSSFADE_MS);
+    outputGate.release();
+    requestFrame();
+}
+
+void DEV_CandleLight::calibrationCommand(const char *args)
+{
+    // Listing and saving leave the factor table the pacer reads alone
+    if (isReadOnlyCommand(args))
     {
+        calibration.command(args);
         return;
     }
-    lastUpdate = millis();
+    outputGate.acquire();
+    calibration.command(args);
+    outputGate.release();
+}
 
-    // Turn off all LEDs if power is off
-    if (!power->getVal())
+void DEV_CandleLight::overlayCommand(const char *args)
+{
+    while (*args == ' ')
+    {
+        args++;
+    }
+
+    if (*args == '\0')
+    {
+        for (uint8_t id = 1; id < OVERLAY_PRESET_COUNT; id++)
+        {
+            Serial.printf("  %u %-10s priority %u%s\n", (unsigned)id, OVERLAY_PRESETS[id].name,
+                          (unsigned)OVERLAY_PRESETS[id].priority, overlays.isActive(id) ? "  [active]" : "");
+        }
+        Serial.println("Usage: @o <name|number>, @o clear");
+    }
+    else if (strcmp(args, "clear") == 0)
+    {
+        notify(OVERLAY_NONE);
+    }
+    else
+    {
+        uint8_t id = OverlayStack::findPreset(args);
+        if (id >= OVERLAY_PRESET_COUNT)
+        {
+            Serial.println("Unknown notification");
+            return;
+        }
+        notify(id);
+    }
+}
+
+// ============================================================================
+// FRAME RENDERING
+// ============================================================================
+
+void DEV_CandleLight::requestFrame()
+{
+    // Keep the earliest timestamp so coalesced writes report true latency
+    if (!framePending)
+    {
+        framePending = true;
+        pendingSince = micros();
+    }
+}
+
+void DEV_CandleLight::frameShown(uint32_t now, uint32_t nowMicros, bool paced)
+{
+    if (lastOutputMicros != 0)
+    {
+        outputInterval.record(nowMicros - lastOutputMicros);
+    }
+    lastOutputMicros = nowMicros;
+    lastOutputFrame = now;
+    pacing = paced;
+}
+
+void DEV_CandleLight::showFrame(uint32_t now, bool paced)
+{
+    fade.prepare(now);
+    if (fade.effect() == &identifyFlash && identifyFlash.done())
+    {
+        // Last Identify flash is over: the candle comes back from dark
+        Serial.println("Identify complete");
+        fade.begin(fadeBlack, false, now, CROSSFADE_MS);
+    }
+    overlays.prepare(now);
+    interpolateFrame(now);
+    ledOutput.showRendered();
+    frameShown(now, micros(), paced);
+}
+
+void DEV_CandleLight::paceFrame(uint32_t now, uint32_t nowMicros)
+{
+    // Busy means loop() is producing a frame right now
+    if (!outputGate.tryAcquire())
     {
-        fill_solid(leds[0], LED_LENGTH, CRGB::Black);
-        fill_solid(leds[1], LED_LENGTH, CRGB::Black);
-        FastLED.show();
+        return;
+    }
+
+    // Step in once loop() has missed its slot (and only after its first
+    // frame), then keep the output rate until loop() produces one again
+    bool due = lastOutputMicros != 0 && now - lastOutputFrame >= (pacing ? OUTPUT_INTERVAL : PACER_STALL_MS);
+#if REALTIME_ENABLED
+    due = due && !realtimeActive;
+#endif
+    if (due)
+    {
+        if (syncClock.tick(now))
+        {
+            if (lastTickMicros != 0)
+            {
+                frameInterval.record(nowMicros - lastTickMicros);
+            }
+            lastTickMicros = nowMicros;
+            renderFrame(true, now);
+        }
+        showFrame(now, true);
+        pacedFrames++;
+    }
+    outputGate.release();
+}
+
+void DEV_CandleLight::renderFrame(bool advanceFlicker, uint32_t now)
+{
+    TIMELINE_SCOPE(TIMELINE_RENDER);
+
+    // A new flicker step interpolates from the previous target; a state
+    // change (out-of-cycle frame) snaps so it shows up immediately
+    if (advanceFlicker && !framePending)
+    {
+        memcpy(fromFrame, toFrame, sizeof(toFrame));
+
+        // Lowest quality: between sparse steps output holds the last one
+        if (quality.level == QUALITY_HOLD && syncClock.frame % QUALITY_HOLD_STEPS != 0)
+        {
+            return;
+        }
+    }
+
+    // Clear all LEDs
+    fill_solid(toFrame, LED_LENGTH, CRGB::Black);
+
+    // Leave all LEDs off if power is off, once the flame has faded out
+    if (!inputs.on && !fade.fadingOut(now))
+    {
+        memcpy(fromFrame, toFrame, sizeof(toFrame));
+        if (fade.effect() == &fadeBlack)
+        {
+            fade.release(); // Candle is dark too, stop blending
+        }
+        return;
+    }
+
+    // A user effect program replaces the flicker; LEDs it had no budget
+    // left for keep their previous step
+    if (effects.loaded)
+    {
+        if (advanceFlicker)
+        {
+            syncClock.catchUpSteps(); // Nothing to replay, but the candle resumes from here
+        }
+        VmInputs in = {now, syncClock.frame + syncClock.frameOffset, syncClock.stepSeed(),
+                       inputs.hue, inputs.saturation, inputs.brightness};
+        static_assert(sizeof(CRGB) == sizeof(EffectPixel), "programs write toFrame in place");
+        int done = effects.run(reinterpret_cast<EffectPixel *>(toFrame), LED_LENGTH, in);
+        memcpy(toFrame + done, fromFrame + done, (LED_LENGTH - done) * sizeof(CRGB));
+        if (framePending)
+        {
+            memcpy(fromFrame, toFrame, sizeof(toFrame));
+        }
         return;
     }
 
     // Calculate LED count from brightness percentage
-    int brightnessPercent = brightness->getVal();
-    float numLEDsFloat = brightnessPercent * LED_LENGTH / 100.0;
+    float numLEDsFloat = inputs.brightness * LED_LENGTH / 100.0;
     int fullLEDs = floor(numLEDsFloat);
     float fraction = numLEDsFloat - fullLEDs;
 
     // Clamp to valid range
     fullLEDs = constrain(fullLEDs, 0, LED_LENGTH);
 
-    // Clear all LEDs
-    fill_solid(leds[0], LED_LENGTH, CRGB::Black);
-    fill_solid(leds[1], LED_LENGTH, CRGB::Black);
+    // Apply flicker effect unless no LEDs should be on
+    if (fullLEDs > 0 || fraction >= 0.01)
+    {
+        // Each step's randomness depends only on (seed, frame), so lamps
+        // sharing a sync clock compute the same flicker
+        if (advanceFlicker)
+        {
+            // Replay steps missed while dark, stalled or before a resync;
+            // skipped when degraded, as replay is what the lamp can't afford
+            int missed = syncClock.catchUpSteps();
+            if (quality.level == QUALITY_FULL)
+            {
+                flicker.warmUp(syncClock.seed, syncClock.frame + syncClock.frameOffset, missed);
+            }
+            flicker.rng.seed(syncClock.stepSeed());
+        }
+
+        // Degraded: alternate LEDs take a new step, swapping each step
+        uint32_t skipMask = quality.level == QUALITY_FULL ? 0 : 1;
+        int litLEDs = applyFlicker(fullLEDs, fraction, inputs.hue, inputs.saturation, advanceFlicker,
+                                   skipMask, syncClock.frame);
+        for (int i = 0; i < litLEDs; i++)
+        {
+            toFrame[i] = CHSV(flicker.flame[i].h, flicker.flame[i].s, flicker.flame[i].v);
+        }
+    }
 
-    // Early exit if no LEDs should be on
-    if (fullLEDs == 0 && fraction < 0.01)
+    if (framePending)
     {
-        FastLED.show();
-        return;
+        memcpy(fromFrame, toFrame, sizeof(toFrame));
     }
+}
 
-    // Apply flicker effect
-    applyFlicker(fullLEDs, fraction, hue->getVal(), saturation->getVal());
+void RENDER_HOT DEV_CandleLight::interpolateFrame(uint32_t now)
+{
+#if TEMPORAL_UPSAMPLING
+    // Position between the last two flicker steps, 0-256
+    uint32_t elapsed = now - syncClock.lastStep;
+    uint16_t t = elapsed >= UPDATE_INTERVAL ? 256 : (uint16_t)((elapsed << 8) / UPDATE_INTERVAL);
+#else
+    uint16_t t = 256;
+#endif
 
-    // Update all strips
-    FastLED.show();
+    // Same interpolated frame on both strips (synchronized), crossfaded
+    // with the other look and overlays blended on top, each strip then
+    // corrected by its own calibration in the same pass
+    const EffectPixel *fadeOther = fade.scratch;
+    uint16_t fadeT = fade.t;
+#if LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+    // Written straight into the APA102 wire frames the SPI DMA sends
+    SpiDirectOutput::Frame *frames[NUM_STRIPS];
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        frames[strip] = &ledOutput.frame(strip);
+    }
+#endif
+    for (int i = 0; i < LED_LENGTH; i++)
+    {
+        uint8_t r = lerp8(fromFrame[i].r, toFrame[i].r, t);
+        uint8_t g = lerp8(fromFrame[i].g, toFrame[i].g, t);
+        uint8_t b = lerp8(fromFrame[i].b, toFrame[i].b, t);
+        if (fadeT)
+        {
+            crossfadePixel(r, g, b, fadeOther[i], fadeT);
+        }
+        compositeLayers(r, g, b, overlays.layers, overlays.numLayers);
+        for (int strip = 0; strip < NUM_STRIPS; strip++)
+        {
+            const uint8_t *factor = calibration.factor[strip][i];
+#if LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+            frames[strip]->set(i, scaleByte(r, factor[0]), scaleByte(g, factor[1]), scaleByte(b, factor[2]));
+#else
+            leds[strip][i].r = scaleByte(r, factor[0]);
+            leds[strip][i].g = scaleByte(g, factor[1]);
+            leds[strip][i].b = scaleByte(b, factor[2]);
+#endif
+        }
+    }
 }
 
 // ============================================================================
@@ -169,6 +878,8 @@ void DEV_CandleLight::loop()
 
 void DEV_CandleLight::handlePowerButton()
 {
+    TIMELINE_SCOPE(TIMELINE_BUTTON);
+
     bool currentReading = digitalRead(POWER_BUTTON_PIN);
     uint32_t now = millis();
 
@@ -212,6 +923,8 @@ void DEV_CandleLight::handlePowerButton()
             buttonState = BTN_LONG_PRESS_ACTIVE;
 
             homeSpan.processSerialCommand("A");
+            TRACE(TRACE_BUTTON, 1, 0);
+            notify(OVERLAY_WIFI_AP);
             Serial.println("\n*** LONG PRESS DETECTED ***");
             Serial.println("WiFi AP mode enabled for 5 minutes");
             Serial.print("Connect to: ");
@@ -242,6 +955,8 @@ void DEV_CandleLight::handlePowerButton()
         {
             // Stable HIGH confirmed, execute short press action
             power->setVal(!power->getVal());
+            requestFrame();
+            TRACE(TRACE_BUTTON, 0, power->getVal());
             Serial.print("Power button pressed - Lamp ");
             Serial.println(power->getVal() ? "ON" : "OFF");
 
@@ -272,82 +987,20 @@ void DEV_CandleLight::handlePowerButton()
 // FLICKER ANIMATION
 // ============================================================================
 
-void DEV_CandleLight::applyFlicker(int fullLEDs, float fraction, int baseHue, int baseSat)
+int RENDER_HOT DEV_CandleLight::applyFlicker(int fullLEDs, float fraction, int baseHue, int baseSat, bool advance,
+                                             uint32_t skipMask, uint32_t phase)
 {
-    // Apply flicker to fully-lit LEDs
-    for (int i = 0; i < fullLEDs; i++)
-    {
-        // Generate random target brightness
-        float targetBrightness = 100.0 + random(FLICKER_VARIATION_MIN, FLICKER_VARIATION_MAX);
-        targetBrightness = constrain(targetBrightness, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX);
-
-        // Apply exponential smoothing
-        float smoothedBrightness = calculateSmoothedBrightness(targetBrightness, previousBrightness[0][i]);
+    TIMELINE_SCOPE(TIMELINE_FLICKER);
 
-        // Store for next iteration
-        previousBrightness[0][i] = smoothedBrightness;
-        previousBrightness[1][i] = smoothedBrightness;
-
-        // Generate hue variation (toward yellow/orange)
-        int flickerHue = baseHue + random(FLICKER_HUE_MIN, FLICKER_HUE_MAX);
-        // Wrap to 0-360 range (handles negative values correctly)
-        flickerHue = ((flickerHue % 360) + 360) % 360;
-
-        // Convert to FastLED CHSV format (0-255 range)
-        uint8_t finalHue = map(flickerHue, 0, 360, 0, 255);
-        uint8_t finalBrightness = map((int)smoothedBrightness, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX, 0, 255);
-        uint8_t finalSaturation = map(baseSat, 0, 100, 0, 255);
-        CHSV color(finalHue, finalSaturation, finalBrightness);
-
-        // Apply to both strips (synchronized)
-        leds[0][i] = color;
-        leds[1][i] = color;
-    }
-
-    // Handle fractional LED (if any)
-    if (fraction > 0.01 && fullLEDs < LED_LENGTH)
-    {
-        // Generate random target brightness
-        float targetBrightness = 100.0 + random(FLICKER_VARIATION_MIN, FLICKER_VARIATION_MAX);
-        targetBrightness = constrain(targetBrightness, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX);
-
-        // Apply smoothing
-        float smoothedBrightness = calculateSmoothedBrightness(targetBrightness, previousBrightness[0][fullLEDs]);
-
-        // Store for next iteration
-        previousBrightness[0][fullLEDs] = smoothedBrightness;
-        previousBrightness[1][fullLEDs] = smoothedBrightness;
-
-        // Generate hue variation
-        int flickerHue = baseHue + random(FLICKER_HUE_MIN, FLICKER_HUE_MAX);
-        // Wrap to 0-360 range (handles negative values correctly)
-        flickerHue = ((flickerHue % 360) + 360) % 360;
-
-        // Scale by fractional amount and convert to FastLED CHSV format (0-255 range)
-        uint8_t finalHue = map(flickerHue, 0, 360, 0, 255);
-        int scaledBrightness = (int)(smoothedBrightness * fraction);
-        uint8_t finalBrightness = map(constrain(scaledBrightness, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX), FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX, 0, 255);
-        uint8_t finalSaturation = map(baseSat, 0, 100, 0, 255);
-        CHSV color(finalHue, finalSaturation, finalBrightness);
-
-        // Apply to both strips
-        leds[0][fullLEDs] = color;
-        leds[1][fullLEDs] = color;
-    }
-}
-
-float DEV_CandleLight::calculateSmoothedBrightness(float target, float previous)
-{
-    // Exponential moving average
-    // smoothed = (alpha × previous) + ((1-alpha) × target)
-    return (FLICKER_SMOOTHING * previous) + ((1.0 - FLICKER_SMOOTHING) * target);
+    // The engine is forced inline, so the whole synthesis lands here in IRAM
+    return flicker.render(fullLEDs, fraction, baseHue, baseSat, advance, skipMask, phase);
 }
 
 // ============================================================================
 // DEV_IDENTIFY - CONSTRUCTOR
 // ============================================================================
 
-DEV_Identify::DEV_Identify() : Service::AccessoryInformation()
+DEV_Identify::DEV_Identify() : Service::AccessoryInformation(), candle(nullptr)
 {
     // Create required characteristics
     new Characteristic::Identify();
@@ -370,22 +1023,10 @@ boolean DEV_Identify::update()
     Serial.println("\n*** IDENTIFY REQUEST ***");
     Serial.println("Flashing LEDs to identify device");
 
-    // Flash all LEDs white 3 times (1.8 seconds total)
-    for (int flash = 0; flash < 3; flash++)
+    // Flash all LEDs white 3 times (1.8 seconds total) without blocking
+    if (candle)
     {
-        // Turn all LEDs white (full brightness)
-        fill_solid(leds[0], LED_LENGTH, CRGB::White);
-        fill_solid(leds[1], LED_LENGTH, CRGB::White);
-        FastLED.show();
-        delay(300);
-
-        // Turn off all LEDs
-        fill_solid(leds[0], LED_LENGTH, CRGB::Black);
-        fill_solid(leds[1], LED_LENGTH, CRGB::Black);
-        FastLED.show();
-        delay(300);
+        candle->identify();
     }
-
-    Serial.println("Identify complete\n");
     return true;
 }
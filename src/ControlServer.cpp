@@ -0,0 +1,271 @@
+/**
+ * @file ControlServer.cpp
+ * @brief HTTP/WebSocket handlers and LED preview streaming
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Third-party libraries
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Project headers
+#include "ControlServer.h"
+
+#if CONTROL_API_ENABLED
+
+ControlServer::ControlServer(ControlMailbox &commandMailbox)
+    : requests(0), rejected(0), previews(0), server(nullptr), mailbox(commandMailbox),
+      previewBusy(false), wsConnected(false), lastPreview(0)
+{
+    portMUX_INITIALIZE(&previewLock);
+    memset(preview, 0, sizeof(preview));
+}
+
+// ============================================================================
+// SERVER
+// ============================================================================
+
+void ControlServer::poll()
+{
+    if (server != nullptr || WiFi.status() != WL_CONNECTED)
+    {
+        return;
+    }
+
+    // Own task on the other core at loop() priority, so request parsing
+    // never preempts rendering
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = CONTROL_PORT;
+    config.ctrl_port = CONTROL_PORT + 1;
+    config.max_open_sockets = CONTROL_MAX_CLIENTS;
+    config.lru_purge_enable = true;
+    config.core_id = 0;
+    config.task_priority = 1;
+    if (httpd_start(&server, &config) != ESP_OK)
+    {
+        Serial.println("Control API: failed to start server");
+        server = nullptr;
+        return;
+    }
+
+    const httpd_uri_t routes[] = {
+        {"/api/state", HTTP_GET, handleGetState, this, false, false, nullptr},
+        {"/api/state", HTTP_POST, handlePostState, this, false, false, nullptr},
+        {"/ws", HTTP_GET, handleWebSocket, this, true, false, nullptr},
+    };
+    for (const httpd_uri_t &route : routes)
+    {
+        httpd_register_uri_handler(server, &route);
+    }
+
+    Serial.print("Control API: http://");
+    Serial.print(WiFi.localIP());
+    Serial.printf(":%u/api/state, WebSocket /ws\n", (unsigned)CONTROL_PORT);
+}
+
+// ============================================================================
+// PREVIEWS
+// ============================================================================
+
+void ControlServer::publishPreview(const CRGB pixels[][LED_LENGTH], uint32_t now)
+{
+    if (!previewDue(now))
+    {
+        return;
+    }
+    lastPreview = now;
+
+    portENTER_CRITICAL(&previewLock);
+    memcpy(preview, pixels, sizeof(preview));
+    portEXIT_CRITICAL(&previewLock);
+
+    previewBusy = true;
+    if (httpd_queue_work(server, sendPreview, this) != ESP_OK)
+    {
+        previewBusy = false;
+    }
+}
+
+// ============================================================================
+// HANDLERS (server task)
+// ============================================================================
+
+esp_err_t ControlServer::handleGetState(httpd_req_t *req)
+{
+    ControlServer *self = (ControlServer *)req->user_ctx;
+    self->requests++;
+
+    char json[96];
+    size_t length = encodeControlState(self->mailbox.readState(), json, sizeof(json));
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, json, length);
+}
+
+esp_err_t ControlServer::handlePostState(httpd_req_t *req)
+{
+    ControlServer *self = (ControlServer *)req->user_ctx;
+    self->requests++;
+
+    if (req->content_len > CONTROL_JSON_MAX)
+    {
+        self->rejected++;
+        httpd_resp_set_status(req, "413 Payload Too Large");
+        return httpd_resp_send(req, nullptr, 0);
+    }
+
+    size_t received = 0;
+    while (received < req->content_len)
+    {
+        int n = httpd_req_recv(req, self->body + received, req->content_len - received);
+        if (n == HTTPD_SOCK_ERR_TIMEOUT)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return ESP_FAIL;
+        }
+        received += n;
+    }
+
+    ControlCommand cmd;
+    if (!parseControlCommand(self->body, received, cmd))
+    {
+        self->rejected++;
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid command");
+    }
+    self->mailbox.post(cmd);
+
+    // Applied on the next loop() pass, within one OUTPUT_INTERVAL
+    httpd_resp_set_status(req, "202 Accepted");
+    return httpd_resp_send(req, nullptr, 0);
+}
+
+esp_err_t ControlServer::handleWebSocket(httpd_req_t *req)
+{
+    ControlServer *self = (ControlServer *)req->user_ctx;
+
+    // Handshake
+    if (req->method == HTTP_GET)
+    {
+        self->wsConnected = true;
+        return ESP_OK;
+    }
+
+    httpd_ws_frame_t frame = {};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    if (frame.type != HTTPD_WS_TYPE_TEXT)
+    {
+        return ESP_OK;
+    }
+    self->requests++;
+
+    // httpd_ws_recv_frame() refuses a payload longer than its buffer and
+    // reads none of it, so drain oversized messages from the socket in
+    // buffer-sized chunks before replying with the error
+    bool fits = frame.len <= CONTROL_JSON_MAX;
+    if (fits)
+    {
+        frame.payload = (uint8_t *)self->body;
+        err = httpd_ws_recv_frame(req, &frame, CONTROL_JSON_MAX);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+    else
+    {
+        int fd = httpd_req_to_sockfd(req);
+        for (size_t left = frame.len; left > 0;)
+        {
+            int n = httpd_socket_recv(self->server, fd, self->body,
+                                      left < CONTROL_JSON_MAX ? left : CONTROL_JSON_MAX, 0);
+            if (n <= 0)
+            {
+                return ESP_FAIL;
+            }
+            left -= n;
+        }
+    }
+
+    ControlCommand cmd;
+    if (!fits || !parseControlCommand(self->body, frame.len, cmd))
+    {
+        self->rejected++;
+        static const char INVALID[] = "{\"error\":\"invalid command\"}";
+        httpd_ws_frame_t reply = {};
+        reply.type = HTTPD_WS_TYPE_TEXT;
+        reply.payload = (uint8_t *)INVALID;
+        reply.len = sizeof(INVALID) - 1;
+        return httpd_ws_send_frame(req, &reply);
+    }
+    self->mailbox.post(cmd);
+    return ESP_OK;
+}
+
+void ControlServer::sendPreview(void *arg)
+{
+    ControlServer *self = (ControlServer *)arg;
+
+    uint8_t frameCopy[sizeof(self->preview)];
+    portENTER_CRITICAL(&self->previewLock);
+    memcpy(frameCopy, self->preview, sizeof(frameCopy));
+    portEXIT_CRITICAL(&self->previewLock);
+
+    httpd_ws_frame_t frame = {};
+    frame.type = HTTPD_WS_TYPE_BINARY;
+    frame.payload = frameCopy;
+    frame.len = sizeof(frameCopy);
+
+    // Send to every WebSocket client; stop previews when none are left
+    size_t count = CONTROL_MAX_CLIENTS;
+    int fds[CONTROL_MAX_CLIENTS];
+    bool any = false;
+    if (httpd_get_client_list(self->server, &count, fds) == ESP_OK)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (httpd_ws_get_fd_info(self->server, fds[i]) == HTTPD_WS_CLIENT_WEBSOCKET &&
+                httpd_ws_send_frame_async(self->server, fds[i], &frame) == ESP_OK)
+            {
+                self->previews++;
+                any = true;
+            }
+        }
+    }
+    self->wsConnected = any;
+    self->previewBusy = false;
+}
+
+void ControlServer::printStats()
+{
+    Serial.printf("%-24s requests=%u rejected=%u previews=%u\n", "Control API",
+                  (unsigned)requests, (unsigned)rejected, (unsigned)previews);
+}
+
+#endif // CONTROL_API_ENABLED
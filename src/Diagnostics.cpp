@@ -0,0 +1,107 @@
+/**
+ * @file Diagnostics.cpp
+ * @brief Custom HomeKit diagnostics service implementation
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "Diagnostics.h"
+
+#if DIAGNOSTICS_ENABLED
+
+#include <esp_system.h>
+#include <esp_timer.h>
+
+// Service and characteristic UUIDs share the Notification characteristic's base
+#define DIAGNOSTICS_SERVICE_UUID "4A9C1E50-5C2B-4C8E-9E1B-0A1ADD1E0100"
+
+CUSTOM_CHAR(FrameRate, 4A9C1E50-5C2B-4C8E-9E1B-0A1ADD1E0101, PR + EV, FLOAT, 0, 0, 1000, true);
+CUSTOM_CHAR(WorstFrameTime, 4A9C1E50-5C2B-4C8E-9E1B-0A1ADD1E0102, PR + EV, UINT32, 0, 0, 4294967295, true);
+CUSTOM_CHAR(DroppedFrames, 4A9C1E50-5C2B-4C8E-9E1B-0A1ADD1E0103, PR + EV, UINT32, 0, 0, 4294967295, true);
+CUSTOM_CHAR(FreeHeap, 4A9C1E50-5C2B-4C8E-9E1B-0A1ADD1E0104, PR + EV, UINT32, 0, 0, 4294967295, true);
+CUSTOM_CHAR(Uptime, 4A9C1E50-5C2B-4C8E-9E1B-0A1ADD1E0105, PR, UINT32, 0, 0, 4294967295, true);
+CUSTOM_CHAR_STRING(ResetReason, 4A9C1E50-5C2B-4C8E-9E1B-0A1ADD1E0106, PR, "unknown");
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+DEV_Diagnostics::DEV_Diagnostics(DEV_CandleLight &lamp)
+    : SpanService(DIAGNOSTICS_SERVICE_UUID, "Diagnostics", true), lamp(lamp), lastRefresh(0)
+{
+    // Descriptions are what HAP browsers show for custom characteristics
+    frameRateChar = (new Characteristic::FrameRate())->setDescription("Frame Rate (fps)");
+    worstFrameChar = (new Characteristic::WorstFrameTime())->setDescription("Worst Frame Time (us)");
+    droppedFramesChar = (new Characteristic::DroppedFrames())->setDescription("Dropped Frames");
+    freeHeapChar = (new Characteristic::FreeHeap())->setDescription("Free Heap (bytes)");
+    uptimeChar = (new Characteristic::Uptime())->setDescription("Uptime")->setUnit("seconds"); // Read-only, no events
+
+    // Fixed for this boot
+    resetReasonChar = (new Characteristic::ResetReason(resetReasonName(esp_reset_reason())))
+                          ->setDescription("Reset Reason");
+
+    refresh(millis());
+    Serial.println("Diagnostics service initialized");
+}
+
+// ============================================================================
+// REFRESH
+// ============================================================================
+
+void DEV_Diagnostics::loop()
+{
+    uint32_t now = millis();
+    if (now - lastRefresh >= DIAGNOSTICS_INTERVAL)
+    {
+        refresh(now);
+    }
+}
+
+void DEV_Diagnostics::refresh(uint32_t now)
+{
+    lastRefresh = now;
+
+    // setVal() raises an event, so only for values that changed
+    float fps = frameRate.update(lamp.frameTime.count, now);
+    if (fps != frameRateChar->getVal<float>())
+    {
+        frameRateChar->setVal(fps);
+    }
+
+    uint32_t values[] = {
+        lamp.frameTime.worst,
+        lamp.droppedFrames,
+        esp_get_free_heap_size(),
+        (uint32_t)(esp_timer_get_time() / 1000000),
+    };
+    SpanCharacteristic *chars[] = {worstFrameChar, droppedFramesChar, freeHeapChar, uptimeChar};
+    for (int i = 0; i < 4; i++)
+    {
+        if (values[i] != chars[i]->getVal<uint32_t>())
+        {
+            chars[i]->setVal(values[i]);
+        }
+    }
+}
+
+#endif // DIAGNOSTICS_ENABLED
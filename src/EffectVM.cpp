@@ -0,0 +1,202 @@
+/**
+ * @file EffectVM.cpp
+ * @brief NVS persistence and serial upload for effect programs
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Third-party libraries
+#include <Arduino.h>
+#include <Preferences.h>
+
+// Project headers
+#include "EffectVM.h"
+
+// NVS namespace and key; the program is stored as its raw bytes
+#define EFFECT_NVS_NAMESPACE "effect"
+#define EFFECT_NVS_KEY "program"
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+void EffectVM::load()
+{
+    Preferences prefs;
+    prefs.begin(EFFECT_NVS_NAMESPACE, true);
+
+    uint8_t stored[VM_MAX_CODE];
+    size_t bytes = prefs.getBytesLength(EFFECT_NVS_KEY);
+    if (bytes > 0 && bytes <= sizeof(stored) && prefs.getBytes(EFFECT_NVS_KEY, stored, bytes) == bytes)
+    {
+        int where;
+        const char *error = install(stored, bytes, &where);
+        if (error)
+        {
+            Serial.printf("Effect program in NVS rejected: %s\n", error);
+        }
+        else
+        {
+            Serial.printf("Effect program loaded from NVS (%u instructions)\n",
+                          (unsigned)(length / VM_INSN_BYTES));
+        }
+    }
+    prefs.end();
+}
+
+void EffectVM::save()
+{
+    Preferences prefs;
+    prefs.begin(EFFECT_NVS_NAMESPACE, false);
+    if (loaded)
+    {
+        prefs.putBytes(EFFECT_NVS_KEY, code, length);
+        Serial.println("Effect program saved, runs at boot");
+    }
+    else
+    {
+        prefs.remove(EFFECT_NVS_KEY);
+        Serial.println("Effect program erased, candle runs at boot");
+    }
+    prefs.end();
+}
+
+// ============================================================================
+// SERIAL CLI
+// ============================================================================
+
+/**
+ * Value of one hex digit, -1 if c is not one
+ */
+static int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool EffectVM::command(const char *args)
+{
+    bool wasLoaded = loaded;
+
+    while (*args == ' ')
+    {
+        args++;
+    }
+
+    if (*args == '\0')
+    {
+        print();
+    }
+    else if (strncmp(args, "begin", 5) == 0)
+    {
+        // The upload is staged in code itself, so the candle shows meanwhile
+        unload();
+        Serial.println("Effect upload: send '@v + <hex>' lines, then '@v end'");
+    }
+    else if (*args == '+')
+    {
+        if (loaded)
+        {
+            Serial.println("Effect upload not started, send '@v begin' first");
+            return false;
+        }
+        for (const char *p = args + 1; *p; p++)
+        {
+            if (*p == ' ')
+            {
+                continue;
+            }
+            int high = hexDigit(p[0]);
+            int low = high < 0 ? -1 : hexDigit(p[1]);
+            if (low < 0)
+            {
+                Serial.println("Effect upload: bad hex, send '@v begin' to start over");
+                return false;
+            }
+            if (length >= VM_MAX_CODE)
+            {
+                Serial.printf("Effect upload: over %d bytes\n", VM_MAX_CODE);
+                return false;
+            }
+            code[length++] = (uint8_t)(high << 4 | low);
+            p++;
+        }
+    }
+    else if (strncmp(args, "end", 3) == 0)
+    {
+        int where;
+        const char *error = install(code, length, &where);
+        if (error)
+        {
+            Serial.printf("Effect program rejected at instruction %d: %s\n", where, error);
+            unload();
+        }
+        else
+        {
+            Serial.printf("Effect program running (%u instructions, use '@v save' to keep it)\n",
+                          (unsigned)(length / VM_INSN_BYTES));
+        }
+    }
+    else if (strncmp(args, "save", 4) == 0)
+    {
+        save();
+    }
+    else if (strncmp(args, "off", 3) == 0)
+    {
+        unload();
+        Serial.println("Effect program stopped, candle running ('@v save' to keep it off)");
+    }
+    else
+    {
+        Serial.println("Usage: @v              - show the effect program");
+        Serial.println("       @v begin        - start an upload (see scripts/fxasm.py)");
+        Serial.println("       @v + <hex>      - append program bytes");
+        Serial.println("       @v end          - check and run the upload");
+        Serial.println("       @v save | off   - persist to NVS / back to the candle");
+    }
+
+    return loaded != wasLoaded;
+}
+
+void EffectVM::print()
+{
+    if (!loaded)
+    {
+        Serial.printf("Effect program: none (candle), %u bytes staged\n", (unsigned)length);
+        return;
+    }
+    Serial.printf("Effect program: %u instructions, %u steps, %u over budget, last step %u/%d instructions\n",
+                  (unsigned)(length / VM_INSN_BYTES), (unsigned)steps, (unsigned)exhausted,
+                  (unsigned)lastUsed, VM_STEP_BUDGET);
+}
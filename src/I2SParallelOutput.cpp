@@ -0,0 +1,140 @@
+/**
+ * @file I2SParallelOutput.cpp
+ * @brief Implementation of the I2S-parallel APA102 output driver
+ *
+ * Uses the ESP-IDF esp_lcd i80 bus, which on the ESP32 runs the I2S
+ * peripheral in LCD mode with DMA. The WR strobe is the shared APA102
+ * clock; each data line is one strip.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "I2SParallelOutput.h"
+
+#if LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
+
+#include <esp_heap_caps.h>
+#include <esp_lcd_panel_io.h>
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+I2SParallelOutput::I2SParallelOutput()
+    : bus(nullptr), io(nullptr), dmaBuffer(nullptr), busy(false), dropped(0)
+{
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+bool I2SParallelOutput::begin(const int *dataPins, int clockPin, uint32_t clockHz)
+{
+    dmaBuffer = (Word *)heap_caps_malloc(FRAME_WORDS * sizeof(Word), MALLOC_CAP_DMA);
+    if (!dmaBuffer)
+    {
+        Serial.println("I2S output: DMA buffer allocation failed");
+        return false;
+    }
+
+    // Bus: shared clock on WR, one data lane per strip, unused lanes off
+    esp_lcd_i80_bus_config_t busConfig = {};
+    busConfig.clk_src = LCD_CLK_SRC_DEFAULT;
+    busConfig.dc_gpio_num = -1;
+    busConfig.wr_gpio_num = clockPin;
+    busConfig.bus_width = LANES;
+    busConfig.max_transfer_bytes = FRAME_WORDS * sizeof(Word);
+    for (int lane = 0; lane < LANES; lane++)
+    {
+        busConfig.data_gpio_nums[lane] = lane < NUM_STRIPS ? dataPins[lane] : -1;
+    }
+
+    if (esp_lcd_new_i80_bus(&busConfig, &bus) != ESP_OK)
+    {
+        Serial.println("I2S output: bus setup failed");
+        return false;
+    }
+
+    // Panel IO: no chip select, no command phase, one frame in flight
+    esp_lcd_panel_io_i80_config_t ioConfig = {};
+    ioConfig.cs_gpio_num = -1;
+    ioConfig.pclk_hz = clockHz;
+    ioConfig.trans_queue_depth = 1;
+    ioConfig.on_color_trans_done = onTransferDone;
+    ioConfig.user_ctx = this;
+    ioConfig.lcd_cmd_bits = 8;
+    ioConfig.lcd_param_bits = 8;
+
+    if (esp_lcd_new_panel_io_i80(bus, &ioConfig, &io) != ESP_OK)
+    {
+        Serial.println("I2S output: panel IO setup failed");
+        return false;
+    }
+
+    Serial.print("I2S parallel output: ");
+    Serial.print(NUM_STRIPS);
+    Serial.print(" strips, ");
+    Serial.print(FRAME_WORDS * sizeof(Word));
+    Serial.println(" byte DMA frame");
+    return true;
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+bool I2SParallelOutput::show(CRGB leds[][LED_LENGTH])
+{
+    // Never block the render loop: drop the frame if DMA still owns the buffer
+    if (!io || busy)
+    {
+        dropped++;
+        return false;
+    }
+
+    const uint8_t *strips[NUM_STRIPS];
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        strips[strip] = (const uint8_t *)leds[strip];
+    }
+    apa102EncodeParallel<Word>(strips, NUM_STRIPS, LED_LENGTH, dmaBuffer);
+
+    busy = true;
+    if (esp_lcd_panel_io_tx_color(io, -1, dmaBuffer, FRAME_WORDS * sizeof(Word)) != ESP_OK)
+    {
+        busy = false;
+        dropped++;
+        return false;
+    }
+    return true;
+}
+
+bool IRAM_ATTR I2SParallelOutput::onTransferDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *event, void *ctx)
+{
+    // ISR context: just release the buffer
+    static_cast<I2SParallelOutput *>(ctx)->busy = false;
+    return false;
+}
+
+#endif // LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
@@ -0,0 +1,262 @@
+/**
+ * @file LedOutput.cpp
+ * @brief Implementation of the LED output layer
+ *
+ * Maps each strip's configured chipset onto the matching FastLED
+ * controller (or the I2S-parallel driver) and times every output call.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "LedOutput.h"
+#include "Timeline.h"
+
+// ============================================================================
+// CHIPSET SELECTION
+// ============================================================================
+
+/**
+ * Compile-time mapping from CHIPSET_* to a FastLED controller
+ *
+ * Pins are template parameters in FastLED, so the mapping is a template
+ * too; each specialization is one addLeds<> call with the chipset's
+ * color order, or no controller for chipsets RmtOutput sends.
+ */
+template <int Chipset, uint8_t DataPin, uint8_t ClockPin>
+struct StripDriver;
+
+template <uint8_t DataPin, uint8_t ClockPin>
+struct StripDriver<CHIPSET_APA102, DataPin, ClockPin>
+{
+    static CLEDController *add(CRGB *leds)
+    {
+        return &FastLED.addLeds<APA102, DataPin, ClockPin, BGR>(leds, LED_LENGTH);
+    }
+};
+
+template <uint8_t DataPin, uint8_t ClockPin>
+struct StripDriver<CHIPSET_SK9822, DataPin, ClockPin>
+{
+    static CLEDController *add(CRGB *leds)
+    {
+        return &FastLED.addLeds<SK9822, DataPin, ClockPin, BGR>(leds, LED_LENGTH);
+    }
+};
+
+template <uint8_t DataPin, uint8_t ClockPin>
+struct StripDriver<CHIPSET_WS2812, DataPin, ClockPin>
+{
+    static CLEDController *add(CRGB *)
+    {
+        // Clockless: sent by RmtOutput, which does not wait for the wire
+        return nullptr;
+    }
+};
+
+static constexpr int stripChipsets[] = STRIP_CHIPSETS;
+static constexpr uint8_t stripDataPins[] = STRIP_DATA_PINS;
+static constexpr uint8_t stripClockPins[] = STRIP_CLOCK_PINS;
+
+static_assert(sizeof(stripChipsets) / sizeof(stripChipsets[0]) == NUM_STRIPS &&
+                  sizeof(stripDataPins) == NUM_STRIPS && sizeof(stripClockPins) == NUM_STRIPS,
+              "STRIP_CHIPSETS, STRIP_DATA_PINS and STRIP_CLOCK_PINS need one entry per strip");
+
+/**
+ * Add the controllers for strips 0 .. Strips-1, one StripDriver each
+ */
+template <int Strips>
+static void addStrips(CRGB leds[][LED_LENGTH], CLEDController **controllers)
+{
+    const int strip = Strips - 1;
+    addStrips<strip>(leds, controllers);
+    controllers[strip] =
+        StripDriver<stripChipsets[strip], stripDataPins[strip], stripClockPins[strip]>::add(leds[strip]);
+}
+
+template <>
+void addStrips<0>(CRGB[][LED_LENGTH], CLEDController **)
+{
+}
+
+/**
+ * True if no strip from the given one on is clockless
+ */
+static constexpr bool clockedFrom(int strip)
+{
+    return strip == NUM_STRIPS || (stripChipsets[strip] != CHIPSET_WS2812 && clockedFrom(strip + 1));
+}
+
+#if LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
+static_assert(clockedFrom(0), "I2S parallel output drives clocked strips only (APA102/SK9822)");
+#elif LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+static_assert(clockedFrom(0), "SPI direct output drives clocked strips only (APA102/SK9822)");
+#endif
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+LedOutput::LedOutput() : leds(nullptr)
+{
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+void LedOutput::begin(CRGB leds[][LED_LENGTH])
+{
+    this->leds = leds;
+
+#if LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
+    // Clock all strips together from one I2S DMA buffer
+    static const int dataPins[NUM_STRIPS] = STRIP_DATA_PINS;
+    i2s.begin(dataPins, I2S_PARALLEL_CLOCK_PIN, I2S_PARALLEL_CLOCK_HZ);
+#elif LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+    // One SPI host per strip, each sending its wire-format frame
+    static const int dataPins[NUM_STRIPS] = STRIP_DATA_PINS;
+    static const int clockPins[NUM_STRIPS] = STRIP_CLOCK_PINS;
+    spi.begin(dataPins, clockPins, SPI_DIRECT_CLOCK_HZ);
+#else
+    // One driver per strip, chipset from config.h
+    addStrips<NUM_STRIPS>(leds, controllers);
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        if (stripChipsets[strip] == CHIPSET_WS2812)
+        {
+            rmt.begin(strip, stripDataPins[strip]);
+        }
+    }
+    FastLED.setBrightness(255); // Use full brightness, control via color values
+#endif
+
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        fill_solid(leds[strip], LED_LENGTH, CRGB::Black);
+        Serial.print("Strip ");
+        Serial.print(strip + 1);
+        Serial.print(": ");
+        Serial.println(chipsetName(stripChipsets[strip]));
+    }
+    show();
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+void LedOutput::show()
+{
+    TIMELINE_SCOPE(TIMELINE_SHOW);
+
+#if LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
+    uint32_t start = micros();
+    i2s.show(leds);
+    outputTime.record(micros() - start);
+#elif LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+    // Drawn into leds (real-time input, Identify): pack into the wire frames
+    uint32_t start = micros();
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        spi.frame(strip).pack((const uint8_t *)leds[strip]);
+    }
+    spi.show();
+    outputTime.record(micros() - start);
+#else
+    // Show strips individually (same work FastLED.show() does) so each
+    // chipset's cost can be measured
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        uint32_t start = micros();
+        if (controllers[strip])
+        {
+            controllers[strip]->showLeds(255);
+        }
+        else
+        {
+            rmt.show(strip, (const uint8_t *)leds[strip]);
+        }
+        outputTime[strip].record(micros() - start);
+    }
+#endif
+}
+
+void LedOutput::showRendered()
+{
+#if LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+    TIMELINE_SCOPE(TIMELINE_SHOW);
+
+    // Frames are already on the wire format: queueing is all that's left
+    uint32_t start = micros();
+    spi.show();
+    outputTime.record(micros() - start);
+#else
+    show();
+#endif
+}
+
+#if LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+void LedOutput::unpack(CRGB out[][LED_LENGTH]) const
+{
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        spi.shown(strip).unpack((uint8_t *)out[strip]);
+    }
+}
+#endif
+
+void LedOutput::printStats()
+{
+#if LED_OUTPUT == LED_OUTPUT_I2S_PARALLEL
+    Serial.printf("Output (I2S, %d strips):  n=%u avg=%uus worst=%uus dropped=%u\n",
+                  NUM_STRIPS, (unsigned)outputTime.count, (unsigned)outputTime.average(),
+                  (unsigned)outputTime.worst, (unsigned)i2s.droppedFrames());
+#elif LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+    Serial.printf("Output (SPI direct, %d strips): n=%u avg=%uus worst=%uus dropped=%u\n",
+                  NUM_STRIPS, (unsigned)outputTime.count, (unsigned)outputTime.average(),
+                  (unsigned)outputTime.worst, (unsigned)spi.droppedFrames());
+#else
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        Serial.printf("Output strip %d (%s): n=%u avg=%uus worst=%uus dropped=%u\n",
+                      strip + 1, chipsetName(stripChipsets[strip]),
+                      (unsigned)outputTime[strip].count, (unsigned)outputTime[strip].average(),
+                      (unsigned)outputTime[strip].worst, (unsigned)rmt.droppedFrames(strip));
+    }
+#endif
+}
+
+const char *LedOutput::chipsetName(int chipset)
+{
+    switch (chipset)
+    {
+    case CHIPSET_APA102:
+        return "APA102";
+    case CHIPSET_SK9822:
+        return "SK9822";
+    case CHIPSET_WS2812:
+        return "WS2812";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,180 @@
+/**
+ * @file MqttBridge.cpp
+ * @brief MQTT background task: batching, metrics and commands
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Third-party libraries
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Project headers
+#include "MqttBridge.h"
+
+#if MQTT_ENABLED
+
+#define MQTT_TOPIC_STATE MQTT_TOPIC_PREFIX "/state"
+#define MQTT_TOPIC_METRICS MQTT_TOPIC_PREFIX "/metrics"
+#define MQTT_TOPIC_STATUS MQTT_TOPIC_PREFIX "/status"
+#define MQTT_TOPIC_SET MQTT_TOPIC_PREFIX "/set"
+
+static MqttConnectOptions connectOptions(const char *clientId)
+{
+    MqttConnectOptions options;
+    options.clientId = clientId;
+    options.user = MQTT_USER;
+    options.password = MQTT_PASSWORD;
+    options.willTopic = MQTT_TOPIC_STATUS;
+    options.willMessage = "offline";
+    options.keepAlive = MQTT_KEEPALIVE;
+    return options;
+}
+
+MqttBridge::MqttBridge(ControlMailbox &commandMailbox)
+    : mailbox(commandMailbox), client(connectOptions(clientId), MQTT_TOPIC_SET),
+      stateBatch(MQTT_PUBLISH_INTERVAL), stateVersion(0), announced(false), metricsFresh(false),
+      rejected(0)
+{
+    // Unique per board; filled before the task first connects
+    snprintf(clientId, sizeof(clientId), "%s-%06x", MQTT_TOPIC_PREFIX,
+             (unsigned)(ESP.getEfuseMac() & 0xFFFFFF));
+    portMUX_INITIALIZE(&metricsLock);
+    memset(&metrics, 0, sizeof(metrics));
+    client.onMessage(onMessage, this);
+}
+
+void MqttBridge::begin()
+{
+    // Core 0 with WiFi, away from the render loop on core 1
+    xTaskCreatePinnedToCore(taskEntry, "mqtt", MQTT_TASK_STACK, this, MQTT_TASK_PRIORITY, nullptr, 0);
+}
+
+void MqttBridge::publishMetrics(const LampMetrics &snapshot)
+{
+    portENTER_CRITICAL(&metricsLock);
+    metrics = snapshot;
+    portEXIT_CRITICAL(&metricsLock);
+    metricsFresh = true;
+}
+
+// ============================================================================
+// TASK
+// ============================================================================
+
+void MqttBridge::taskEntry(void *arg)
+{
+    ((MqttBridge *)arg)->run();
+}
+
+void MqttBridge::run()
+{
+    for (;;)
+    {
+        if (WiFi.status() != WL_CONNECTED)
+        {
+            announced = false;
+            vTaskDelay(pdMS_TO_TICKS(500));
+            continue;
+        }
+
+        uint32_t now = millis();
+        if (!client.poll(MQTT_BROKER, MQTT_PORT, now, MQTT_POLL_MS))
+        {
+            announced = false;
+            continue;
+        }
+        now = millis();
+
+        // Fresh connection: status and full state right away
+        if (!announced)
+        {
+            client.publish(MQTT_TOPIC_STATUS, "online", 6, true, now);
+            publishState(now);
+            announced = true;
+            Serial.println("MQTT: connected to " MQTT_BROKER);
+        }
+
+        // Batch state changes published by the render loop
+        uint32_t version;
+        mailbox.readState(&version);
+        if (version != stateVersion)
+        {
+            stateVersion = version;
+            stateBatch.mark(now);
+        }
+        if (stateBatch.due(now))
+        {
+            publishState(now);
+        }
+
+        if (metricsFresh)
+        {
+            portENTER_CRITICAL(&metricsLock);
+            LampMetrics snapshot = metrics;
+            portEXIT_CRITICAL(&metricsLock);
+            metricsFresh = false;
+
+            char json[256];
+            size_t length = encodeMetrics(snapshot, json, sizeof(json));
+            client.publish(MQTT_TOPIC_METRICS, json, length, false, now);
+        }
+    }
+}
+
+void MqttBridge::publishState(uint32_t now)
+{
+    char json[96];
+    size_t length = encodeControlState(mailbox.readState(&stateVersion), json, sizeof(json));
+    if (client.publish(MQTT_TOPIC_STATE, json, length, true, now))
+    {
+        stateBatch.sent();
+    }
+}
+
+void MqttBridge::onMessage(void *context, const char *topic, size_t topicLength,
+                           const uint8_t *payload, size_t length)
+{
+    MqttBridge *self = (MqttBridge *)context;
+    ControlCommand cmd;
+    if (parseControlCommand((const char *)payload, length, cmd))
+    {
+        self->mailbox.post(cmd);
+    }
+    else
+    {
+        self->rejected++;
+    }
+}
+
+void MqttBridge::printStats()
+{
+    Serial.printf("%-24s %s connects=%u failures=%u rejected=%u\n", "MQTT",
+                  client.connected() ? "connected" : "disconnected", (unsigned)client.connects,
+                  (unsigned)client.failures, (unsigned)rejected);
+    Serial.printf("%-24s changes=%u publishes=%u sent=%u received=%u\n", "MQTT state batching",
+                  (unsigned)stateBatch.changes, (unsigned)stateBatch.publishes,
+                  (unsigned)client.published, (unsigned)client.received);
+}
+
+#endif // MQTT_ENABLED
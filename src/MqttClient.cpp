@@ -0,0 +1,286 @@
+/**
+ * @file MqttClient.cpp
+ * @brief MQTT session over BSD sockets (lwIP on the ESP32, POSIX on the host)
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef ARDUINO
+#include <lwip/netdb.h>
+#include <lwip/sockets.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#endif
+
+// Project headers
+#include "MqttClient.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Blocking send/connect limit, so a stalled broker cannot wedge the task
+#define MQTT_SOCKET_TIMEOUT_MS 3000
+
+MqttClient::MqttClient(const MqttConnectOptions &connectOptions, const char *subscribe)
+    : published(0), received(0), connects(0), failures(0), reconnectDelay(MQTT_RECONNECT_DELAY),
+      options(connectOptions), subscription(subscribe), handler(nullptr), context(nullptr),
+      fd(-1), state(IDLE), lastAttempt(0), lastSent(0), lastReceived(0), attempted(false)
+{
+}
+
+void MqttClient::onMessage(MessageHandler messageHandler, void *messageContext)
+{
+    handler = messageHandler;
+    context = messageContext;
+}
+
+// ============================================================================
+// CONNECTION
+// ============================================================================
+
+bool MqttClient::open(const char *host, uint16_t port, uint32_t now)
+{
+    attempted = true;
+    lastAttempt = now;
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *result = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &result) != 0 || result == nullptr)
+    {
+        failures++;
+        return false;
+    }
+    struct sockaddr_in addr = *(struct sockaddr_in *)result->ai_addr;
+    freeaddrinfo(result);
+    addr.sin_port = htons(port);
+
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        failures++;
+        return false;
+    }
+    struct timeval tv;
+    tv.tv_sec = MQTT_SOCKET_TIMEOUT_MS / 1000;
+    tv.tv_usec = (MQTT_SOCKET_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close();
+        failures++;
+        return false;
+    }
+
+    reader.reset();
+    lastReceived = now;
+    size_t length = mqttConnect(options, tx, sizeof(tx));
+    if (length == 0 || !send(tx, length, now))
+    {
+        close();
+        failures++;
+        return false;
+    }
+    state = WAIT_CONNACK;
+    return true;
+}
+
+void MqttClient::close()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    fd = -1;
+    state = IDLE;
+}
+
+void MqttClient::disconnect()
+{
+    if (state == CONNECTED)
+    {
+        size_t length = mqttEmpty(MQTT_DISCONNECT, tx, sizeof(tx));
+        send(tx, length, lastSent);
+    }
+    close();
+}
+
+bool MqttClient::send(const uint8_t *data, size_t length, uint32_t now)
+{
+    while (length > 0)
+    {
+        ssize_t n = ::send(fd, data, length, MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            return false;
+        }
+        data += n;
+        length -= n;
+    }
+    lastSent = now;
+    return true;
+}
+
+// ============================================================================
+// SESSION
+// ============================================================================
+
+bool MqttClient::poll(const char *host, uint16_t port, uint32_t now, uint32_t timeoutMs)
+{
+    if (state == IDLE)
+    {
+        if (attempted && now - lastAttempt < reconnectDelay)
+        {
+            usleep(timeoutMs * 1000);
+            return false;
+        }
+        if (!open(host, port, now))
+        {
+            return false;
+        }
+    }
+
+    // The wait for data doubles as the task's sleep
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    struct timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+    if (select(fd + 1, &fds, nullptr, nullptr, &tv) > 0)
+    {
+        ssize_t n = recv(fd, reader.space(), reader.spaceLeft(), 0);
+        if (n <= 0)
+        {
+            close();
+            failures++;
+            return false;
+        }
+        reader.received(n);
+        lastReceived = now;
+
+        MqttPacket packet;
+        while (state != IDLE && reader.next(packet))
+        {
+            handle(packet, now);
+        }
+    }
+
+    // No CONNACK, or nothing (not even a PINGRESP) for 1.5 keep-alives:
+    // the connection is dead even if TCP has not noticed yet
+    uint32_t silence = state == WAIT_CONNACK ? MQTT_SOCKET_TIMEOUT_MS : 1500UL * options.keepAlive;
+    if (now - lastReceived > silence)
+    {
+        close();
+        failures++;
+        return false;
+    }
+
+    // Ping at half the keep-alive so a PINGRESP arrives well in time
+    if (now - lastSent >= 500UL * options.keepAlive)
+    {
+        size_t length = mqttEmpty(MQTT_PINGREQ, tx, sizeof(tx));
+        if (!send(tx, length, now))
+        {
+            close();
+            failures++;
+        }
+    }
+    return state == CONNECTED;
+}
+
+void MqttClient::handle(const MqttPacket &packet, uint32_t now)
+{
+    switch (packet.type)
+    {
+    case MQTT_CONNACK:
+        if (packet.length < 2 || packet.body[1] != 0)
+        {
+            close(); // Refused: bad credentials or client id
+            failures++;
+            return;
+        }
+        state = CONNECTED;
+        connects++;
+        if (subscription)
+        {
+            size_t length = mqttSubscribe(1, subscription, tx, sizeof(tx));
+            if (!send(tx, length, now))
+            {
+                close();
+                failures++;
+            }
+        }
+        break;
+
+    case MQTT_PUBLISH:
+    {
+        const char *topic;
+        const uint8_t *payload;
+        size_t topicLength, payloadLength;
+        if (handler && mqttParsePublish(packet, topic, topicLength, payload, payloadLength))
+        {
+            received++;
+            handler(context, topic, topicLength, payload, payloadLength);
+        }
+        break;
+    }
+
+    default:
+        break; // SUBACK, PINGRESP
+    }
+}
+
+bool MqttClient::publish(const char *topic, const char *payload, size_t length, bool retain, uint32_t now)
+{
+    if (state != CONNECTED)
+    {
+        return false;
+    }
+    size_t packetLength = mqttPublish(topic, payload, length, retain, tx, sizeof(tx));
+    if (packetLength == 0)
+    {
+        return false;
+    }
+    if (!send(tx, packetLength, now))
+    {
+        close();
+        failures++;
+        return false;
+    }
+    published++;
+    return true;
+}
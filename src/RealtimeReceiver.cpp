@@ -0,0 +1,186 @@
+/**
+ * @file RealtimeReceiver.cpp
+ * @brief DDP and E1.31 sockets and packet dispatch
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Third-party libraries
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+
+// Project headers
+#include "RealtimeReceiver.h"
+
+#if REALTIME_ENABLED
+
+RealtimeReceiver::RealtimeReceiver()
+    : packets(0), frames(0), ignored(0), ddpSocket(-1), e131Socket(-1),
+      streaming(false), lastPacket(0), frameMicros(0)
+{
+}
+
+/**
+ * Non-blocking UDP socket bound to a port on all interfaces
+ */
+static int openUdpSocket(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+}
+
+// ============================================================================
+// SOCKETS
+// ============================================================================
+
+bool RealtimeReceiver::open()
+{
+    if (ddpSocket >= 0 && e131Socket >= 0)
+    {
+        return true;
+    }
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        return false;
+    }
+
+    // Each socket is retried on its own so one that keeps failing to bind
+    // never replaces (and leaks) the other
+    if (ddpSocket < 0)
+    {
+        ddpSocket = openUdpSocket(DDP_PORT);
+    }
+    if (e131Socket < 0)
+    {
+        e131Socket = openUdpSocket(E131_PORT);
+
+        // E1.31 sources usually multicast to 239.255.<universe hi>.<universe lo>
+        if (e131Socket >= 0)
+        {
+            struct ip_mreq mreq = {};
+            mreq.imr_multiaddr.s_addr = htonl(0xEFFF0000u | REALTIME_E131_UNIVERSE);
+            mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+            setsockopt(e131Socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+        }
+    }
+
+    // Only reached again while a socket is missing, so this prints once
+    if (ddpSocket >= 0 && e131Socket >= 0)
+    {
+        Serial.printf("Realtime input: DDP port %u, E1.31 universe %u\n",
+                      (unsigned)DDP_PORT, (unsigned)REALTIME_E131_UNIVERSE);
+    }
+    return ddpSocket >= 0 || e131Socket >= 0;
+}
+
+// ============================================================================
+// RECEIVING
+// ============================================================================
+
+bool RealtimeReceiver::poll(uint8_t *pixels, size_t pixelBytes, uint32_t now)
+{
+    if (!open())
+    {
+        return false;
+    }
+
+    // Drain both sockets; later frames simply overwrite earlier ones
+    bool frameReady = false;
+    const int sockets[2] = {ddpSocket, e131Socket};
+    for (int s = 0; s < 2; s++)
+    {
+        if (sockets[s] < 0)
+        {
+            continue;
+        }
+
+        int length;
+        while ((length = recv(sockets[s], packet, sizeof(packet), 0)) > 0)
+        {
+            packets++;
+            RealtimeResult result = sockets[s] == ddpSocket
+                                        ? parseDdp(packet, length, pixels, pixelBytes, ddpSeq)
+                                        : parseE131(packet, length, REALTIME_E131_UNIVERSE, pixels, pixelBytes, e131Seq);
+            switch (result)
+            {
+            case RT_FRAME:
+                frames++;
+                frameReady = true;
+                frameMicros = micros();
+                // fall through
+            case RT_DATA:
+                streaming = true;
+                lastPacket = now;
+                break;
+
+            case RT_TERMINATED:
+                streaming = false;
+                frameReady = false;
+                break;
+
+            case RT_STALE:
+                break;
+
+            case RT_IGNORED:
+                ignored++;
+                break;
+            }
+        }
+    }
+
+    return frameReady && streaming;
+}
+
+void RealtimeReceiver::frameShown()
+{
+    latency.record(micros() - frameMicros);
+}
+
+void RealtimeReceiver::printStats()
+{
+    Serial.printf("%-24s packets=%u frames=%u ignored=%u\n", "Realtime input",
+                  (unsigned)packets, (unsigned)frames, (unsigned)ignored);
+    Serial.printf("%-24s ddp=%u e131=%u (late e131 %u)\n", "Realtime dropped",
+                  (unsigned)ddpSeq.dropped, (unsigned)e131Seq.dropped, (unsigned)e131Seq.stale);
+    Serial.printf("%-24s n=%u last=%uus avg=%uus worst=%uus\n", "Packet-to-output latency",
+                  (unsigned)latency.count, (unsigned)latency.last,
+                  (unsigned)latency.average(), (unsigned)latency.worst);
+}
+
+#endif // REALTIME_ENABLED
@@ -0,0 +1,151 @@
+/**
+ * @file RmtOutput.cpp
+ * @brief WS2812 strips through the ESP-IDF RMT driver
+ *
+ * Uses the driver/rmt_tx.h API (ESP-IDF 5, Arduino-ESP32 3.x), the same
+ * one FastLED's RMT5 controller uses: IDF 5 aborts at boot if the legacy
+ * driver/rmt.h is linked alongside it. rmt_transmit() returns once the
+ * transaction is queued; a bytes encoder in the driver's interrupt turns
+ * the frame's bytes into WS2812 symbols as the channel memory drains.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "RmtOutput.h"
+
+#if LED_OUTPUT == LED_OUTPUT_FASTLED
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+RmtOutput::RmtOutput()
+{
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        frames[strip] = nullptr;
+        channels[strip] = nullptr;
+        encoders[strip] = nullptr;
+        busy[strip] = false;
+        back[strip] = 0;
+        dropped[strip] = 0;
+    }
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+bool RmtOutput::begin(int strip, int dataPin)
+{
+    // Read by the RMT interrupt while it refills the channel memory
+    frames[strip] = (Frame *)calloc(2, sizeof(Frame));
+    if (!frames[strip])
+    {
+        Serial.println("RMT output: frame allocation failed");
+        return false;
+    }
+
+    rmt_tx_channel_config_t channelConfig = {};
+    channelConfig.gpio_num = (gpio_num_t)dataPin;
+    channelConfig.clk_src = RMT_CLK_SRC_DEFAULT;
+    channelConfig.resolution_hz = WS2812_RMT_RESOLUTION_HZ;
+    channelConfig.mem_block_symbols = 64;
+    // One frame in flight at most, so a free descriptor is always left
+    // and rmt_transmit() never waits for one
+    channelConfig.trans_queue_depth = 2;
+
+    rmt_bytes_encoder_config_t encoderConfig = {};
+    encoderConfig.bit0.val = WS2812_SYMBOL_0;
+    encoderConfig.bit1.val = WS2812_SYMBOL_1;
+    encoderConfig.flags.msb_first = 1;
+
+    rmt_tx_event_callbacks_t callbacks = {};
+    callbacks.on_trans_done = sent;
+
+    if (rmt_new_tx_channel(&channelConfig, &channels[strip]) != ESP_OK ||
+        rmt_new_bytes_encoder(&encoderConfig, &encoders[strip]) != ESP_OK ||
+        rmt_tx_register_event_callbacks(channels[strip], &callbacks, (void *)&busy[strip]) != ESP_OK ||
+        rmt_enable(channels[strip]) != ESP_OK)
+    {
+        Serial.println("RMT output: channel setup failed");
+        if (encoders[strip])
+        {
+            rmt_del_encoder(encoders[strip]);
+            encoders[strip] = nullptr;
+        }
+        if (channels[strip])
+        {
+            rmt_del_channel(channels[strip]);
+            channels[strip] = nullptr;
+        }
+        free(frames[strip]);
+        frames[strip] = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+bool IRAM_ATTR RmtOutput::sent(rmt_channel_handle_t, const rmt_tx_done_event_data_t *, void *busy)
+{
+    *(volatile bool *)busy = false;
+    return false; // No task woken
+}
+
+bool RmtOutput::show(int strip, const uint8_t *rgb)
+{
+    if (!frames[strip])
+    {
+        dropped[strip]++;
+        return false;
+    }
+
+    // Safe while the encoder reads the front buffer
+    Frame &frame = frames[strip][back[strip]];
+    frame.pack(rgb);
+
+    // Never block the render loop: only send once the last frame is out
+    if (busy[strip])
+    {
+        dropped[strip]++;
+        return false;
+    }
+
+    rmt_transmit_config_t config = {};
+    config.loop_count = 0;
+    busy[strip] = true;
+    if (rmt_transmit(channels[strip], encoders[strip], frame.bytes, Frame::BYTES, &config) != ESP_OK)
+    {
+        busy[strip] = false;
+        dropped[strip]++;
+        return false;
+    }
+    back[strip] ^= 1;
+    return true;
+}
+
+#endif // LED_OUTPUT == LED_OUTPUT_FASTLED
@@ -0,0 +1,146 @@
+/**
+ * @file SpiDirectOutput.cpp
+ * @brief Implementation of the SPI DMA wire-format output driver
+ *
+ * Uses the ESP-IDF spi_master driver on SPI2 (HSPI) and SPI3 (VSPI),
+ * routed to any GPIOs through the matrix. Transfers are queued without
+ * waiting and reclaimed on the next show().
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "SpiDirectOutput.h"
+
+#if LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
+
+#include <esp_heap_caps.h>
+
+static const spi_host_device_t stripHosts[] = {SPI2_HOST, SPI3_HOST};
+
+// ============================================================================
+// CONSTRUCTOR
+// ============================================================================
+
+SpiDirectOutput::SpiDirectOutput() : back(0), dropped(0)
+{
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        devices[strip] = nullptr;
+        inFlight[strip] = false;
+        frames[0][strip] = frames[1][strip] = nullptr;
+    }
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+bool SpiDirectOutput::begin(const int *dataPins, const int *clockPins, uint32_t clockHz)
+{
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        // Both buffers carry the framing from the start; render only touches pixels
+        for (int b = 0; b < 2; b++)
+        {
+            frames[b][strip] = (Frame *)heap_caps_malloc(sizeof(Frame), MALLOC_CAP_DMA);
+            if (!frames[b][strip])
+            {
+                Serial.println("SPI output: DMA frame allocation failed");
+                return false;
+            }
+            frames[b][strip]->begin(APA102_GLOBAL_BRIGHTNESS);
+        }
+
+        spi_bus_config_t busConfig = {};
+        busConfig.mosi_io_num = dataPins[strip];
+        busConfig.miso_io_num = -1;
+        busConfig.sclk_io_num = clockPins[strip];
+        busConfig.quadwp_io_num = -1;
+        busConfig.quadhd_io_num = -1;
+        busConfig.max_transfer_sz = Frame::BYTES;
+        if (spi_bus_initialize(stripHosts[strip], &busConfig, SPI_DMA_CH_AUTO) != ESP_OK)
+        {
+            Serial.println("SPI output: bus setup failed");
+            return false;
+        }
+
+        // Mode 0, no chip select, one frame in flight
+        spi_device_interface_config_t deviceConfig = {};
+        deviceConfig.mode = 0;
+        deviceConfig.clock_speed_hz = clockHz;
+        deviceConfig.spics_io_num = -1;
+        deviceConfig.queue_size = 1;
+        if (spi_bus_add_device(stripHosts[strip], &deviceConfig, &devices[strip]) != ESP_OK)
+        {
+            Serial.println("SPI output: device setup failed");
+            return false;
+        }
+    }
+
+    Serial.print("SPI direct output: ");
+    Serial.print(NUM_STRIPS);
+    Serial.print(" strips, ");
+    Serial.print(Frame::BYTES);
+    Serial.println(" byte wire frames");
+    return true;
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+bool SpiDirectOutput::show()
+{
+    // Never block the render loop: drop the frame if DMA still owns a buffer
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        if (!devices[strip])
+        {
+            dropped++;
+            return false;
+        }
+        if (inFlight[strip])
+        {
+            spi_transaction_t *done;
+            if (spi_device_get_trans_result(devices[strip], &done, 0) != ESP_OK)
+            {
+                dropped++;
+                return false;
+            }
+            inFlight[strip] = false;
+        }
+    }
+
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        spi_transaction_t &t = transactions[strip];
+        memset(&t, 0, sizeof(t));
+        t.length = Frame::BYTES * 8;
+        t.tx_buffer = frames[back][strip]->bytes;
+        inFlight[strip] = spi_device_queue_trans(devices[strip], &t, 0) == ESP_OK;
+    }
+    back ^= 1;
+    return true;
+}
+
+#endif // LED_OUTPUT == LED_OUTPUT_SPI_DIRECT
@@ -0,0 +1,233 @@
+/**
+ * @file SyncLink.cpp
+ * @brief UDP multicast beacons for multi-lamp flicker sync
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Third-party libraries
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+
+// Project headers
+#include "SyncLink.h"
+#include "TraceLog.h"
+
+static const char *const ROLE_NAMES[] = {"off", "leader", "follower"};
+
+SyncLink::SyncLink()
+    : sock(-1), role(SYNC_ROLE), group(SYNC_GROUP), joined(false), joinFailed(false), lastJoin(0), lastSent(0),
+      sent(0), received(0), foreign(0)
+{
+}
+
+/**
+ * Multicast group address in network byte order
+ */
+static struct sockaddr_in groupAddress()
+{
+    static const uint8_t ADDR[4] = {SYNC_MULTICAST_ADDR};
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SYNC_PORT);
+    memcpy(&addr.sin_addr.s_addr, ADDR, sizeof(ADDR));
+    return addr;
+}
+
+// ============================================================================
+// SOCKET
+// ============================================================================
+
+bool SyncLink::join()
+{
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        return false;
+    }
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SYNC_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    struct ip_mreq mreq = {};
+    mreq.imr_multiaddr = groupAddress().sin_addr;
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+    {
+        leave();
+        return false;
+    }
+    fcntl(sock, F_SETFL, O_NONBLOCK);
+    return true;
+}
+
+void SyncLink::leave()
+{
+    if (sock >= 0)
+    {
+        close(sock);
+        sock = -1;
+    }
+}
+
+// ============================================================================
+// BEACONS
+// ============================================================================
+
+void SyncLink::poll(SyncClock &clock, FrameGate &gate, uint32_t now)
+{
+    if (role == SYNC_ROLE_OFF)
+    {
+        return;
+    }
+
+    // (Re)join the group each time WiFi connects, backing off if it fails
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        if (joined)
+        {
+            leave();
+            joined = false;
+        }
+        joinFailed = false;
+    }
+    else if (!joined && (!joinFailed || now - lastJoin >= SYNC_JOIN_RETRY))
+    {
+        joined = join();
+        joinFailed = !joined;
+        lastJoin = now;
+    }
+    if (!joined)
+    {
+        return;
+    }
+
+    if (role == SYNC_ROLE_LEADER && now - lastSent >= SYNC_INTERVAL)
+    {
+        gate.acquire();
+        SyncPacket beacon = clock.beacon(group, now);
+        gate.release();
+
+        size_t length = encodeSyncPacket(beacon, buf);
+        struct sockaddr_in to = groupAddress();
+        sendto(sock, buf, length, 0, (struct sockaddr *)&to, sizeof(to));
+        lastSent = now;
+        sent++;
+    }
+
+    // Drain everything queued; our own beacons loop back and are skipped
+    int length;
+    while ((length = recvfrom(sock, buf, sizeof(buf), MSG_DONTWAIT, nullptr, nullptr)) > 0)
+    {
+        SyncPacket packet;
+        if (!decodeSyncPacket(buf, length, packet))
+        {
+            continue;
+        }
+
+        if (role == SYNC_ROLE_FOLLOWER)
+        {
+            gate.acquire();
+            uint32_t resyncs = clock.resyncs;
+            bool followed = clock.follow(packet, group, now);
+            bool resynced = clock.resyncs != resyncs;
+            uint32_t frame = clock.frame;
+            gate.release();
+
+            if (followed)
+            {
+                received++;
+                if (resynced)
+                {
+                    TRACE(TRACE_SYNC, 1, frame);
+                }
+            }
+        }
+        else if (packet.group == group && packet.seed != clock.seed)
+        {
+            foreign++; // Two leaders in one group
+        }
+    }
+}
+
+// ============================================================================
+// SERIAL CLI
+// ============================================================================
+
+void SyncLink::setRole(uint8_t newRole)
+{
+    role = newRole;
+    leave();
+    joined = false;
+    joinFailed = false;
+}
+
+void SyncLink::command(const char *args, SyncClock &clock)
+{
+    int value;
+
+    while (*args == ' ')
+    {
+        args++;
+    }
+
+    if (strcmp(args, "off") == 0)
+    {
+        setRole(SYNC_ROLE_OFF);
+    }
+    else if (strcmp(args, "leader") == 0)
+    {
+        setRole(SYNC_ROLE_LEADER);
+    }
+    else if (strcmp(args, "follower") == 0)
+    {
+        setRole(SYNC_ROLE_FOLLOWER);
+    }
+    else if (sscanf(args, "group %d", &value) == 1)
+    {
+        group = constrain(value, 1, 255);
+    }
+    else if (sscanf(args, "offset %d", &value) == 1)
+    {
+        clock.frameOffset = value;
+    }
+    else if (*args != '\0')
+    {
+        Serial.println("Usage: @s [leader|follower|off|group <n>|offset <n>]");
+        return;
+    }
+
+    uint32_t now = millis();
+    Serial.printf("Sync: %s, group %u, offset %d, %s\n", ROLE_NAMES[role], (unsigned)group,
+                  (int)clock.frameOffset, joined ? "joined" : "not joined");
+    Serial.printf("  seed %08x, frame %u, resyncs %u, %s\n", (unsigned)clock.seed, (unsigned)clock.frame,
+                  (unsigned)clock.resyncs, clock.inSync(now) ? "in sync" : "free-running");
+    Serial.printf("  beacons sent %u, received %u, other leaders %u\n", (unsigned)sent, (unsigned)received,
+                  (unsigned)foreign);
+}
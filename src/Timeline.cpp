@@ -0,0 +1,97 @@
+/**
+ * @file Timeline.cpp
+ * @brief Span ring storage and the "@l" dump
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Third-party libraries
+#include <Arduino.h>
+
+// Project headers
+#include "Timeline.h"
+
+#if TIMELINE_ENABLED
+
+Timeline timeline;
+
+// ============================================================================
+// SERIAL CLI
+// ============================================================================
+
+/**
+ * Print the spans as base64 between marker lines
+ *
+ * "TIMELINE BEGIN <now µs> <spans>" gives the clock at the dump, which
+ * dates each span from its 32-bit start; six spans per line.
+ */
+static void timelineDump()
+{
+    timeline.pause(true);
+    uint32_t count = timeline.count();
+    uint64_t now = esp_timer_get_time();
+    Serial.printf("TIMELINE BEGIN %llu %u\n", (unsigned long long)now, (unsigned)count);
+
+    uint8_t bytes[6 * TIMELINE_WIRE_SIZE];
+    char line[4 * sizeof(bytes) / 3 + 1];
+    size_t used = 0;
+    timeline.forEach([&](const TimelineEntry &e) {
+        Timeline::encode(e, bytes + used);
+        used += TIMELINE_WIRE_SIZE;
+        if (used == sizeof(bytes))
+        {
+            timelineBase64(bytes, used, line);
+            Serial.println(line);
+            used = 0;
+        }
+    });
+    if (used > 0)
+    {
+        timelineBase64(bytes, used, line);
+        Serial.println(line);
+    }
+
+    Serial.println("TIMELINE END");
+    Serial.printf("%u spans; save the log and run scripts/timeline_json.py on it\n", (unsigned)count);
+    timeline.pause(false);
+}
+
+void timelineCommand(const char *args)
+{
+    while (*args == ' ')
+    {
+        args++;
+    }
+
+    if (strncmp(args, "clear", 5) == 0)
+    {
+        timeline.clear();
+        Serial.println("Timeline cleared");
+    }
+    else
+    {
+        timelineDump();
+    }
+}
+
+#endif // TIMELINE_ENABLED
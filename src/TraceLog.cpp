@@ -0,0 +1,90 @@
+/**
+ * @file TraceLog.cpp
+ * @brief RTC-resident trace ring and its serial dump
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Third-party libraries
+#include <Arduino.h>
+#include <esp_system.h>
+
+// Project headers
+#include "TraceLog.h"
+
+/**
+ * Ring storage in RTC slow memory, not zeroed at boot so the previous
+ * session's entries are still there after a reset
+ */
+RTC_NOINIT_ATTR static TraceBuffer traceBuffer;
+
+TraceLog traceLog;
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+void traceBegin()
+{
+    traceLog.attach(&traceBuffer);
+    TRACE(TRACE_BOOT, esp_reset_reason(), 0);
+}
+
+// ============================================================================
+// SERIAL CLI
+// ============================================================================
+
+void traceDump()
+{
+    uint32_t count = 0;
+    traceLog.forEach([&count](const TraceEntry &e) {
+        uint32_t ms = (uint32_t)((uint64_t)e.time * 1024 / 1000);
+        if (e.event() == TRACE_BOOT)
+        {
+            Serial.println("---- boot ----");
+        }
+        Serial.printf("#%-6u %7u.%03us  %-9s a=%u b=%u\n", (unsigned)e.seq,
+                      (unsigned)(ms / 1000), (unsigned)(ms % 1000),
+                      TraceLog::eventName(e.event()), (unsigned)e.a(), (unsigned)e.b());
+        count++;
+    });
+    Serial.printf("%u trace entries (times since each boot)\n", (unsigned)count);
+}
+
+void traceCommand(const char *args)
+{
+    while (*args == ' ')
+    {
+        args++;
+    }
+
+    if (strncmp(args, "clear", 5) == 0)
+    {
+        traceLog.clear();
+        Serial.println("Trace cleared");
+    }
+    else
+    {
+        traceDump();
+    }
+}
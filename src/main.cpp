@@ -48,10 +48,15 @@
 #include <Arduino.h>
 #include "HomeSpan.h"
 #include <FastLED.h>
+#include <esp_system.h>
 
 // Project headers
 #include "config.h"
 #include "CandleLight.h"
+#include "Diagnostics.h"
+#include "LedOutput.h"
+#include "Timeline.h"
+#include "TraceLog.h"
 
 // ============================================================================
 // GLOBAL LED ARRAYS
@@ -63,6 +68,132 @@
  */
 CRGB leds[NUM_STRIPS][LED_LENGTH];
 
+/**
+ * Output layer that sends the LED arrays to the strips
+ * Chipset and driver per strip come from config.h
+ */
+LedOutput ledOutput;
+
+/**
+ * Candle light service instance
+ * Kept for serial CLI commands that report on the render path
+ */
+DEV_CandleLight *candleLight = nullptr;
+
+// ============================================================================
+// SERIAL CLI COMMANDS
+// ============================================================================
+
+/**
+ * Skip the "@x" prefix of a user command, returning its arguments
+ */
+static const char *commandArgs(const char *buf)
+{
+    if (*buf == '@')
+    {
+        buf++;
+    }
+    if (*buf)
+    {
+        buf++;
+    }
+    return buf;
+}
+
+/**
+ * "@p" - print render performance counters, or time frames across NVS writes
+ */
+void cmdPrintStats(const char *buf)
+{
+    if (candleLight)
+    {
+        candleLight->statsCommand(commandArgs(buf));
+    }
+}
+
+/**
+ * "@c" - show or edit LED calibration (white balance, intensity)
+ */
+void cmdCalibration(const char *buf)
+{
+    if (candleLight)
+    {
+        candleLight->calibrationCommand(commandArgs(buf));
+    }
+}
+
+/**
+ * "@o" - show or clear a notification overlay
+ */
+void cmdOverlay(const char *buf)
+{
+    if (candleLight)
+    {
+        candleLight->overlayCommand(commandArgs(buf));
+    }
+}
+
+/**
+ * "@t" - dump the crash-surviving event trace
+ */
+void cmdTrace(const char *buf)
+{
+    traceCommand(commandArgs(buf));
+}
+
+#if TIMELINE_ENABLED
+/**
+ * "@l" - print the span timeline for scripts/timeline_json.py
+ */
+void cmdTimeline(const char *buf)
+{
+    timelineCommand(commandArgs(buf));
+}
+#endif
+
+/**
+ * "@v" - upload, save or stop a user effect program
+ */
+void cmdEffect(const char *buf)
+{
+    if (candleLight)
+    {
+        candleLight->effectCommand(commandArgs(buf));
+    }
+}
+
+/**
+ * "@s" - show or change multi-lamp flicker sync
+ */
+void cmdSync(const char *buf)
+{
+    if (candleLight)
+    {
+        candleLight->syncCommand(commandArgs(buf));
+    }
+}
+
+// ============================================================================
+// STATUS CALLBACK
+// ============================================================================
+
+/**
+ * HomeSpan status changes, mirrored on the strips as overlays
+ */
+void statusChanged(HS_STATUS status)
+{
+    Serial.print("Status: ");
+    Serial.println(homeSpan.statusString(status));
+    TRACE(TRACE_STATUS, status, 0);
+
+#if STATUS_ON_STRIPS
+    if (candleLight)
+    {
+        candleLight->showStatus(status);
+    }
+#endif
+}
+
 // ============================================================================
 // SETUP AND MAIN LOOP
 // ============================================================================
@@ -75,9 +206,8 @@ void setup()
         ; // wait for serial port to connect. Needed for native USB
     }
 
-    // Initialize random number generator with ESP32 hardware RNG
-    // This ensures different flicker patterns on each power cycle
-    randomSeed(esp_random());
+    // Keep the previous session's trace and record this boot
+    traceBegin();
 
     Serial.println("\n\n================================");
     Serial.println("Aladdin Lamp - HomeKit Candle");
@@ -90,14 +220,30 @@ void setup()
     homeSpan.setPairingCode(HOMEKIT_SETUP_CODE); // Custom pairing code
     homeSpan.setStatusPin(STATUS_LED_PIN);
     homeSpan.setControlPin(CONTROL_BUTTON_PIN);
+    homeSpan.setStatusCallback(statusChanged);
 
     // Initialize HomeSpan
     homeSpan.begin(Category::Lighting, HOMEKIT_NAME);
 
     // Create HomeKit accessory
     new SpanAccessory();
-    new DEV_Identify();  // Custom AccessoryInformation with identify functionality
-    new DEV_CandleLight();  // Candle light service
+    DEV_Identify *identify = new DEV_Identify();  // Custom AccessoryInformation with identify functionality
+    candleLight = new DEV_CandleLight();  // Candle light service
+    identify->candle = candleLight;       // Fades the candle back in after identifying
+#if DIAGNOSTICS_ENABLED
+    new DEV_Diagnostics(*candleLight);    // Performance counters for Eve / HAP browsers
+#endif
+
+    // Register custom serial CLI commands (type "@p" in serial monitor)
+    new SpanUserCommand('p', "- print render performance counters, '@p nvs' times frames across NVS writes", cmdPrintStats);
+    new SpanUserCommand('c', "- show/edit LED calibration, '@c help' for usage", cmdCalibration);
+    new SpanUserCommand('o', "- show a notification overlay, '@o' lists them", cmdOverlay);
+    new SpanUserCommand('t', "- dump event trace (survives resets), '@t clear' wipes it", cmdTrace);
+    new SpanUserCommand('s', "- show/change multi-lamp flicker sync, '@s leader|follower|off'", cmdSync);
+    new SpanUserCommand('v', "- upload/save/stop an effect program, '@v help' for usage", cmdEffect);
+#if TIMELINE_ENABLED
+    new SpanUserCommand('l', "- print span timeline (base64), '@l clear' wipes it", cmdTimeline);
+#endif
 
     // Print setup instructions
     Serial.println("Setup complete!");
@@ -109,6 +255,17 @@ void setup()
     Serial.println("\nStatus LED (GPIO 22):");
     Serial.println("  - Blinking: Not connected/pairing");
     Serial.println("  - Solid: Connected and paired");
+#if STATUS_ON_STRIPS
+    Serial.println("\nStatus on strips:");
+    Serial.println("  - Amber pulse: Waiting to pair");
+    Serial.println("  - Blue shimmer: Connecting to WiFi");
+    Serial.println("  - Cyan pulse: Setup AP active");
+#endif
+#if CONTROL_API_ENABLED
+    Serial.println("\nLocal control API (once WiFi is up):");
+    Serial.printf("  - http://<lamp-ip>:%u/api/state (GET/POST JSON)\n", (unsigned)CONTROL_PORT);
+    Serial.printf("  - ws://<lamp-ip>:%u/ws (JSON in, LED previews out)\n", (unsigned)CONTROL_PORT);
+#endif
     Serial.println("\nTo pair with HomeKit:");
     Serial.println("1. Connect to '" WIFI_AP_SSID "' WiFi (no password)");
     Serial.println("2. Configure your WiFi credentials via captive portal");
@@ -118,10 +275,37 @@ void setup()
     Serial.println("\nTo reconfigure WiFi:");
     Serial.println("- Long press power button (GPIO 0) for 3 seconds");
     Serial.println("- WiFi AP will be enabled for 5 minutes");
+    Serial.println("\nDiagnostics:");
+    Serial.println("- Type '@p' to print render performance counters");
+    Serial.println("- Type '@c' to show LED calibration ('@c help' for usage)");
+    Serial.println("- Type '@o' to list notification overlays ('@o doorbell' to test)");
+    Serial.println("- Type '@t' to dump the event trace (kept across resets)");
+    Serial.println("- Type '@s' to show multi-lamp sync ('@s leader' / '@s follower')");
+    Serial.println("- Type '@v' to show the effect program (scripts/fxasm.py to make one)");
+#if TIMELINE_ENABLED
+    Serial.println("- Type '@l' to print the span timeline (scripts/timeline_json.py)");
+#endif
     Serial.println("================================\n");
 }
 
 void loop()
 {
-    homeSpan.poll();
+    {
+        TIMELINE_SCOPE(TIMELINE_POLL);
+        homeSpan.poll();
+    }
+
+    // Trace each new free-heap low once it falls below the threshold
+    static uint32_t lastHeapCheck = 0;
+    static uint32_t lowestHeap = TRACE_HEAP_LOW_BYTES;
+    if (millis() - lastHeapCheck >= 1000)
+    {
+        lastHeapCheck = millis();
+        uint32_t freeHeap = esp_get_free_heap_size();
+        if (freeHeap < lowestHeap)
+        {
+            lowestHeap = freeHeap;
+            TRACE(TRACE_HEAP_LOW, 0, freeHeap / 1024);
+        }
+    }
 }
@@ -89,6 +89,24 @@ void test_led_configuration(void)
     TEST_ASSERT_EQUAL(2, NUM_STRIPS);
 }
 
+void test_strip_chipsets(void)
+{
+    // One supported chipset per strip
+    static const int chipsets[] = STRIP_CHIPSETS;
+    TEST_ASSERT_EQUAL(NUM_STRIPS, (int)(sizeof(chipsets) / sizeof(chipsets[0])));
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL(CHIPSET_APA102, chipsets[strip]);
+        TEST_ASSERT_LESS_OR_EQUAL(CHIPSET_WS2812, chipsets[strip]);
+
+        // I2S parallel and SPI direct output only drive clocked chipsets
+        if (LED_OUTPUT != LED_OUTPUT_FASTLED)
+        {
+            TEST_ASSERT_NOT_EQUAL(CHIPSET_WS2812, chipsets[strip]);
+        }
+    }
+}
+
 // ============================================================================
 // DEFAULT SETTINGS TESTS
 // ============================================================================
@@ -132,6 +150,20 @@ void test_update_interval(void)
     TEST_ASSERT_LESS_OR_EQUAL(1000, UPDATE_INTERVAL);
 }
 
+void test_output_interval(void)
+{
+    // Interpolated output must run at least as often as flicker synthesis
+    TEST_ASSERT_GREATER_THAN(0, OUTPUT_INTERVAL);
+    TEST_ASSERT_LESS_OR_EQUAL(UPDATE_INTERVAL, OUTPUT_INTERVAL);
+}
+
+void test_pacer_stall(void)
+{
+    // The pacer only steps in once loop() has missed its output slot
+    TEST_ASSERT_GREATER_THAN(OUTPUT_INTERVAL, PACER_STALL_MS);
+    TEST_ASSERT_LESS_THAN(UPDATE_INTERVAL, PACER_STALL_MS);
+}
+
 void test_brightness_range(void)
 {
     // Min should be less than max
@@ -183,6 +215,7 @@ void run_tests(void)
 
     // LED tests
     RUN_TEST(test_led_configuration);
+    RUN_TEST(test_strip_chipsets);
 
     // Default settings tests
     RUN_TEST(test_default_hue);
@@ -192,6 +225,8 @@ void run_tests(void)
     // Flicker algorithm tests
     RUN_TEST(test_flicker_smoothing);
     RUN_TEST(test_update_interval);
+    RUN_TEST(test_output_interval);
+    RUN_TEST(test_pacer_stall);
     RUN_TEST(test_brightness_range);
     RUN_TEST(test_hue_variation);
 
@@ -0,0 +1,271 @@
+/**
+ * @file test_control.cpp
+ * @brief Local control API message tests
+ *
+ * Tests for the zero-copy JSON reader, command parsing and the
+ * latest-wins mailbox merge in ControlProtocol.h.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include "config.h"
+    #include "ControlProtocol.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include "config.h"
+    #include "ControlProtocol.h"
+#endif
+
+/**
+ * Parse a NUL-terminated test string
+ */
+static bool parse(const char *json, ControlCommand &cmd)
+{
+    return parseControlCommand(json, strlen(json), cmd);
+}
+
+// ============================================================================
+// JSON READER TESTS
+// ============================================================================
+
+void test_reader_members_point_into_buffer(void)
+{
+    const char json[] = " { \"a\" : 12 , \"name\":\"doorbell\", \"on\":true, \"x\":null } ";
+    JsonObjectReader reader(json, strlen(json));
+    JsonSlice key, value;
+
+    TEST_ASSERT_TRUE(reader.next(key, value));
+    TEST_ASSERT_TRUE(key.equals("a"));
+    TEST_ASSERT_EQUAL(JSON_NUMBER, value.type);
+    TEST_ASSERT_TRUE(value.p > json && value.p < json + sizeof(json)); // zero-copy
+
+    TEST_ASSERT_TRUE(reader.next(key, value));
+    TEST_ASSERT_TRUE(key.equals("name"));
+    TEST_ASSERT_EQUAL(JSON_STRING, value.type);
+    TEST_ASSERT_TRUE(value.equals("doorbell"));
+
+    TEST_ASSERT_TRUE(reader.next(key, value));
+    TEST_ASSERT_EQUAL(JSON_TRUE, value.type);
+    TEST_ASSERT_TRUE(reader.next(key, value));
+    TEST_ASSERT_EQUAL(JSON_NULL, value.type);
+
+    TEST_ASSERT_FALSE(reader.next(key, value));
+    TEST_ASSERT_TRUE(reader.ok());
+}
+
+void test_reader_skips_nested_values(void)
+{
+    const char json[] = "{\"rgb\":[1,[2],{\"s\":\"]}\"}],\"hue\":5}";
+    JsonObjectReader reader(json, strlen(json));
+    JsonSlice key, value;
+
+    TEST_ASSERT_TRUE(reader.next(key, value));
+    TEST_ASSERT_EQUAL(JSON_NESTED, value.type);
+    TEST_ASSERT_TRUE(reader.next(key, value));
+    TEST_ASSERT_TRUE(key.equals("hue"));
+    TEST_ASSERT_FALSE(reader.next(key, value));
+    TEST_ASSERT_TRUE(reader.ok());
+}
+
+void test_reader_rejects_malformed(void)
+{
+    const char *const bad[] = {
+        "", "[]", "{", "{\"a\"}", "{\"a\":}", "{\"a\":1,}", "{\"a\":1 \"b\":2}",
+        "{\"a\":\"open}", "{\"a\":tru}", "{\"a\":1} extra", "{\"a\":[1,2}"};
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    {
+        JsonObjectReader reader(bad[i], strlen(bad[i]));
+        JsonSlice key, value;
+        while (reader.next(key, value))
+        {
+        }
+        TEST_ASSERT_FALSE_MESSAGE(reader.ok(), bad[i]);
+    }
+
+    JsonObjectReader empty("{ }", 3);
+    JsonSlice key, value;
+    TEST_ASSERT_FALSE(empty.next(key, value));
+    TEST_ASSERT_TRUE(empty.ok());
+}
+
+void test_slice_to_int(void)
+{
+    JsonSlice s = {"-42", 3, JSON_NUMBER};
+    int32_t n = 0;
+    TEST_ASSERT_TRUE(s.toInt(n));
+    TEST_ASSERT_EQUAL(-42, n);
+
+    JsonSlice fraction = {"1.5", 3, JSON_NUMBER};
+    JsonSlice sign = {"-", 1, JSON_NUMBER};
+    JsonSlice huge = {"99999999999", 11, JSON_NUMBER};
+    JsonSlice text = {"12", 2, JSON_STRING};
+    TEST_ASSERT_FALSE(fraction.toInt(n));
+    TEST_ASSERT_FALSE(sign.toInt(n));
+    TEST_ASSERT_FALSE(huge.toInt(n));
+    TEST_ASSERT_FALSE(text.toInt(n));
+}
+
+// ============================================================================
+// COMMAND TESTS
+// ============================================================================
+
+void test_command_fields(void)
+{
+    ControlCommand cmd;
+    TEST_ASSERT_TRUE(parse("{\"power\":false,\"hue\":360,\"saturation\":0,\"brightness\":100}", cmd));
+    TEST_ASSERT_EQUAL(CONTROL_POWER | CONTROL_HUE | CONTROL_SATURATION | CONTROL_BRIGHTNESS, cmd.fields);
+    TEST_ASSERT_FALSE(cmd.power);
+    TEST_ASSERT_EQUAL(360, cmd.hue);
+    TEST_ASSERT_EQUAL(0, cmd.saturation);
+    TEST_ASSERT_EQUAL(100, cmd.brightness);
+
+    // Only what was sent; unknown keys are ignored
+    TEST_ASSERT_TRUE(parse("{\"brightness\":40,\"effect\":{\"speed\":2}}", cmd));
+    TEST_ASSERT_EQUAL(CONTROL_BRIGHTNESS, cmd.fields);
+}
+
+void test_command_rejects_bad_values(void)
+{
+    ControlCommand cmd;
+    TEST_ASSERT_FALSE(parse("{\"hue\":361}", cmd));
+    TEST_ASSERT_FALSE(parse("{\"brightness\":-1}", cmd));
+    TEST_ASSERT_FALSE(parse("{\"brightness\":50.5}", cmd));
+    TEST_ASSERT_FALSE(parse("{\"power\":1}", cmd));
+    TEST_ASSERT_FALSE(parse("{\"saturation\":\"50\"}", cmd));
+    TEST_ASSERT_FALSE(parse("{\"notify\":\"fireworks\"}", cmd));
+    TEST_ASSERT_FALSE(parse("{\"power\":true", cmd));
+}
+
+void test_command_notify(void)
+{
+    ControlCommand cmd;
+    TEST_ASSERT_TRUE(parse("{\"notify\":\"doorbell\"}", cmd));
+    TEST_ASSERT_EQUAL(CONTROL_NOTIFY, cmd.fields);
+    TEST_ASSERT_EQUAL(OVERLAY_DOORBELL, cmd.notify);
+
+    TEST_ASSERT_TRUE(parse("{\"notify\":2}", cmd));
+    TEST_ASSERT_EQUAL(OVERLAY_TIMER, cmd.notify);
+
+    TEST_ASSERT_TRUE(parse("{\"notify\":\"clear\"}", cmd));
+    TEST_ASSERT_EQUAL(OVERLAY_NONE, cmd.notify);
+}
+
+void test_command_merge_latest_wins(void)
+{
+    ControlCommand pending, cmd;
+    TEST_ASSERT_TRUE(parse("{\"power\":true,\"brightness\":10}", cmd));
+    pending.merge(cmd);
+    TEST_ASSERT_TRUE(parse("{\"brightness\":80,\"hue\":200}", cmd));
+    pending.merge(cmd);
+
+    TEST_ASSERT_EQUAL(CONTROL_POWER | CONTROL_BRIGHTNESS | CONTROL_HUE, pending.fields);
+    TEST_ASSERT_TRUE(pending.power);
+    TEST_ASSERT_EQUAL(80, pending.brightness);
+    TEST_ASSERT_EQUAL(200, pending.hue);
+}
+
+// ============================================================================
+// STATE TESTS
+// ============================================================================
+
+void test_state_roundtrip(void)
+{
+    ControlState state = {true, 25, 100, 60};
+    char json[96];
+    size_t length = encodeControlState(state, json, sizeof(json));
+    TEST_ASSERT_EQUAL(strlen(json), length);
+    TEST_ASSERT_EQUAL_STRING("{\"power\":true,\"hue\":25,\"saturation\":100,\"brightness\":60}", json);
+
+    // A client may send the state straight back
+    ControlCommand cmd;
+    TEST_ASSERT_TRUE(parseControlCommand(json, length, cmd));
+    TEST_ASSERT_EQUAL(60, cmd.brightness);
+
+    // Too small a buffer is reported, not truncated silently
+    TEST_ASSERT_EQUAL(0, encodeControlState(state, json, 16));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests(void)
+{
+    UNITY_BEGIN();
+
+    // JSON reader tests
+    RUN_TEST(test_reader_members_point_into_buffer);
+    RUN_TEST(test_reader_skips_nested_values);
+    RUN_TEST(test_reader_rejects_malformed);
+    RUN_TEST(test_slice_to_int);
+
+    // Command tests
+    RUN_TEST(test_command_fields);
+    RUN_TEST(test_command_rejects_bad_values);
+    RUN_TEST(test_command_notify);
+    RUN_TEST(test_command_merge_latest_wins);
+
+    // State tests
+    RUN_TEST(test_state_roundtrip);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
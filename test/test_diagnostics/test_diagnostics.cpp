@@ -0,0 +1,169 @@
+/**
+ * @file test_diagnostics.cpp
+ * @brief HomeKit diagnostics value tests
+ *
+ * Tests for the frame rate meter and reset reason names behind the
+ * custom diagnostics service.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include <string.h>
+    #include "config.h"
+    #include "DiagnosticsStats.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include <string.h>
+    #include "config.h"
+    #include "DiagnosticsStats.h"
+#endif
+
+// ============================================================================
+// FRAME RATE TESTS
+// ============================================================================
+
+void test_frame_rate_first_sample_is_zero(void)
+{
+    FrameRateMeter meter;
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, meter.update(5000, 40000));
+}
+
+void test_frame_rate_steady(void)
+{
+    FrameRateMeter meter;
+    meter.update(0, 0);
+
+    // 125 output frames per second (OUTPUT_INTERVAL 8 ms) over 10 s
+    TEST_ASSERT_EQUAL_FLOAT(125.0f, meter.update(1250, 10000));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, meter.update(2250, 20000));
+}
+
+void test_frame_rate_rounds_to_tenths(void)
+{
+    FrameRateMeter meter;
+    meter.update(0, 0);
+
+    // 1249 frames in 10 s = 124.9 fps; 1 frame in 3 s = 0.33 -> 0.3
+    TEST_ASSERT_EQUAL_FLOAT(124.9f, meter.update(1249, 10000));
+    TEST_ASSERT_EQUAL_FLOAT(0.3f, meter.update(1250, 13000));
+}
+
+void test_frame_rate_counters_wrap(void)
+{
+    FrameRateMeter meter;
+    meter.update(0xFFFFFF00u, 0xFFFFF000u);
+
+    // 0x200 frames across both wraps in 0x2000 ms
+    TEST_ASSERT_EQUAL_FLOAT(62.5f, meter.update(0x100u, 0x1000u));
+}
+
+void test_frame_rate_no_elapsed_time(void)
+{
+    FrameRateMeter meter;
+    meter.update(0, 1000);
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, meter.update(10, 1000));
+}
+
+// ============================================================================
+// RESET REASON TESTS
+// ============================================================================
+
+void test_reset_reason_names(void)
+{
+    TEST_ASSERT_EQUAL_STRING("unknown", resetReasonName(0));
+    TEST_ASSERT_EQUAL_STRING("power-on", resetReasonName(1));
+    TEST_ASSERT_EQUAL_STRING("panic", resetReasonName(4));
+    TEST_ASSERT_EQUAL_STRING("task-wdt", resetReasonName(6));
+    TEST_ASSERT_EQUAL_STRING("brownout", resetReasonName(9));
+    TEST_ASSERT_EQUAL_STRING("sdio", resetReasonName(10));
+}
+
+void test_reset_reason_out_of_range(void)
+{
+    TEST_ASSERT_EQUAL_STRING("unknown", resetReasonName(-1));
+    TEST_ASSERT_EQUAL_STRING("unknown", resetReasonName(11));
+    TEST_ASSERT_EQUAL_STRING("unknown", resetReasonName(255));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests()
+{
+    UNITY_BEGIN();
+
+    // Frame rate tests
+    RUN_TEST(test_frame_rate_first_sample_is_zero);
+    RUN_TEST(test_frame_rate_steady);
+    RUN_TEST(test_frame_rate_rounds_to_tenths);
+    RUN_TEST(test_frame_rate_counters_wrap);
+    RUN_TEST(test_frame_rate_no_elapsed_time);
+
+    // Reset reason tests
+    RUN_TEST(test_reset_reason_names);
+    RUN_TEST(test_reset_reason_out_of_range);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
@@ -31,6 +31,8 @@
     // Native platform - provide Arduino compatibility
     #include <unity.h>
     #include "config.h"
+    #include "FlickerMath.h"
+    #include "FlickerTables.h"
     #include <math.h>
 
     // Mock Arduino functions for native platform
@@ -52,6 +54,8 @@
     #include <Arduino.h>
     #include <unity.h>
     #include "config.h"
+    #include "FlickerMath.h"
+    #include "FlickerTables.h"
 #endif
 
 // ============================================================================
@@ -232,6 +236,142 @@ void test_map_midpoint(void)
     TEST_ASSERT_INT_WITHIN(1, 127, result);
 }
 
+// ============================================================================
+// HOT PATH HELPER TESTS
+// ============================================================================
+
+void test_random_range_bounds(void)
+{
+    // Same contract as random(min, max): min inclusive, max exclusive
+    FlickerRandom rng;
+    rng.seed(12345);
+    for (int i = 0; i < 1000; i++)
+    {
+        int32_t v = rng.range(FLICKER_VARIATION_MIN, FLICKER_VARIATION_MAX);
+        TEST_ASSERT_GREATER_OR_EQUAL(FLICKER_VARIATION_MIN, v);
+        TEST_ASSERT_LESS_THAN(FLICKER_VARIATION_MAX, v);
+    }
+}
+
+void test_random_deterministic(void)
+{
+    // Equal seeds must give equal sequences
+    FlickerRandom a;
+    FlickerRandom b;
+    a.seed(42);
+    b.seed(42);
+    for (int i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_EQUAL(a.next(), b.next());
+    }
+}
+
+void test_random_zero_seed(void)
+{
+    // A zero seed would lock xorshift at zero forever
+    FlickerRandom rng;
+    rng.seed(0);
+    TEST_ASSERT_NOT_EQUAL(0, rng.next());
+}
+
+void test_scale_range_matches_map(void)
+{
+    // scaleRange() replaces map() on the hot path and must agree with it
+    for (int hue = 0; hue <= 360; hue++)
+    {
+        TEST_ASSERT_EQUAL(map(hue, 0, 360, 0, 255), scaleRange(hue, 0, 360, 0, 255));
+    }
+    for (int v = FLICKER_BRIGHTNESS_MIN; v <= FLICKER_BRIGHTNESS_MAX; v++)
+    {
+        TEST_ASSERT_EQUAL(map(v, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX, 0, 255),
+                          scaleRange(v, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX, 0, 255));
+    }
+}
+
+void test_clamp_helpers(void)
+{
+    TEST_ASSERT_EQUAL(30, clampInt(10, 30, 120));
+    TEST_ASSERT_EQUAL(120, clampInt(200, 30, 120));
+    TEST_ASSERT_EQUAL(50, clampInt(50, 30, 120));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 30.0, clampFloat(-5.0f, 30.0f, 120.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 120.0, clampFloat(500.0f, 30.0f, 120.0f));
+}
+
+void test_lerp8_endpoints(void)
+{
+    // t = 0 gives a, t = 256 gives b exactly
+    TEST_ASSERT_EQUAL(10, lerp8(10, 250, 0));
+    TEST_ASSERT_EQUAL(250, lerp8(10, 250, 256));
+    TEST_ASSERT_EQUAL(250, lerp8(250, 10, 0));
+    TEST_ASSERT_EQUAL(10, lerp8(250, 10, 256));
+}
+
+void test_lerp8_midpoint_and_bounds(void)
+{
+    TEST_ASSERT_EQUAL(127, lerp8(0, 255, 128));
+    TEST_ASSERT_EQUAL(127, lerp8(255, 0, 128));
+
+    // Never overshoots either endpoint in either direction
+    for (int t = 0; t <= 256; t++)
+    {
+        TEST_ASSERT_LESS_OR_EQUAL(200, lerp8(50, 200, t));
+        TEST_ASSERT_GREATER_OR_EQUAL(50, lerp8(50, 200, t));
+        TEST_ASSERT_LESS_OR_EQUAL(200, lerp8(200, 50, t));
+        TEST_ASSERT_GREATER_OR_EQUAL(50, lerp8(200, 50, t));
+    }
+}
+
+// ============================================================================
+// FRAME GATE TESTS
+// ============================================================================
+
+void test_frame_gate_single_owner(void)
+{
+    FrameGate gate;
+    TEST_ASSERT_TRUE(gate.tryAcquire());
+    TEST_ASSERT_FALSE(gate.tryAcquire());
+    gate.release();
+    gate.acquire();
+    TEST_ASSERT_FALSE(gate.tryAcquire());
+    gate.release();
+    TEST_ASSERT_TRUE(gate.tryAcquire());
+}
+
+// ============================================================================
+// LOOKUP TABLE TESTS
+// ============================================================================
+
+void test_hue_lut_matches_wrap_and_map(void)
+{
+    // Table must reproduce the original wrap-then-map() for every input
+    for (int baseHue = 0; baseHue <= 360; baseHue++)
+    {
+        for (int offset = FLICKER_HUE_MIN; offset < FLICKER_HUE_MAX; offset++)
+        {
+            int flickerHue = (((baseHue + offset) % 360) + 360) % 360;
+            long expected = map(flickerHue, 0, 360, 0, 255);
+            TEST_ASSERT_EQUAL(expected, FLICKER_HUE_LUT[baseHue + offset - FLICKER_HUE_MIN]);
+        }
+    }
+}
+
+void test_saturation_lut_matches_map(void)
+{
+    for (int sat = 0; sat <= 100; sat++)
+    {
+        TEST_ASSERT_EQUAL(map(sat, 0, 100, 0, 255), SATURATION_LUT[sat]);
+    }
+}
+
+void test_value_lut_matches_map(void)
+{
+    for (int v = FLICKER_BRIGHTNESS_MIN; v <= FLICKER_BRIGHTNESS_MAX; v++)
+    {
+        TEST_ASSERT_EQUAL(map(v, FLICKER_BRIGHTNESS_MIN, FLICKER_BRIGHTNESS_MAX, 0, 255),
+                          FLICKER_VALUE_LUT[v - FLICKER_BRIGHTNESS_MIN]);
+    }
+}
+
 // ============================================================================
 // TEST RUNNER
 // ============================================================================
@@ -271,6 +411,21 @@ void run_tests(void)
     RUN_TEST(test_map_max_to_max);
     RUN_TEST(test_map_midpoint);
 
+    // Hot path helper tests
+    RUN_TEST(test_random_range_bounds);
+    RUN_TEST(test_random_deterministic);
+    RUN_TEST(test_random_zero_seed);
+    RUN_TEST(test_scale_range_matches_map);
+    RUN_TEST(test_clamp_helpers);
+    RUN_TEST(test_lerp8_endpoints);
+    RUN_TEST(test_lerp8_midpoint_and_bounds);
+    RUN_TEST(test_frame_gate_single_owner);
+
+    // Lookup table tests
+    RUN_TEST(test_hue_lut_matches_wrap_and_map);
+    RUN_TEST(test_saturation_lut_matches_map);
+    RUN_TEST(test_value_lut_matches_map);
+
     UNITY_END();
 }
 
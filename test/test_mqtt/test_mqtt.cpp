@@ -0,0 +1,293 @@
+/**
+ * @file test_mqtt.cpp
+ * @brief MQTT codec and batching tests
+ *
+ * Tests for the MQTT 3.1.1 packet encoders, the stream reassembler and
+ * the publish batcher in MqttProtocol.h.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include "config.h"
+    #include "MqttProtocol.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include "config.h"
+    #include "MqttProtocol.h"
+#endif
+
+// ============================================================================
+// ENCODING TESTS
+// ============================================================================
+
+void test_connect_packet(void)
+{
+    MqttConnectOptions options = {"lamp", "", "", "l/status", "offline", 30};
+    uint8_t buf[64];
+    size_t length = mqttConnect(options, buf, sizeof(buf));
+
+    static const uint8_t expected[] = {
+        0x10, 35,                                     // CONNECT, remaining length
+        0, 4, 'M', 'Q', 'T', 'T', 4,                  // Protocol name and level
+        0x26,                                         // Clean session, will, will retain
+        0, 30,                                        // Keep-alive
+        0, 4, 'l', 'a', 'm', 'p',                     // Client id
+        0, 8, 'l', '/', 's', 't', 'a', 't', 'u', 's', // Will topic
+        0, 7, 'o', 'f', 'f', 'l', 'i', 'n', 'e'};     // Will message
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buf, sizeof(expected));
+
+    // Credentials set both flags
+    options.user = "u";
+    options.password = "p";
+    length = mqttConnect(options, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(sizeof(expected) + 6, length);
+    TEST_ASSERT_EQUAL_HEX8(0xE6, buf[9]);
+}
+
+void test_publish_packet(void)
+{
+    uint8_t buf[16];
+    size_t length = mqttPublish("a/b", "hi", 2, true, buf, sizeof(buf));
+    static const uint8_t expected[] = {0x31, 7, 0, 3, 'a', '/', 'b', 'h', 'i'};
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buf, sizeof(expected));
+
+    // Too small a buffer yields no packet rather than a truncated one
+    TEST_ASSERT_EQUAL(0, mqttPublish("a/b", "hello world", 11, false, buf, 10));
+}
+
+void test_remaining_length_varint(void)
+{
+    static uint8_t payload[200];
+    static uint8_t buf[256];
+    size_t length = mqttPublish("t", payload, sizeof(payload), false, buf, sizeof(buf));
+
+    // 3 + 200 = 203 = 0xCB -> 0xCB 0x01
+    TEST_ASSERT_EQUAL(1 + 2 + 203, length);
+    TEST_ASSERT_EQUAL_HEX8(0xCB, buf[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, buf[2]);
+}
+
+void test_subscribe_and_ping(void)
+{
+    uint8_t buf[32];
+    size_t length = mqttSubscribe(1, "l/set", buf, sizeof(buf));
+    static const uint8_t expected[] = {0x82, 10, 0, 1, 0, 5, 'l', '/', 's', 'e', 't', 0};
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buf, sizeof(expected));
+
+    TEST_ASSERT_EQUAL(2, mqttEmpty(MQTT_PINGREQ, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_HEX8(0xC0, buf[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, buf[1]);
+}
+
+// ============================================================================
+// DECODING TESTS
+// ============================================================================
+
+void test_reader_reassembles_fragments(void)
+{
+    static MqttReader reader;
+    reader.reset();
+    uint8_t stream[64];
+    size_t a = mqttPublish("l/set", "{\"hue\":5}", 9, false, stream, sizeof(stream));
+    static const uint8_t ping[] = {0xD0, 0x00};
+    memcpy(stream + a, ping, sizeof(ping));
+    size_t total = a + sizeof(ping);
+
+    // One byte at a time: no packet until the last byte of each arrives
+    MqttPacket packet;
+    int packets = 0;
+    for (size_t i = 0; i < total; i++)
+    {
+        reader.feed(stream + i, 1);
+        while (reader.next(packet))
+        {
+            packets++;
+            if (packets == 1)
+            {
+                TEST_ASSERT_EQUAL(a - 1, i);
+                const char *topic;
+                const uint8_t *payload;
+                size_t topicLength, payloadLength;
+                TEST_ASSERT_TRUE(mqttParsePublish(packet, topic, topicLength, payload, payloadLength));
+                TEST_ASSERT_EQUAL(5, topicLength);
+                TEST_ASSERT_EQUAL(0, memcmp(topic, "l/set", 5));
+                TEST_ASSERT_EQUAL(9, payloadLength);
+            }
+            else
+            {
+                TEST_ASSERT_EQUAL(MQTT_PINGRESP, packet.type);
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(2, packets);
+}
+
+void test_reader_skips_oversized(void)
+{
+    static MqttReader reader;
+    reader.reset();
+    static uint8_t payload[MQTT_MAX_PACKET];
+    static uint8_t big[MQTT_MAX_PACKET + 16];
+    size_t length = mqttPublish("t", payload, sizeof(payload), false, big, sizeof(big));
+    TEST_ASSERT_TRUE(length > MQTT_MAX_PACKET);
+
+    MqttPacket packet;
+    for (size_t i = 0; i < length; i += 100)
+    {
+        reader.feed(big + i, length - i < 100 ? length - i : 100);
+        TEST_ASSERT_FALSE(reader.next(packet));
+    }
+    TEST_ASSERT_EQUAL(1, reader.oversized);
+
+    // The stream stays in sync for the packet after it
+    static const uint8_t ping[] = {0xD0, 0x00};
+    reader.feed(ping, sizeof(ping));
+    TEST_ASSERT_TRUE(reader.next(packet));
+    TEST_ASSERT_EQUAL(MQTT_PINGRESP, packet.type);
+}
+
+void test_parse_publish_qos1(void)
+{
+    // Topic "t", packet id 7, payload "x"
+    static const uint8_t body[] = {0, 1, 't', 0, 7, 'x'};
+    MqttPacket packet = {MQTT_PUBLISH, 0x02, body, sizeof(body)};
+    const char *topic;
+    const uint8_t *payload;
+    size_t topicLength, payloadLength;
+    TEST_ASSERT_TRUE(mqttParsePublish(packet, topic, topicLength, payload, payloadLength));
+    TEST_ASSERT_EQUAL(1, payloadLength);
+    TEST_ASSERT_EQUAL('x', payload[0]);
+
+    // Topic length past the end
+    static const uint8_t bad[] = {0, 9, 't'};
+    MqttPacket truncated = {MQTT_PUBLISH, 0, bad, sizeof(bad)};
+    TEST_ASSERT_FALSE(mqttParsePublish(truncated, topic, topicLength, payload, payloadLength));
+}
+
+// ============================================================================
+// BATCHING TESTS
+// ============================================================================
+
+void test_batcher_coalesces_burst(void)
+{
+    PublishBatcher batch(250);
+    TEST_ASSERT_FALSE(batch.due(0));
+
+    for (uint32_t t = 1000; t < 1200; t += 10)
+    {
+        batch.mark(t);
+        TEST_ASSERT_FALSE(batch.due(t));
+    }
+    TEST_ASSERT_TRUE(batch.due(1250));
+    batch.sent();
+    TEST_ASSERT_FALSE(batch.due(1300));
+
+    TEST_ASSERT_EQUAL(20, batch.changes);
+    TEST_ASSERT_EQUAL(1, batch.publishes);
+
+    // Next change opens a fresh window, also across millis() wrap
+    batch.mark(0xFFFFFF00u);
+    TEST_ASSERT_FALSE(batch.due(0xFFFFFFF0u));
+    TEST_ASSERT_TRUE(batch.due(0x00000010u));
+}
+
+void test_metrics_json(void)
+{
+    LampMetrics m = {60, 150000, 120000, 3600, 850, 2100, 400, 9000, 12, 1};
+    char json[256];
+    size_t length = encodeMetrics(m, json, sizeof(json));
+    TEST_ASSERT_EQUAL(strlen(json), length);
+    TEST_ASSERT_EQUAL_STRING("{\"uptime\":60,\"heapFree\":150000,\"heapMin\":120000,\"frames\":3600,"
+                             "\"frameAvgUs\":850,\"frameWorstUs\":2100,\"latencyAvgUs\":400,\"latencyWorstUs\":9000,"
+                             "\"overruns\":12,\"quality\":1}",
+                             json);
+    TEST_ASSERT_EQUAL(0, encodeMetrics(m, json, 32));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests(void)
+{
+    UNITY_BEGIN();
+
+    // Encoding tests
+    RUN_TEST(test_connect_packet);
+    RUN_TEST(test_publish_packet);
+    RUN_TEST(test_remaining_length_varint);
+    RUN_TEST(test_subscribe_and_ping);
+
+    // Decoding tests
+    RUN_TEST(test_reader_reassembles_fragments);
+    RUN_TEST(test_reader_skips_oversized);
+    RUN_TEST(test_parse_publish_qos1);
+
+    // Batching tests
+    RUN_TEST(test_batcher_coalesces_burst);
+    RUN_TEST(test_metrics_json);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
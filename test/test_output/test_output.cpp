@@ -0,0 +1,718 @@
+/**
+ * @file test_output.cpp
+ * @brief LED output encoding tests
+ *
+ * Tests for the APA102 bit-parallel encoder used by the I2S output
+ * driver, the WS2812 RMT encoding, and the calibration and crossfade
+ * applied in the output stage.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include "config.h"
+    #include "Apa102Frame.h"
+    #include "Apa102Parallel.h"
+    #include "Calibration.h"
+    #include "Crossfade.h"
+    #include "OverlayStack.h"
+    #include "Ws2812Frame.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include "config.h"
+    #include "Apa102Frame.h"
+    #include "Apa102Parallel.h"
+    #include "Calibration.h"
+    #include "Crossfade.h"
+    #include "OverlayStack.h"
+    #include "Ws2812Frame.h"
+#endif
+
+/**
+ * Reference bit transpose: slot k, lane s = bit (7-k) of in[s]
+ */
+static void naiveTranspose(const uint8_t in[8], uint8_t out[8])
+{
+    for (int k = 0; k < 8; k++)
+    {
+        out[k] = 0;
+        for (int s = 0; s < 8; s++)
+        {
+            out[k] |= ((in[s] >> (7 - k)) & 1) << s;
+        }
+    }
+}
+
+/**
+ * Recover lane s's byte stream from a bit-parallel buffer
+ */
+template <typename Word>
+static uint8_t laneByte(const Word *slots, int byteIndex, int lane)
+{
+    uint8_t value = 0;
+    for (int k = 0; k < 8; k++)
+    {
+        value = (value << 1) | ((slots[byteIndex * 8 + k] >> lane) & 1);
+    }
+    return value;
+}
+
+// ============================================================================
+// TRANSPOSE TESTS
+// ============================================================================
+
+void test_transpose_matches_reference(void)
+{
+    uint32_t seed = 1;
+    for (int round = 0; round < 500; round++)
+    {
+        uint8_t in[8];
+        for (int s = 0; s < 8; s++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            in[s] = seed >> 16;
+        }
+
+        uint8_t fast[8];
+        uint8_t reference[8];
+        transposeLanes8(in, fast);
+        naiveTranspose(in, reference);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(reference, fast, 8);
+    }
+}
+
+void test_transpose_single_lane(void)
+{
+    // Only lane 3 set to 0x80: first slot has bit 3, all others zero
+    uint8_t in[8] = {0, 0, 0, 0x80, 0, 0, 0, 0};
+    uint8_t out[8];
+    transposeLanes8(in, out);
+
+    TEST_ASSERT_EQUAL(0x08, out[0]);
+    for (int k = 1; k < 8; k++)
+    {
+        TEST_ASSERT_EQUAL(0, out[k]);
+    }
+}
+
+// ============================================================================
+// FRAME ENCODER TESTS
+// ============================================================================
+
+void test_frame_size(void)
+{
+    // 4 start + 4 per LED + at least 4 end bytes
+    TEST_ASSERT_EQUAL(4 + 32 + 4, apa102FrameBytes(8));
+    TEST_ASSERT_EQUAL(4 + 400 + 7, apa102FrameBytes(100));
+}
+
+void test_encode_roundtrip_8_lanes(void)
+{
+    const int numLeds = LED_LENGTH;
+    uint8_t pixels[3][LED_LENGTH * 3];
+    for (int s = 0; s < 3; s++)
+    {
+        for (int i = 0; i < numLeds * 3; i++)
+        {
+            pixels[s][i] = (uint8_t)(s * 50 + i * 7);
+        }
+    }
+    const uint8_t *strips[3] = {pixels[0], pixels[1], pixels[2]};
+
+    uint8_t out[apa102FrameBytes(LED_LENGTH) * 8];
+    apa102EncodeParallel<uint8_t>(strips, 3, numLeds, out);
+
+    for (int s = 0; s < 3; s++)
+    {
+        // Start frame
+        for (int j = 0; j < 4; j++)
+        {
+            TEST_ASSERT_EQUAL(0x00, laneByte(out, j, s));
+        }
+        // LEDs in header, B, G, R order
+        for (int led = 0; led < numLeds; led++)
+        {
+            int base = 4 + led * 4;
+            TEST_ASSERT_EQUAL(0xFF, laneByte(out, base, s));
+            TEST_ASSERT_EQUAL(pixels[s][led * 3 + 2], laneByte(out, base + 1, s));
+            TEST_ASSERT_EQUAL(pixels[s][led * 3 + 1], laneByte(out, base + 2, s));
+            TEST_ASSERT_EQUAL(pixels[s][led * 3 + 0], laneByte(out, base + 3, s));
+        }
+    }
+
+    // Unused lanes stay low throughout
+    for (int j = 0; j < apa102FrameBytes(numLeds); j++)
+    {
+        TEST_ASSERT_EQUAL(0x00, laneByte(out, j, 5));
+    }
+}
+
+void test_encode_16_lanes(void)
+{
+    const int numStrips = 12;
+    uint8_t pixels[numStrips][3];
+    const uint8_t *strips[numStrips];
+    for (int s = 0; s < numStrips; s++)
+    {
+        pixels[s][0] = (uint8_t)(0x10 + s);
+        pixels[s][1] = (uint8_t)(0x80 | s);
+        pixels[s][2] = (uint8_t)(0xF0 - s);
+        strips[s] = pixels[s];
+    }
+
+    uint16_t out[apa102FrameBytes(1) * 8];
+    apa102EncodeParallel<uint16_t>(strips, numStrips, 1, out);
+
+    for (int s = 0; s < numStrips; s++)
+    {
+        TEST_ASSERT_EQUAL(0xFF, laneByte(out, 4, s));
+        TEST_ASSERT_EQUAL(pixels[s][2], laneByte(out, 5, s));
+        TEST_ASSERT_EQUAL(pixels[s][1], laneByte(out, 6, s));
+        TEST_ASSERT_EQUAL(pixels[s][0], laneByte(out, 7, s));
+    }
+    TEST_ASSERT_EQUAL(0x00, laneByte(out, 4, 13));
+}
+
+// ============================================================================
+// WIRE FRAME TESTS
+// ============================================================================
+
+void test_wire_frame_layout(void)
+{
+    Apa102Frame<LED_LENGTH> frame;
+    frame.begin(31);
+
+    TEST_ASSERT_EQUAL(apa102FrameBytes(LED_LENGTH), (int)sizeof(frame.bytes));
+    for (int j = 0; j < 4; j++)
+    {
+        TEST_ASSERT_EQUAL(0x00, frame.bytes[j]);
+    }
+    for (int led = 0; led < LED_LENGTH; led++)
+    {
+        TEST_ASSERT_EQUAL(0xFF, frame.bytes[4 + led * 4]);
+        TEST_ASSERT_EQUAL(0x00, frame.bytes[4 + led * 4 + 1]);
+    }
+    for (int j = 4 + LED_LENGTH * 4; j < (int)sizeof(frame.bytes); j++)
+    {
+        TEST_ASSERT_EQUAL(0x00, frame.bytes[j]);
+    }
+}
+
+void test_wire_frame_global_brightness(void)
+{
+    Apa102Frame<2> frame;
+    frame.begin(8);
+    TEST_ASSERT_EQUAL(0xE8, frame.bytes[4]);
+    TEST_ASSERT_EQUAL(0xE8, frame.bytes[8]);
+
+    // Only 5 bits fit; the 0xE0 marker is always set
+    TEST_ASSERT_EQUAL(0xFF, apa102Header(0xFF));
+    TEST_ASSERT_EQUAL(0xE0, apa102Header(0));
+}
+
+void test_wire_frame_set_is_bgr(void)
+{
+    Apa102Frame<LED_LENGTH> frame;
+    frame.begin(31);
+    frame.set(3, 0x11, 0x22, 0x33);
+
+    const uint8_t *led = frame.bytes + 4 + 3 * 4;
+    TEST_ASSERT_EQUAL(0xFF, led[0]);
+    TEST_ASSERT_EQUAL(0x33, led[1]);
+    TEST_ASSERT_EQUAL(0x22, led[2]);
+    TEST_ASSERT_EQUAL(0x11, led[3]);
+    TEST_ASSERT_EQUAL(0x00, led[5]); // Neighbours untouched
+    TEST_ASSERT_EQUAL(0x00, led[-1]);
+}
+
+void test_wire_frame_matches_parallel_lane(void)
+{
+    // Same bytes as lane 0 of the bit-parallel encoder
+    uint8_t pixels[LED_LENGTH * 3];
+    for (int i = 0; i < LED_LENGTH * 3; i++)
+    {
+        pixels[i] = (uint8_t)(i * 29 + 3);
+    }
+    const uint8_t *strips[1] = {pixels};
+    uint8_t parallel[apa102FrameBytes(LED_LENGTH) * 8];
+    apa102EncodeParallel<uint8_t>(strips, 1, LED_LENGTH, parallel);
+
+    Apa102Frame<LED_LENGTH> frame;
+    frame.begin(31);
+    frame.pack(pixels);
+
+    for (int j = 0; j < apa102FrameBytes(LED_LENGTH); j++)
+    {
+        TEST_ASSERT_EQUAL(laneByte(parallel, j, 0), frame.bytes[j]);
+    }
+}
+
+void test_wire_frame_unpack_roundtrip(void)
+{
+    uint8_t pixels[LED_LENGTH * 3];
+    uint8_t back[LED_LENGTH * 3];
+    for (int i = 0; i < LED_LENGTH * 3; i++)
+    {
+        pixels[i] = (uint8_t)(255 - i * 5);
+    }
+
+    Apa102Frame<LED_LENGTH> frame;
+    frame.begin(31);
+    frame.pack(pixels);
+    frame.unpack(back);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixels, back, LED_LENGTH * 3);
+}
+
+// ============================================================================
+// WS2812 FRAME TESTS
+// ============================================================================
+
+void test_ws2812_symbol_timing(void)
+{
+    // duration0/level0 high pulse, then duration1/level1 low
+    TEST_ASSERT_EQUAL_HEX32(16u | 1u << 15 | 34u << 16, WS2812_SYMBOL_0);
+    TEST_ASSERT_EQUAL_HEX32(32u | 1u << 15 | 18u << 16, WS2812_SYMBOL_1);
+    TEST_ASSERT_EQUAL(WS2812_BYTES_PER_LED * LED_LENGTH, Ws2812Frame<LED_LENGTH>::BYTES);
+}
+
+void test_ws2812_set_is_grb(void)
+{
+    const uint8_t black[LED_LENGTH * 3] = {};
+    Ws2812Frame<LED_LENGTH> frame;
+    frame.pack(black);
+    frame.set(2, 0x01, 0x80, 0x03);
+
+    const uint8_t *led = frame.bytes + 2 * WS2812_BYTES_PER_LED;
+    TEST_ASSERT_EQUAL_HEX8(0x80, led[0]); // G
+    TEST_ASSERT_EQUAL_HEX8(0x01, led[1]); // R
+    TEST_ASSERT_EQUAL_HEX8(0x03, led[2]); // B
+    TEST_ASSERT_EQUAL_HEX8(0x00, led[-1]); // Neighbours untouched
+    TEST_ASSERT_EQUAL_HEX8(0x00, led[3]);
+}
+
+void test_ws2812_unpack_roundtrip(void)
+{
+    uint8_t pixels[LED_LENGTH * 3];
+    uint8_t back[LED_LENGTH * 3];
+    for (int i = 0; i < LED_LENGTH * 3; i++)
+    {
+        pixels[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    Ws2812Frame<LED_LENGTH> frame;
+    frame.pack(pixels);
+    frame.unpack(back);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixels, back, LED_LENGTH * 3);
+}
+
+// ============================================================================
+// CALIBRATION TESTS
+// ============================================================================
+
+void test_scale_byte_unity(void)
+{
+    // 255 leaves every value unchanged, 0 blacks it out
+    for (int v = 0; v <= 255; v++)
+    {
+        TEST_ASSERT_EQUAL(v, scaleByte(v, 255));
+        TEST_ASSERT_EQUAL(0, scaleByte(v, 0));
+    }
+    TEST_ASSERT_INT_WITHIN(1, 100, scaleByte(200, 128));
+}
+
+void test_calibration_default_is_unity(void)
+{
+    CalibrationTable cal;
+    for (int strip = 0; strip < NUM_STRIPS; strip++)
+    {
+        for (int i = 0; i < LED_LENGTH; i++)
+        {
+            TEST_ASSERT_EQUAL(255, cal.factor[strip][i][0]);
+            TEST_ASSERT_EQUAL(255, cal.factor[strip][i][1]);
+            TEST_ASSERT_EQUAL(255, cal.factor[strip][i][2]);
+        }
+    }
+}
+
+void test_calibration_fuses_gain_and_trims(void)
+{
+    CalibrationTable cal;
+    cal.setGain(1, 255, 200, 128);
+    cal.setIntensity(1, 128);
+    cal.setLed(1, 3, 128);
+
+    // Strip 0 untouched
+    TEST_ASSERT_EQUAL(255, cal.factor[0][3][1]);
+
+    // Strip 1 gain scaled by intensity
+    TEST_ASSERT_INT_WITHIN(1, 128, cal.factor[1][0][0]);
+    TEST_ASSERT_INT_WITHIN(1, 100, cal.factor[1][0][1]);
+
+    // LED 3 additionally trimmed by half
+    TEST_ASSERT_INT_WITHIN(1, 64, cal.factor[1][3][0]);
+    TEST_ASSERT_INT_WITHIN(1, 32, cal.factor[1][3][2]);
+}
+
+void test_calibration_rejects_bad_indices(void)
+{
+    CalibrationTable cal;
+    TEST_ASSERT_FALSE(cal.setGain(NUM_STRIPS, 1, 2, 3));
+    TEST_ASSERT_FALSE(cal.setIntensity(-1, 10));
+    TEST_ASSERT_FALSE(cal.setLed(0, LED_LENGTH, 10));
+    TEST_ASSERT_EQUAL(255, cal.factor[0][0][0]);
+}
+
+// ============================================================================
+// NOTIFICATION OVERLAY TESTS
+// ============================================================================
+
+void test_overlay_idle_has_no_layers(void)
+{
+    OverlayStack overlays;
+    overlays.prepare(1000);
+    TEST_ASSERT_EQUAL(0, overlays.numLayers);
+
+    // Unknown ids are ignored
+    TEST_ASSERT_FALSE(overlays.trigger(OVERLAY_NONE, 0));
+    TEST_ASSERT_FALSE(overlays.trigger(OVERLAY_PRESET_COUNT, 0));
+}
+
+void test_overlay_expires(void)
+{
+    OverlayStack overlays;
+    TEST_ASSERT_TRUE(overlays.trigger(OVERLAY_TIMER, 1000));
+    overlays.prepare(1000 + OVERLAY_PRESETS[OVERLAY_TIMER].durationMs - 1);
+    TEST_ASSERT_EQUAL(1, overlays.numLayers);
+    overlays.prepare(1000 + OVERLAY_PRESETS[OVERLAY_TIMER].durationMs);
+    TEST_ASSERT_EQUAL(0, overlays.numLayers);
+    TEST_ASSERT_FALSE(overlays.isActive(OVERLAY_TIMER));
+}
+
+void test_overlay_priority_order(void)
+{
+    OverlayStack overlays;
+    overlays.trigger(OVERLAY_DOORBELL, 0);
+    overlays.trigger(OVERLAY_WIFI_AP, 0);
+    overlays.prepare(250);
+
+    // WiFi AP indicator (lower priority) is drawn first, doorbell on top
+    TEST_ASSERT_EQUAL(2, overlays.numLayers);
+    TEST_ASSERT_EQUAL(OVERLAY_PRESETS[OVERLAY_WIFI_AP].g, overlays.layers[0].g);
+    TEST_ASSERT_EQUAL(OVERLAY_PRESETS[OVERLAY_DOORBELL].b, overlays.layers[1].b);
+
+    // Retriggering reuses the slot
+    overlays.trigger(OVERLAY_DOORBELL, 300);
+    overlays.prepare(300);
+    TEST_ASSERT_EQUAL(2, overlays.numLayers);
+}
+
+void test_overlay_patterns(void)
+{
+    const OverlayPreset &blink = OVERLAY_PRESETS[OVERLAY_TIMER];
+    TEST_ASSERT_EQUAL(255, OverlayStack::patternLevel(blink, 0));
+    TEST_ASSERT_EQUAL(0, OverlayStack::patternLevel(blink, blink.periodMs / 2));
+
+    const OverlayPreset &pulse = OVERLAY_PRESETS[OVERLAY_DOORBELL];
+    TEST_ASSERT_EQUAL(0, OverlayStack::patternLevel(pulse, 0));
+    TEST_ASSERT_EQUAL(255, OverlayStack::patternLevel(pulse, pulse.periodMs / 2));
+    TEST_ASSERT_INT_WITHIN(1, 127, OverlayStack::patternLevel(pulse, pulse.periodMs / 4));
+}
+
+void test_overlay_status_persists(void)
+{
+    // Status overlays stay until HomeSpan reports a new state
+    OverlayStack overlays;
+    overlays.trigger(OVERLAY_PAIRING, 0);
+    overlays.prepare(3600000UL);
+    TEST_ASSERT_EQUAL(1, overlays.numLayers);
+    overlays.clear(OVERLAY_PAIRING);
+    overlays.prepare(3600001UL);
+    TEST_ASSERT_EQUAL(0, overlays.numLayers);
+
+    // Shimmer never drops to dark
+    const OverlayPreset &shimmer = OVERLAY_PRESETS[OVERLAY_CONNECTING];
+    for (uint32_t ms = 0; ms < 5000; ms += 7)
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL(96, OverlayStack::patternLevel(shimmer, ms));
+    }
+}
+
+void test_overlay_composite(void)
+{
+    // Fully opaque layer replaces the pixel, none leaves it untouched
+    OverlayLayer opaque = {10, 20, 30, 256};
+    uint8_t r = 200, g = 100, b = 50;
+    compositeLayers(r, g, b, &opaque, 0);
+    TEST_ASSERT_EQUAL(200, r);
+    compositeLayers(r, g, b, &opaque, 1);
+    TEST_ASSERT_EQUAL(10, r);
+    TEST_ASSERT_EQUAL(20, g);
+    TEST_ASSERT_EQUAL(30, b);
+}
+
+// ============================================================================
+// CROSSFADE TESTS
+// ============================================================================
+
+/**
+ * Effect that records how it was called, filling LED i with now + i
+ */
+class ProbeEffect : public Effect
+{
+public:
+    int renders;
+
+    ProbeEffect() : renders(0) {}
+
+    void render(EffectPixel *out, uint32_t now) override
+    {
+        renders++;
+        for (int i = 0; i < LED_LENGTH; i++)
+        {
+            out[i].r = out[i].g = out[i].b = (uint8_t)(now + i);
+        }
+    }
+};
+
+void test_crossfade_idle(void)
+{
+    Crossfade fade;
+
+    TEST_ASSERT_EQUAL(0, fade.prepare(1000));
+    TEST_ASSERT_NULL(fade.effect());
+    TEST_ASSERT_FALSE(fade.ramping(1000));
+}
+
+void test_crossfade_to_other_holds(void)
+{
+    Crossfade fade;
+    SolidEffect black;
+    fade.begin(black, true, 1000, 400);
+
+    TEST_ASSERT_EQUAL(0, fade.prepare(1000));
+    TEST_ASSERT_EQUAL(128, fade.prepare(1200));
+    TEST_ASSERT_TRUE(fade.fadingOut(1200));
+    TEST_ASSERT_EQUAL(256, fade.prepare(1400));
+
+    // Complete: the other look stays until released
+    TEST_ASSERT_EQUAL(256, fade.prepare(5000));
+    TEST_ASSERT_FALSE(fade.ramping(5000));
+    TEST_ASSERT_FALSE(fade.fadingOut(5000));
+    TEST_ASSERT_TRUE(fade.effect() == &black);
+    fade.release();
+    TEST_ASSERT_EQUAL(0, fade.prepare(5008));
+}
+
+void test_crossfade_from_other_releases(void)
+{
+    Crossfade fade;
+    SolidEffect black;
+    fade.begin(black, false, 1000, 400);
+
+    TEST_ASSERT_EQUAL(256, fade.prepare(1000));
+    TEST_ASSERT_EQUAL(128, fade.prepare(1200));
+    TEST_ASSERT_FALSE(fade.fadingOut(1200));
+    TEST_ASSERT_EQUAL(0, fade.prepare(1400));
+    TEST_ASSERT_NULL(fade.effect());
+}
+
+void test_crossfade_reverse_is_continuous(void)
+{
+    Crossfade fade;
+    SolidEffect black;
+
+    // Off, then on again a quarter of the way in
+    fade.begin(black, true, 1000, 400);
+    TEST_ASSERT_EQUAL(64, fade.weight(1100));
+    fade.begin(black, false, 1100, 400);
+    TEST_ASSERT_EQUAL(64, fade.weight(1100));
+    TEST_ASSERT_EQUAL(32, fade.weight(1150));
+    TEST_ASSERT_EQUAL(0, fade.weight(1200));
+
+    // A different effect starts from its own end
+    FrameEffect tail;
+    fade.begin(black, true, 2000, 400);
+    fade.begin(tail, false, 2100, 400);
+    TEST_ASSERT_EQUAL(256, fade.weight(2100));
+}
+
+void test_crossfade_zero_duration_cuts(void)
+{
+    Crossfade fade;
+    SolidEffect black;
+
+    fade.begin(black, true, 1000, 0);
+    TEST_ASSERT_EQUAL(256, fade.prepare(1000));
+    fade.begin(black, false, 1000, 0);
+    TEST_ASSERT_EQUAL(0, fade.prepare(1000));
+    TEST_ASSERT_NULL(fade.effect());
+}
+
+void test_crossfade_renders_other_live(void)
+{
+    Crossfade fade;
+    ProbeEffect probe;
+    fade.begin(probe, false, 1000, 400);
+
+    // Re-rendered every frame it's on screen, into the scratch buffer
+    fade.prepare(1000);
+    fade.prepare(1008);
+    TEST_ASSERT_EQUAL(2, probe.renders);
+    TEST_ASSERT_EQUAL((uint8_t)1008, fade.scratch[0].r);
+    TEST_ASSERT_EQUAL((uint8_t)(1008 + LED_LENGTH - 1), fade.scratch[LED_LENGTH - 1].b);
+
+    // Not once it's faded out
+    fade.prepare(1400);
+    fade.prepare(1408);
+    TEST_ASSERT_EQUAL(2, probe.renders);
+}
+
+void test_crossfade_pixel(void)
+{
+    EffectPixel other = {10, 20, 30};
+    uint8_t r = 200, g = 100, b = 50;
+
+    crossfadePixel(r, g, b, other, 0);
+    TEST_ASSERT_EQUAL(200, r);
+    crossfadePixel(r, g, b, other, 128);
+    TEST_ASSERT_EQUAL(105, r);
+    TEST_ASSERT_EQUAL(60, g);
+    TEST_ASSERT_EQUAL(40, b);
+    crossfadePixel(r, g, b, other, 256);
+    TEST_ASSERT_EQUAL(10, r);
+    TEST_ASSERT_EQUAL(20, g);
+    TEST_ASSERT_EQUAL(30, b);
+}
+
+void test_frame_effect_capture(void)
+{
+    uint8_t rgb[LED_LENGTH][3];
+    for (int i = 0; i < LED_LENGTH; i++)
+    {
+        rgb[i][0] = (uint8_t)i;
+        rgb[i][1] = (uint8_t)(i * 2);
+        rgb[i][2] = (uint8_t)(i * 3);
+    }
+    FrameEffect tail;
+    tail.capture(rgb);
+
+    EffectPixel out[LED_LENGTH];
+    tail.render(out, 0);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY((const uint8_t *)rgb, (const uint8_t *)out, sizeof(out));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests(void)
+{
+    UNITY_BEGIN();
+
+    // Transpose tests
+    RUN_TEST(test_transpose_matches_reference);
+    RUN_TEST(test_transpose_single_lane);
+
+    // Frame encoder tests
+    RUN_TEST(test_frame_size);
+    RUN_TEST(test_encode_roundtrip_8_lanes);
+    RUN_TEST(test_encode_16_lanes);
+
+    // Wire frame tests
+    RUN_TEST(test_wire_frame_layout);
+    RUN_TEST(test_wire_frame_global_brightness);
+    RUN_TEST(test_wire_frame_set_is_bgr);
+    RUN_TEST(test_wire_frame_matches_parallel_lane);
+    RUN_TEST(test_wire_frame_unpack_roundtrip);
+
+    // WS2812 frame tests
+    RUN_TEST(test_ws2812_symbol_timing);
+    RUN_TEST(test_ws2812_set_is_grb);
+    RUN_TEST(test_ws2812_unpack_roundtrip);
+
+    // Calibration tests
+    RUN_TEST(test_scale_byte_unity);
+    RUN_TEST(test_calibration_default_is_unity);
+    RUN_TEST(test_calibration_fuses_gain_and_trims);
+    RUN_TEST(test_calibration_rejects_bad_indices);
+
+    // Notification overlay tests
+    RUN_TEST(test_overlay_idle_has_no_layers);
+    RUN_TEST(test_overlay_expires);
+    RUN_TEST(test_overlay_priority_order);
+    RUN_TEST(test_overlay_patterns);
+    RUN_TEST(test_overlay_status_persists);
+    RUN_TEST(test_overlay_composite);
+
+    // Crossfade tests
+    RUN_TEST(test_crossfade_idle);
+    RUN_TEST(test_crossfade_to_other_holds);
+    RUN_TEST(test_crossfade_from_other_releases);
+    RUN_TEST(test_crossfade_reverse_is_continuous);
+    RUN_TEST(test_crossfade_zero_duration_cuts);
+    RUN_TEST(test_crossfade_renders_other_live);
+    RUN_TEST(test_crossfade_pixel);
+    RUN_TEST(test_frame_effect_capture);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
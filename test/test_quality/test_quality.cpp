@@ -0,0 +1,306 @@
+/**
+ * @file test_quality.cpp
+ * @brief Render deadline and quality level tests
+ *
+ * Tests for the deadline monitor that steps the flicker down to cheaper
+ * rendering under sustained overruns, and for the sparse flicker step
+ * the reduced levels use.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include <string.h>
+    #include "config.h"
+    #include "FlickerEngine.h"
+    #include "RenderQuality.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include <string.h>
+    #include "config.h"
+    #include "FlickerEngine.h"
+    #include "RenderQuality.h"
+#endif
+
+// Frame times well inside, just past and within the upper half of the deadline
+static const uint32_t FAST_US = RENDER_DEADLINE_US / 4;
+static const uint32_t SLOW_US = RENDER_DEADLINE_US + 1;
+static const uint32_t BUSY_US = RENDER_DEADLINE_US * 3 / 4;
+
+/**
+ * Record overruns until the level changes, returning how many it took
+ */
+static int overrunUntilChange(RenderQuality &quality)
+{
+    for (int n = 1; n <= QUALITY_WINDOW; n++)
+    {
+        if (quality.record(SLOW_US, false))
+        {
+            return n;
+        }
+    }
+    return -1;
+}
+
+// ============================================================================
+// DEADLINE TESTS
+// ============================================================================
+
+void test_quality_starts_full(void)
+{
+    RenderQuality quality;
+
+    TEST_ASSERT_EQUAL(QUALITY_FULL, quality.level);
+    TEST_ASSERT_FALSE(quality.record(FAST_US, false));
+    TEST_ASSERT_EQUAL(0, quality.overruns);
+}
+
+void test_quality_counts_overruns(void)
+{
+    RenderQuality quality;
+
+    quality.record(SLOW_US, false);
+    quality.record(RENDER_DEADLINE_US, false); // On the deadline is in time
+    quality.record(FAST_US, true);             // Late start counts too
+
+    TEST_ASSERT_EQUAL(2, quality.overruns);
+}
+
+void test_quality_isolated_overruns_keep_level(void)
+{
+    RenderQuality quality;
+
+    // Fewer than QUALITY_DEGRADE_OVERRUNS per window, for many windows
+    for (int w = 0; w < 20; w++)
+    {
+        for (int n = 0; n < QUALITY_WINDOW; n++)
+        {
+            TEST_ASSERT_FALSE(quality.record(n < QUALITY_DEGRADE_OVERRUNS - 1 ? SLOW_US : FAST_US, false));
+        }
+    }
+
+    TEST_ASSERT_EQUAL(QUALITY_FULL, quality.level);
+    TEST_ASSERT_EQUAL(20 * (QUALITY_DEGRADE_OVERRUNS - 1), quality.overruns);
+}
+
+void test_quality_sustained_overruns_degrade(void)
+{
+    RenderQuality quality;
+
+    TEST_ASSERT_EQUAL(QUALITY_DEGRADE_OVERRUNS, overrunUntilChange(quality));
+    TEST_ASSERT_EQUAL(QUALITY_REDUCED, quality.level);
+    TEST_ASSERT_EQUAL(1, quality.degrades);
+}
+
+void test_quality_degrades_one_level_at_a_time(void)
+{
+    RenderQuality quality;
+
+    overrunUntilChange(quality);
+    TEST_ASSERT_EQUAL(QUALITY_DEGRADE_OVERRUNS, overrunUntilChange(quality));
+    TEST_ASSERT_EQUAL(QUALITY_HOLD, quality.level);
+
+    // Already at the bottom
+    TEST_ASSERT_EQUAL(-1, overrunUntilChange(quality));
+    TEST_ASSERT_EQUAL(QUALITY_HOLD, quality.level);
+    TEST_ASSERT_EQUAL(2, quality.degrades);
+}
+
+void test_quality_recovers_with_headroom(void)
+{
+    RenderQuality quality;
+    overrunUntilChange(quality);
+    overrunUntilChange(quality);
+
+    for (int n = 1; n < QUALITY_RECOVER_FRAMES; n++)
+    {
+        TEST_ASSERT_FALSE(quality.record(FAST_US, false));
+    }
+    TEST_ASSERT_TRUE(quality.record(FAST_US, false));
+    TEST_ASSERT_EQUAL(QUALITY_REDUCED, quality.level);
+
+    // The next level needs its own run of headroom
+    for (int n = 1; n < QUALITY_RECOVER_FRAMES; n++)
+    {
+        TEST_ASSERT_FALSE(quality.record(FAST_US, false));
+    }
+    TEST_ASSERT_TRUE(quality.record(FAST_US, false));
+    TEST_ASSERT_EQUAL(QUALITY_FULL, quality.level);
+    TEST_ASSERT_EQUAL(2, quality.recoveries);
+}
+
+void test_quality_recovery_needs_consecutive_headroom(void)
+{
+    RenderQuality quality;
+    overrunUntilChange(quality);
+
+    // Frames in time but without headroom restart the count
+    for (int n = 0; n < 3 * QUALITY_RECOVER_FRAMES; n++)
+    {
+        quality.record(n % 100 == 99 ? BUSY_US : FAST_US, false);
+    }
+    TEST_ASSERT_EQUAL(QUALITY_REDUCED, quality.level);
+
+    // A single overrun does too
+    quality.record(BUSY_US, false);
+    for (int n = 1; n < QUALITY_RECOVER_FRAMES; n++)
+    {
+        quality.record(FAST_US, false);
+    }
+    quality.record(SLOW_US, false);
+    for (int n = 1; n < QUALITY_RECOVER_FRAMES; n++)
+    {
+        TEST_ASSERT_FALSE(quality.record(FAST_US, false));
+    }
+    TEST_ASSERT_TRUE(quality.record(FAST_US, false));
+    TEST_ASSERT_EQUAL(QUALITY_FULL, quality.level);
+}
+
+void test_quality_level_names(void)
+{
+    TEST_ASSERT_EQUAL_STRING("full", RenderQuality::levelName(QUALITY_FULL));
+    TEST_ASSERT_EQUAL_STRING("reduced", RenderQuality::levelName(QUALITY_REDUCED));
+    TEST_ASSERT_EQUAL_STRING("hold", RenderQuality::levelName(QUALITY_HOLD));
+    TEST_ASSERT_EQUAL_STRING("?", RenderQuality::levelName(QUALITY_LEVEL_COUNT));
+}
+
+// ============================================================================
+// SPARSE FLICKER TESTS
+// ============================================================================
+
+void test_sparse_step_advances_alternate_leds(void)
+{
+    FlickerEngine engine;
+    float before[LED_LENGTH];
+    memcpy(before, engine.previousBrightness, sizeof(before));
+
+    engine.rng.seed(1234);
+    engine.render(LED_LENGTH, 0.0f, DEFAULT_HUE, DEFAULT_SATURATION, true, 1, 0);
+
+    for (int i = 0; i < LED_LENGTH; i++)
+    {
+        if (i % 2 == 0)
+        {
+            TEST_ASSERT_NOT_EQUAL(before[i], engine.previousBrightness[i]);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_FLOAT(before[i], engine.previousBrightness[i]);
+        }
+    }
+}
+
+void test_sparse_steps_alternate_by_phase(void)
+{
+    FlickerEngine engine;
+    float before[LED_LENGTH];
+    memcpy(before, engine.previousBrightness, sizeof(before));
+
+    // Two steps with consecutive phases reach every LED
+    engine.rng.seed(1234);
+    engine.render(LED_LENGTH, 0.0f, DEFAULT_HUE, DEFAULT_SATURATION, true, 1, 0);
+    engine.rng.seed(5678);
+    engine.render(LED_LENGTH, 0.0f, DEFAULT_HUE, DEFAULT_SATURATION, true, 1, 1);
+
+    for (int i = 0; i < LED_LENGTH; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(before[i], engine.previousBrightness[i]);
+    }
+}
+
+void test_full_step_matches_default(void)
+{
+    FlickerEngine a;
+    FlickerEngine b;
+
+    a.rng.seed(42);
+    a.render(LED_LENGTH, 0.0f, DEFAULT_HUE, DEFAULT_SATURATION, true);
+    b.rng.seed(42);
+    b.render(LED_LENGTH, 0.0f, DEFAULT_HUE, DEFAULT_SATURATION, true, 0, 7);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY((const uint8_t *)a.flame, (const uint8_t *)b.flame, sizeof(a.flame));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests()
+{
+    UNITY_BEGIN();
+
+    // Deadline tests
+    RUN_TEST(test_quality_starts_full);
+    RUN_TEST(test_quality_counts_overruns);
+    RUN_TEST(test_quality_isolated_overruns_keep_level);
+    RUN_TEST(test_quality_sustained_overruns_degrade);
+    RUN_TEST(test_quality_degrades_one_level_at_a_time);
+    RUN_TEST(test_quality_recovers_with_headroom);
+    RUN_TEST(test_quality_recovery_needs_consecutive_headroom);
+    RUN_TEST(test_quality_level_names);
+
+    // Sparse flicker tests
+    RUN_TEST(test_sparse_step_advances_alternate_leds);
+    RUN_TEST(test_sparse_steps_alternate_by_phase);
+    RUN_TEST(test_full_step_matches_default);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
@@ -0,0 +1,311 @@
+/**
+ * @file test_realtime.cpp
+ * @brief DDP and E1.31 packet parser tests
+ *
+ * Tests for the real-time pixel input parsers and sequence tracking
+ * in RealtimeProtocol.h, on hand-built packets.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include "config.h"
+    #include "RealtimeProtocol.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include "config.h"
+    #include "RealtimeProtocol.h"
+#endif
+
+#define TEST_PIXEL_BYTES 12
+
+static uint8_t pixels[TEST_PIXEL_BYTES];
+static uint8_t packet[E131_HEADER_LEN + E131_MAX_CHANNELS];
+
+/**
+ * Build a DDP RGB packet carrying bytes start, start+1, ...
+ */
+static size_t buildDdp(uint8_t flags, uint8_t seq, uint32_t offset, uint16_t length, uint8_t start)
+{
+    packet[0] = DDP_FLAGS_VER1 | flags;
+    packet[1] = seq;
+    packet[2] = DDP_TYPE_RGB24;
+    packet[3] = DDP_ID_DISPLAY;
+    packet[4] = offset >> 24;
+    packet[5] = offset >> 16;
+    packet[6] = offset >> 8;
+    packet[7] = offset;
+    packet[8] = length >> 8;
+    packet[9] = length;
+    for (uint16_t i = 0; i < length; i++)
+    {
+        packet[DDP_HEADER_LEN + i] = start + i;
+    }
+    return DDP_HEADER_LEN + length;
+}
+
+/**
+ * Build an E1.31 data packet for a universe carrying bytes start, start+1, ...
+ */
+static size_t buildE131(uint16_t universe, uint8_t seq, uint8_t options, uint16_t channels, uint8_t start)
+{
+    static const uint8_t ACN_ID[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+    memset(packet, 0, E131_HEADER_LEN);
+    memcpy(packet + 4, ACN_ID, sizeof(ACN_ID));
+    packet[21] = E131_ROOT_VECTOR_DATA;
+    packet[43] = E131_FRAME_VECTOR_DATA;
+    packet[111] = seq;
+    packet[112] = options;
+    packet[113] = universe >> 8;
+    packet[114] = universe;
+    packet[117] = E131_DMP_VECTOR_SET;
+    packet[123] = (channels + 1) >> 8;
+    packet[124] = channels + 1;
+    for (uint16_t i = 0; i < channels; i++)
+    {
+        packet[E131_HEADER_LEN + i] = start + i;
+    }
+    return E131_HEADER_LEN + channels;
+}
+
+// ============================================================================
+// DDP TESTS
+// ============================================================================
+
+void test_ddp_writes_at_offset(void)
+{
+    SequenceTracker seq;
+    size_t length = buildDdp(0, 1, 3, 3, 10);
+    TEST_ASSERT_EQUAL(RT_DATA, parseDdp(packet, length, pixels, sizeof(pixels), seq));
+    TEST_ASSERT_EQUAL(0, pixels[2]);
+    TEST_ASSERT_EQUAL(10, pixels[3]);
+    TEST_ASSERT_EQUAL(12, pixels[5]);
+    TEST_ASSERT_EQUAL(0, pixels[6]);
+
+    // Push flag completes the frame
+    length = buildDdp(DDP_FLAGS_PUSH, 2, 6, 3, 20);
+    TEST_ASSERT_EQUAL(RT_FRAME, parseDdp(packet, length, pixels, sizeof(pixels), seq));
+    TEST_ASSERT_EQUAL(20, pixels[6]);
+}
+
+void test_ddp_clips_to_buffer(void)
+{
+    SequenceTracker seq;
+    uint8_t guard[TEST_PIXEL_BYTES + 4] = {0};
+    size_t length = buildDdp(DDP_FLAGS_PUSH, 0, TEST_PIXEL_BYTES - 2, 6, 1);
+    TEST_ASSERT_EQUAL(RT_FRAME, parseDdp(packet, length, guard, TEST_PIXEL_BYTES, seq));
+    TEST_ASSERT_EQUAL(2, guard[TEST_PIXEL_BYTES - 1]);
+    TEST_ASSERT_EQUAL(0, guard[TEST_PIXEL_BYTES]);
+
+    // Offset past the end writes nothing
+    length = buildDdp(DDP_FLAGS_PUSH, 0, 1000, 3, 1);
+    TEST_ASSERT_EQUAL(RT_FRAME, parseDdp(packet, length, guard, TEST_PIXEL_BYTES, seq));
+}
+
+void test_ddp_rejects_bad_packets(void)
+{
+    SequenceTracker seq;
+    size_t length = buildDdp(DDP_FLAGS_PUSH, 0, 0, 3, 1);
+
+    // Truncated payload
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseDdp(packet, length - 1, pixels, sizeof(pixels), seq));
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseDdp(packet, 4, pixels, sizeof(pixels), seq));
+
+    // Queries, other devices, wrong version
+    packet[0] |= DDP_FLAGS_QUERY;
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseDdp(packet, length, pixels, sizeof(pixels), seq));
+    length = buildDdp(DDP_FLAGS_PUSH, 0, 0, 3, 1);
+    packet[3] = 2;
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseDdp(packet, length, pixels, sizeof(pixels), seq));
+    length = buildDdp(DDP_FLAGS_PUSH, 0, 0, 3, 1);
+    packet[0] = (packet[0] & ~DDP_FLAGS_VER_MASK) | 0x80;
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseDdp(packet, length, pixels, sizeof(pixels), seq));
+}
+
+void test_ddp_timecode_skipped(void)
+{
+    SequenceTracker seq;
+    memset(pixels, 0, sizeof(pixels));
+    size_t length = buildDdp(DDP_FLAGS_PUSH | DDP_FLAGS_TIMECODE, 0, 0, 3 + DDP_TIMECODE_LEN, 0);
+    packet[9] = 3; // Data length excludes the timecode
+    TEST_ASSERT_EQUAL(RT_FRAME, parseDdp(packet, length, pixels, sizeof(pixels), seq));
+    TEST_ASSERT_EQUAL(DDP_TIMECODE_LEN, pixels[0]);
+}
+
+// ============================================================================
+// E1.31 TESTS
+// ============================================================================
+
+void test_e131_writes_channels(void)
+{
+    SequenceTracker seq;
+    memset(pixels, 0, sizeof(pixels));
+    size_t length = buildE131(1, 0, 0, 6, 50);
+    TEST_ASSERT_EQUAL(RT_FRAME, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+    TEST_ASSERT_EQUAL(50, pixels[0]);
+    TEST_ASSERT_EQUAL(55, pixels[5]);
+    TEST_ASSERT_EQUAL(0, pixels[6]);
+
+    // A full universe is clipped to the pixel buffer
+    length = buildE131(1, 1, 0, E131_MAX_CHANNELS, 0);
+    TEST_ASSERT_EQUAL(RT_FRAME, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+    TEST_ASSERT_EQUAL(TEST_PIXEL_BYTES - 1, pixels[TEST_PIXEL_BYTES - 1]);
+}
+
+void test_e131_filters_packets(void)
+{
+    SequenceTracker seq;
+    size_t length = buildE131(2, 0, 0, 6, 0);
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+
+    length = buildE131(1, 0, E131_OPT_PREVIEW, 6, 0);
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+
+    // Non-zero start code (e.g. per-channel priority)
+    length = buildE131(1, 0, 0, 6, 0);
+    packet[125] = 0xDD;
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+
+    length = buildE131(1, 0, 0, 6, 0);
+    packet[4] = 'X';
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+    TEST_ASSERT_EQUAL(RT_IGNORED, parseE131(packet, E131_HEADER_LEN - 1, 1, pixels, sizeof(pixels), seq));
+}
+
+void test_e131_terminated(void)
+{
+    SequenceTracker seq;
+    size_t length = buildE131(1, 40, 0, 6, 0);
+    TEST_ASSERT_EQUAL(RT_FRAME, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+
+    length = buildE131(1, 41, E131_OPT_TERMINATED, 6, 0);
+    TEST_ASSERT_EQUAL(RT_TERMINATED, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+
+    // A restarted source may begin at any sequence number
+    length = buildE131(1, 5, 0, 6, 0);
+    TEST_ASSERT_EQUAL(RT_FRAME, parseE131(packet, length, 1, pixels, sizeof(pixels), seq));
+    TEST_ASSERT_EQUAL(0, seq.dropped);
+    TEST_ASSERT_EQUAL(0, seq.stale);
+}
+
+// ============================================================================
+// SEQUENCE TRACKING TESTS
+// ============================================================================
+
+void test_ddp_sequence_gaps(void)
+{
+    SequenceTracker seq;
+    seq.ddp(14);
+    seq.ddp(15);
+    seq.ddp(1); // Wraps 15 -> 1
+    TEST_ASSERT_EQUAL(0, seq.dropped);
+    seq.ddp(4);
+    TEST_ASSERT_EQUAL(2, seq.dropped);
+
+    // Unnumbered packets are not tracked
+    seq.ddp(0);
+    seq.ddp(5);
+    TEST_ASSERT_EQUAL(2, seq.dropped);
+}
+
+void test_e131_sequence_window(void)
+{
+    SequenceTracker seq;
+    TEST_ASSERT_TRUE(seq.e131(254));
+    TEST_ASSERT_TRUE(seq.e131(255));
+    TEST_ASSERT_TRUE(seq.e131(0)); // Wraps
+    TEST_ASSERT_TRUE(seq.e131(3));
+    TEST_ASSERT_EQUAL(2, seq.dropped);
+
+    // Duplicates and late packets inside the window are discarded
+    TEST_ASSERT_FALSE(seq.e131(3));
+    TEST_ASSERT_FALSE(seq.e131(250));
+    TEST_ASSERT_EQUAL(2, seq.stale);
+
+    // Far behind means the source restarted
+    TEST_ASSERT_TRUE(seq.e131(3 - E131_STALE_WINDOW));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    memset(pixels, 0, sizeof(pixels));
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests(void)
+{
+    UNITY_BEGIN();
+
+    // DDP tests
+    RUN_TEST(test_ddp_writes_at_offset);
+    RUN_TEST(test_ddp_clips_to_buffer);
+    RUN_TEST(test_ddp_rejects_bad_packets);
+    RUN_TEST(test_ddp_timecode_skipped);
+
+    // E1.31 tests
+    RUN_TEST(test_e131_writes_channels);
+    RUN_TEST(test_e131_filters_packets);
+    RUN_TEST(test_e131_terminated);
+
+    // Sequence tracking tests
+    RUN_TEST(test_ddp_sequence_gaps);
+    RUN_TEST(test_e131_sequence_window);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
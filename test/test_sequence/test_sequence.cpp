@@ -0,0 +1,315 @@
+/**
+ * @file test_sequence.cpp
+ * @brief Stackless sequence and timed effect tests
+ *
+ * Tests for the resume-point coroutines used to write timed light
+ * sequences as straight-line code, and for the Identify flash effect
+ * built on them.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include <string.h>
+    #include "config.h"
+    #include "Effect.h"
+    #include "Sequence.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include <string.h>
+    #include "config.h"
+    #include "Effect.h"
+    #include "Sequence.h"
+#endif
+
+/**
+ * Records the order its steps run in: two yields inside a loop, a wait
+ * on a flag and a sleep
+ */
+struct Script
+{
+    Sequence seq;
+    int i;          // Loop counter, kept across yields
+    int trace[16];  // Values recorded by the steps
+    int traced;
+    bool ready;     // Condition for SEQ_WAIT_UNTIL
+
+    Script() : i(0), traced(0), ready(false) {}
+
+    void note(int value)
+    {
+        trace[traced++] = value;
+    }
+
+    bool step(uint32_t now)
+    {
+        SEQ_BEGIN(seq);
+        note(1);
+        for (i = 0; i < 3; i++)
+        {
+            note(10 + i);
+            SEQ_YIELD(seq);
+        }
+        SEQ_WAIT_UNTIL(seq, ready);
+        note(2);
+        SEQ_SLEEP(seq, now, 100);
+        note(3);
+        SEQ_END(seq);
+    }
+};
+
+/**
+ * Step a flash effect at one instant and return LED 0's red level
+ */
+static int flashLevel(FlashEffect &flash, uint32_t now)
+{
+    EffectPixel out[LED_LENGTH];
+    flash.render(out, now);
+    return out[0].r;
+}
+
+// ============================================================================
+// SEQUENCE TESTS
+// ============================================================================
+
+void test_sequence_idle_until_restart(void)
+{
+    Script script;
+
+    TEST_ASSERT_FALSE(script.step(0));
+    TEST_ASSERT_EQUAL(0, script.traced);
+}
+
+void test_sequence_resumes_after_each_yield(void)
+{
+    Script script;
+    script.seq.restart(0);
+
+    // One loop iteration per step; locals would be lost, members are not
+    TEST_ASSERT_TRUE(script.step(0));
+    TEST_ASSERT_EQUAL(2, script.traced);
+    TEST_ASSERT_TRUE(script.step(0));
+    TEST_ASSERT_TRUE(script.step(0));
+    TEST_ASSERT_EQUAL(4, script.traced);
+    TEST_ASSERT_EQUAL(1, script.trace[0]);
+    TEST_ASSERT_EQUAL(10, script.trace[1]);
+    TEST_ASSERT_EQUAL(11, script.trace[2]);
+    TEST_ASSERT_EQUAL(12, script.trace[3]);
+}
+
+void test_sequence_waits_for_condition(void)
+{
+    Script script;
+    script.seq.restart(0);
+    for (int n = 0; n < 10; n++)
+    {
+        TEST_ASSERT_TRUE(script.step(0));
+    }
+    TEST_ASSERT_EQUAL(4, script.traced); // Held at the wait
+
+    script.ready = true;
+    TEST_ASSERT_TRUE(script.step(0));
+    TEST_ASSERT_EQUAL(2, script.trace[4]);
+}
+
+void test_sequence_sleep_measures_from_first_step(void)
+{
+    Script script;
+    script.ready = true;
+    script.seq.restart(0);
+    for (int n = 0; n < 4; n++)
+    {
+        script.step(1000); // Through the loop; sleep starts at 1000
+    }
+    TEST_ASSERT_EQUAL(5, script.traced);
+
+    TEST_ASSERT_TRUE(script.step(1099));
+    TEST_ASSERT_EQUAL(5, script.traced);
+    TEST_ASSERT_FALSE(script.step(1100));
+    TEST_ASSERT_EQUAL(3, script.trace[5]);
+    TEST_ASSERT_FALSE(script.seq.active);
+}
+
+void test_sequence_sleep_across_millis_wrap(void)
+{
+    Script script;
+    script.ready = true;
+    uint32_t start = 0xFFFFFFFFu - 50;
+    script.seq.restart(start);
+    for (int n = 0; n < 4; n++)
+    {
+        script.step(start);
+    }
+
+    TEST_ASSERT_TRUE(script.step(start + 99));
+    TEST_ASSERT_FALSE(script.step(start + 100));
+}
+
+void test_sequence_restart_and_stop(void)
+{
+    Script script;
+    script.seq.restart(0);
+    script.step(0);
+    script.step(0);
+
+    // Restart runs from the top again
+    script.traced = 0;
+    script.seq.restart(0);
+    script.step(0);
+    TEST_ASSERT_EQUAL(1, script.trace[0]);
+    TEST_ASSERT_EQUAL(10, script.trace[1]);
+
+    // Stop ends it without running the rest
+    script.seq.stop();
+    TEST_ASSERT_FALSE(script.step(0));
+    TEST_ASSERT_EQUAL(2, script.traced);
+}
+
+void test_sequence_ramp(void)
+{
+    Sequence seq;
+    seq.startTimer(500);
+
+    TEST_ASSERT_EQUAL(0, seq.ramp(500, 200));
+    TEST_ASSERT_EQUAL(128, seq.ramp(600, 200));
+    TEST_ASSERT_EQUAL(256, seq.ramp(700, 200));
+    TEST_ASSERT_EQUAL(256, seq.ramp(5000, 200));
+    TEST_ASSERT_EQUAL(256, seq.ramp(500, 0));
+}
+
+// ============================================================================
+// FLASH EFFECT TESTS
+// ============================================================================
+
+void test_flash_timing(void)
+{
+    EffectPixel white = {255, 255, 255};
+    FlashEffect flash(white, 2, 0, 300, 200);
+    flash.start(0);
+
+    // Frames at every 10ms: on 300, off 200, on 300, off 200, done
+    int lit = 0;
+    uint32_t now = 0;
+    for (; !flash.done() && now < 5000; now += 10)
+    {
+        lit += flashLevel(flash, now) == 255;
+    }
+
+    TEST_ASSERT_EQUAL(60, lit);
+    TEST_ASSERT_EQUAL(1010, now); // Done on the step at 1000
+    TEST_ASSERT_EQUAL(0, flashLevel(flash, now));
+}
+
+void test_flash_fades_up(void)
+{
+    EffectPixel red = {200, 0, 0};
+    FlashEffect flash(red, 1, 100, 100, 100);
+    flash.start(0);
+
+    TEST_ASSERT_EQUAL(0, flashLevel(flash, 0));
+    TEST_ASSERT_EQUAL(100, flashLevel(flash, 50));
+    TEST_ASSERT_EQUAL(200, flashLevel(flash, 100));
+    TEST_ASSERT_EQUAL(200, flashLevel(flash, 199));
+    TEST_ASSERT_EQUAL(0, flashLevel(flash, 200));
+    TEST_ASSERT_FALSE(flash.done());
+    flashLevel(flash, 300);
+    TEST_ASSERT_TRUE(flash.done());
+}
+
+void test_flash_restarts_mid_sequence(void)
+{
+    EffectPixel white = {255, 255, 255};
+    FlashEffect flash(white, IDENTIFY_FLASHES, IDENTIFY_RAMP_MS, IDENTIFY_ON_MS, IDENTIFY_OFF_MS);
+
+    TEST_ASSERT_TRUE(flash.done());
+    flash.start(0);
+    flashLevel(flash, 0);
+    flashLevel(flash, IDENTIFY_ON_MS); // First flash over
+
+    flash.start(1000);
+    TEST_ASSERT_FALSE(flash.done());
+    TEST_ASSERT_EQUAL(255, flashLevel(flash, 1000));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests()
+{
+    UNITY_BEGIN();
+
+    // Sequence tests
+    RUN_TEST(test_sequence_idle_until_restart);
+    RUN_TEST(test_sequence_resumes_after_each_yield);
+    RUN_TEST(test_sequence_waits_for_condition);
+    RUN_TEST(test_sequence_sleep_measures_from_first_step);
+    RUN_TEST(test_sequence_sleep_across_millis_wrap);
+    RUN_TEST(test_sequence_restart_and_stop);
+    RUN_TEST(test_sequence_ramp);
+
+    // Flash effect tests
+    RUN_TEST(test_flash_timing);
+    RUN_TEST(test_flash_fades_up);
+    RUN_TEST(test_flash_restarts_mid_sequence);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
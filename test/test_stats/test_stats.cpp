@@ -0,0 +1,142 @@
+/**
+ * @file test_stats.cpp
+ * @brief Render timing counter tests
+ *
+ * Tests for the FrameStats accumulator used to track write-to-frame
+ * latency and frame timing.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include "config.h"
+    #include "FrameStats.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include "config.h"
+    #include "FrameStats.h"
+#endif
+
+// ============================================================================
+// FRAME STATS TESTS
+// ============================================================================
+
+void test_stats_initially_empty(void)
+{
+    FrameStats stats;
+
+    TEST_ASSERT_EQUAL(0, stats.count);
+    TEST_ASSERT_EQUAL(0, stats.worst);
+    TEST_ASSERT_EQUAL(0, stats.average());
+}
+
+void test_stats_record(void)
+{
+    FrameStats stats;
+    stats.record(100);
+    stats.record(300);
+    stats.record(200);
+
+    TEST_ASSERT_EQUAL(3, stats.count);
+    TEST_ASSERT_EQUAL(200, stats.last);
+    TEST_ASSERT_EQUAL(300, stats.worst);
+    TEST_ASSERT_EQUAL(200, stats.average());
+}
+
+void test_stats_reset(void)
+{
+    FrameStats stats;
+    stats.record(500);
+    stats.reset();
+
+    TEST_ASSERT_EQUAL(0, stats.count);
+    TEST_ASSERT_EQUAL(0, stats.last);
+    TEST_ASSERT_EQUAL(0, stats.worst);
+}
+
+void test_stats_large_totals(void)
+{
+    // Total must not overflow 32 bits over long uptimes
+    FrameStats stats;
+    for (int i = 0; i < 10; i++)
+    {
+        stats.record(0xF0000000u);
+    }
+
+    TEST_ASSERT_EQUAL(0xF0000000u, stats.average());
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests(void)
+{
+    UNITY_BEGIN();
+
+    // Frame stats tests
+    RUN_TEST(test_stats_initially_empty);
+    RUN_TEST(test_stats_record);
+    RUN_TEST(test_stats_reset);
+    RUN_TEST(test_stats_large_totals);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
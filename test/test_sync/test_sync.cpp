@@ -0,0 +1,239 @@
+/**
+ * @file test_sync.cpp
+ * @brief Multi-lamp flicker sync tests
+ *
+ * Tests for the beacon codec, the sync clock and the flicker engine
+ * replay that together let lamps compute identical flicker.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include "config.h"
+    #include "FlickerEngine.h"
+    #include "FlickerSync.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include "config.h"
+    #include "FlickerEngine.h"
+    #include "FlickerSync.h"
+#endif
+
+// ============================================================================
+// BEACON CODEC TESTS
+// ============================================================================
+
+void test_packet_roundtrip(void)
+{
+    SyncPacket in = {7, UPDATE_INTERVAL, 0xDEADBEEF, 123456, 42};
+    uint8_t buf[SYNC_PACKET_SIZE];
+    TEST_ASSERT_EQUAL(SYNC_PACKET_SIZE, encodeSyncPacket(in, buf));
+
+    SyncPacket out;
+    TEST_ASSERT_TRUE(decodeSyncPacket(buf, sizeof(buf), out));
+    TEST_ASSERT_EQUAL(7, out.group);
+    TEST_ASSERT_EQUAL(UPDATE_INTERVAL, out.intervalMs);
+    TEST_ASSERT_EQUAL_UINT32(0xDEADBEEF, out.seed);
+    TEST_ASSERT_EQUAL_UINT32(123456, out.frame);
+    TEST_ASSERT_EQUAL(42, out.phaseMs);
+
+    // Little-endian on the wire regardless of host
+    TEST_ASSERT_EQUAL('A', buf[0]);
+    TEST_ASSERT_EQUAL(0xEF, buf[8]);
+}
+
+void test_packet_rejects_garbage(void)
+{
+    SyncPacket in = {1, UPDATE_INTERVAL, 1, 2, 3};
+    uint8_t buf[SYNC_PACKET_SIZE];
+    encodeSyncPacket(in, buf);
+
+    SyncPacket out;
+    TEST_ASSERT_FALSE(decodeSyncPacket(buf, SYNC_PACKET_SIZE - 1, out));
+    buf[4] = SYNC_VERSION + 1;
+    TEST_ASSERT_FALSE(decodeSyncPacket(buf, sizeof(buf), out));
+    buf[4] = SYNC_VERSION;
+    buf[0] ^= 0xFF;
+    TEST_ASSERT_FALSE(decodeSyncPacket(buf, sizeof(buf), out));
+}
+
+// ============================================================================
+// SYNC CLOCK TESTS
+// ============================================================================
+
+void test_clock_ticks_on_grid(void)
+{
+    SyncClock clock;
+    clock.begin(1, 1000);
+    TEST_ASSERT_FALSE(clock.tick(1000 + UPDATE_INTERVAL - 1));
+    TEST_ASSERT_TRUE(clock.tick(1000 + UPDATE_INTERVAL + 5));
+    TEST_ASSERT_EQUAL_UINT32(1, clock.frame);
+    TEST_ASSERT_EQUAL_UINT32(1000 + UPDATE_INTERVAL, clock.lastStep);
+
+    // A stall skips frames instead of bunching them
+    TEST_ASSERT_TRUE(clock.tick(1000 + 4 * UPDATE_INTERVAL + 1));
+    TEST_ASSERT_EQUAL_UINT32(4, clock.frame);
+}
+
+void test_clock_follows_leader(void)
+{
+    SyncClock leader, follower;
+    leader.begin(0xABCD, 0);
+    follower.begin(0x1234, 17);
+    for (uint32_t t = 0; t < 10 * UPDATE_INTERVAL + 20; t++)
+    {
+        leader.tick(t);
+    }
+
+    // First beacon jumps onto the leader's seed, frame and phase
+    uint32_t now = 10 * UPDATE_INTERVAL + 20;
+    TEST_ASSERT_TRUE(follower.follow(leader.beacon(SYNC_GROUP, now), SYNC_GROUP, now));
+    TEST_ASSERT_EQUAL_UINT32(leader.seed, follower.seed);
+    TEST_ASSERT_EQUAL_UINT32(leader.frame, follower.frame);
+    TEST_ASSERT_EQUAL_UINT32(leader.lastStep, follower.lastStep);
+    TEST_ASSERT_EQUAL_UINT32(1, follower.resyncs);
+
+    // A small phase error is slewed, not jumped
+    follower.lastStep += 4;
+    follower.follow(leader.beacon(SYNC_GROUP, now), SYNC_GROUP, now);
+    TEST_ASSERT_EQUAL_UINT32(1, follower.resyncs);
+    TEST_ASSERT_EQUAL_UINT32(leader.lastStep + 2, follower.lastStep);
+
+    // Other groups are ignored
+    TEST_ASSERT_FALSE(follower.follow(leader.beacon(SYNC_GROUP + 1, now), SYNC_GROUP, now));
+}
+
+void test_clock_catch_up_steps(void)
+{
+    SyncClock clock;
+    clock.begin(5, 0);
+
+    // Full history after boot, then nothing while every step is rendered
+    clock.tick(UPDATE_INTERVAL);
+    TEST_ASSERT_EQUAL(SYNC_WARMUP_STEPS, clock.catchUpSteps());
+    clock.tick(2 * UPDATE_INTERVAL);
+    TEST_ASSERT_EQUAL(0, clock.catchUpSteps());
+
+    // Steps skipped by a stall are replayed
+    clock.tick(5 * UPDATE_INTERVAL);
+    TEST_ASSERT_EQUAL(2, clock.catchUpSteps());
+}
+
+// ============================================================================
+// REPRODUCIBLE FLICKER TESTS
+// ============================================================================
+
+void test_replay_matches_lived_history(void)
+{
+    const uint32_t seed = 0xC0FFEE;
+    const uint32_t frame = 500;
+
+    // Lamp A rendered every step from frame 0
+    FlickerEngine a;
+    for (uint32_t f = 1; f <= frame; f++)
+    {
+        a.rng.seed(frameSeed(seed, f));
+        a.render(LED_LENGTH, 0.0f, DEFAULT_HUE, DEFAULT_SATURATION, true);
+    }
+
+    // Lamp B joins at the last frame and replays the history it missed
+    FlickerEngine b;
+    b.warmUp(seed, frame, SYNC_WARMUP_STEPS);
+    b.rng.seed(frameSeed(seed, frame));
+    b.render(LED_LENGTH, 0.0f, DEFAULT_HUE, DEFAULT_SATURATION, true);
+
+    for (int i = 0; i < LED_LENGTH; i++)
+    {
+        TEST_ASSERT_EQUAL(a.flame[i].h, b.flame[i].h);
+        TEST_ASSERT_EQUAL(a.flame[i].v, b.flame[i].v);
+    }
+}
+
+void test_frame_seed_varies(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(frameSeed(1, 2), frameSeed(1, 2));
+    TEST_ASSERT_NOT_EQUAL(frameSeed(1, 2), frameSeed(1, 3));
+    TEST_ASSERT_NOT_EQUAL(frameSeed(1, 2), frameSeed(2, 2));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests(void)
+{
+    UNITY_BEGIN();
+
+    // Beacon codec tests
+    RUN_TEST(test_packet_roundtrip);
+    RUN_TEST(test_packet_rejects_garbage);
+
+    // Sync clock tests
+    RUN_TEST(test_clock_ticks_on_grid);
+    RUN_TEST(test_clock_follows_leader);
+    RUN_TEST(test_clock_catch_up_steps);
+
+    // Reproducible flicker tests
+    RUN_TEST(test_replay_matches_lived_history);
+    RUN_TEST(test_frame_seed_varies);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
@@ -0,0 +1,247 @@
+/**
+ * @file test_timeline.cpp
+ * @brief Span timeline tests
+ *
+ * Tests for the Timeline ring: ordering, wrap-around, span packing, the
+ * wire form and base64 used by "@l", and start-time recovery.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include "config.h"
+    #include "Timeline.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include "config.h"
+    #include "Timeline.h"
+#endif
+
+/**
+ * Ring under test for TimelineScope (declared extern in Timeline.h)
+ */
+Timeline timeline;
+
+/**
+ * Collect held spans into an array, in recording order
+ */
+static int collect(const Timeline &t, TimelineEntry *out)
+{
+    int n = 0;
+    t.forEach([&](const TimelineEntry &e) { out[n++] = e; });
+    return n;
+}
+
+// ============================================================================
+// RING TESTS
+// ============================================================================
+
+void test_timeline_records_in_order(void)
+{
+    static Timeline t;
+    t.minDuration = 0;
+    t.record(TIMELINE_POLL, 1, 100, 400);
+    t.record(TIMELINE_FLICKER, 1, 150, 190);
+
+    TimelineEntry entries[TIMELINE_CAPACITY];
+    TEST_ASSERT_EQUAL(2, collect(t, entries));
+    TEST_ASSERT_EQUAL(TIMELINE_POLL, entries[0].span());
+    TEST_ASSERT_EQUAL(300, entries[0].duration());
+    TEST_ASSERT_EQUAL(TIMELINE_FLICKER, entries[1].span());
+    TEST_ASSERT_EQUAL(150, entries[1].start);
+    TEST_ASSERT_EQUAL(40, entries[1].duration());
+}
+
+void test_timeline_wraps(void)
+{
+    static Timeline t;
+    t.minDuration = 0;
+    for (int i = 0; i < TIMELINE_CAPACITY + 5; i++)
+    {
+        t.record(TIMELINE_SHOW, 0, i, i + 1);
+    }
+
+    // Only the newest TIMELINE_CAPACITY spans are kept, still in order
+    TimelineEntry entries[TIMELINE_CAPACITY];
+    TEST_ASSERT_EQUAL(TIMELINE_CAPACITY, collect(t, entries));
+    TEST_ASSERT_EQUAL(5, entries[0].start);
+    TEST_ASSERT_EQUAL(TIMELINE_CAPACITY + 4, entries[TIMELINE_CAPACITY - 1].start);
+
+    t.clear();
+    TEST_ASSERT_EQUAL(0, t.count());
+}
+
+void test_timeline_packing(void)
+{
+    static Timeline t;
+    t.minDuration = 0;
+    t.record(TIMELINE_SHOW, 1, 0, 20000000);           // Longer than 24 bits
+    t.record(TIMELINE_UPDATE, 0, 0xFFFFFFF0u, 0x10); // Across the clock wrap
+
+    TimelineEntry entries[TIMELINE_CAPACITY];
+    TEST_ASSERT_EQUAL(2, collect(t, entries));
+    TEST_ASSERT_EQUAL(TIMELINE_SHOW, entries[0].span());
+    TEST_ASSERT_EQUAL(1, entries[0].track());
+    TEST_ASSERT_EQUAL_HEX32(TIMELINE_MAX_DURATION, entries[0].duration());
+    TEST_ASSERT_EQUAL(TIMELINE_UPDATE, entries[1].span());
+    TEST_ASSERT_EQUAL(0, entries[1].track());
+    TEST_ASSERT_EQUAL(0x20, entries[1].duration());
+}
+
+void test_timeline_filters_short_and_paused(void)
+{
+    static Timeline t;
+    t.minDuration = 20;
+    t.record(TIMELINE_POLL, 0, 0, 19); // Idle pass, dropped
+    t.record(TIMELINE_POLL, 0, 0, 20);
+    t.pause(true);
+    t.record(TIMELINE_POLL, 0, 0, 500); // While dumping, dropped
+    t.pause(false);
+
+    TEST_ASSERT_EQUAL(1, t.count());
+}
+
+void test_timeline_scope(void)
+{
+    timeline.clear();
+    timeline.minDuration = 0;
+    {
+        TimelineScope scope(TIMELINE_RENDER);
+    }
+
+    TimelineEntry entries[TIMELINE_CAPACITY];
+    TEST_ASSERT_EQUAL(1, collect(timeline, entries));
+    TEST_ASSERT_EQUAL(TIMELINE_RENDER, entries[0].span());
+}
+
+// ============================================================================
+// WIRE FORMAT TESTS
+// ============================================================================
+
+void test_timeline_wire_encoding(void)
+{
+    TimelineEntry e;
+    e.start = 0x12345678u;
+    e.info = 0x85000102u; // Core 1, TIMELINE_FLICKER, 258 µs
+
+    uint8_t out[TIMELINE_WIRE_SIZE];
+    Timeline::encode(e, out);
+    const uint8_t expected[TIMELINE_WIRE_SIZE] = {0x78, 0x56, 0x34, 0x12, 0x02, 0x01, 0x00, 0x85};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, out, TIMELINE_WIRE_SIZE);
+}
+
+void test_timeline_base64(void)
+{
+    // RFC 4648 test vectors
+    char out[16];
+    TEST_ASSERT_EQUAL(0, timelineBase64((const uint8_t *)"", 0, out));
+    TEST_ASSERT_EQUAL_STRING("", out);
+    timelineBase64((const uint8_t *)"f", 1, out);
+    TEST_ASSERT_EQUAL_STRING("Zg==", out);
+    timelineBase64((const uint8_t *)"fo", 2, out);
+    TEST_ASSERT_EQUAL_STRING("Zm8=", out);
+    TEST_ASSERT_EQUAL(8, timelineBase64((const uint8_t *)"foobar", 6, out));
+    TEST_ASSERT_EQUAL_STRING("Zm9vYmFy", out);
+
+    const uint8_t high[3] = {0xFF, 0xFE, 0xFD};
+    timelineBase64(high, 3, out);
+    TEST_ASSERT_EQUAL_STRING("//79", out);
+}
+
+void test_timeline_unwrap(void)
+{
+    uint64_t now = 0x100000010ULL; // Just past a 32-bit wrap
+
+    TEST_ASSERT_TRUE(Timeline::unwrap(0x5, now) == 0x100000005ULL);
+    TEST_ASSERT_TRUE(Timeline::unwrap(0xFFFFFFF0u, now) == 0xFFFFFFF0ULL);
+    TEST_ASSERT_TRUE(Timeline::unwrap(1000, 5000) == 1000);
+}
+
+void test_timeline_span_names(void)
+{
+    TEST_ASSERT_EQUAL_STRING("homeSpan.poll", Timeline::spanName(TIMELINE_POLL));
+    TEST_ASSERT_EQUAL_STRING("show", Timeline::spanName(TIMELINE_SHOW));
+    TEST_ASSERT_EQUAL_STRING("?", Timeline::spanName(TIMELINE_SPAN_COUNT));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests(void)
+{
+    UNITY_BEGIN();
+
+    // Ring tests
+    RUN_TEST(test_timeline_records_in_order);
+    RUN_TEST(test_timeline_wraps);
+    RUN_TEST(test_timeline_packing);
+    RUN_TEST(test_timeline_filters_short_and_paused);
+    RUN_TEST(test_timeline_scope);
+
+    // Wire format tests
+    RUN_TEST(test_timeline_wire_encoding);
+    RUN_TEST(test_timeline_base64);
+    RUN_TEST(test_timeline_unwrap);
+    RUN_TEST(test_timeline_span_names);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
@@ -0,0 +1,189 @@
+/**
+ * @file test_trace.cpp
+ * @brief Crash trace ring tests
+ *
+ * Tests for the TraceLog ring: ordering, wrap-around and recovery of a
+ * buffer that survived a reset.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include "config.h"
+    #include "TraceLog.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include "config.h"
+    #include "TraceLog.h"
+#endif
+
+/**
+ * Collect surviving entries into an array, oldest first
+ */
+static int collect(const TraceLog &log, TraceEntry *out)
+{
+    int n = 0;
+    log.forEach([&](const TraceEntry &e) { out[n++] = e; });
+    return n;
+}
+
+// ============================================================================
+// TRACE RING TESTS
+// ============================================================================
+
+void test_trace_cold_buffer_is_wiped(void)
+{
+    // Garbage (no magic) as after power-on
+    static TraceBuffer buffer;
+    memset(&buffer, 0xA5, sizeof(buffer));
+
+    TraceLog log;
+    log.attach(&buffer);
+    TraceEntry entries[TRACE_CAPACITY];
+    TEST_ASSERT_EQUAL(0, collect(log, entries));
+    TEST_ASSERT_EQUAL_HEX32(TRACE_MAGIC, buffer.magic);
+}
+
+void test_trace_records_in_order(void)
+{
+    static TraceBuffer buffer;
+    TraceLog log;
+    buffer.magic = 0;
+    log.attach(&buffer);
+
+    log.record(TRACE_BUTTON, 1, 0, 10);
+    log.record(TRACE_HOMEKIT, 1, 75, 20);
+
+    TraceEntry entries[TRACE_CAPACITY];
+    TEST_ASSERT_EQUAL(2, collect(log, entries));
+    TEST_ASSERT_EQUAL(TRACE_BUTTON, entries[0].event());
+    TEST_ASSERT_EQUAL(1, entries[0].a());
+    TEST_ASSERT_EQUAL(TRACE_HOMEKIT, entries[1].event());
+    TEST_ASSERT_EQUAL(75, entries[1].b());
+    TEST_ASSERT_EQUAL(20, entries[1].time);
+}
+
+void test_trace_wraps(void)
+{
+    static TraceBuffer buffer;
+    TraceLog log;
+    buffer.magic = 0;
+    log.attach(&buffer);
+
+    for (int i = 0; i < TRACE_CAPACITY + 5; i++)
+    {
+        log.record(TRACE_FRAME_OVERRUN, 0, i, i);
+    }
+
+    // Only the newest TRACE_CAPACITY entries survive, still in order
+    TraceEntry entries[TRACE_CAPACITY];
+    TEST_ASSERT_EQUAL(TRACE_CAPACITY, collect(log, entries));
+    TEST_ASSERT_EQUAL(5, entries[0].b());
+    TEST_ASSERT_EQUAL(TRACE_CAPACITY + 4, entries[TRACE_CAPACITY - 1].b());
+}
+
+void test_trace_survives_reattach(void)
+{
+    static TraceBuffer buffer;
+    buffer.magic = 0;
+    {
+        TraceLog before;
+        before.attach(&buffer);
+        for (int i = 0; i < TRACE_CAPACITY + 3; i++)
+        {
+            before.record(TRACE_STATUS, i, 0, 0);
+        }
+    }
+
+    // New session (after a reset) continues after the newest entry
+    TraceLog after;
+    after.attach(&buffer);
+    after.record(TRACE_BOOT, 4, 0, 0);
+
+    TraceEntry entries[TRACE_CAPACITY];
+    TEST_ASSERT_EQUAL(TRACE_CAPACITY, collect(after, entries));
+    TEST_ASSERT_EQUAL((uint8_t)(TRACE_CAPACITY + 2), entries[TRACE_CAPACITY - 2].a());
+    TEST_ASSERT_EQUAL(TRACE_BOOT, entries[TRACE_CAPACITY - 1].event());
+}
+
+void test_trace_clamp(void)
+{
+    TEST_ASSERT_EQUAL(1234, traceClamp16(1234));
+    TEST_ASSERT_EQUAL(0xFFFF, traceClamp16(100000));
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests(void)
+{
+    UNITY_BEGIN();
+
+    // Trace ring tests
+    RUN_TEST(test_trace_cold_buffer_is_wiped);
+    RUN_TEST(test_trace_records_in_order);
+    RUN_TEST(test_trace_wraps);
+    RUN_TEST(test_trace_survives_reattach);
+    RUN_TEST(test_trace_clamp);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif
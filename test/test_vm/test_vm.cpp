@@ -0,0 +1,391 @@
+/**
+ * @file test_vm.cpp
+ * @brief Effect program interpreter tests
+ *
+ * Tests for the bytecode VM that runs user effect programs in place of
+ * the candle: instruction semantics, load-time validation, the
+ * per-step instruction budget and the built-in functions.
+ *
+ * @license MIT License
+ *
+ * Copyright (c) 2025 @outofjungle
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef UNIT_TEST
+    // Native platform - provide Arduino compatibility
+    #include <unity.h>
+    #include <string.h>
+    #include "config.h"
+    #include "EffectVM.h"
+
+    // Mock Arduino functions for native platform
+    void delay(unsigned long ms) {}
+#else
+    // Embedded platform - use real Arduino
+    #include <Arduino.h>
+    #include <unity.h>
+    #include <string.h>
+    #include "config.h"
+    #include "EffectVM.h"
+#endif
+
+// Inputs for one step: 1s in, frame 16, full orange at 80% brightness
+static const VmInputs INPUTS = {1000, 16, 0x1234567, 30, 100, 80};
+
+static EffectVM vm;
+static EffectPixel pixels[LED_LENGTH];
+
+/**
+ * Load a program, failing the test if it is rejected
+ */
+static void install(const uint8_t *program, size_t bytes)
+{
+    int where;
+    const char *error = vm.install(program, bytes, &where);
+    TEST_ASSERT_NULL(error);
+}
+
+/**
+ * Run a program that leaves its result in the red channel of LED 0
+ *
+ * @return The result, -1 if the program was rejected or ran out of budget
+ */
+static int32_t result(const uint8_t *program, size_t bytes)
+{
+    int where;
+    if (vm.install(program, bytes, &where) || vm.run(pixels, LED_LENGTH, INPUTS) != LED_LENGTH)
+    {
+        return -1;
+    }
+    return pixels[0].r;
+}
+
+// ============================================================================
+// INSTRUCTION TESTS
+// ============================================================================
+
+void test_vm_arithmetic(void)
+{
+    // (100 - 7) * 3 / 2 % 100 = 39
+    static const uint8_t program[] = {
+        VM_IMM(OP_LDI, 7, 100), VM_IMM(OP_LDI, 8, 7), VM_I(OP_SUB, 7, 7, 8),
+        VM_IMM(OP_LDI, 8, 3),   VM_I(OP_MUL, 7, 7, 8), VM_IMM(OP_LDI, 8, 2),
+        VM_I(OP_DIV, 7, 7, 8),  VM_IMM(OP_LDI, 8, 100), VM_I(OP_MOD, 7, 7, 8),
+        VM_I(OP_RGB, 7, 0, 0),  VM_I(OP_END, 0, 0, 0)};
+
+    TEST_ASSERT_EQUAL(39, result(program, sizeof(program)));
+}
+
+void test_vm_fixed_point_and_immediates(void)
+{
+    // 1.5 * 0.5 in 8.8 is 0.75 = 192; addi takes a signed byte
+    static const uint8_t program[] = {
+        VM_IMM(OP_LDI, 7, 384), VM_IMM(OP_LDI, 8, 128), VM_I(OP_FMUL, 7, 7, 8),
+        VM_I(OP_ADDI, 7, 7, -2), VM_I(OP_RGB, 7, 0, 0), VM_I(OP_END, 0, 0, 0)};
+
+    TEST_ASSERT_EQUAL(190, result(program, sizeof(program)));
+}
+
+void test_vm_load_high_half(void)
+{
+    // ldi sign-extends; ldhi replaces the top 16 bits: 0x00010000 >> 9 = 128
+    static const uint8_t program[] = {
+        VM_IMM(OP_LDI, 7, 0), VM_IMM(OP_LDHI, 7, 1), VM_IMM(OP_LDI, 8, 9),
+        VM_I(OP_SHR, 7, 7, 8), VM_I(OP_RGB, 7, 0, 0), VM_I(OP_END, 0, 0, 0)};
+
+    TEST_ASSERT_EQUAL(128, result(program, sizeof(program)));
+}
+
+void test_vm_division_by_zero_is_zero(void)
+{
+    static const uint8_t program[] = {
+        VM_IMM(OP_LDI, 7, 50), VM_I(OP_DIV, 8, 7, 9), VM_I(OP_MOD, 10, 7, 9),
+        VM_I(OP_ADD, 7, 8, 10), VM_I(OP_RGB, 7, 0, 0), VM_I(OP_END, 0, 0, 0)};
+
+    TEST_ASSERT_EQUAL(0, result(program, sizeof(program)));
+}
+
+void test_vm_inputs_and_color_clamp(void)
+{
+    // Red = LED index * 100 (clamped), green = level, blue = -1 (clamped)
+    static const uint8_t program[] = {
+        VM_IMM(OP_LDI, 7, 100), VM_I(OP_MUL, 7, VM_REG_LED, 7), VM_IMM(OP_LDI, 8, -1),
+        VM_I(OP_RGB, 7, VM_REG_LEVEL, 8), VM_I(OP_END, 0, 0, 0)};
+
+    install(program, sizeof(program));
+    vm.run(pixels, LED_LENGTH, INPUTS);
+
+    TEST_ASSERT_EQUAL(0, pixels[0].r);
+    TEST_ASSERT_EQUAL(100, pixels[1].r);
+    TEST_ASSERT_EQUAL(200, pixels[2].r);
+    TEST_ASSERT_EQUAL(255, pixels[3].r);
+    TEST_ASSERT_EQUAL(80, pixels[3].g);
+    TEST_ASSERT_EQUAL(0, pixels[3].b);
+}
+
+void test_vm_loop_and_branches(void)
+{
+    // Sum 1..10 with jlt, then skip a store with jz
+    static const uint8_t program[] = {
+        VM_IMM(OP_LDI, 7, 0),     // sum
+        VM_IMM(OP_LDI, 8, 0),     // i
+        VM_IMM(OP_LDI, 9, 10),    // limit
+        VM_I(OP_ADDI, 8, 8, 1),   // loop: i++
+        VM_I(OP_ADD, 7, 7, 8),    //       sum += i
+        VM_I(OP_JLT, 8, 9, -3),   //       while i < limit
+        VM_IMM(OP_JZ, 10, 1),     // r10 is 0: skip the next instruction
+        VM_IMM(OP_LDI, 7, 0),
+        VM_I(OP_RGB, 7, 0, 0), VM_I(OP_END, 0, 0, 0)};
+
+    TEST_ASSERT_EQUAL(55, result(program, sizeof(program)));
+}
+
+void test_vm_registers_persist_across_leds(void)
+{
+    // r7 counts LEDs run so far this step
+    static const uint8_t program[] = {
+        VM_I(OP_ADDI, 7, 7, 1), VM_I(OP_RGB, 7, 0, 0), VM_I(OP_END, 0, 0, 0)};
+
+    install(program, sizeof(program));
+    vm.run(pixels, LED_LENGTH, INPUTS);
+    TEST_ASSERT_EQUAL(1, pixels[0].r);
+    TEST_ASSERT_EQUAL(LED_LENGTH, pixels[LED_LENGTH - 1].r);
+
+    // ... and start from zero again the next step
+    vm.run(pixels, LED_LENGTH, INPUTS);
+    TEST_ASSERT_EQUAL(1, pixels[0].r);
+}
+
+// ============================================================================
+// VALIDATION TESTS
+// ============================================================================
+
+void test_vm_rejects_bad_programs(void)
+{
+    static const uint8_t badOpcode[] = {VM_OP_COUNT, 0, 0, 0, VM_I(OP_END, 0, 0, 0)};
+    static const uint8_t badRegister[] = {VM_I(OP_ADD, 7, 16, 0), VM_I(OP_END, 0, 0, 0)};
+    static const uint8_t badJump[] = {VM_IMM(OP_JMP, 0, 1), VM_I(OP_END, 0, 0, 0)};
+    static const uint8_t badJumpBack[] = {VM_I(OP_JLT, 0, 1, -2), VM_I(OP_END, 0, 0, 0)};
+    static const uint8_t runsOffEnd[] = {VM_I(OP_RGB, 0, 0, 0)};
+    static const uint8_t partial[] = {VM_I(OP_END, 0, 0, 0), 0};
+    int where;
+
+    TEST_ASSERT_NOT_NULL(EffectVM::validate(badOpcode, sizeof(badOpcode), &where));
+    TEST_ASSERT_EQUAL(0, where);
+    TEST_ASSERT_NOT_NULL(EffectVM::validate(badRegister, sizeof(badRegister), &where));
+    TEST_ASSERT_NOT_NULL(EffectVM::validate(badJump, sizeof(badJump), &where));
+    TEST_ASSERT_NOT_NULL(EffectVM::validate(badJumpBack, sizeof(badJumpBack), &where));
+    TEST_ASSERT_NOT_NULL(EffectVM::validate(runsOffEnd, sizeof(runsOffEnd), &where));
+    TEST_ASSERT_NOT_NULL(EffectVM::validate(partial, sizeof(partial), &where));
+    TEST_ASSERT_NOT_NULL(EffectVM::validate(partial, 0, &where));
+}
+
+void test_vm_unused_operands_are_not_checked(void)
+{
+    // Bytes b, c of ldi are an immediate, not registers
+    static const uint8_t program[] = {VM_IMM(OP_LDI, 7, 0x7F7F), VM_I(OP_END, 0, 0, 0)};
+    int where;
+
+    TEST_ASSERT_NULL(EffectVM::validate(program, sizeof(program), &where));
+}
+
+void test_vm_rejected_program_keeps_running_one(void)
+{
+    static const uint8_t good[] = {VM_I(OP_RGB, VM_REG_LEVEL, 0, 0), VM_I(OP_END, 0, 0, 0)};
+    static const uint8_t bad[] = {VM_I(OP_ADD, 0, 0, 99), VM_I(OP_END, 0, 0, 0)};
+    int where;
+
+    install(good, sizeof(good));
+    TEST_ASSERT_NOT_NULL(vm.install(bad, sizeof(bad), &where));
+    TEST_ASSERT_TRUE(vm.loaded);
+    TEST_ASSERT_EQUAL(80, result(good, sizeof(good)));
+}
+
+// ============================================================================
+// BUDGET TESTS
+// ============================================================================
+
+void test_vm_infinite_loop_stops_at_budget(void)
+{
+    static const uint8_t program[] = {VM_I(OP_RGB, VM_REG_LEVEL, 0, 0), VM_IMM(OP_JMP, 0, -1)};
+
+    install(program, sizeof(program));
+    memset(pixels, 7, sizeof(pixels));
+
+    TEST_ASSERT_EQUAL(0, vm.run(pixels, LED_LENGTH, INPUTS));
+    TEST_ASSERT_EQUAL(1, vm.exhausted);
+    TEST_ASSERT_EQUAL(VM_STEP_BUDGET, vm.lastUsed);
+    TEST_ASSERT_EQUAL(7, pixels[0].r); // Left as it was
+}
+
+void test_vm_budget_is_shared_by_all_leds(void)
+{
+    // Each LED loops VM_STEP_BUDGET / 4 times: the budget runs out mid-strip
+    static const uint8_t program[] = {
+        VM_IMM(OP_LDI, 8, VM_STEP_BUDGET / 8), VM_I(OP_ADDI, 7, 7, 1),
+        VM_I(OP_JLT, 7, 8, -2), VM_IMM(OP_LDI, 7, 0), VM_I(OP_RGB, 8, 0, 0), VM_I(OP_END, 0, 0, 0)};
+
+    install(program, sizeof(program));
+    int done = vm.run(pixels, LED_LENGTH, INPUTS);
+
+    TEST_ASSERT_TRUE(done > 0);
+    TEST_ASSERT_TRUE(done < LED_LENGTH);
+    TEST_ASSERT_EQUAL(1, vm.exhausted);
+}
+
+void test_vm_counts_instructions(void)
+{
+    static const uint8_t program[] = {VM_I(OP_RGB, 0, 0, 0), VM_I(OP_END, 0, 0, 0)};
+
+    install(program, sizeof(program));
+    vm.run(pixels, LED_LENGTH, INPUTS);
+
+    TEST_ASSERT_EQUAL(2 * LED_LENGTH, vm.lastUsed);
+    TEST_ASSERT_EQUAL(1, vm.steps);
+    TEST_ASSERT_EQUAL(0, vm.exhausted);
+}
+
+// ============================================================================
+// BUILT-IN FUNCTION TESTS
+// ============================================================================
+
+void test_vm_sine_table(void)
+{
+    TEST_ASSERT_EQUAL(128, VM_SIN8[0]);
+    TEST_ASSERT_EQUAL(255, VM_SIN8[64]);
+    TEST_ASSERT_EQUAL(128, VM_SIN8[128]);
+    TEST_ASSERT_EQUAL(0, VM_SIN8[192]);
+}
+
+void test_vm_noise_is_smooth(void)
+{
+    // Lattice points are hash values; neighbours 1/256 apart differ a little
+    for (int32_t row = 0; row < 4; row++)
+    {
+        TEST_ASSERT_EQUAL(vmHash(3, row), vmNoise(3 << 8, row));
+        for (int32_t x = 0; x < 8 << 8; x++)
+        {
+            int step = (int)vmNoise(x + 1, row) - (int)vmNoise(x, row);
+            TEST_ASSERT_TRUE(step >= -3 && step <= 3);
+        }
+    }
+}
+
+void test_vm_rand_range_and_sync(void)
+{
+    // r7 = rand(10) for every LED; same seed, same sequence
+    static const uint8_t program[] = {
+        VM_IMM(OP_LDI, 8, 10), VM_I(OP_RAND, 7, 8, 0), VM_I(OP_RGB, 7, 0, 0), VM_I(OP_END, 0, 0, 0)};
+    EffectPixel first[LED_LENGTH];
+
+    install(program, sizeof(program));
+    vm.run(first, LED_LENGTH, INPUTS);
+    vm.run(pixels, LED_LENGTH, INPUTS);
+
+    for (int i = 0; i < LED_LENGTH; i++)
+    {
+        TEST_ASSERT_TRUE(first[i].r < 10);
+        TEST_ASSERT_EQUAL(first[i].r, pixels[i].r);
+    }
+}
+
+void test_vm_hsv_primaries(void)
+{
+    EffectPixel red = vmHsv(0, 255, 255);
+    EffectPixel grey = vmHsv(100, 0, 200);
+    EffectPixel dark = vmHsv(100, 255, 0);
+
+    TEST_ASSERT_EQUAL(255, red.r);
+    TEST_ASSERT_EQUAL(0, red.g);
+    TEST_ASSERT_EQUAL(0, red.b);
+    TEST_ASSERT_EQUAL(200, grey.r);
+    TEST_ASSERT_EQUAL(200, grey.g);
+    TEST_ASSERT_EQUAL(200, grey.b);
+    TEST_ASSERT_EQUAL(0, dark.r + dark.g + dark.b);
+}
+
+// ============================================================================
+// TEST RUNNER
+// ============================================================================
+
+void setUp(void)
+{
+    // Called before each test
+    vm.unload();
+}
+
+void tearDown(void)
+{
+    // Called after each test
+}
+
+void run_tests()
+{
+    UNITY_BEGIN();
+
+    // Instruction tests
+    RUN_TEST(test_vm_arithmetic);
+    RUN_TEST(test_vm_fixed_point_and_immediates);
+    RUN_TEST(test_vm_load_high_half);
+    RUN_TEST(test_vm_division_by_zero_is_zero);
+    RUN_TEST(test_vm_inputs_and_color_clamp);
+    RUN_TEST(test_vm_loop_and_branches);
+    RUN_TEST(test_vm_registers_persist_across_leds);
+
+    // Validation tests
+    RUN_TEST(test_vm_rejects_bad_programs);
+    RUN_TEST(test_vm_unused_operands_are_not_checked);
+    RUN_TEST(test_vm_rejected_program_keeps_running_one);
+
+    // Budget tests
+    RUN_TEST(test_vm_infinite_loop_stops_at_budget);
+    RUN_TEST(test_vm_budget_is_shared_by_all_leds);
+    RUN_TEST(test_vm_counts_instructions);
+
+    // Built-in function tests
+    RUN_TEST(test_vm_sine_table);
+    RUN_TEST(test_vm_noise_is_smooth);
+    RUN_TEST(test_vm_rand_range_and_sync);
+    RUN_TEST(test_vm_hsv_primaries);
+
+    UNITY_END();
+}
+
+#ifdef UNIT_TEST
+// Native platform - use main()
+int main(int argc, char **argv)
+{
+    run_tests();
+    return 0;
+}
+#else
+// Embedded platform - use setup()/loop()
+void setup()
+{
+    delay(2000); // Wait for serial monitor
+    run_tests();
+}
+
+void loop()
+{
+    // Tests run once in setup()
+}
+#endif